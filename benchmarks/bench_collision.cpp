@@ -0,0 +1,103 @@
+// player collision benchmark: a big grid of rooms (6+ colliders each), reports the hash build cost, per-frame
+// moveAndSlide() cost for a player walking into walls (normal frames and long hitches), and the cost of re-syncing after some walls move
+//
+// usage: bench_collision [rooms] [frames] [cellSize]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/collision.h"
+#include "../include/world/room.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int rooms = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 2000;
+    CollisionSettings settings;
+    if (argc > 3) settings.cellSize = static_cast<float>(std::atof(argv[3]));
+
+    const float S = 20.0f;
+    Vector3 roomSize = {10*S, 2.5f*S, 10*S};
+    int side = 1;
+    while (side * side < rooms) side++;
+
+    Registry registry;
+    TransformSystem transformSystem;
+
+    std::vector<Vector3> centers;
+    for (int i = 0; i < rooms; ++i) {
+        float x = (i % side) * roomSize.x * 1.5f;
+        float z = (i / side) * roomSize.z * 1.5f;
+        CreateRoom(registry, { x, 0, z }, roomSize);
+        centers.push_back({ x, 0, z });
+    }
+    transformSystem.update(registry);
+
+    CollisionSystem collision(settings);
+    auto t0 = Clock::now();
+    collision.update(registry);
+    double buildMs = MsSince(t0);
+    const SpatialHash& hash = collision.getHash();
+    std::printf("%zu colliders, %zu cells, %zu oversized\n", collision.colliderCount(), hash.cellCount(), hash.oversizedCount());
+    std::printf("hash build:     %.2f ms\n", buildMs);
+
+    // a player per frame next to a random wall of a random room, walking at CAMERA_MOVE_SPEED towards it
+    // (+-60 degrees), so most frames hit and slide
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> room(0, rooms - 1);
+    std::uniform_int_distribution<int> wallSide(0, 3);
+    std::uniform_real_distribution<float> along(-roomSize.x * 0.45f, roomSize.x * 0.45f);
+    std::uniform_real_distribution<float> gap(0.5f, 2.0f);
+    std::uniform_real_distribution<float> turn(-PI / 3, PI / 3);
+    const Vector3 half{ 0.3f, 1.0f, 0.3f };
+
+    // one 60 Hz frame, then a 2 s hitch (~170 units, the sweep has to stop at the first wall)
+    for (float dt : { 1.0f / 60.0f, 2.0f }) {
+        const float stepLength = 85.0f * dt;
+        double moveMs = 0.0;
+        size_t contacts = 0, candidates = 0;
+        for (int f = 0; f < frames; ++f) {
+            Vector3 c = centers[room(rng)];
+            int w = wallSide(rng);
+            float dirX = w == 0 ? 1.0f : w == 1 ? -1.0f : 0.0f; // towards the wall
+            float dirZ = w == 2 ? 1.0f : w == 3 ? -1.0f : 0.0f;
+            float distance = roomSize.x * 0.5f - gap(rng);
+            Vector3 from{ c.x + (dirX != 0 ? dirX * distance : along(rng)), 0.0f, c.z + (dirZ != 0 ? dirZ * distance : along(rng)) };
+            float a = atan2f(dirZ, dirX) + turn(rng);
+            Vector3 to{ from.x + cosf(a) * stepLength, 0.0f, from.z + sinf(a) * stepLength };
+            t0 = Clock::now();
+            collision.moveAndSlide(from, to, half);
+            moveMs += MsSince(t0);
+            contacts += collision.contacts;
+            candidates += collision.candidates;
+        }
+        std::printf("moveAndSlide:   %.4f ms/frame at dt %.3f (%.1f candidates, %.2f contacts)\n", moveMs / frames, dt,
+                    double(candidates) / frames, double(contacts) / frames);
+    }
+
+    // move 600 walls (~100 rooms) a little, then sync only those
+    std::vector<Entity> moved;
+    for (const auto& [e, c] : registry.view<Collision>()) {
+        if (moved.size() >= 600) break;
+        moved.push_back(e);
+    }
+    for (Entity e : moved) registry.get<WorldTransform>(e)->position.y += 0.5f;
+    t0 = Clock::now();
+    for (Entity e : moved) collision.markChanged(e);
+    collision.update(registry);
+    std::printf("update %zu walls: %.3f ms\n", moved.size(), MsSince(t0));
+
+    t0 = Clock::now();
+    collision.invalidate();
+    collision.update(registry);
+    std::printf("full re-sync:   %.2f ms\n", MsSince(t0));
+    return 0;
+}
@@ -0,0 +1,92 @@
+// CPU-only frustum culling benchmark: builds a large grid of rooms and reports BVH build cost,
+// per-frame culling cost and cull ratio (vs. testing every drawable)
+//
+// usage: bench_culling [rooms] [frames]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/culling.h"
+#include "../include/world/room.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int rooms = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    const float S = 20.0f;
+    Vector3 roomSize = {10*S, 2.5f*S, 10*S};
+    int side = 1;
+    while (side * side < rooms) side++;
+
+    Registry registry;
+    TransformSystem transformSystem;
+
+    auto t0 = Clock::now();
+    for (int i = 0; i < rooms; ++i) {
+        float x = (i % side) * roomSize.x * 1.5f;
+        float z = (i / side) * roomSize.z * 1.5f;
+        CreateRoom(registry, { x, 0, z }, roomSize);
+    }
+    transformSystem.update(registry);
+    double buildLevelMs = MsSince(t0);
+
+    VisibleSet visible;
+    Camera camera{};
+    camera.up = { 0, 1, 0 };
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    CullingSystem culling(camera, visible);
+
+    t0 = Clock::now();
+    culling.rebuild(registry);
+    double bvhMs = MsSince(t0);
+
+    // random first-person cameras inside the level
+    std::mt19937 rng(1234);
+    float extent = side * roomSize.x * 1.5f;
+    std::uniform_real_distribution<float> pos(0.0f, extent);
+    std::uniform_real_distribution<float> yaw(0.0f, 2.0f * PI);
+
+    double cullMs = 0.0, bruteMs = 0.0;
+    size_t visibleTotal = 0;
+    const auto& bvh = culling.getBvh();
+    for (int f = 0; f < frames; ++f) {
+        float a = yaw(rng);
+        camera.position = { pos(rng), 2.0f, pos(rng) };
+        camera.target = { camera.position.x + cosf(a), 2.0f, camera.position.z + sinf(a) };
+        Frustum frustum = Frustum::FromCamera(camera, 16.0f / 9.0f);
+
+        t0 = Clock::now();
+        culling.cull(frustum);
+        cullMs += MsSince(t0);
+        visibleTotal += visible.entities.size();
+
+        // baseline: test every drawable
+        t0 = Clock::now();
+        size_t bruteVisible = 0;
+        for (const auto& box : bvh.getItemBounds())
+            if (frustum.testBox(box) != FrustumTest::Outside) bruteVisible++;
+        bruteMs += MsSince(t0);
+        if (bruteVisible != visible.entities.size())
+            std::fprintf(stderr, "mismatch: bvh %zu vs brute %zu\n", visible.entities.size(), bruteVisible);
+    }
+
+    size_t drawables = culling.drawableCount();
+    double avgVisible = double(visibleTotal) / frames;
+    std::printf("rooms:            %d (%zu entities, %zu drawables)\n", rooms, registry.entityCount(), drawables);
+    std::printf("level build:      %.2f ms\n", buildLevelMs);
+    std::printf("bvh build:        %.2f ms (%zu nodes)\n", bvhMs, bvh.nodeCount());
+    std::printf("cull (bvh):       %.3f ms/frame\n", cullMs / frames);
+    std::printf("cull (brute):     %.3f ms/frame\n", bruteMs / frames);
+    std::printf("visible:          %.1f avg -> cull ratio %.2f%%\n", avgVisible, 100.0 * (1.0 - avgVisible / double(drawables)));
+    return 0;
+}
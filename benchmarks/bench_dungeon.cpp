@@ -0,0 +1,58 @@
+// procedural dungeon benchmark: layout time on one thread vs the pool, then building the layout into a Registry
+// (prefab rooms/hallways, ConnectAnchors) and one TransformSystem pass over the result
+//
+// usage: bench_dungeon [rooms] [regionRooms] [seed] [build: 0/1]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../include/core/thread_pool.h"
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/dungeon.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    DungeonSettings settings;
+    settings.rooms = argc > 1 ? std::atoi(argv[1]) : 100000;
+    if (argc > 2) settings.regionRooms = std::atoi(argv[2]);
+    if (argc > 3) settings.seed = std::strtoull(argv[3], nullptr, 10);
+    bool build = argc > 4 ? std::atoi(argv[4]) != 0 : true;
+
+    auto t0 = Clock::now();
+    DungeonLayout serial = GenerateDungeonLayout(settings);
+    double serialMs = MsSince(t0);
+
+    ThreadPool pool;
+    t0 = Clock::now();
+    DungeonLayout layout = GenerateDungeonLayout(settings, &pool);
+    double parallelMs = MsSince(t0);
+
+    bool same = serial.rooms.size() == layout.rooms.size() && serial.halls.size() == layout.halls.size();
+    for (size_t i = 0; same && i < layout.rooms.size(); ++i)
+        same = serial.rooms[i].position.x == layout.rooms[i].position.x && serial.rooms[i].position.z == layout.rooms[i].position.z;
+
+    std::printf("%zu rooms, %zu halls in %zu regions (%zu placements rejected)\n", layout.rooms.size(), layout.halls.size(),
+                layout.regions, layout.rejected);
+    std::printf("layout: %.1f ms on 1 thread, %.1f ms on %zu threads (%s)\n", serialMs, parallelMs, pool.threadCount(),
+                same ? "identical" : "DIFFERENT");
+    if (!build) return 0;
+
+    Registry registry;
+    TransformSystem transformSystem;
+    t0 = Clock::now();
+    BuildDungeon(registry, transformSystem, layout);
+    double buildMs = MsSince(t0);
+
+    t0 = Clock::now();
+    transformSystem.update(registry);
+    double transformMs = MsSince(t0);
+    std::printf("build: %.0f ms for %zu entities (%zu colliders), TransformSystem pass %.0f ms\n", buildMs, registry.entityCount(),
+                registry.count<Collision>(), transformMs);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// cold start of a big level (no window): building it procedurally (layout, prefab rooms/hallways, doorways, one
+// TransformSystem pass) vs mapping a saved .level and instantiating it into an empty Registry
+// the .level is dropped from the page cache (posix_fadvise) before each load, so it's read from disk... the level
+// file stores world transforms, so nothing else runs before the first frame could draw
+//
+// usage: bench_level_load [rooms] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/core/mapped_file.h"
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/dungeon.h"
+#include "../include/world/level_file.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// asks the kernel to forget the file's cached pages (best effort, dirty pages are synced first)
+static void DropFromCache(const std::filesystem::path& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+int main(int argc, char** argv) {
+    DungeonSettings settings;
+    settings.rooms = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 3;
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "bench_level_load.level";
+
+    double buildMs = 0.0;
+    size_t built = 0;
+    for (int i = 0; i < iterations; ++i) {
+        auto t0 = Clock::now();
+        DungeonLayout layout = GenerateDungeonLayout(settings);
+        Registry registry;
+        TransformSystem transformSystem;
+        BuildDungeon(registry, transformSystem, layout);
+        transformSystem.update(registry);
+        buildMs += MsSince(t0);
+        built = registry.entityCount();
+        if (i == 0) {
+            t0 = Clock::now();
+            LevelFile level = WriteLevel(registry);
+            if (!SaveLevel(level, path.string().c_str())) return 1;
+            std::printf("%d rooms: %zu entities, .level %.1f MB written in %.0f ms\n", settings.rooms, built,
+                        static_cast<double>(level.bytes.size()) / (1024.0 * 1024.0), MsSince(t0));
+        }
+    }
+    buildMs /= iterations;
+
+    double coldMs = 0.0, warmMs = 0.0;
+    size_t loaded = 0;
+    for (int i = 0; i < 2 * iterations; ++i) {
+        bool cold = i < iterations;
+        if (cold) DropFromCache(path);
+        auto t0 = Clock::now();
+        Registry registry;
+        if (!LoadLevel(registry, path.string())) {
+            std::fprintf(stderr, "failed to load %s\n", path.string().c_str());
+            return 1;
+        }
+        (cold ? coldMs : warmMs) += MsSince(t0);
+        loaded = registry.entityCount();
+    }
+    coldMs /= iterations;
+    warmMs /= iterations;
+
+    std::printf("procedural (layout + build + transforms): %.0f ms\n", buildMs);
+    std::printf(".level cold: %.0f ms (%.1fx), warm: %.0f ms (%.1fx)%s\n", coldMs, buildMs / coldMs, warmMs, buildMs / warmMs,
+                loaded == built ? "" : "  ENTITY COUNT DIFFERS");
+    std::filesystem::remove(path);
+    return 0;
+}
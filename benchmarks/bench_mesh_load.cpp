@@ -0,0 +1,79 @@
+// mesh load benchmark (no window): parsing the glTF directly vs mapping the cooked .cmesh
+// both paths end with everything the GPU upload would read (the .cmesh pages are touched, since mapping alone
+// reads nothing)... before each run the files are dropped from the page cache (posix_fadvise) to get cold loads
+//
+// usage: bench_mesh_load [file.gltf] [iterations]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/core/mapped_file.h"
+#include "../include/render/cooked_mesh.h"
+#include "../include/render/gltf_reader.h"
+#include "../include/render/mesh_cooker.h"
+
+using Clock = std::chrono::steady_clock;
+
+// asks the kernel to forget the file's cached pages (best effort, dirty pages are synced first)
+static void DropFromCache(const std::filesystem::path& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+template <typename Fn>
+static double Measure(const char* label, int iterations, Fn&& fn) {
+    double total = 0;
+    for (int i = 0; i < iterations; ++i) total += fn();
+    double ms = total / iterations;
+    std::printf("%-10s %.3f ms/load\n", label, ms);
+    return ms;
+}
+
+int main(int argc, char** argv) {
+    std::filesystem::path gltf = argc > 1 ? argv[1] : "assets/models/brick/scene.gltf";
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    MeshData source = LoadGltfMesh(gltf.string());
+    if (source.empty()) {
+        std::fprintf(stderr, "failed to load %s\n", gltf.string().c_str());
+        return 1;
+    }
+    std::filesystem::path cmesh = std::filesystem::temp_directory_path() / "bench_mesh_load.cmesh";
+    if (!SaveCookedMesh(CookMesh(source), cmesh.string().c_str())) return 1;
+    std::printf("%zu vertices, %zu indices\n", source.positions.size(), source.indices.size());
+
+    volatile size_t sink = 0;
+    double gltfMs = Measure("glTF", iterations, [&] {
+        for (const auto& entry : std::filesystem::directory_iterator(gltf.parent_path())) DropFromCache(entry.path());
+        auto t0 = Clock::now();
+        MeshData mesh = LoadGltfMesh(gltf.string());
+        sink = sink + mesh.indices.size();
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    });
+
+    double cmeshMs = Measure(".cmesh", iterations, [&] {
+        DropFromCache(cmesh);
+        auto t0 = Clock::now();
+        MappedFile file(cmesh.string());
+        CookedMeshView view;
+        if (ParseCookedMesh(file.data(), file.size(), view)) {
+            // stand-in for the upload's copy: read every page once
+            uint64_t sum = 0;
+            for (size_t i = 0; i < file.size(); i += 4096) sum += file.data()[i];
+            sink = sink + sum + view.header->indexCount;
+        }
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    });
+
+    std::printf("speedup    %.1fx\n", gltfMs / cmeshMs);
+    std::filesystem::remove(cmesh);
+    return 0;
+}
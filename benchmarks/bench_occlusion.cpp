@@ -0,0 +1,88 @@
+// CPU-only occlusion culling benchmark: a grid of closed rooms with the camera inside one of them,
+// reports depth buffer cost per frame and how much of the frustum-culled set the walls hide
+//
+// usage: bench_occlusion [rooms] [frames] [threads]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/culling.h"
+#include "../include/render/occlusion.h"
+#include "../include/world/room.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int rooms = argc > 1 ? std::atoi(argv[1]) : 2500;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+    unsigned threads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 0;
+
+    const float S = 20.0f;
+    Vector3 roomSize = {10*S, 2.5f*S, 10*S};
+    int side = 1;
+    while (side * side < rooms) side++;
+
+    Registry registry;
+    TransformSystem transformSystem;
+
+    for (int i = 0; i < rooms; ++i) {
+        float x = (i % side) * roomSize.x * 1.5f;
+        float z = (i / side) * roomSize.z * 1.5f;
+        CreateRoom(registry, { x, 0, z }, roomSize);
+    }
+    transformSystem.update(registry);
+
+    VisibleSet visible;
+    Camera camera{};
+    camera.up = { 0, 1, 0 };
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    CullingSystem culling(camera, visible);
+    OcclusionSettings settings;
+    settings.threads = threads;
+    OcclusionCullingSystem occlusion(camera, visible, settings);
+
+    // random first-person cameras inside random rooms
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> room(0, rooms - 1);
+    std::uniform_real_distribution<float> offset(-roomSize.x * 0.4f, roomSize.x * 0.4f);
+    std::uniform_real_distribution<float> yaw(0.0f, 2.0f * PI);
+
+    double frustumMs = 0.0, occlusionMs = 0.0;
+    size_t frustumVisible = 0, finalVisible = 0, occluders = 0;
+    culling.update(registry);
+    occlusion.update(registry); // first update builds the occluder BVH
+    for (int f = 0; f < frames; ++f) {
+        int r = room(rng);
+        float a = yaw(rng);
+        camera.position = { (r % side) * roomSize.x * 1.5f + offset(rng), 0.0f, (r / side) * roomSize.z * 1.5f + offset(rng) };
+        camera.target = { camera.position.x + cosf(a), 0.0f, camera.position.z + sinf(a) };
+
+        auto t0 = Clock::now();
+        culling.update(registry);
+        frustumMs += MsSince(t0);
+        frustumVisible += visible.entities.size();
+
+        t0 = Clock::now();
+        occlusion.update(registry);
+        occlusionMs += MsSince(t0);
+        finalVisible += visible.entities.size();
+        occluders += occlusion.occludersUsed;
+    }
+
+    const OcclusionBuffer& buffer = occlusion.getBuffer();
+    std::printf("rooms:            %d (%zu entities)\n", rooms, registry.entityCount());
+    std::printf("depth buffer:     %d x %d\n", buffer.getWidth(), buffer.getHeight());
+    std::printf("frustum cull:     %.3f ms/frame, %.1f visible\n", frustumMs / frames, double(frustumVisible) / frames);
+    std::printf("occlusion:        %.3f ms/frame, %.1f occluders\n", occlusionMs / frames, double(occluders) / frames);
+    std::printf("after occlusion:  %.1f visible (%.2f%% of frustum set hidden)\n", double(finalVisible) / frames,
+                frustumVisible ? 100.0 * (1.0 - double(finalVisible) / double(frustumVisible)) : 0.0);
+    return 0;
+}
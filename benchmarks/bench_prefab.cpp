@@ -0,0 +1,58 @@
+// stamping out rooms: one CreateRoom call per room vs one batched Prefab::instantiate() for all of them
+// (same entities either way, see tests/test_prefab.cpp)
+//
+// usage: bench_prefab [rooms] [runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/prefabs.h"
+#include "../include/world/room.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int rooms = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+    const int side = 250;
+
+    std::vector<PrefabInstance> instances;
+    instances.reserve(rooms);
+    for (int i = 0; i < rooms; ++i) {
+        // a few sizes, like a real level
+        Vector3 size = { 80.0f + (i % 4) * 40.0f, 50, 80.0f + (i % 3) * 40.0f };
+        instances.push_back(PrefabInstance{ { (i % side) * 250.0f, 0, (i / side) * 250.0f }, size });
+    }
+
+    double createBest = 1e30, stampBest = 1e30;
+    size_t entities = 0;
+    for (int run = 0; run < runs; ++run) {
+        {
+            Registry registry;
+            auto t0 = Clock::now();
+            for (const PrefabInstance& inst : instances) CreateRoom(registry, inst.position, *inst.size);
+            createBest = std::min(createBest, MsSince(t0));
+        }
+        {
+            Registry registry;
+            auto t0 = Clock::now();
+            Prefab prefab = MakeRoomPrefab(); // captured inside the timing, it's part of a load
+            InstantiateRooms(registry, prefab, instances);
+            stampBest = std::min(stampBest, MsSince(t0));
+            entities = registry.entityCount();
+        }
+    }
+
+    std::printf("%d rooms (%zu entities), best of %d\n", rooms, entities, runs);
+    std::printf("CreateRoom per room: %.1f ms\n", createBest);
+    std::printf("prefab instantiate:  %.1f ms (%.1fx)\n", stampBest, createBest / stampBest);
+    return 0;
+}
@@ -0,0 +1,114 @@
+// raycast benchmark: a grid of rooms (6 walls each, ~100k walls by default), reports SAH build cost and
+// rays/sec for closest-hit, any-hit and 4/8-ray line-of-sight packets, single core
+//
+// usage: bench_raycast [rooms] [rays]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/raycast.h"
+#include "../include/world/room.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void Report(const char* label, size_t rays, double ms, size_t hits) {
+    std::printf("%-14s %7.2f Mrays/s  (%.1f%% hit)\n", label, rays / (ms * 1000.0), 100.0 * hits / rays);
+}
+
+int main(int argc, char** argv) {
+    int rooms = argc > 1 ? std::atoi(argv[1]) : 16667;
+    int rayCount = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    const float S = 20.0f;
+    Vector3 roomSize = {10*S, 2.5f*S, 10*S};
+    int side = 1;
+    while (side * side < rooms) side++;
+
+    Registry registry;
+    TransformSystem transformSystem;
+
+    std::vector<Vector3> centers;
+    for (int i = 0; i < rooms; ++i) {
+        // every room is open on one side so rays get out now and then
+        float x = (i % side) * roomSize.x * 1.5f;
+        float z = (i / side) * roomSize.z * 1.5f;
+        CreateRoom(registry, { x, 0, z }, roomSize, {}, { static_cast<Wall::Side>(2 + i % 2) });
+        centers.push_back({ x, 0, z });
+    }
+    transformSystem.update(registry);
+
+    RaycastQuery query;
+    auto t0 = Clock::now();
+    query.update(registry);
+    double buildMs = MsSince(t0);
+    std::printf("%zu walls, %zu nodes, SAH build %.1f ms\n", query.boxCount(), query.getBvh().nodeCount(), buildMs);
+
+    // eyes inside random rooms, directions mostly horizontal like aiming
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> room(0, rooms - 1);
+    std::uniform_real_distribution<float> offset(-roomSize.x * 0.45f, roomSize.x * 0.45f);
+    std::uniform_real_distribution<float> yaw(0.0f, 2.0f * PI);
+    std::uniform_real_distribution<float> pitch(-0.3f, 0.3f);
+    std::vector<Ray> rays(rayCount);
+    for (Ray& r : rays) {
+        Vector3 c = centers[room(rng)];
+        float a = yaw(rng), p = pitch(rng);
+        r.position = { c.x + offset(rng), 2.0f, c.z + offset(rng) };
+        r.direction = { cosf(a) * cosf(p), sinf(p), sinf(a) * cosf(p) };
+    }
+
+    size_t hits = 0;
+    t0 = Clock::now();
+    for (const Ray& r : rays) hits += query.closest(r).hit();
+    Report("closest", rays.size(), MsSince(t0), hits);
+
+    // line of sight to a point 150 units away (often through the open side into the next room)
+    hits = 0;
+    t0 = Clock::now();
+    for (const Ray& r : rays) hits += query.any(r, 150.0f);
+    Report("any (150)", rays.size(), MsSince(t0), hits);
+
+    // the same checks as packets: one AI eye, N targets around it
+    auto packets = [&]<int N>(const char* label) {
+        size_t blocked = 0;
+        RayPacket<N> packet;
+        auto start = Clock::now();
+        for (size_t i = 0; i + N <= rays.size(); i += N) {
+            for (int k = 0; k < N; ++k) {
+                const Ray& r = rays[i + k];
+                packet.origin[k] = rays[i].position;
+                packet.direction[k] = r.direction;
+                packet.maxDistance[k] = 150.0f;
+            }
+            blocked += __builtin_popcount(query.any(packet));
+        }
+        Report(label, rays.size() / N * N, MsSince(start), blocked);
+    };
+    packets.template operator()<4>("any x4 packet");
+    packets.template operator()<8>("any x8 packet");
+
+    // closest-hit packets too (hitscan spread)
+    hits = 0;
+    RayPacket<4> spread;
+    RayHit out[4];
+    t0 = Clock::now();
+    for (size_t i = 0; i + 4 <= rays.size(); i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            spread.origin[k] = rays[i].position;
+            spread.direction[k] = rays[i + k].direction;
+            spread.maxDistance[k] = INFINITY;
+        }
+        query.closest(spread, out);
+        for (const RayHit& h : out) hits += h.hit();
+    }
+    Report("closest x4", rays.size() / 4 * 4, MsSince(t0), hits);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// streaming a big dungeon around a camera that flies across it: main-thread update() cost per frame and how
+// many entities are resident at once, against building the whole layout up front
+//
+// usage: bench_streaming [rooms] [frames] [cellSize] [loadRadius] [threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/dungeon.h"
+#include "../include/world/streaming.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    DungeonSettings dungeon;
+    dungeon.rooms = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 3000;
+    StreamingSettings settings;
+    if (argc > 3) settings.cellSize = static_cast<float>(std::atof(argv[3]));
+    if (argc > 4) settings.loadRadius = static_cast<float>(std::atof(argv[4]));
+    if (argc > 5) settings.threads = static_cast<unsigned>(std::atoi(argv[5]));
+
+    DungeonLayout layout = GenerateDungeonLayout(dungeon);
+    // from the first room to the one furthest from it
+    const Vector3 lo = layout.rooms.front().position;
+    Vector3 hi = lo;
+    for (const DungeonRoom& room : layout.rooms)
+        if (Vector3Distance(room.position, lo) > Vector3Distance(hi, lo)) hi = room.position;
+    std::printf("%zu rooms, %zu halls, walking %.0f units\n", layout.rooms.size(), layout.halls.size(), Vector3Distance(hi, lo));
+
+    size_t everything = 0;
+    double buildMs = 0.0;
+    {
+        Registry full;
+        TransformSystem transformSystem;
+        auto t0 = Clock::now();
+        BuildDungeon(full, transformSystem, layout);
+        buildMs = MsSince(t0);
+        everything = full.entityCount();
+    }
+    std::printf("up front: %zu entities, built in %.0f ms\n", everything, buildMs);
+
+    Registry registry;
+    TransformSystem transformSystem;
+    StreamingWorld world(layout, settings);
+    auto t0 = Clock::now();
+    world.finish(registry, lo);
+    transformSystem.update(registry);
+    std::printf("streamed: %zu cells, first load %.1f ms for %zu entities\n", world.cellCount(), MsSince(t0), registry.entityCount());
+
+    // ~60 fps worth of frames, the camera moving the same distance each one
+    std::vector<double> updateMs;
+    size_t mostEntities = 0, mostCells = 0, merged = 0, unloaded = 0, overBudget = 0;
+    const Vector3 stepBy = Vector3Scale(Vector3Subtract(hi, lo), 1.0f / std::max(1, frames));
+    for (int f = 0; f <= frames; ++f) {
+        world.update(registry, Vector3Add(lo, Vector3Scale(stepBy, static_cast<float>(f))));
+        transformSystem.update(registry); // only the new entities are dirty
+        const StreamingStats& stats = world.getStats();
+        updateMs.push_back(stats.updateMs);
+        if (stats.updateMs > settings.frameBudgetMs) overBudget++;
+        merged += stats.mergedChunks;
+        unloaded += stats.unloadedCells;
+        mostEntities = std::max(mostEntities, registry.entityCount());
+        mostCells = std::max(mostCells, stats.residentCells);
+    }
+    std::sort(updateMs.begin(), updateMs.end());
+    double total = 0.0;
+    for (double ms : updateMs) total += ms;
+    std::printf("walk: %d frames, %.1f units/frame, %zu chunks merged, %zu cells unloaded\n", frames, Vector3Length(stepBy), merged, unloaded);
+    std::printf("update(): avg %.3f ms, p99 %.3f ms, max %.3f ms (budget %.1f ms, exceeded on %zu frames)\n", total / updateMs.size(),
+                updateMs[updateMs.size() * 99 / 100], updateMs.back(), settings.frameBudgetMs, overBudget);
+    std::printf("resident: at most %zu cells, %zu entities (%.1f%% of up front)\n", mostCells, mostEntities,
+                100.0 * static_cast<double>(mostEntities) / static_cast<double>(std::max<size_t>(1, everything)));
+    return 0;
+}
@@ -0,0 +1,70 @@
+// coplanar wall merging on a densely connected level: a grid of rooms built edge to edge (every room joined to its
+// +x and +z neighbour, so each shared wall exists twice) plus long corridors made of hallway pieces
+//
+// usage: bench_wall_merge [grid side] [corridors] [pieces per corridor]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/collision.h"
+#include "../include/world/anchor.h"
+#include "../include/world/hallway.h"
+#include "../include/world/room.h"
+#include "../include/world/wall_merge.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? std::atoi(argv[1]) : 60;
+    int corridors = argc > 2 ? std::atoi(argv[2]) : 200;
+    int pieces = argc > 3 ? std::atoi(argv[3]) : 20;
+
+    Registry registry;
+    TransformSystem transformSystem;
+    const Vector3 roomSize = { 200, 50, 200 };
+    std::vector<Entity> rooms;
+    for (int z = 0; z < side; ++z)
+        for (int x = 0; x < side; ++x) rooms.push_back(CreateRoom(registry, { x * roomSize.x, 0, z * roomSize.z }, roomSize));
+    // corridors south of the grid, along z
+    const Vector3 pieceSize = { 40, 50, 60 };
+    for (int c = 0; c < corridors; ++c)
+        for (int p = 0; p < pieces; ++p)
+            CreateHallway(registry, { c * 100.0f, 0, -500.0f - p * pieceSize.z }, pieceSize, AnchorDir::Back);
+    transformSystem.update(registry);
+    for (int z = 0; z < side; ++z)
+        for (int x = 0; x < side; ++x) {
+            Entity room = rooms[z * side + x];
+            if (x + 1 < side) ConnectAnchors(registry, FindAnchor(registry, room, AnchorDir::Right), FindAnchor(registry, rooms[z * side + x + 1], AnchorDir::Left));
+            if (z + 1 < side) ConnectAnchors(registry, FindAnchor(registry, room, AnchorDir::Back), FindAnchor(registry, rooms[(z + 1) * side + x], AnchorDir::Front));
+        }
+    transformSystem.update(registry);
+
+    auto syncMs = [&] {
+        CollisionSystem collision;
+        auto t0 = Clock::now();
+        collision.update(registry);
+        return MsSince(t0);
+    };
+    size_t entitiesBefore = registry.entityCount(), collidersBefore = registry.count<Collision>();
+    double syncBefore = syncMs();
+
+    auto t0 = Clock::now();
+    WallMergeStats stats = MergeCoplanarWalls(registry);
+    double mergeMs = MsSince(t0);
+    transformSystem.update(registry);
+    double syncAfter = syncMs();
+
+    std::printf("%d x %d rooms, %d corridors of %d pieces\n", side, side, corridors, pieces);
+    std::printf("merge: %.0f ms, %zu boxes merged (%zu exact duplicates)\n", mergeMs, stats.merged, stats.duplicates);
+    std::printf("entities %zu -> %zu, colliders %zu -> %zu\n", entitiesBefore, registry.entityCount(), collidersBefore,
+                registry.count<Collision>());
+    std::printf("CollisionSystem full sync: %.1f ms -> %.1f ms\n", syncBefore, syncAfter);
+    return 0;
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// just enough JSON for asset files (glTF) read by the offline tools... not for anything per frame
+// parse errors give a Null value, lookups on missing keys/indices return a shared Null so chains like
+// doc["nodes"][3]["mesh"] never need checks in between
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;                           // Array
+    std::vector<std::pair<std::string, JsonValue>> members; // Object, in file order
+
+    [[nodiscard]] bool isNull() const { return type == Type::Null; }
+    [[nodiscard]] bool isNumber() const { return type == Type::Number; }
+    [[nodiscard]] bool isArray() const { return type == Type::Array; }
+    [[nodiscard]] bool isObject() const { return type == Type::Object; }
+
+    [[nodiscard]] size_t size() const { return type == Type::Array ? items.size() : members.size(); }
+
+    [[nodiscard]] const JsonValue& operator[](size_t i) const {
+        return type == Type::Array && i < items.size() ? items[i] : Null();
+    }
+
+    [[nodiscard]] const JsonValue& operator[](std::string_view key) const {
+        for (const auto& [name, value] : members)
+            if (name == key) return value;
+        return Null();
+    }
+
+    [[nodiscard]] bool has(std::string_view key) const { return !(*this)[key].isNull(); }
+
+    [[nodiscard]] double asNumber(double fallback = 0.0) const { return type == Type::Number ? number : fallback; }
+    [[nodiscard]] int asInt(int fallback = 0) const { return type == Type::Number ? static_cast<int>(number) : fallback; }
+    [[nodiscard]] const std::string& asString() const { return string; }
+
+    static const JsonValue& Null() {
+        static const JsonValue null;
+        return null;
+    }
+};
+
+namespace json_detail {
+
+struct Parser {
+    std::string_view text;
+    size_t pos = 0;
+    bool failed = false;
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) pos++;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool literal(std::string_view word) {
+        if (text.substr(pos, word.size()) != word) return false;
+        pos += word.size();
+        return true;
+    }
+
+    // note: \u escapes outside ASCII are kept as '?', asset names and uris don't need them
+    std::string parseString() {
+        std::string out;
+        pos++; // opening quote
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) break;
+            char e = text[pos++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    unsigned code = static_cast<unsigned>(std::strtoul(std::string(text.substr(pos, 4)).c_str(), nullptr, 16));
+                    out += code < 0x80 ? static_cast<char>(code) : '?';
+                    pos += 4;
+                    break;
+                }
+                default: out += e; break; // \" \\ \/
+            }
+        }
+        if (pos >= text.size()) failed = true;
+        pos++; // closing quote
+        return out;
+    }
+
+    JsonValue parseValue(int depth = 0) {
+        JsonValue v;
+        skipSpace();
+        if (pos >= text.size() || depth > 64) {
+            failed = true;
+            return v;
+        }
+
+        char c = text[pos];
+        if (c == '{') {
+            pos++;
+            v.type = JsonValue::Type::Object;
+            if (consume('}')) return v;
+            do {
+                skipSpace();
+                if (pos >= text.size() || text[pos] != '"') { failed = true; return v; }
+                std::string key = parseString();
+                if (!consume(':')) { failed = true; return v; }
+                v.members.emplace_back(std::move(key), parseValue(depth + 1));
+            } while (!failed && consume(','));
+            if (!consume('}')) failed = true;
+        } else if (c == '[') {
+            pos++;
+            v.type = JsonValue::Type::Array;
+            if (consume(']')) return v;
+            do {
+                v.items.push_back(parseValue(depth + 1));
+            } while (!failed && consume(','));
+            if (!consume(']')) failed = true;
+        } else if (c == '"') {
+            v.type = JsonValue::Type::String;
+            v.string = parseString();
+        } else if (literal("true")) {
+            v.type = JsonValue::Type::Bool;
+            v.boolean = true;
+        } else if (literal("false")) {
+            v.type = JsonValue::Type::Bool;
+        } else if (literal("null")) {
+            // already Null
+        } else {
+            const char* begin = text.data() + pos;
+            char* end = nullptr;
+            std::string number(begin, std::min<size_t>(text.size() - pos, 64));
+            v.number = std::strtod(number.c_str(), &end);
+            size_t used = static_cast<size_t>(end - number.c_str());
+            if (used == 0) {
+                failed = true;
+                return v;
+            }
+            v.type = JsonValue::Type::Number;
+            pos += used;
+        }
+        return v;
+    }
+};
+
+} // namespace json_detail
+
+// Null (and ok = false) if the text isn't one well-formed JSON value
+inline JsonValue ParseJson(std::string_view text, bool* ok = nullptr) {
+    json_detail::Parser parser{ text };
+    JsonValue value = parser.parseValue();
+    parser.skipSpace();
+    bool good = !parser.failed && parser.pos == text.size();
+    if (ok) *ok = good;
+    return good ? value : JsonValue{};
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// small persistent worker pool for per-frame fork/join work (no thread start-up cost every frame)
+// parallelFor() blocks until every index has run, and the calling thread takes jobs too
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobCount = 0;
+    std::atomic<size_t> nextIndex{0};
+    size_t busy = 0;          // workers still inside the current job
+    uint64_t generation = 0;  // bumped per parallelFor so workers never run a job twice
+    bool stopping = false;
+
+    void drain(const std::function<void(size_t)>& fn, size_t count) {
+        for (size_t i = nextIndex++; i < count; i = nextIndex++) fn(i);
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* fn;
+            size_t count;
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+                count = jobCount;
+            }
+            drain(*fn, count);
+            {
+                std::lock_guard lock(mutex);
+                if (--busy == 0) done.notify_one();
+            }
+        }
+    }
+
+public:
+    // 0 = one thread per core (the caller counts as one)
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < threads; ++i) workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    [[nodiscard]] size_t threadCount() const { return workers.size() + 1; }
+
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) return;
+        if (workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+        {
+            std::lock_guard lock(mutex);
+            job = &fn;
+            jobCount = count;
+            nextIndex = 0;
+            busy = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        drain(fn, count);
+
+        std::unique_lock lock(mutex);
+        done.wait(lock, [&] { return busy == 0; });
+        job = nullptr;
+    }
+};
@@ -1,8 +1,12 @@
 #pragma once
 #include "raylib.h"
+#include "registry.h"
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include <memory>
-#include "../textures/managed_texture.h"
+#include "../textures/texture_handle.h"
+#include "../render/gpu_mesh.h"
 
 struct TransformComp {
     Vector3 position{0};
@@ -49,13 +53,22 @@ struct ColoredRender {
     ColoredRender(Color c) : color(c) {}
 };
 
+// uv: the part of the texture put on every face, normalized, v pointing down (raylib source rectangle order)
+// the default is the whole texture with v flipped, which is how DrawCubeTexture() maps it...
+// walls using a TextureAtlas get their tile here, so every material shares the atlas texture (one bind)
+// note: plain data (handle + rect), the texture itself lives in the AssetCache
 struct TexturedRender {
-    std::shared_ptr<ManagedTexture> texture;
+    TextureHandle texture;
+    Rectangle uv{0, 1, 1, -1};
     
     TexturedRender() = default;
-    TexturedRender(std::shared_ptr<ManagedTexture> tex) : texture(std::move(tex)) {}
+    TexturedRender(TextureHandle tex) : texture(tex) {}
+    TexturedRender(TextureHandle tex, Rectangle region) : texture(tex), uv(region) {}
     
-    const std::shared_ptr<ManagedTexture>& getTexture() const { return texture; }
+    TextureHandle getTexture() const { return texture; }
+
+    // true for an atlas tile (the texture can't repeat across a face, see BakeBoxes)
+    bool isSubRegion() const { return uv.x != 0 || uv.y != 1 || uv.width != 1 || uv.height != -1; }
 };
 
 struct Collision {
@@ -68,7 +81,7 @@ struct Collision {
 };
 
 struct Wall {
-    enum class Side { Front, Back, Left, Right };
+    enum class Side { Front, Back, Left, Right, Floor, Ceiling };
     Side side{Side::Front};
     
     Wall() = default;
@@ -77,16 +90,88 @@ struct Wall {
     Side getSide() const { return side; }
 };
 
+// what a doorway carve did to a wall entity (see CarveDoorway), so broadphases and baked meshes can follow it
+// without a full re-sync: Resized kept its entity (only the TransformComp changed), Created/Removed added/destroyed one,
+// Moved went along with its owner (see ConnectAnchors snapping a hallway)
+struct WallChange {
+    enum class Kind : uint8_t { Resized, Created, Removed, Moved };
+    Entity wall;
+    Entity owner; // the room/hallway
+    Kind kind;
+};
+
+// the four directions an anchor can face, in the same order as the matching Wall::Side
+enum class AnchorDir : uint8_t { Front, Back, Left, Right }; // -z, +z, -x, +x
+
+inline Vector3 AnchorDirVector(AnchorDir dir) {
+    constexpr Vector3 vectors[4] = { {0, 0, -1}, {0, 0, 1}, {-1, 0, 0}, {1, 0, 0} };
+    return vectors[static_cast<int>(dir)];
+}
+
+// nearest of the four (anchor directions are axis-aligned anyway)
+inline AnchorDir AnchorDirFromVector(Vector3 v) {
+    if (fabsf(v.x) > fabsf(v.z)) return v.x < 0 ? AnchorDir::Left : AnchorDir::Right;
+    return v.z < 0 ? AnchorDir::Front : AnchorDir::Back;
+}
+
+inline AnchorDir OppositeDir(AnchorDir dir) {
+    constexpr AnchorDir opposite[4] = { AnchorDir::Back, AnchorDir::Front, AnchorDir::Right, AnchorDir::Left };
+    return opposite[static_cast<int>(dir)];
+}
+
 struct Anchor {
     Vector3 localPos{0};
     Vector3 direction{0, 0, 1}; // normalized
     Entity connectedTo{INVALID_ENTITY};   // the other anchor entity id
+    AnchorDir dir{AnchorDir::Back};       // direction as an enum, no float compares needed
     
     Anchor() = default;
     Anchor(Vector3 pos, Vector3 dir, Entity connected) 
-        : localPos(pos), direction(dir), connectedTo(connected) {}
+        : localPos(pos), direction(dir), connectedTo(connected), dir(AnchorDirFromVector(dir)) {}
+    Anchor(Vector3 pos, AnchorDir d, Entity connected) 
+        : localPos(pos), direction(AnchorDirVector(d)), connectedTo(connected), dir(d) {}
     
     const Vector3& getLocalPos() const { return localPos; }
     const Vector3& getDirection() const { return direction; }
     Entity getConnectedTo() const { return connectedTo; }
-};
\ No newline at end of file
+    AnchorDir getDir() const { return dir; }
+};
+
+// on rooms/hallways: their anchor entity per direction (filled by CreateRoom/CreateHallway, see FindAnchor)
+struct AnchorSlots {
+    Entity anchors[4]{ INVALID_ENTITY, INVALID_ENTITY, INVALID_ENTITY, INVALID_ENTITY };
+
+    Entity get(AnchorDir dir) const { return anchors[static_cast<int>(dir)]; }
+};
+
+// one draw worth of merged static geometry (every face that shares a texture + tint)
+struct BakedMeshBatch {
+    TextureHandle texture; // empty for flat-colored walls
+    Color color{WHITE};
+    std::vector<float> vertices;  // xyz, world space
+    std::vector<float> texcoords; // uv, world-space tiled (atlas tiles: the tile once per tiling cell)
+    std::vector<float> normals;   // xyz
+    std::vector<unsigned short> indices;
+    GpuMesh gpu; // uploaded lazily on first draw
+};
+
+// merged walls of a room/hallway, cached on the room entity (see BakeRoomMesh)
+// note: dirty is set by CarveDoorway() so the room is only re-baked when its children change
+struct BakedMesh {
+    std::vector<BakedMeshBatch> batches;
+    BoundingBox bounds{};
+    size_t faceCount{0};   // faces kept after hidden-face removal
+    size_t culledFaces{0}; // faces dropped (contact / floor + ceiling overlap)
+    bool dirty{true};
+
+    BakedMesh() = default;
+
+    size_t vertexCount() const {
+        size_t n = 0;
+        for (const auto& b : batches) n += b.vertices.size() / 3;
+        return n;
+    }
+};
+
+// tag: entity is rendered through its parent's BakedMesh (DrawSystem skips it)
+struct StaticBatched {};
\ No newline at end of file
@@ -0,0 +1,237 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "components.h"
+#include "registry.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// per-instance overrides for Prefab::instantiate()
+struct PrefabInstance {
+    Vector3 position{0};
+    std::optional<Vector3> size;            // stretch the prefab to this size (see Prefab)
+    std::optional<TexturedRender> material; // every rendered node gets this instead of its captured render component
+                                            // (untextured = keep the captured one, like CreateRoom's default)
+
+    bool overridesMaterial() const { return material && material->texture; }
+};
+
+// what a node's fixup needs to know about the copy being stamped
+struct PrefabStamp {
+    const PrefabInstance& instance;
+    Vector3 prefabSize;               // the (first) captured root's size
+    uint32_t node;
+    const Vector3* rootOffset;        // roots only: where it sat relative to the first root, nullptr for the rest
+    std::span<const Entity> entities; // this instance's entities, by node
+
+    // captured references point at nodes: Entity{node + 1, 0}... version 0 is never alive, so they can't be mistaken
+    // for real entities (INVALID_ENTITY = a reference that left the subtree)
+    Entity resolve(Entity ref) const { return ref.id == 0 ? INVALID_ENTITY : entities[ref.id - 1]; }
+};
+
+// every entity reference inside a component, for capture (entity -> node) and instantiate (node -> entity)
+template<typename F> void ForEachEntityRef(Parent& p, F&& f) { p.parent = f(p.parent); }
+template<typename F> void ForEachEntityRef(Children& c, F&& f) { for (Entity& e : c.entities) e = f(e); }
+template<typename F> void ForEachEntityRef(Anchor& a, F&& f) { a.connectedTo = f(a.connectedTo); }
+template<typename F> void ForEachEntityRef(AnchorSlots& s, F&& f) { for (Entity& e : s.anchors) e = f(e); }
+
+// stretch a node to the instance's size: positions scale with the root, sizes only on the axes where the node spans
+// the whole prefab (a floor's width, a wall's height)... wall thickness and anchor markers keep theirs
+inline Vector3 PrefabStretchPosition(Vector3 p, const PrefabStamp& s) {
+    const Vector3 to = *s.instance.size, from = s.prefabSize;
+    // p / from first: exact for the usual +-half, so a stamped room lands on the same floats CreateRoom would
+    return { from.x != 0 ? p.x / from.x * to.x : p.x, from.y != 0 ? p.y / from.y * to.y : p.y, from.z != 0 ? p.z / from.z * to.z : p.z };
+}
+
+inline Vector3 PrefabStretchSize(Vector3 size, const PrefabStamp& s) {
+    const Vector3 to = *s.instance.size, from = s.prefabSize;
+    auto spans = [](float a, float b) { return fabsf(a - b) <= 1e-4f * std::max(1.0f, fabsf(b)); };
+    return { spans(size.x, from.x) ? to.x : size.x, spans(size.y, from.y) ? to.y : size.y, spans(size.z, from.z) ? to.z : size.z };
+}
+
+// per-component overrides, applied after the captured value was copied
+inline void PrefabFixup(TransformComp& t, const PrefabStamp& s) {
+    if (s.rootOffset) {
+        t.position = Vector3Add(s.instance.position, *s.rootOffset);
+        if (s.instance.size) t.size = *s.instance.size;
+        return;
+    }
+    if (!s.instance.size) return;
+    t.position = PrefabStretchPosition(t.position, s);
+    t.size = PrefabStretchSize(t.size, s);
+}
+
+// recomputed by the next TransformSystem pass, same as a freshly created entity
+inline void PrefabFixup(WorldTransform& w, const PrefabStamp&) { w = WorldTransform{}; }
+
+inline void PrefabFixup(Anchor& a, const PrefabStamp& s) {
+    if (s.instance.size) a.localPos = PrefabStretchPosition(a.localPos, s);
+}
+
+// an entity subtree (a room with its walls and anchors) captured once as plain component blobs, stamped out many
+// times... instantiate() creates every entity of every copy in one go and adds each component type as one batch
+// (Registry::add(span, span)), instead of one add<T>() per component per entity
+//   - nodes: the root, then its Children depth-first (same order CreateRoom made them)
+//   - several roots (a chunk of a level, see StreamingWorld) are captured as one prefab: the instance position places
+//     the first one, the others keep their offset to it... size overrides are meant for single-root prefabs
+//   - references inside the subtree (Parent, Children, anchors) are re-pointed at the copy, ones leaving it are
+//     cleared... the roots' Parents aren't captured, copies are new roots
+//   - Capture() takes the world components, CaptureWith<Ts...>() any list (types not listed aren't copied)
+// note: entities only, no BakedMesh or other caches... those get rebuilt like for anything else that's new
+class Prefab {
+private:
+    struct IColumn {
+        virtual ~IColumn() = default;
+        virtual void stamp(Registry& reg, const Prefab& prefab, std::span<const PrefabInstance> instances,
+                           std::span<const Entity> entities) const = 0;
+    };
+
+    template<typename T>
+    struct Column : IColumn {
+        std::vector<uint32_t> nodes;
+        std::vector<T> values;
+
+        void stamp(Registry& reg, const Prefab& prefab, std::span<const PrefabInstance> instances,
+                   std::span<const Entity> entities) const override {
+            std::vector<Entity> es;
+            std::vector<T> out;
+            es.reserve(nodes.size() * instances.size());
+            out.reserve(nodes.size() * instances.size());
+            for (size_t k = 0; k < instances.size(); ++k) {
+                const PrefabInstance& inst = instances[k];
+                if constexpr (std::is_same_v<T, ColoredRender> || std::is_same_v<T, TexturedRender>)
+                    if (inst.overridesMaterial()) continue; // see instantiate()
+                std::span<const Entity> mine = entities.subspan(k * prefab.nodes, prefab.nodes);
+                size_t first = out.size();
+                for (uint32_t node : nodes) es.push_back(mine[node]);
+                out.insert(out.end(), values.begin(), values.end());
+                for (size_t j = 0; j < nodes.size(); ++j) {
+                    int32_t slot = prefab.rootSlot[nodes[j]];
+                    PrefabStamp s{ inst, prefab.size, nodes[j], slot < 0 ? nullptr : &prefab.rootOffsets[slot], mine };
+                    if constexpr (requires(T& v) { ForEachEntityRef(v, [](Entity e) { return e; }); })
+                        ForEachEntityRef(out[first + j], [&](Entity ref) { return s.resolve(ref); });
+                    if constexpr (requires(T& v) { PrefabFixup(v, s); })
+                        PrefabFixup(out[first + j], s);
+                }
+            }
+            reg.add<T>(std::span<const Entity>(es), std::span<const T>(out));
+        }
+    };
+
+    std::vector<std::unique_ptr<IColumn>> columns;
+    std::vector<uint32_t> renderNodes; // nodes with a ColoredRender or TexturedRender (material override)
+    std::vector<uint32_t> roots;       // root nodes, in capture order
+    std::vector<int32_t> rootSlot;     // per node: index into roots/rootOffsets, -1 for the rest
+    std::vector<Vector3> rootOffsets;
+    size_t nodes = 0;
+    Vector3 size{ 1, 1, 1 };
+
+    template<typename T>
+    void captureColumn(const Registry& reg, const std::vector<Entity>& subtree, const std::unordered_map<Entity, uint32_t>& nodeOf) {
+        auto column = std::make_unique<Column<T>>();
+        for (uint32_t node = 0; node < subtree.size(); ++node) {
+            const T* value = reg.get<T>(subtree[node]);
+            if (!value) continue;
+            if constexpr (std::is_same_v<T, Parent>)
+                if (rootSlot[node] >= 0) continue;
+            T copy = *value;
+            if constexpr (requires(T& v) { ForEachEntityRef(v, [](Entity e) { return e; }); })
+                ForEachEntityRef(copy, [&](Entity e) {
+                    auto it = nodeOf.find(e);
+                    return it == nodeOf.end() ? INVALID_ENTITY : Entity{ it->second + 1, 0 };
+                });
+            column->nodes.push_back(node);
+            column->values.push_back(std::move(copy));
+        }
+        if (!column->nodes.empty()) columns.push_back(std::move(column));
+    }
+
+public:
+    template<typename... Ts>
+    static Prefab CaptureWith(const Registry& reg, std::span<const Entity> rootEntities) {
+        Prefab prefab;
+        std::vector<Entity> subtree;
+        std::unordered_map<Entity, uint32_t> nodeOf;
+        Vector3 origin{ 0, 0, 0 };
+        for (Entity root : rootEntities) {
+            if (nodeOf.contains(root)) continue; // already in an earlier root's subtree
+            auto t = reg.get<TransformComp>(root);
+            if (prefab.roots.empty() && t) {
+                origin = t->position;
+                prefab.size = t->size;
+            }
+            prefab.roots.push_back(static_cast<uint32_t>(subtree.size()));
+            prefab.rootOffsets.push_back(t ? Vector3Subtract(t->position, origin) : Vector3{ 0, 0, 0 });
+            std::vector<Entity> stack = { root };
+            while (!stack.empty()) {
+                Entity e = stack.back();
+                stack.pop_back();
+                if (!nodeOf.emplace(e, static_cast<uint32_t>(subtree.size())).second) continue;
+                subtree.push_back(e);
+                if (auto children = reg.get<Children>(e))
+                    for (auto it = children->entities.rbegin(); it != children->entities.rend(); ++it) stack.push_back(*it);
+            }
+        }
+        prefab.nodes = subtree.size();
+        prefab.rootSlot.assign(subtree.size(), -1);
+        for (size_t r = 0; r < prefab.roots.size(); ++r) prefab.rootSlot[prefab.roots[r]] = static_cast<int32_t>(r);
+        (prefab.captureColumn<Ts>(reg, subtree, nodeOf), ...);
+        for (uint32_t node = 0; node < subtree.size(); ++node)
+            if (reg.has<ColoredRender>(subtree[node]) || reg.has<TexturedRender>(subtree[node])) prefab.renderNodes.push_back(node);
+        return prefab;
+    }
+
+    template<typename... Ts>
+    static Prefab CaptureWith(const Registry& reg, Entity root) {
+        return CaptureWith<Ts...>(reg, std::span<const Entity>(&root, 1));
+    }
+
+    static Prefab Capture(const Registry& reg, std::span<const Entity> roots) {
+        return CaptureWith<TransformComp, WorldTransform, Parent, Children, ColoredRender, TexturedRender, Collision, Wall,
+                           Anchor, AnchorSlots, StaticBatched>(reg, roots);
+    }
+
+    static Prefab Capture(const Registry& reg, Entity root) {
+        return Capture(reg, std::span<const Entity>(&root, 1));
+    }
+
+    size_t nodeCount() const { return nodes; }
+    size_t rootCount() const { return roots.size(); }
+    Vector3 getSize() const { return size; }
+
+    // one copy per instance, returns their roots (copy by copy, in capture order)
+    std::vector<Entity> instantiate(Registry& reg, std::span<const PrefabInstance> instances) const {
+        std::vector<Entity> entities(nodes * instances.size());
+        reg.create(entities);
+        for (const auto& column : columns) column->stamp(reg, *this, instances, entities);
+
+        // material overrides replace whatever render component the node had
+        std::vector<Entity> es;
+        for (size_t k = 0; k < instances.size(); ++k)
+            if (instances[k].overridesMaterial())
+                for (uint32_t node : renderNodes) es.push_back(entities[k * nodes + node]);
+        if (!es.empty()) {
+            std::vector<TexturedRender> materials;
+            materials.reserve(es.size());
+            for (const PrefabInstance& inst : instances)
+                if (inst.overridesMaterial()) materials.insert(materials.end(), renderNodes.size(), *inst.material);
+            reg.add<TexturedRender>(std::span<const Entity>(es), std::span<const TexturedRender>(materials));
+        }
+
+        std::vector<Entity> out;
+        out.reserve(instances.size() * roots.size());
+        for (size_t k = 0; k < instances.size(); ++k)
+            for (uint32_t root : roots) out.push_back(entities[k * nodes + root]);
+        return out;
+    }
+
+    Entity instantiate(Registry& reg, const PrefabInstance& instance) const {
+        return instantiate(reg, std::span<const PrefabInstance>(&instance, 1)).front();
+    }
+};
@@ -12,6 +12,7 @@
 #include <limits>
 #include <typeinfo> // for typeid
 #include <ranges>   // c++23
+#include <span>
 
 // 'Entity' is now a versioned handle: 24-bit ID + 8-bit generation
 // prevents bugs when entity IDs are reused
@@ -86,6 +87,7 @@ private:
     std::vector<T> dense_components; // contiguous components
 
     size_t validCount = 0;
+    uint64_t revision = 0; // +1 per entity that gained or lost a T, see Registry::revision()
 
     // get dense index if entity is alive (in sparse set) and matches version
     // ensures that operations on entities are safe and consistent
@@ -121,9 +123,29 @@ public:
         dense_entities.push_back(e);
         dense_components.push_back(std::move(comp));
         validCount++;
+        revision++;
         return &dense_components.back();
     }
 
+    // many at once (prefab instantiation): one sparse resize and one reserve for the lot... when none of them has a T
+    // yet, both dense arrays are appended as whole ranges (a memcpy for plain components)
+    // note: es must not contain the same entity twice
+    void add(std::span<const Entity> es, std::span<const T> comps) {
+        uint32_t maxId = 0;
+        for (Entity e : es) maxId = std::max<uint32_t>(maxId, e.id);
+        enforceSparseSize(maxId);
+        if (std::any_of(es.begin(), es.end(), [&](Entity e) { return getDenseIndex(e).has_value(); })) {
+            for (size_t i = 0; i < es.size(); ++i) add(es[i], comps[i]);
+            return;
+        }
+        uint32_t base = static_cast<uint32_t>(dense_components.size());
+        for (size_t i = 0; i < es.size(); ++i) sparse[es[i].id] = base + static_cast<uint32_t>(i);
+        dense_entities.insert(dense_entities.end(), es.begin(), es.end());
+        dense_components.insert(dense_components.end(), comps.begin(), comps.end());
+        validCount += es.size();
+        revision += es.size();
+    }
+
     T* get(Entity e) {
         auto idx = getDenseIndex(e);
         return idx ? &dense_components[*idx] : nullptr;
@@ -151,6 +173,7 @@ public:
         dense_components.pop_back();
         sparse[e.id] = NULL_INDEX;
         validCount--;
+        revision++;
     }
 
     bool has(Entity e) const override {
@@ -161,6 +184,8 @@ public:
         return validCount;
     }
 
+    uint64_t getRevision() const { return revision; }
+
     // for iteration (const)
     const std::vector<Entity>& getEntities() const override { return dense_entities; }
     const std::vector<T>& getComponents() const { return dense_components; }
@@ -261,6 +286,12 @@ public:
         return Entity{id, ver};
     }
 
+    // fills out with new entities... one version-table resize for the lot instead of one per create()
+    void create(std::span<Entity> out) {
+        enforceEntityVersionSize(std::min<uint32_t>(nextId + static_cast<uint32_t>(out.size()), MAX_ENTITIES - 1));
+        for (Entity& e : out) e = create();
+    }
+
     void destroy(Entity e) {
         if (!isValid(e)) return; // handles id==0 and stale versions
 
@@ -287,6 +318,17 @@ public:
         getPool<T>()->add(e, std::move(comp));
     }
 
+    // batch add, comps[i] goes to es[i] (see ComponentPool::add(span, span))
+    template<typename T>
+    void add(std::span<const Entity> es, std::span<const T> comps) {
+        if (es.empty()) return;
+        if (!std::all_of(es.begin(), es.end(), [&](Entity e) { return isValid(e); })) {
+            for (size_t i = 0; i < es.size(); ++i) add<T>(es[i], comps[i]);
+            return;
+        }
+        getPool<T>()->add(es, comps);
+    }
+
     template<typename T>
     T* get(Entity e) {
         if (!isValid(e)) return nullptr;
@@ -356,6 +398,22 @@ public:
     //     return entities | std::views::transform(transform_fn);
     // }
 
+    // number of entities that have a T (cheap, no iteration)
+    template<typename T>
+    size_t count() const {
+        auto pool = getPool<T>();
+        return pool ? pool->size() : 0;
+    }
+
+    // bumped once per entity that gains a T (add) or loses it (destroy)... unlike count(), destroying one entity and
+    // making another in the same frame still moves it, so caches re-synced on it can't miss the swap
+    // note: overwriting an existing T or changing it in place doesn't count
+    template<typename T>
+    uint64_t revision() const {
+        auto pool = getPool<T>();
+        return pool ? pool->getRevision() : 0;
+    }
+
     size_t entityCount() const {
         return aliveEntityCount;
     }
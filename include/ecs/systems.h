@@ -2,7 +2,14 @@
 #include "components.h"
 #include "registry.h"
 #include "../render/draw_utils.h"
+#include "../render/mesh_baker.h"
+#include "../render/raylib_backend.h"
+#include "../render/render_commands.h"
+#include "../render/visible_set.h"
+#include "../spatial/bounds.h"
+#include "../textures/asset_cache.h"
 #include "raylib.h"
+#include "raymath.h"
 #include <memory>
 #include <unordered_set>
 #include <queue>
@@ -15,7 +22,7 @@ public:
 
 // convert euler angles (in degrees) to rotation matrix
 // uses YXZ (yaw-pitch-roll) order
-Matrix MatrixFromEulerDegrees(Vector3 eulerAngles) {
+inline Matrix MatrixFromEulerDegrees(Vector3 eulerAngles) {
     float radX = eulerAngles.x * DEG2RAD;
     float radY = eulerAngles.y * DEG2RAD;
     float radZ = eulerAngles.z * DEG2RAD;
@@ -29,7 +36,7 @@ Matrix MatrixFromEulerDegrees(Vector3 eulerAngles) {
 
 // extract Euler angles (in degrees) from rotation matrix
 // assumes YXZ (yaw-pitch-roll) order
-Vector3 EulerFromMatrix(Matrix mat) {
+inline Vector3 EulerFromMatrix(Matrix mat) {
     // clamp to avoid NaN due to floating point inaccuracies
     const float epsilon = 1e-6f;
     float sy = sqrtf(mat.m0 * mat.m0 + mat.m1 * mat.m1);
@@ -49,9 +56,48 @@ Vector3 EulerFromMatrix(Matrix mat) {
 
 // calculates hierarchical world transforms
 // based on local transforms (TransformComp) and parent-child relationships
+// also records which colliders it moved, so broadphases (see DynamicBroadphase) only touch what changed
 class TransformSystem : public ISystem {
+private:
+    std::vector<Entity> changedColliders;
+
 public:
+    // where `local` ends up under a parent placed at `parentWorld` (nullptr: a root, world transform = local transform)
+    // note: what update() writes, so code that makes entities between updates (see CarveDoorway) can place them exactly
+    static WorldTransform Compose(const WorldTransform* parentWorld, const TransformComp& local) {
+        WorldTransform world{};
+        if (!parentWorld) {
+            world.position = local.position;
+            world.size = local.size;
+            world.rotation = local.rotation;
+            return world;
+        }
+        // build parent's world transformation matrix (rotation + translation)
+        Matrix parentRot = MatrixFromEulerDegrees(parentWorld->rotation);
+        Matrix parentMat = MatrixTranslate(parentWorld->position.x, parentWorld->position.y, parentWorld->position.z);
+        parentMat = MatrixMultiply(parentRot, parentMat); // rotation applied before translation
+
+        // transform local position by parent's world matrix
+        Vector3 worldPos = Vector3Transform(local.position, parentMat);
+
+        // combine rotations via matrix multiplication
+        Matrix localRot = MatrixFromEulerDegrees(local.rotation);
+        Matrix worldRotMat = MatrixMultiply(parentRot, localRot);
+        Vector3 worldRot = EulerFromMatrix(worldRotMat);
+
+        // set world transform
+        world.position = worldPos;
+        world.rotation = worldRot;
+        world.size = local.size;
+        // world.size = Vector3Multiply(parentWorld->size, local.size); // TODO: if hierarchical scaling is needed, multiply by parent size
+        return world;
+    }
+
+    // entities with a Collision whose WorldTransform was added or changed by the last update()
+    [[nodiscard]] const std::vector<Entity>& getChangedColliders() const { return changedColliders; }
+
     void update(Registry& reg, float deltaTime = 0.0f) override {
+        changedColliders.clear();
         // build dependency graph to process parents before children
         std::unordered_map<Entity, std::vector<Entity>> parentToChildren;
         std::unordered_set<Entity> rootEntities; // entities without parents
@@ -90,48 +136,42 @@ public:
         }
     }
 private:
+    // exact on purpose: Vector3Equals() would let slow movers creep away unnoticed, a frame at a time
+    static bool SameTransform(const WorldTransform& a, const WorldTransform& b) {
+        auto same = [](Vector3 p, Vector3 q) { return p.x == q.x && p.y == q.y && p.z == q.z; };
+        return same(a.position, b.position) && same(a.size, b.size) && same(a.rotation, b.rotation);
+    }
+
     void updateEntityTransform(Registry& reg, Entity e, Entity parentEntity) {
         if (auto transform = reg.get<TransformComp>(e)) {
-            WorldTransform world{};
-            if (parentEntity != INVALID_ENTITY && reg.has<WorldTransform>(parentEntity)) {
-                // get parent's world transform
-                auto parentWorldTransform = reg.get<WorldTransform>(parentEntity);
-                if (parentWorldTransform) {
-                    // build parent's world transformation matrix (rotation + translation)
-                    Matrix parentRot = MatrixFromEulerDegrees(parentWorldTransform->rotation);
-                    Matrix parentMat = MatrixTranslate(parentWorldTransform->position.x, parentWorldTransform->position.y, parentWorldTransform->position.z);
-                    parentMat = MatrixMultiply(parentRot, parentMat); // rotation applied before translation
-
-                    // transform local position by parent's world matrix
-                    Vector3 worldPos = Vector3Transform(transform->position, parentMat);
-
-                    // combine rotations via matrix multiplication
-                    Matrix localRot = MatrixFromEulerDegrees(transform->rotation);
-                    Matrix worldRotMat = MatrixMultiply(parentRot, localRot);
-                    Vector3 worldRot = EulerFromMatrix(worldRotMat);
-
-                    // set world transform
-                    world.position = worldPos;
-                    world.rotation = worldRot;
-                    world.size = transform->size;                     
-                    // world.size = Vector3Multiply(parentWorldTransform->size, transform->size); // TODO: if hierarchical scaling is needed, multiply by parent size
-                } else {
-                    // FALLBACK: use local transform if parent world transform doesn't exist
-                    world.position = transform->position;
-                    world.size = transform->size;
-                    world.rotation = transform->rotation;
-                }
-            } else {
-                // root entity - world transform equals local transform
-                world.position = transform->position;
-                world.size = transform->size;
-                world.rotation = transform->rotation;
-            }
+            const WorldTransform* parentWorld = parentEntity != INVALID_ENTITY ? reg.get<WorldTransform>(parentEntity) : nullptr;
+            WorldTransform world = Compose(parentWorld, *transform);
             // update or add WorldTransform component
-            if (reg.has<WorldTransform>(e)) 
-                *reg.get<WorldTransform>(e) = world;
-            else 
+            if (auto current = reg.get<WorldTransform>(e)) {
+                if (reg.has<Collision>(e) && !SameTransform(*current, world)) changedColliders.push_back(e);
+                *current = world;
+            } else {
                 reg.add<WorldTransform>(e, world);
+                if (reg.has<Collision>(e)) changedColliders.push_back(e);
+            }
+        }
+    }
+};
+
+// (re)bakes rooms whose BakedMesh is dirty
+// must run after TransformSystem (bakes from WorldTransform) and before DrawSystem
+class MeshBakeSystem : public ISystem {
+public:
+    BakeSettings settings;
+
+    void update(Registry& reg, float deltaTime = 0.0f) override {
+        // collect first, re-adding the component while iterating its pool is not safe
+        std::vector<Entity> dirty;
+        for (const auto& entityComp : reg.view<BakedMesh>()) {
+            if (entityComp.second->dirty) dirty.push_back(entityComp.first);
+        }
+        for (Entity room : dirty) {
+            reg.add<BakedMesh>(room, BakeRoomMesh(reg, room, settings));
         }
     }
 };
@@ -140,19 +180,68 @@ private:
 // iterates over entities with:
 //      WorldTransform and either 
 //      ColoredRender or TexturedRender components 
+// rooms with a BakedMesh draw in one call per material, their walls are skipped (StaticBatched)
+// when given a VisibleSet (see CullingSystem) only the entities in it are drawn
 class DrawSystem : public ISystem {
+private:
+    const VisibleSet* visible = nullptr;
+    RaylibBackend defaultBackend;
+    IRenderBackend* backend = &defaultBackend;
+    RenderCommandBuffer commands;
+    const Camera* camera = nullptr; // view point for depth keys
+    const AssetCache* assets = nullptr; // resolves TextureHandles (none = textured walls draw untextured)
+
+    Texture2D resolve(TextureHandle h) const { return assets ? assets->get(h) : Texture2D{}; }
+
+    // turns one entity into draw packets (no API calls here, the backend does those)
+    void emit(Registry& reg, Entity e, const WorldTransform& wt) {
+        if (reg.has<StaticBatched>(e)) 
+            return; // drawn by the parent's baked mesh
+        if (auto baked = reg.get<BakedMesh>(e)) {
+            Vector3 center = BoundsCenter(baked->bounds);
+            for (auto& batch : baked->batches) // baked rooms/hallways
+                if (!batch.indices.empty()) commands.pushBakedBatch(batch, center, resolve(batch.texture));
+        }
+        else if (auto cr = reg.get<ColoredRender>(e)) 
+            commands.pushColoredCube(wt.position, wt.size, cr->color); // colored walls
+        else if (auto tr = reg.get<TexturedRender>(e))
+            if (tr->texture)
+                commands.pushTexturedCube(wt.position, wt.size, resolve(tr->texture), WHITE, tr->uv); // textured walls
+    }
+
 public:
+    DrawSystem() = default;
+    explicit DrawSystem(const VisibleSet* visibleSet, IRenderBackend* renderBackend = nullptr) : visible(visibleSet) {
+        if (renderBackend) backend = renderBackend;
+    }
+
+    // swap where packets go (e.g. a RecordingBackend for headless runs), nullptr = raylib
+    void setBackend(IRenderBackend* renderBackend) { backend = renderBackend ? renderBackend : &defaultBackend; }
+
+    // opaque packets are sorted front-to-back from this camera (texture still wins over depth)
+    void setCamera(const Camera* cam) { camera = cam; }
+
+    // where TexturedRender/BakedMesh texture handles are looked up (must outlive the system)
+    void setAssets(const AssetCache* cache) { assets = cache; }
+
     void update(Registry& reg, float deltaTime = 0.0f) override {       
-        for (const auto& entityComp : reg.view<WorldTransform>()) {
-            Entity e = entityComp.first;
-            const WorldTransform& wt = *entityComp.second;
-            if (auto cr = reg.get<ColoredRender>(e)) 
-                DrawCube(wt.position, wt.size.x, wt.size.y, wt.size.z, cr->color); // colored walls
-            else if (auto tr = reg.get<TexturedRender>(e))
-                if (tr->texture)
-                    DrawCubeTexture(tr->texture->get(), wt.position, wt.size.x, wt.size.y, wt.size.z, WHITE); // textured walls
+        commands.clear();
+        if (camera) commands.setView(camera->position, RL_CULL_DISTANCE_FAR);
+        if (visible && visible->valid) {
+            for (Entity e : visible->entities) {
+                if (auto wt = reg.get<WorldTransform>(e)) 
+                    emit(reg, e, *wt);
+            }
+        } else {
+            for (const auto& entityComp : reg.view<WorldTransform>()) 
+                emit(reg, entityComp.first, *entityComp.second);
         }
+        commands.sort();
+        backend->submit(commands);
     }
+
+    [[nodiscard]] const RenderCommandBuffer& getCommands() const { return commands; }
+    [[nodiscard]] const RenderStats& getStats() const { return backend->getStats(); }
 };
 
 // system manager for organizing systems
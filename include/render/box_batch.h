@@ -0,0 +1,233 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define BOX_BATCH_SSE 1
+#endif
+
+// one axis aligned box to batch: center, full size, texture rect and tint
+// uv is in normalized texture space... v grows downwards like raylib's source rectangles,
+// BoxUvFull() keeps the look of DrawCubeTexture() and BoxUvFromSource() the look of DrawCubeTextureRec()
+struct BoxInstance {
+    Vector3 position{0};
+    Vector3 size{1, 1, 1};
+    Rectangle uv{0, 1, 1, -1};
+    Color color{WHITE};
+};
+
+inline Rectangle BoxUvFull() { return Rectangle{0, 1, 1, -1}; }
+
+inline Rectangle BoxUvFromSource(const Rectangle& source, float texWidth, float texHeight) {
+    return Rectangle{source.x / texWidth, source.y / texHeight, source.width / texWidth, source.height / texHeight};
+}
+
+// interleaved vertex, 36 bytes: the whole box goes up in one buffer instead of 24 rlVertex3f/rlTexCoord2f calls
+struct BoxVertex {
+    float position[3];
+    float normal[3];
+    float texcoord[2];
+    uint8_t color[4];
+};
+static_assert(sizeof(BoxVertex) == 36, "BoxVertex is uploaded as-is");
+
+namespace box_batch {
+    constexpr int VERTICES_PER_BOX = 24;
+    constexpr int INDICES_PER_BOX = 36;
+    // 16-bit indices: a chunk can address 65536 vertices
+    constexpr size_t MAX_BOXES_PER_CHUNK = 65536 / VERTICES_PER_BOX;
+
+    // corner sign (x, y, z), normal and face uv for each vertex, same winding and uvs as DrawCubeTexture()
+    struct Corner {
+        float sx, sy, sz;
+        float nx, ny, nz;
+        float u, v;
+    };
+
+    inline constexpr Corner CORNERS[VERTICES_PER_BOX] = {
+        // front
+        { -1, -1,  1,   0,  0,  1,   0, 0 }, {  1, -1,  1,   0,  0,  1,   1, 0 },
+        {  1,  1,  1,   0,  0,  1,   1, 1 }, { -1,  1,  1,   0,  0,  1,   0, 1 },
+        // back
+        { -1, -1, -1,   0,  0, -1,   1, 0 }, { -1,  1, -1,   0,  0, -1,   1, 1 },
+        {  1,  1, -1,   0,  0, -1,   0, 1 }, {  1, -1, -1,   0,  0, -1,   0, 0 },
+        // top
+        { -1,  1, -1,   0,  1,  0,   0, 1 }, { -1,  1,  1,   0,  1,  0,   0, 0 },
+        {  1,  1,  1,   0,  1,  0,   1, 0 }, {  1,  1, -1,   0,  1,  0,   1, 1 },
+        // bottom
+        { -1, -1, -1,   0, -1,  0,   1, 1 }, {  1, -1, -1,   0, -1,  0,   0, 1 },
+        {  1, -1,  1,   0, -1,  0,   0, 0 }, { -1, -1,  1,   0, -1,  0,   1, 0 },
+        // right
+        {  1, -1, -1,   1,  0,  0,   1, 0 }, {  1,  1, -1,   1,  0,  0,   1, 1 },
+        {  1,  1,  1,   1,  0,  0,   0, 1 }, {  1, -1,  1,   1,  0,  0,   0, 0 },
+        // left
+        { -1, -1, -1,  -1,  0,  0,   0, 0 }, { -1, -1,  1,  -1,  0,  0,   1, 0 },
+        { -1,  1,  1,  -1,  0,  0,   1, 1 }, { -1,  1, -1,  -1,  0,  0,   0, 1 },
+    };
+
+#ifdef BOX_BATCH_SSE
+    // per-vertex constants laid out like the two 16-byte halves of a BoxVertex:
+    //   a = center + sign * half + (0, 0, 0, nx)        -> x y z nx
+    //   b = (ny, nz, u, 1 - v) * uvScale + uvOffset     -> ny nz u' v'
+    struct SimdCorner {
+        __m128 sign;
+        __m128 normalX;
+        __m128 rest;
+    };
+
+    inline const SimdCorner* SimdCorners() {
+        static const auto table = [] {
+            struct Table { SimdCorner c[VERTICES_PER_BOX]; } t{};
+            for (int i = 0; i < VERTICES_PER_BOX; ++i) {
+                const Corner& k = CORNERS[i];
+                t.c[i].sign = _mm_setr_ps(k.sx, k.sy, k.sz, 0.0f);
+                t.c[i].normalX = _mm_setr_ps(0.0f, 0.0f, 0.0f, k.nx);
+                t.c[i].rest = _mm_setr_ps(k.ny, k.nz, k.u, 1.0f - k.v);
+            }
+            return t;
+        }();
+        return table.c;
+    }
+#endif
+}
+
+// reference version, also used where SSE2 is not available
+// everything that only depends on the box (half extents, uv rect, packed color) is computed once per box
+inline void GenerateBoxVerticesScalar(std::span<const BoxInstance> boxes, BoxVertex* out) {
+    for (const BoxInstance& box : boxes) {
+        const float hx = box.size.x * 0.5f, hy = box.size.y * 0.5f, hz = box.size.z * 0.5f;
+        const Rectangle& uv = box.uv;
+        for (const box_batch::Corner& k : box_batch::CORNERS) {
+            out->position[0] = box.position.x + k.sx * hx;
+            out->position[1] = box.position.y + k.sy * hy;
+            out->position[2] = box.position.z + k.sz * hz;
+            out->normal[0] = k.nx;
+            out->normal[1] = k.ny;
+            out->normal[2] = k.nz;
+            out->texcoord[0] = uv.x + k.u * uv.width;
+            out->texcoord[1] = uv.y + (1.0f - k.v) * uv.height;
+            out->color[0] = box.color.r;
+            out->color[1] = box.color.g;
+            out->color[2] = box.color.b;
+            out->color[3] = box.color.a;
+            ++out;
+        }
+    }
+}
+
+// writes 24 vertices per box into out (must hold boxes.size() * 24)
+// SSE2: each vertex is two unaligned 16-byte stores plus the packed color
+inline void GenerateBoxVertices(std::span<const BoxInstance> boxes, BoxVertex* out) {
+#ifdef BOX_BATCH_SSE
+    const box_batch::SimdCorner* corners = box_batch::SimdCorners();
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (const BoxInstance& box : boxes) {
+        const __m128 center = _mm_setr_ps(box.position.x, box.position.y, box.position.z, 0.0f);
+        const __m128 extent = _mm_mul_ps(_mm_setr_ps(box.size.x, box.size.y, box.size.z, 0.0f), half);
+        const __m128 uvScale = _mm_setr_ps(1.0f, 1.0f, box.uv.width, box.uv.height);
+        const __m128 uvOffset = _mm_setr_ps(0.0f, 0.0f, box.uv.x, box.uv.y);
+        uint32_t color;
+        std::memcpy(&color, &box.color, sizeof(color));
+
+        for (int i = 0; i < box_batch::VERTICES_PER_BOX; ++i) {
+            const box_batch::SimdCorner& k = corners[i];
+            __m128 a = _mm_add_ps(_mm_add_ps(center, _mm_mul_ps(k.sign, extent)), k.normalX);
+            __m128 b = _mm_add_ps(_mm_mul_ps(k.rest, uvScale), uvOffset);
+            auto* dst = reinterpret_cast<float*>(out + i);
+            _mm_storeu_ps(dst, a);
+            _mm_storeu_ps(dst + 4, b);
+            std::memcpy(dst + 8, &color, sizeof(color));
+        }
+        out += box_batch::VERTICES_PER_BOX;
+    }
+#else
+    GenerateBoxVerticesScalar(boxes, out);
+#endif
+}
+
+// two triangles per face, relative to the first vertex of the chunk
+inline void GenerateBoxIndices(size_t boxCount, std::vector<uint16_t>& indices) {
+    indices.resize(boxCount * box_batch::INDICES_PER_BOX);
+    uint16_t* dst = indices.data();
+    for (size_t box = 0; box < boxCount; ++box) {
+        for (int face = 0; face < 6; ++face) {
+            auto base = static_cast<uint16_t>(box * box_batch::VERTICES_PER_BOX + face * 4);
+            *dst++ = base;
+            *dst++ = base + 1;
+            *dst++ = base + 2;
+            *dst++ = base;
+            *dst++ = base + 2;
+            *dst++ = base + 3;
+        }
+    }
+}
+
+// CPU-side vertex buffer for many boxes plus the GPU buffers it is streamed into
+// build() fills the interleaved vertices (no GL calls, usable headless), draw() uploads them with one
+// buffer update per chunk of MAX_BOXES_PER_CHUNK boxes and issues one draw call per chunk
+class BoxBatch {
+private:
+    struct Chunk {
+        unsigned int vao = 0;
+        unsigned int vbo = 0;
+        unsigned int ebo = 0;
+        size_t capacity = 0; // boxes the buffers were created for
+    };
+
+    std::vector<BoxVertex> vertices;
+    std::vector<uint16_t> indices; // same for every chunk
+    std::vector<Chunk> chunks;
+    size_t boxCount = 0;
+    bool dirty = false;            // built since the last upload
+
+    void Unload();
+
+public:
+    BoxBatch() = default;
+
+    // no copying (vertex buffers are GPU resources)
+    BoxBatch(const BoxBatch&) = delete;
+    BoxBatch& operator=(const BoxBatch&) = delete;
+
+    ~BoxBatch() { Unload(); }
+
+    void clear() {
+        boxCount = 0;
+        dirty = true;
+    }
+
+    // preallocates room for n boxes so build() does not allocate mid-frame
+    void reserve(size_t n) { vertices.reserve(n * box_batch::VERTICES_PER_BOX); }
+
+    // replaces the batch contents
+    void build(std::span<const BoxInstance> boxes) {
+        boxCount = 0;
+        append(boxes);
+    }
+
+    // adds boxes after the ones already built
+    void append(std::span<const BoxInstance> boxes) {
+        size_t first = boxCount * box_batch::VERTICES_PER_BOX;
+        boxCount += boxes.size();
+        dirty = true;
+        if (vertices.size() < boxCount * box_batch::VERTICES_PER_BOX)
+            vertices.resize(boxCount * box_batch::VERTICES_PER_BOX);
+        GenerateBoxVertices(boxes, vertices.data() + first);
+    }
+
+    // uploads (if built since the last draw) and draws every box with one texture (id 0 = untextured)
+    void draw(const Texture2D& texture);
+
+    [[nodiscard]] size_t size() const { return boxCount; }
+    [[nodiscard]] bool empty() const { return boxCount == 0; }
+    [[nodiscard]] size_t chunkCount() const {
+        return (boxCount + box_batch::MAX_BOXES_PER_CHUNK - 1) / box_batch::MAX_BOXES_PER_CHUNK;
+    }
+    [[nodiscard]] const BoxVertex* data() const { return vertices.data(); }
+    [[nodiscard]] size_t vertexCount() const { return boxCount * box_batch::VERTICES_PER_BOX; }
+};
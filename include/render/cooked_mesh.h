@@ -0,0 +1,136 @@
+#pragma once
+#include "raylib.h"
+#include "../core/mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// .cmesh: a mesh cooked offline by tools/mesh_cooker (see mesh_cooker.h), laid out exactly as it goes to the GPU:
+//   header | parts[partCount] | vertices[vertexCount] (interleaved CookedVertex) | indices[indexCount] (uint16)
+// positions are quantized to 16 bits inside the bounding box, normals to 8 bits... the bounds double as the
+// dequantization transform, so no vertex is touched on load
+// indices are 16-bit and relative to their part's first vertex: rlgl only draws 16-bit indices, so the cooker
+// splits anything with more than 65536 vertices into several parts instead of using 32-bit ones
+struct CookedMeshHeader {
+    static constexpr uint32_t MAGIC = 0x48534D43; // "CMSH"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint32_t partCount = 0;
+    uint32_t vertexStride = 0; // sizeof(CookedVertex)
+    uint32_t indexSize = 2;
+    uint32_t reserved = 0;
+    Vector3 boundsMin{};
+    Vector3 boundsMax{};
+};
+static_assert(sizeof(CookedMeshHeader) == 56);
+
+// one draw: a range of indices over a range of vertices (one glTF primitive, or a piece of a big one)
+struct CookedMeshPart {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    int32_t material = -1;
+};
+static_assert(sizeof(CookedMeshPart) == 20);
+
+struct CookedVertex {
+    uint16_t position[4]; // xyz as 0..65535 across the bounds, w unused
+    int8_t normal[4];     // xyz as -127..127, w unused
+    float texcoord[2];
+};
+static_assert(sizeof(CookedVertex) == 20);
+
+// pointers into a loaded .cmesh (a MappedFile, or a buffer in memory), nothing is copied
+struct CookedMeshView {
+    const CookedMeshHeader* header = nullptr;
+    const CookedMeshPart* parts = nullptr;
+    const CookedVertex* vertices = nullptr;
+    const uint16_t* indices = nullptr;
+
+    [[nodiscard]] bool valid() const { return header != nullptr; }
+    [[nodiscard]] BoundingBox bounds() const { return BoundingBox{ header->boundsMin, header->boundsMax }; }
+
+    [[nodiscard]] Vector3 position(uint32_t vertex) const {
+        const uint16_t* q = vertices[vertex].position;
+        const Vector3 lo = header->boundsMin, hi = header->boundsMax;
+        return Vector3{ lo.x + (hi.x - lo.x) * (q[0] / 65535.0f),
+                        lo.y + (hi.y - lo.y) * (q[1] / 65535.0f),
+                        lo.z + (hi.z - lo.z) * (q[2] / 65535.0f) };
+    }
+};
+
+// checks sizes/counts and every index against its part's vertices (never trusts the file) and points the view into
+// `data`, false if it isn't a valid .cmesh
+inline bool ParseCookedMesh(const void* data, size_t size, CookedMeshView& view) {
+    view = CookedMeshView{};
+    if (data == nullptr || size < sizeof(CookedMeshHeader)) return false;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const auto* header = reinterpret_cast<const CookedMeshHeader*>(bytes);
+    if (header->magic != CookedMeshHeader::MAGIC || header->version != CookedMeshHeader::VERSION ||
+        header->vertexStride != sizeof(CookedVertex) || header->indexSize != 2) return false;
+
+    const size_t partsAt = sizeof(CookedMeshHeader);
+    const size_t verticesAt = partsAt + size_t{ header->partCount } * sizeof(CookedMeshPart);
+    const size_t indicesAt = verticesAt + size_t{ header->vertexCount } * sizeof(CookedVertex);
+    if (indicesAt + size_t{ header->indexCount } * sizeof(uint16_t) > size) return false;
+
+    const auto* parts = reinterpret_cast<const CookedMeshPart*>(bytes + partsAt);
+    const auto* indices = reinterpret_cast<const uint16_t*>(bytes + indicesAt);
+    for (uint32_t p = 0; p < header->partCount; ++p) {
+        const CookedMeshPart& part = parts[p];
+        if (part.vertexCount > 65536 || size_t{ part.firstVertex } + part.vertexCount > header->vertexCount ||
+            size_t{ part.firstIndex } + part.indexCount > header->indexCount) return false;
+        // an index past its part's vertices would make the GPU read past the vertex buffer
+        for (uint32_t i = 0; i < part.indexCount; ++i) {
+            if (indices[part.firstIndex + i] >= part.vertexCount) return false;
+        }
+    }
+
+    view.header = header;
+    view.parts = parts;
+    view.vertices = reinterpret_cast<const CookedVertex*>(bytes + verticesAt);
+    view.indices = indices;
+    return true;
+}
+
+// a .cmesh on the GPU (RAII, move only): one vertex and one index buffer uploaded straight from the mapped file,
+// one VAO per part pointing at its slice of them
+class CookedMesh {
+private:
+    struct Part {
+        unsigned int vao = 0;
+        CookedMeshPart range;
+    };
+
+    unsigned int vbo = 0;
+    unsigned int ebo = 0;
+    std::vector<Part> parts;
+    BoundingBox bounds{};
+
+    void Unload();
+
+public:
+    CookedMesh() = default;
+    CookedMesh(const CookedMesh&) = delete;
+    CookedMesh& operator=(const CookedMesh&) = delete;
+    CookedMesh(CookedMesh&& other) noexcept;
+    CookedMesh& operator=(CookedMesh&& other) noexcept;
+    ~CookedMesh() { Unload(); }
+
+    // maps the file, uploads it and unmaps it again... needs the window (GL context)
+    bool load(const std::string& path);
+    bool upload(const CookedMeshView& view);
+
+    // default shader, `transform` places the mesh (its vertices are already in model space)
+    void draw(const Matrix& transform, const Texture2D& texture, Color tint = WHITE) const;
+
+    [[nodiscard]] bool isUploaded() const { return vbo != 0; }
+    [[nodiscard]] const BoundingBox& getBounds() const { return bounds; }
+    [[nodiscard]] size_t partCount() const { return parts.size(); }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "../spatial/bounds.h"
+#include "../spatial/bvh.h"
+#include "frustum.h"
+#include "visible_set.h"
+#include <array>
+#include <type_traits>
+#include <vector>
+
+// true for entities DrawSystem would actually draw
+// (anchors and walls drawn through a parent's BakedMesh are left out)
+inline bool IsDrawable(const Registry& reg, Entity e) {
+    if (reg.has<StaticBatched>(e)) return false;
+    return reg.has<BakedMesh>(e) || reg.has<ColoredRender>(e) || reg.has<TexturedRender>(e);
+}
+
+inline BoundingBox DrawableBounds(const Registry& reg, Entity e, const WorldTransform& wt) {
+    if (auto baked = reg.get<BakedMesh>(e)) {
+        if (!baked->batches.empty()) return baked->bounds;
+    }
+    return BoundsFromTransform(wt);
+}
+
+// decides when a cache built from the registry (culling BVHs, cell graphs, occluders) is out of date:
+//   - an entity gained or lost one of Pools (Registry::revision, so a swap that keeps every count still counts)
+//   - walls were carved, merged or moved in place (applyWallChanges with their WallChanges)
+//   - the TransformSystem given to setTransforms() moved a collider in its last update
+//   - with BakedMesh among Pools: a room still waiting for its bake at the last rebuild got baked (new bounds)
+//   - invalidate()
+template <typename... Pools>
+class RebuildTrigger {
+private:
+    static constexpr bool TracksBakes = (std::is_same_v<Pools, BakedMesh> || ...);
+
+    std::array<uint64_t, sizeof...(Pools)> revisions{};
+    std::vector<Entity> unbaked; // dirty BakedMeshes at the last rebuild
+    const TransformSystem* transforms = nullptr;
+    bool pending = true;
+
+public:
+    void invalidate() { pending = true; }
+    void setTransforms(const TransformSystem* transformSystem) { transforms = transformSystem; }
+    void applyWallChanges(const std::vector<WallChange>& changes) { pending = pending || !changes.empty(); }
+
+    [[nodiscard]] bool needed(const Registry& reg) const {
+        if (pending || revisions != std::array<uint64_t, sizeof...(Pools)>{ reg.revision<Pools>()... }) return true;
+        if (transforms && !transforms->getChangedColliders().empty()) return true;
+        if constexpr (TracksBakes) {
+            for (Entity e : unbaked)
+                if (auto baked = reg.get<BakedMesh>(e); baked && !baked->dirty) return true;
+        }
+        return false;
+    }
+
+    // call after rebuilding from reg
+    void rebuilt(const Registry& reg) {
+        revisions = { reg.revision<Pools>()... };
+        pending = false;
+        if constexpr (TracksBakes) {
+            unbaked.clear();
+            for (const auto& [e, baked] : reg.view<BakedMesh>())
+                if (baked->dirty) unbaked.push_back(e);
+        }
+    }
+};
+
+// what decides which entities are drawable, and where (see IsDrawable / DrawableBounds)
+using DrawableRebuildTrigger = RebuildTrigger<WorldTransform, StaticBatched, BakedMesh, ColoredRender, TexturedRender>;
+
+// frustum culling over a BVH of drawable world AABBs
+// fills a VisibleSet for DrawSystem... the BVH is rebuilt only when the drawables change (see RebuildTrigger)
+class CullingSystem : public ISystem {
+private:
+    const Camera* camera = nullptr;
+    VisibleSet& visible;
+
+    Bvh bvh;
+    std::vector<Entity> drawables; // BVH item index -> entity
+    DrawableRebuildTrigger trigger;
+
+public:
+    float aspect = 16.0f / 9.0f;
+    size_t rebuilds = 0; // BVH builds so far
+
+    CullingSystem(const Camera& cam, VisibleSet& visibleSet) : camera(&cam), visible(visibleSet) {}
+
+    // force a rebuild on the next update (e.g. after moving static geometry without a TransformSystem)
+    void invalidate() { trigger.invalidate(); }
+    // walls that moved, or colliders a TransformSystem moved, rebuild on the next update
+    void applyWallChanges(const std::vector<WallChange>& changes) { trigger.applyWallChanges(changes); }
+    void setTransforms(const TransformSystem* transformSystem) { trigger.setTransforms(transformSystem); }
+
+    void rebuild(const Registry& reg) {
+        drawables.clear();
+        std::vector<BoundingBox> bounds;
+        for (const auto& [e, wt] : reg.view<WorldTransform>()) {
+            if (!IsDrawable(reg, e)) continue;
+            drawables.push_back(e);
+            bounds.push_back(DrawableBounds(reg, e, *wt));
+        }
+        bvh.build(bounds);
+        trigger.rebuilt(reg);
+        rebuilds++;
+    }
+
+    void cull(const Frustum& frustum) {
+        visible.entities.clear();
+        bvh.queryFrustum(frustum, [&](uint32_t item) { visible.entities.push_back(drawables[item]); });
+        visible.candidates = drawables.size();
+        visible.valid = true;
+    }
+
+    void update(Registry& reg, float deltaTime = 0.0f) override {
+        if (trigger.needed(reg)) rebuild(reg);
+        cull(Frustum::FromCamera(*camera, aspect));
+    }
+
+    const Bvh& getBvh() const { return bvh; }
+    size_t drawableCount() const { return drawables.size(); }
+};
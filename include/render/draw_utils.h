@@ -2,10 +2,22 @@
 #include "raylib.h"
 #include "rlgl.h"
 
+struct BakedMesh;
+struct BakedMeshBatch;
+class AssetCache;
+
 
 // cube textured on all faces
 void DrawCubeTexture(const Texture2D& texture, const Vector3& position, float width, float height, float length, Color color);
 
 
 // cube with a texture sub-rectangle applied to all faces
-void DrawCubeTextureRec(const Texture2D& texture, const Rectangle& source, const Vector3& position, float width, float height, float length, Color color);
\ No newline at end of file
+void DrawCubeTextureRec(const Texture2D& texture, const Rectangle& source, const Vector3& position, float width, float height, float length, Color color);
+
+
+// draws one batch of a baked mesh (uploads it on first use) with the texture its handle resolved to
+void DrawBakedBatch(BakedMeshBatch& batch, const Texture2D& texture);
+
+
+// draws every batch of a baked room/hallway mesh, resolving batch textures through `assets`
+void DrawBakedMesh(BakedMesh& mesh, const AssetCache& assets);
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <cmath>
+
+enum class FrustumTest { Outside, Intersect, Inside };
+
+// view frustum as 6 planes (ax + by + cz + d >= 0 is inside), extracted from view * projection
+// matches what BeginMode3D() sets up for the same camera
+struct Frustum {
+    Vector4 planes[6]{}; // left, right, bottom, top, near, far
+
+    static Frustum FromMatrix(Matrix viewProj) {
+        // rows of the (column-major) clip matrix
+        const Vector4 r0{ viewProj.m0, viewProj.m4, viewProj.m8,  viewProj.m12 };
+        const Vector4 r1{ viewProj.m1, viewProj.m5, viewProj.m9,  viewProj.m13 };
+        const Vector4 r2{ viewProj.m2, viewProj.m6, viewProj.m10, viewProj.m14 };
+        const Vector4 r3{ viewProj.m3, viewProj.m7, viewProj.m11, viewProj.m15 };
+
+        auto add = [](Vector4 a, Vector4 b) { return Vector4{ a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w }; };
+        auto sub = [](Vector4 a, Vector4 b) { return Vector4{ a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w }; };
+
+        Frustum f;
+        f.planes[0] = add(r3, r0);
+        f.planes[1] = sub(r3, r0);
+        f.planes[2] = add(r3, r1);
+        f.planes[3] = sub(r3, r1);
+        f.planes[4] = add(r3, r2);
+        f.planes[5] = sub(r3, r2);
+        for (auto& p : f.planes) {
+            float len = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+            if (len > 0.0f) p = Vector4{ p.x / len, p.y / len, p.z / len, p.w / len };
+        }
+        return f;
+    }
+
+    static Matrix ViewProjection(const Camera& camera, float aspect,
+                                 float nearPlane = RL_CULL_DISTANCE_NEAR, float farPlane = RL_CULL_DISTANCE_FAR) {
+        Matrix proj;
+        if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+            double top = camera.fovy / 2.0;
+            double right = top * aspect;
+            proj = MatrixOrtho(-right, right, -top, top, nearPlane, farPlane);
+        } else {
+            proj = MatrixPerspective(camera.fovy * DEG2RAD, aspect, nearPlane, farPlane);
+        }
+        Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+        return MatrixMultiply(view, proj);
+    }
+
+    static Frustum FromCamera(const Camera& camera, float aspect,
+                              float nearPlane = RL_CULL_DISTANCE_NEAR, float farPlane = RL_CULL_DISTANCE_FAR) {
+        return FromMatrix(ViewProjection(camera, aspect, nearPlane, farPlane));
+    }
+
+    // p-vertex/n-vertex test: Inside lets a hierarchy accept a whole subtree without more tests
+    FrustumTest testBox(const BoundingBox& box) const {
+        FrustumTest result = FrustumTest::Inside;
+        for (const auto& p : planes) {
+            // corner furthest along the plane normal
+            float px = p.x >= 0 ? box.max.x : box.min.x;
+            float py = p.y >= 0 ? box.max.y : box.min.y;
+            float pz = p.z >= 0 ? box.max.z : box.min.z;
+            if (p.x * px + p.y * py + p.z * pz + p.w < 0) return FrustumTest::Outside;
+
+            // corner furthest against the normal
+            float nx = p.x >= 0 ? box.min.x : box.max.x;
+            float ny = p.y >= 0 ? box.min.y : box.max.y;
+            float nz = p.z >= 0 ? box.min.z : box.max.z;
+            if (p.x * nx + p.y * ny + p.z * nz + p.w < 0) result = FrustumTest::Intersect;
+        }
+        return result;
+    }
+
+    bool containsPoint(Vector3 v) const {
+        for (const auto& p : planes) {
+            if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0) return false;
+        }
+        return true;
+    }
+};
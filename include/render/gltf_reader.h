@@ -0,0 +1,246 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "../core/json.h"
+#include "../spatial/bounds.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// triangle mesh flattened out of a model file: every primitive of every node in the scene, in world space
+// (node transforms applied), sharing one vertex/index list
+struct MeshData {
+    struct Primitive {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        int material = -1; // glTF material index, -1 = none
+    };
+
+    std::vector<Vector3> positions;
+    std::vector<Vector3> normals;   // empty if the file has none
+    std::vector<Vector2> texcoords; // TEXCOORD_0, empty if the file has none
+    std::vector<uint32_t> indices;
+    std::vector<Primitive> primitives;
+    BoundingBox bounds = BoundsEmpty();
+
+    [[nodiscard]] bool empty() const { return indices.empty(); }
+};
+
+namespace gltf_detail {
+
+constexpr int FLOAT = 5126;
+constexpr int UNSIGNED_INT = 5125;
+constexpr int UNSIGNED_SHORT = 5123;
+constexpr int UNSIGNED_BYTE = 5121;
+constexpr int TRIANGLES = 4;
+
+struct Document {
+    JsonValue json;
+    std::vector<std::vector<uint8_t>> buffers;
+};
+
+inline int ComponentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0;
+}
+
+inline int ComponentSize(int componentType) {
+    switch (componentType) {
+        case FLOAT: case UNSIGNED_INT: return 4;
+        case UNSIGNED_SHORT: return 2;
+        case UNSIGNED_BYTE: return 1;
+        default: return 0;
+    }
+}
+
+// reads accessor `index` as floats (normalized integer types are mapped to 0..1), `components` per element
+inline bool ReadFloats(const Document& doc, int index, int components, std::vector<float>& out) {
+    const JsonValue& accessor = doc.json["accessors"][static_cast<size_t>(index)];
+    const JsonValue& view = doc.json["bufferViews"][static_cast<size_t>(accessor["bufferView"].asInt(-1))];
+    const int buffer = view["buffer"].asInt(-1);
+    const int type = accessor["componentType"].asInt();
+    const int size = ComponentSize(type);
+    if (!accessor.isObject() || !view.isObject() || buffer < 0 || buffer >= static_cast<int>(doc.buffers.size()) ||
+        ComponentCount(accessor["type"].asString()) != components || size == 0) return false;
+    if (type != FLOAT && !(accessor["normalized"].boolean && (type == UNSIGNED_SHORT || type == UNSIGNED_BYTE))) return false;
+
+    const size_t count = static_cast<size_t>(accessor["count"].asNumber());
+    const size_t stride = view.has("byteStride") ? static_cast<size_t>(view["byteStride"].asInt()) : static_cast<size_t>(size * components);
+    const size_t offset = static_cast<size_t>(view["byteOffset"].asInt()) + static_cast<size_t>(accessor["byteOffset"].asInt());
+    const std::vector<uint8_t>& data = doc.buffers[static_cast<size_t>(buffer)];
+    if (count > 0 && offset + (count - 1) * stride + static_cast<size_t>(size * components) > data.size()) return false;
+
+    out.resize(count * components);
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* element = data.data() + offset + i * stride;
+        for (int c = 0; c < components; ++c) {
+            float& v = out[i * components + c];
+            if (type == FLOAT) std::memcpy(&v, element + c * 4, 4);
+            else if (type == UNSIGNED_SHORT) { uint16_t u; std::memcpy(&u, element + c * 2, 2); v = u / 65535.0f; }
+            else v = element[c] / 255.0f;
+        }
+    }
+    return true;
+}
+
+inline bool ReadIndices(const Document& doc, int index, std::vector<uint32_t>& out) {
+    const JsonValue& accessor = doc.json["accessors"][static_cast<size_t>(index)];
+    const JsonValue& view = doc.json["bufferViews"][static_cast<size_t>(accessor["bufferView"].asInt(-1))];
+    const int buffer = view["buffer"].asInt(-1);
+    const int type = accessor["componentType"].asInt();
+    const int size = ComponentSize(type);
+    if (!accessor.isObject() || !view.isObject() || buffer < 0 || buffer >= static_cast<int>(doc.buffers.size()) ||
+        size == 0 || type == FLOAT) return false;
+
+    const size_t count = static_cast<size_t>(accessor["count"].asNumber());
+    const size_t offset = static_cast<size_t>(view["byteOffset"].asInt()) + static_cast<size_t>(accessor["byteOffset"].asInt());
+    const std::vector<uint8_t>& data = doc.buffers[static_cast<size_t>(buffer)];
+    if (offset + count * size > data.size()) return false;
+
+    out.resize(count);
+    const uint8_t* src = data.data() + offset;
+    for (size_t i = 0; i < count; ++i) {
+        if (size == 4) std::memcpy(&out[i], src + i * 4, 4);
+        else if (size == 2) { uint16_t u; std::memcpy(&u, src + i * 2, 2); out[i] = u; }
+        else out[i] = src[i];
+    }
+    return true;
+}
+
+inline Matrix NodeMatrix(const JsonValue& node) {
+    const JsonValue& m = node["matrix"];
+    if (m.isArray() && m.size() == 16) {
+        // glTF is column-major with the translation in 12..14, same memory order as raylib's m0..m15
+        float f[16];
+        for (size_t i = 0; i < 16; ++i) f[i] = static_cast<float>(m[i].asNumber());
+        Matrix r;
+        r.m0 = f[0]; r.m1 = f[1]; r.m2 = f[2]; r.m3 = f[3];
+        r.m4 = f[4]; r.m5 = f[5]; r.m6 = f[6]; r.m7 = f[7];
+        r.m8 = f[8]; r.m9 = f[9]; r.m10 = f[10]; r.m11 = f[11];
+        r.m12 = f[12]; r.m13 = f[13]; r.m14 = f[14]; r.m15 = f[15];
+        return r;
+    }
+    const JsonValue& t = node["translation"];
+    const JsonValue& q = node["rotation"];
+    const JsonValue& s = node["scale"];
+    Matrix scale = MatrixScale(static_cast<float>(s[0].asNumber(1)), static_cast<float>(s[1].asNumber(1)), static_cast<float>(s[2].asNumber(1)));
+    Quaternion rotation{ static_cast<float>(q[0].asNumber(0)), static_cast<float>(q[1].asNumber(0)),
+                         static_cast<float>(q[2].asNumber(0)), static_cast<float>(q[3].asNumber(1)) };
+    Matrix translate = MatrixTranslate(static_cast<float>(t[0].asNumber()), static_cast<float>(t[1].asNumber()), static_cast<float>(t[2].asNumber()));
+    return MatrixMultiply(MatrixMultiply(scale, QuaternionToMatrix(rotation)), translate); // T * R * S
+}
+
+inline bool AppendPrimitive(const Document& doc, const JsonValue& primitive, const Matrix& world, MeshData& out) {
+    if (primitive["mode"].asInt(TRIANGLES) != TRIANGLES) return true; // lines/points: nothing to draw as walls
+    const JsonValue& attributes = primitive["attributes"];
+    if (!attributes.has("POSITION")) return false;
+
+    std::vector<float> positions, normals, texcoords;
+    if (!ReadFloats(doc, attributes["POSITION"].asInt(), 3, positions)) return false;
+    const size_t count = positions.size() / 3;
+    if (attributes.has("NORMAL") && !ReadFloats(doc, attributes["NORMAL"].asInt(), 3, normals)) return false;
+    if (attributes.has("TEXCOORD_0") && !ReadFloats(doc, attributes["TEXCOORD_0"].asInt(), 2, texcoords)) return false;
+
+    std::vector<uint32_t> indices;
+    if (primitive.has("indices")) {
+        if (!ReadIndices(doc, primitive["indices"].asInt(), indices)) return false;
+    } else {
+        indices.resize(count);
+        for (size_t i = 0; i < count; ++i) indices[i] = static_cast<uint32_t>(i);
+    }
+    for (uint32_t i : indices)
+        if (i >= count) return false;
+
+    // mixing primitives with and without an attribute: pad the missing ones so the arrays stay parallel
+    const size_t base = out.positions.size();
+    if (!normals.empty() && out.normals.size() < base) out.normals.resize(base, Vector3{ 0, 1, 0 });
+    if (!texcoords.empty() && out.texcoords.size() < base) out.texcoords.resize(base, Vector2{});
+
+    const Matrix normalMatrix = MatrixTranspose(MatrixInvert(world));
+    for (size_t i = 0; i < count; ++i) {
+        Vector3 p = Vector3Transform(Vector3{ positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2] }, world);
+        out.positions.push_back(p);
+        out.bounds = BoundsUnion(out.bounds, BoundingBox{ p, p });
+        if (!normals.empty()) {
+            Vector3 n{ normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2] };
+            // direction only: no translation
+            out.normals.push_back(Vector3Normalize(Vector3{
+                normalMatrix.m0 * n.x + normalMatrix.m4 * n.y + normalMatrix.m8 * n.z,
+                normalMatrix.m1 * n.x + normalMatrix.m5 * n.y + normalMatrix.m9 * n.z,
+                normalMatrix.m2 * n.x + normalMatrix.m6 * n.y + normalMatrix.m10 * n.z }));
+        } else if (!out.normals.empty()) {
+            out.normals.push_back(Vector3{ 0, 1, 0 });
+        }
+        if (!texcoords.empty()) out.texcoords.push_back(Vector2{ texcoords[i * 2], texcoords[i * 2 + 1] });
+        else if (!out.texcoords.empty()) out.texcoords.push_back(Vector2{});
+    }
+
+    MeshData::Primitive prim;
+    prim.firstIndex = static_cast<uint32_t>(out.indices.size());
+    prim.indexCount = static_cast<uint32_t>(indices.size());
+    prim.material = primitive["material"].asInt(-1);
+    for (uint32_t i : indices) out.indices.push_back(static_cast<uint32_t>(base) + i);
+    out.primitives.push_back(prim);
+    return true;
+}
+
+inline bool AppendNode(const Document& doc, int nodeIndex, const Matrix& parent, MeshData& out, int depth = 0) {
+    const JsonValue& node = doc.json["nodes"][static_cast<size_t>(nodeIndex)];
+    if (!node.isObject() || depth > 64) return false;
+    const Matrix world = MatrixMultiply(NodeMatrix(node), parent);
+
+    if (node.has("mesh")) {
+        const JsonValue& mesh = doc.json["meshes"][static_cast<size_t>(node["mesh"].asInt())];
+        for (const JsonValue& primitive : mesh["primitives"].items)
+            if (!AppendPrimitive(doc, primitive, world, out)) return false;
+    }
+    for (const JsonValue& child : node["children"].items)
+        if (!AppendNode(doc, child.asInt(), world, out, depth + 1)) return false;
+    return true;
+}
+
+} // namespace gltf_detail
+
+// loads a .gltf with external .bin buffers (no .glb, no embedded data: uris, no skinning/morphs)
+// returns an empty MeshData if anything is missing or malformed
+inline MeshData LoadGltfMesh(const std::string& path) {
+    using namespace gltf_detail;
+    MeshData mesh;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return mesh;
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    bool ok = false;
+    Document doc;
+    doc.json = ParseJson(text, &ok);
+    if (!ok) return mesh;
+
+    const std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    for (const JsonValue& buffer : doc.json["buffers"].items) {
+        const std::string& uri = buffer["uri"].asString();
+        if (uri.empty() || uri.rfind("data:", 0) == 0) return mesh;
+        std::ifstream bin(dir / uri, std::ios::binary);
+        if (!bin) return mesh;
+        doc.buffers.emplace_back((std::istreambuf_iterator<char>(bin)), std::istreambuf_iterator<char>());
+    }
+
+    const JsonValue& scene = doc.json["scenes"][static_cast<size_t>(doc.json["scene"].asInt(0))];
+    bool loaded = true;
+    if (scene.isObject()) {
+        for (const JsonValue& root : scene["nodes"].items) loaded = loaded && AppendNode(doc, root.asInt(), MatrixIdentity(), mesh);
+    } else {
+        // no scene: every mesh as is
+        for (size_t m = 0; m < doc.json["meshes"].size(); ++m)
+            for (const JsonValue& primitive : doc.json["meshes"][m]["primitives"].items)
+                loaded = loaded && AppendPrimitive(doc, primitive, MatrixIdentity(), mesh);
+    }
+    return loaded ? mesh : MeshData{};
+}
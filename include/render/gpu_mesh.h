@@ -0,0 +1,68 @@
+#pragma once
+#include "raylib.h"
+#include <vector>
+
+// RAII wrapper for a mesh uploaded from CPU-side vectors (no accidental copying)
+// note: the vectors are owned by the caller and must outlive the upload...
+//       raylib's DrawMesh() still checks mesh.indices to pick the indexed path, so we keep pointing at them
+class GpuMesh {
+private:
+    Mesh mesh{};
+
+public:
+    GpuMesh() = default;
+
+    // no copying (vertex buffers are GPU resources)
+    GpuMesh(const GpuMesh&) = delete;
+    GpuMesh& operator=(const GpuMesh&) = delete;
+
+    // move semantics
+    GpuMesh(GpuMesh&& other) noexcept : mesh(other.mesh) {
+        other.mesh = Mesh{};
+    }
+
+    GpuMesh& operator=(GpuMesh&& other) noexcept {
+        if (this != &other) {
+            Unload();
+            mesh = other.mesh;
+            other.mesh = Mesh{};
+        }
+        return *this;
+    }
+
+    ~GpuMesh() {
+        Unload();
+    }
+
+    // uploads positions (xyz), texcoords (uv), normals (xyz) and 16-bit triangle indices
+    void upload(std::vector<float>& vertices, std::vector<float>& texcoords,
+                std::vector<float>& normals, std::vector<unsigned short>& indices) {
+        Unload();
+        mesh.vertexCount = static_cast<int>(vertices.size() / 3);
+        mesh.triangleCount = static_cast<int>(indices.size() / 3);
+        mesh.vertices = vertices.data();
+        mesh.texcoords = texcoords.data();
+        mesh.normals = normals.data();
+        mesh.indices = indices.data();
+        UploadMesh(&mesh, false);
+    }
+
+    [[nodiscard]] bool isUploaded() const { return mesh.vaoId != 0; }
+
+    // access underlying raylib mesh
+    [[nodiscard]] const Mesh& get() const { return mesh; }
+
+private:
+    void Unload() {
+        if (mesh.vaoId != 0) {
+            // UnloadMesh() frees the CPU arrays too... those belong to the caller's vectors
+            Mesh gpuOnly = mesh;
+            gpuOnly.vertices = nullptr;
+            gpuOnly.texcoords = nullptr;
+            gpuOnly.normals = nullptr;
+            gpuOnly.indices = nullptr;
+            UnloadMesh(gpuOnly);
+        }
+        mesh = Mesh{};
+    }
+};
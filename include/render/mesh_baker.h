@@ -0,0 +1,234 @@
+#pragma once
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include <cmath>
+#include <memory>
+#include <vector>
+
+struct BakeSettings {
+    float uvTileSize = 10.0f; // world units per texture repeat
+    float epsilon = 0.001f;   // tolerance for "touching" faces
+};
+
+// a world-space box going into a bake
+struct BakeBox {
+    Vector3 min{0};
+    Vector3 max{0};
+    TextureHandle texture; // empty for flat-colored walls
+    Color color{WHITE};
+    Rectangle uv{0, 1, 1, -1}; // see TexturedRender::uv
+    bool tiled = true;         // repeat the texture every uvTileSize units through uv wrap (atlas tiles: false, see EmitFace)
+};
+
+namespace bake_detail {
+    // raylib's DrawMesh() uses 16-bit indices, so a batch is split before it overflows
+    constexpr size_t MAX_BATCH_VERTICES = 65535;
+
+    inline float Axis(const Vector3& v, int a) { return a == 0 ? v.x : (a == 1 ? v.y : v.z); }
+
+    inline void SetAxis(Vector3& v, int a, float value) {
+        if (a == 0) v.x = value;
+        else if (a == 1) v.y = value;
+        else v.z = value;
+    }
+
+    // true if `other` closes off the face of `box` that points along axis a (sign s)
+    // i.e. other spans the whole face rectangle, touches/straddles the face plane, and continues past it
+    inline bool FaceCoveredBy(const BakeBox& box, int a, int s, const BakeBox& other, float eps) {
+        for (int k = 1; k <= 2; ++k) {
+            int u = (a + k) % 3;
+            if (Axis(other.min, u) > Axis(box.min, u) + eps) return false;
+            if (Axis(other.max, u) < Axis(box.max, u) - eps) return false;
+        }
+        float plane = s > 0 ? Axis(box.max, a) : Axis(box.min, a);
+        if (plane < Axis(other.min, a) - eps || plane > Axis(other.max, a) + eps) return false;
+        return s > 0 ? Axis(other.max, a) > plane + eps : Axis(other.min, a) < plane - eps;
+    }
+
+    inline BakedMeshBatch& BatchFor(BakedMesh& mesh, const BakeBox& box) {
+        for (auto it = mesh.batches.rbegin(); it != mesh.batches.rend(); ++it) {
+            bool sameMaterial = it->texture == box.texture &&
+                it->color.r == box.color.r && it->color.g == box.color.g &&
+                it->color.b == box.color.b && it->color.a == box.color.a;
+            if (sameMaterial && it->vertices.size() / 3 + 4 <= MAX_BATCH_VERTICES) return *it;
+        }
+        BakedMeshBatch batch;
+        batch.texture = box.texture;
+        batch.color = box.color;
+        mesh.batches.push_back(std::move(batch));
+        return mesh.batches.back();
+    }
+
+    // appends one quad (two triangles, CCW seen from outside) covering [u0, u1] x [v0, v1] of box's face along axis a
+    // (sign s), with world-space tiled uvs... or, for atlas tiles, the part of the tile the quad covers: the tile
+    // repeats every tileSize like a plain texture would, tileOrigin is where the repeat under this quad starts
+    inline void EmitQuad(BakedMeshBatch& batch, const BakeBox& box, int a, int s, float u0, float u1, float v0, float v1,
+                         float tileSize, Vector2 tileOrigin) {
+        // in-plane axes picked so that cross(U, V) points along +a
+        int u = (a + 1) % 3;
+        int v = (a + 2) % 3;
+
+        Vector3 corners[4];
+        const float us[4] = { u0, u1, u1, u0 };
+        const float vs[4] = { v0, v0, v1, v1 };
+        float plane = s > 0 ? Axis(box.max, a) : Axis(box.min, a);
+        for (int i = 0; i < 4; ++i) {
+            SetAxis(corners[i], a, plane);
+            SetAxis(corners[i], u, us[i]);
+            SetAxis(corners[i], v, vs[i]);
+        }
+
+        Vector3 normal{0, 0, 0};
+        SetAxis(normal, a, static_cast<float>(s));
+
+        auto base = static_cast<unsigned short>(batch.vertices.size() / 3);
+        float invTile = 1.0f / tileSize;
+        for (int i = 0; i < 4; ++i) {
+            // flip the winding for faces pointing down their axis
+            const Vector3& c = corners[s > 0 ? i : 3 - i];
+            batch.vertices.insert(batch.vertices.end(), { c.x, c.y, c.z });
+            batch.normals.insert(batch.normals.end(), { normal.x, normal.y, normal.z });
+
+            if (!box.tiled) {
+                // the box's uv rect over one repeat, oriented like the tiled case
+                float fu = (a == 0 ? c.z - tileOrigin.x : c.x - tileOrigin.x) * invTile; // 0..1 across the repeat
+                float fv = (a == 1 ? c.z - tileOrigin.y : c.y - tileOrigin.y) * invTile; // fv = 0 at the bottom of walls
+                batch.texcoords.insert(batch.texcoords.end(), { box.uv.x + fu * box.uv.width, box.uv.y + (1.0f - fv) * box.uv.height });
+            }
+            // walls keep "up" along -v so the texture stays upright, floors/ceilings map x/z
+            else if (a == 1) batch.texcoords.insert(batch.texcoords.end(), { c.x * invTile, c.z * invTile });
+            else if (a == 0) batch.texcoords.insert(batch.texcoords.end(), { c.z * invTile, -c.y * invTile });
+            else batch.texcoords.insert(batch.texcoords.end(), { c.x * invTile, -c.y * invTile });
+        }
+        batch.indices.insert(batch.indices.end(), {
+            base, static_cast<unsigned short>(base + 1), static_cast<unsigned short>(base + 2),
+            base, static_cast<unsigned short>(base + 2), static_cast<unsigned short>(base + 3)
+        });
+    }
+
+    // the next tiling grid line after x (at least a sliver further, so rounding can't stall or leave hairline quads)
+    inline float NextGridLine(float x, float tileSize) {
+        float next = (floorf(x / tileSize) + 1.0f) * tileSize;
+        return next - x < tileSize * 1e-4f ? next + tileSize : next;
+    }
+
+    // one face of box: a single quad with tiled uvs, or for atlas tiles (which can't wrap, raylib has no texture
+    // arrays or per-tile wrap) one quad per tileSize cell of the world-space grid, each mapping its part of the tile
+    // note: the grid is the tiled case's, so atlas and standalone textures line up the same way across walls
+    inline void EmitFace(BakedMesh& mesh, const BakeBox& box, int a, int s, float tileSize) {
+        int u = (a + 1) % 3;
+        int v = (a + 2) % 3;
+        if (box.tiled) {
+            EmitQuad(BatchFor(mesh, box), box, a, s, Axis(box.min, u), Axis(box.max, u), Axis(box.min, v), Axis(box.max, v), tileSize, {});
+            return;
+        }
+        const int texU = a == 0 ? 2 : 0; // world axes the uv rect's u/v run along
+        const int texV = a == 1 ? 2 : 1;
+        for (float u0 = Axis(box.min, u); u0 < Axis(box.max, u); ) {
+            float u1 = fminf(NextGridLine(u0, tileSize), Axis(box.max, u));
+            for (float v0 = Axis(box.min, v); v0 < Axis(box.max, v); ) {
+                float v1 = fminf(NextGridLine(v0, tileSize), Axis(box.max, v));
+                Vector3 mid{};
+                SetAxis(mid, u, (u0 + u1) / 2);
+                SetAxis(mid, v, (v0 + v1) / 2);
+                Vector2 origin{ floorf(Axis(mid, texU) / tileSize) * tileSize, floorf(Axis(mid, texV) / tileSize) * tileSize };
+                EmitQuad(BatchFor(mesh, box), box, a, s, u0, u1, v0, v1, tileSize, origin);
+                v0 = v1;
+            }
+            u0 = u1;
+        }
+    }
+}
+
+// merges boxes into one vertex/index buffer per material, dropping faces hidden by contact or overlap
+// note: O(boxes^2) face tests, which is fine for the handful of walls under one room
+inline BakedMesh BakeBoxes(const std::vector<BakeBox>& boxes, const BakeSettings& settings = {}) {
+    BakedMesh mesh;
+    mesh.dirty = false;
+    if (boxes.empty()) return mesh;
+
+    mesh.bounds = { boxes.front().min, boxes.front().max };
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const BakeBox& box = boxes[i];
+        mesh.bounds.min = Vector3{ fminf(mesh.bounds.min.x, box.min.x), fminf(mesh.bounds.min.y, box.min.y), fminf(mesh.bounds.min.z, box.min.z) };
+        mesh.bounds.max = Vector3{ fmaxf(mesh.bounds.max.x, box.max.x), fmaxf(mesh.bounds.max.y, box.max.y), fmaxf(mesh.bounds.max.z, box.max.z) };
+
+        for (int a = 0; a < 3; ++a) {
+            for (int s = -1; s <= 1; s += 2) {
+                bool hidden = false;
+                for (size_t j = 0; j < boxes.size() && !hidden; ++j) {
+                    if (j != i) hidden = bake_detail::FaceCoveredBy(box, a, s, boxes[j], settings.epsilon);
+                }
+                if (hidden) {
+                    mesh.culledFaces++;
+                    continue;
+                }
+                bake_detail::EmitFace(mesh, box, a, s, settings.uvTileSize);
+                mesh.faceCount++;
+            }
+        }
+    }
+    return mesh;
+}
+
+// collects the renderable child boxes of a room/hallway in world space
+// note: rotation is ignored (same as DrawSystem)
+inline std::vector<BakeBox> GatherRoomBoxes(const Registry& reg, Entity room) {
+    std::vector<BakeBox> boxes;
+    auto children = reg.get<Children>(room);
+    if (!children) return boxes;
+
+    Vector3 roomPos{0, 0, 0};
+    if (auto rw = reg.get<WorldTransform>(room)) roomPos = rw->position;
+
+    for (Entity child : children->entities) {
+        auto local = reg.get<TransformComp>(child);
+        if (!local) continue;
+
+        BakeBox box;
+        if (auto tr = reg.get<TexturedRender>(child)) {
+            if (!tr->texture) continue;
+            box.texture = tr->texture;
+            box.uv = tr->uv;
+            box.tiled = !tr->isSubRegion();
+        } else if (auto cr = reg.get<ColoredRender>(child)) {
+            box.color = cr->color;
+        } else {
+            continue; // anchors and other non-rendered children
+        }
+
+        // freshly carved segments may not have a WorldTransform until the next TransformSystem pass
+        Vector3 center, size;
+        if (auto wt = reg.get<WorldTransform>(child)) {
+            center = wt->position;
+            size = wt->size;
+        } else {
+            center = Vector3{ roomPos.x + local->position.x, roomPos.y + local->position.y, roomPos.z + local->position.z };
+            size = local->size;
+        }
+        Vector3 half{ fabsf(size.x) / 2, fabsf(size.y) / 2, fabsf(size.z) / 2 };
+        if (half.x <= 0.0f || half.y <= 0.0f || half.z <= 0.0f) continue;
+
+        box.min = Vector3{ center.x - half.x, center.y - half.y, center.z - half.z };
+        box.max = Vector3{ center.x + half.x, center.y + half.y, center.z + half.z };
+        boxes.push_back(std::move(box));
+    }
+    return boxes;
+}
+
+// bakes a room's walls and marks them StaticBatched so they stop drawing one cube at a time
+inline BakedMesh BakeRoomMesh(Registry& reg, Entity room, const BakeSettings& settings = {}) {
+    BakedMesh mesh = BakeBoxes(GatherRoomBoxes(reg, room), settings);
+    if (auto children = reg.get<Children>(room)) {
+        for (Entity child : children->entities) {
+            if (reg.has<TexturedRender>(child) || reg.has<ColoredRender>(child))
+                reg.add<StaticBatched>(child, StaticBatched{});
+        }
+    }
+    return mesh;
+}
+
+// opt a room/hallway into baking... MeshBakeSystem picks it up on its next update
+inline void EnableMeshBaking(Registry& reg, Entity room) {
+    if (!reg.has<BakedMesh>(room)) reg.add<BakedMesh>(room, BakedMesh{});
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "raylib.h"
+#include "cooked_mesh.h"
+#include "gltf_reader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// offline mesh cooking (tools/mesh_cooker): MeshData -> quantized interleaved .cmesh (layout in cooked_mesh.h)
+namespace mesh_cooker {
+
+inline uint16_t QuantizeUnorm16(float v, float lo, float extent) {
+    if (extent <= 0.0f) return 0;
+    return static_cast<uint16_t>(std::clamp(std::lround((v - lo) / extent * 65535.0f), 0L, 65535L));
+}
+
+inline int8_t QuantizeSnorm8(float v) {
+    return static_cast<int8_t>(std::clamp(std::lround(v * 127.0f), -127L, 127L));
+}
+
+} // namespace mesh_cooker
+
+// the whole .cmesh in memory, SaveCookedMesh() writes it as is and ParseCookedMesh() reads it back
+struct CookedMeshFile {
+    std::vector<uint8_t> bytes;
+
+    [[nodiscard]] CookedMeshView view() const {
+        CookedMeshView v;
+        ParseCookedMesh(bytes.data(), bytes.size(), v);
+        return v;
+    }
+};
+
+// one part per primitive... a primitive using more than 65536 vertices is cut into several parts (triangles in
+// order, shared vertices duplicated at the cuts) so every index fits in 16 bits
+inline CookedMeshFile CookMesh(const MeshData& mesh) {
+    using namespace mesh_cooker;
+    constexpr uint32_t MAX_PART_VERTICES = 65536;
+
+    std::vector<CookedMeshPart> parts;
+    std::vector<uint32_t> remap;   // cooked vertex -> source vertex
+    std::vector<uint16_t> indices;
+
+    for (const MeshData::Primitive& prim : mesh.primitives) {
+        std::unordered_map<uint32_t, uint16_t> local; // source vertex -> index within the current part
+        CookedMeshPart part;
+        part.firstIndex = static_cast<uint32_t>(indices.size());
+        part.firstVertex = static_cast<uint32_t>(remap.size());
+        part.material = prim.material;
+
+        auto closePart = [&] {
+            part.indexCount = static_cast<uint32_t>(indices.size()) - part.firstIndex;
+            part.vertexCount = static_cast<uint32_t>(remap.size()) - part.firstVertex;
+            if (part.indexCount > 0) parts.push_back(part);
+            part.firstIndex = static_cast<uint32_t>(indices.size());
+            part.firstVertex = static_cast<uint32_t>(remap.size());
+            local.clear();
+        };
+
+        for (uint32_t t = 0; t + 2 < prim.indexCount; t += 3) {
+            const uint32_t* tri = &mesh.indices[prim.firstIndex + t];
+            int fresh = 0;
+            for (int k = 0; k < 3; ++k) fresh += local.count(tri[k]) ? 0 : 1;
+            if (local.size() + fresh > MAX_PART_VERTICES) closePart();
+
+            for (int k = 0; k < 3; ++k) {
+                auto [it, added] = local.try_emplace(tri[k], static_cast<uint16_t>(local.size()));
+                if (added) remap.push_back(tri[k]);
+                indices.push_back(it->second);
+            }
+        }
+        closePart();
+    }
+
+    CookedMeshHeader header;
+    header.vertexCount = static_cast<uint32_t>(remap.size());
+    header.indexCount = static_cast<uint32_t>(indices.size());
+    header.partCount = static_cast<uint32_t>(parts.size());
+    header.vertexStride = sizeof(CookedVertex);
+    header.boundsMin = mesh.empty() ? Vector3{} : mesh.bounds.min;
+    header.boundsMax = mesh.empty() ? Vector3{} : mesh.bounds.max;
+
+    const Vector3 lo = header.boundsMin;
+    const Vector3 extent = Vector3Subtract(header.boundsMax, header.boundsMin);
+    std::vector<CookedVertex> vertices(remap.size());
+    for (size_t i = 0; i < remap.size(); ++i) {
+        const uint32_t src = remap[i];
+        CookedVertex& v = vertices[i];
+        const Vector3 p = mesh.positions[src];
+        v.position[0] = QuantizeUnorm16(p.x, lo.x, extent.x);
+        v.position[1] = QuantizeUnorm16(p.y, lo.y, extent.y);
+        v.position[2] = QuantizeUnorm16(p.z, lo.z, extent.z);
+        v.position[3] = 0;
+        const Vector3 n = src < mesh.normals.size() ? mesh.normals[src] : Vector3{ 0, 1, 0 };
+        v.normal[0] = QuantizeSnorm8(n.x);
+        v.normal[1] = QuantizeSnorm8(n.y);
+        v.normal[2] = QuantizeSnorm8(n.z);
+        v.normal[3] = 0;
+        const Vector2 uv = src < mesh.texcoords.size() ? mesh.texcoords[src] : Vector2{};
+        v.texcoord[0] = uv.x;
+        v.texcoord[1] = uv.y;
+    }
+
+    CookedMeshFile file;
+    file.bytes.resize(sizeof(header) + parts.size() * sizeof(CookedMeshPart) + vertices.size() * sizeof(CookedVertex) +
+                      indices.size() * sizeof(uint16_t));
+    uint8_t* out = file.bytes.data();
+    auto put = [&](const void* src, size_t n) {
+        if (n) std::memcpy(out, src, n);
+        out += n;
+    };
+    put(&header, sizeof(header));
+    put(parts.data(), parts.size() * sizeof(CookedMeshPart));
+    put(vertices.data(), vertices.size() * sizeof(CookedVertex));
+    put(indices.data(), indices.size() * sizeof(uint16_t));
+    return file;
+}
+
+inline bool SaveCookedMesh(const CookedMeshFile& file, const char* path) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(file.bytes.data(), 1, file.bytes.size(), f) == file.bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
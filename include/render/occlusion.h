@@ -0,0 +1,381 @@
+#pragma once
+#include "../core/thread_pool.h"
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "../spatial/bounds.h"
+#include "../spatial/bvh.h"
+#include "culling.h"
+#include "frustum.h"
+#include "visible_set.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCCLUSION_SSE 1
+#endif
+
+struct OcclusionSettings {
+    int width = 256;             // depth buffer size in pixels (rounded up to whole tiles)
+    int height = 128;
+    size_t maxOccluders = 48;    // nearest/largest walls rasterized per frame
+    float minOccluderSize = 1.0f; // walls smaller than this (second largest side) never occlude
+    unsigned threads = 0;        // 0 = one per core
+};
+
+// low-res CPU depth buffer holding 1/w of the nearest occluder per pixel (0 = nothing drawn)
+// 1/w is affine in screen space, so triangles interpolate it directly and "bigger = closer"
+// rows are split into bands of TILE rows that rasterize independently (one band per job)
+class OcclusionBuffer {
+public:
+    static constexpr int TILE = 8;
+    static constexpr float NEAR_W = 0.05f; // occluders are clipped here, boxes crossing it are always visible
+
+private:
+    struct ScreenVertex { float x, y, z; };
+    struct ClipVertex { float x, y, w; };
+
+    int width = 0;
+    int height = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+    std::vector<float> depth;
+    std::vector<float> tileMin; // farthest occluder (smallest 1/w) per tile, for whole-tile accepts
+    std::vector<ScreenVertex> triangles; // 3 per triangle
+    Matrix viewProj{};
+
+    ClipVertex toClip(float x, float y, float z) const {
+        const Matrix& m = viewProj;
+        return ClipVertex{
+            m.m0 * x + m.m4 * y + m.m8 * z + m.m12,
+            m.m1 * x + m.m5 * y + m.m9 * z + m.m13,
+            m.m3 * x + m.m7 * y + m.m11 * z + m.m15
+        };
+    }
+
+    ScreenVertex toScreen(const ClipVertex& c) const {
+        float invW = 1.0f / c.w;
+        return ScreenVertex{ (c.x * invW * 0.5f + 0.5f) * width, (0.5f - c.y * invW * 0.5f) * height, invW };
+    }
+
+    // clips a quad against w >= NEAR_W and fans the result into triangles
+    void addQuad(const ClipVertex (&quad)[4]) {
+        ClipVertex poly[5];
+        int n = 0;
+        for (int i = 0; i < 4; ++i) {
+            const ClipVertex& a = quad[i];
+            const ClipVertex& b = quad[(i + 1) % 4];
+            bool aIn = a.w >= NEAR_W, bIn = b.w >= NEAR_W;
+            if (aIn) poly[n++] = a;
+            if (aIn != bIn) {
+                float t = (NEAR_W - a.w) / (b.w - a.w);
+                poly[n++] = ClipVertex{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, NEAR_W };
+            }
+        }
+        if (n < 3) return;
+        ScreenVertex first = toScreen(poly[0]);
+        for (int i = 1; i + 1 < n; ++i) {
+            triangles.push_back(first);
+            triangles.push_back(toScreen(poly[i]));
+            triangles.push_back(toScreen(poly[i + 1]));
+        }
+    }
+
+    void rasterizeTriangle(ScreenVertex v0, ScreenVertex v1, ScreenVertex v2, int bandY0, int bandY1) {
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+        if (fabsf(area) < 1e-6f) return;
+        if (area < 0) {
+            std::swap(v1, v2);
+            area = -area;
+        }
+
+        int minY = std::max(bandY0, static_cast<int>(floorf(std::min({ v0.y, v1.y, v2.y }))));
+        int maxY = std::min(bandY1 - 1, static_cast<int>(ceilf(std::max({ v0.y, v1.y, v2.y }))));
+        int minX = std::max(0, static_cast<int>(floorf(std::min({ v0.x, v1.x, v2.x }))));
+        int maxX = std::min(width - 1, static_cast<int>(ceilf(std::max({ v0.x, v1.x, v2.x }))));
+        if (minX > maxX || minY > maxY) return;
+        minX &= ~3; // 4-wide rows start aligned (width is a multiple of 4)
+
+        // edge functions, positive inside: E(p) = (b - a) x (p - a)
+        const ScreenVertex* a[3] = { &v0, &v1, &v2 };
+        const ScreenVertex* b[3] = { &v1, &v2, &v0 };
+        float stepX[3], stepY[3], origin[3];
+        float px = minX + 0.5f, py = minY + 0.5f;
+        for (int i = 0; i < 3; ++i) {
+            stepX[i] = a[i]->y - b[i]->y;
+            stepY[i] = b[i]->x - a[i]->x;
+            origin[i] = (b[i]->x - a[i]->x) * (py - a[i]->y) - (b[i]->y - a[i]->y) * (px - a[i]->x);
+        }
+        float zdx = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+        float zdy = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+        float zOrigin = v0.z + zdx * (px - v0.x) + zdy * (py - v0.y);
+
+#ifdef OCCLUSION_SSE
+        const __m128 lanes = _mm_setr_ps(0, 1, 2, 3);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 eStep4[3], eLane[3];
+        for (int i = 0; i < 3; ++i) {
+            eLane[i] = _mm_mul_ps(lanes, _mm_set1_ps(stepX[i]));
+            eStep4[i] = _mm_set1_ps(stepX[i] * 4);
+        }
+        const __m128 zLane = _mm_mul_ps(lanes, _mm_set1_ps(zdx));
+        const __m128 zStep4 = _mm_set1_ps(zdx * 4);
+
+        for (int y = minY; y <= maxY; ++y) {
+            float dy = static_cast<float>(y - minY);
+            __m128 e0 = _mm_add_ps(_mm_set1_ps(origin[0] + stepY[0] * dy), eLane[0]);
+            __m128 e1 = _mm_add_ps(_mm_set1_ps(origin[1] + stepY[1] * dy), eLane[1]);
+            __m128 e2 = _mm_add_ps(_mm_set1_ps(origin[2] + stepY[2] * dy), eLane[2]);
+            __m128 z = _mm_add_ps(_mm_set1_ps(zOrigin + zdy * dy), zLane);
+            float* row = &depth[static_cast<size_t>(y) * width];
+
+            for (int x = minX; x <= maxX; x += 4) {
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                if (_mm_movemask_ps(inside)) {
+                    __m128 old = _mm_loadu_ps(row + x);
+                    __m128 closer = _mm_max_ps(old, z);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, old)));
+                }
+                e0 = _mm_add_ps(e0, eStep4[0]);
+                e1 = _mm_add_ps(e1, eStep4[1]);
+                e2 = _mm_add_ps(e2, eStep4[2]);
+                z = _mm_add_ps(z, zStep4);
+            }
+        }
+#else
+        for (int y = minY; y <= maxY; ++y) {
+            float dy = static_cast<float>(y - minY);
+            float* row = &depth[static_cast<size_t>(y) * width];
+            for (int x = minX; x <= maxX; ++x) {
+                float dx = static_cast<float>(x - minX);
+                float e0 = origin[0] + stepY[0] * dy + stepX[0] * dx;
+                float e1 = origin[1] + stepY[1] * dy + stepX[1] * dx;
+                float e2 = origin[2] + stepY[2] * dy + stepX[2] * dx;
+                if (e0 >= 0 && e1 >= 0 && e2 >= 0) row[x] = std::max(row[x], zOrigin + zdy * dy + zdx * dx);
+            }
+        }
+#endif
+    }
+
+    void rasterizeBand(int band) {
+        int y0 = band * TILE;
+        int y1 = std::min(height, y0 + TILE);
+        std::fill(depth.begin() + static_cast<size_t>(y0) * width, depth.begin() + static_cast<size_t>(y1) * width, 0.0f);
+
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            const ScreenVertex& t0 = triangles[i];
+            const ScreenVertex& t1 = triangles[i + 1];
+            const ScreenVertex& t2 = triangles[i + 2];
+            if (std::max({ t0.y, t1.y, t2.y }) < y0 || std::min({ t0.y, t1.y, t2.y }) > y1) continue;
+            rasterizeTriangle(t0, t1, t2, y0, y1);
+        }
+
+        for (int tx = 0; tx < tilesX; ++tx) {
+            float farthest = INFINITY;
+            for (int y = y0; y < y1; ++y) {
+                const float* row = &depth[static_cast<size_t>(y) * width + tx * TILE];
+                for (int x = 0; x < TILE; ++x) farthest = std::min(farthest, row[x]);
+            }
+            tileMin[static_cast<size_t>(band) * tilesX + tx] = farthest;
+        }
+    }
+
+public:
+    OcclusionBuffer(int w = 256, int h = 128) { resize(w, h); }
+
+    void resize(int w, int h) {
+        tilesX = std::max(1, (w + TILE - 1) / TILE);
+        tilesY = std::max(1, (h + TILE - 1) / TILE);
+        width = tilesX * TILE;
+        height = tilesY * TILE;
+        depth.assign(static_cast<size_t>(width) * height, 0.0f);
+        tileMin.assign(static_cast<size_t>(tilesX) * tilesY, 0.0f);
+    }
+
+    void begin(const Matrix& viewProjection) {
+        viewProj = viewProjection;
+        triangles.clear();
+    }
+
+    // queues the faces of a box that point towards the eye (at most three)
+    void addOccluder(const BoundingBox& box, Vector3 eye) {
+        const Vector3& lo = box.min;
+        const Vector3& hi = box.max;
+        for (int axis = 0; axis < 3; ++axis) {
+            float e = axis == 0 ? eye.x : (axis == 1 ? eye.y : eye.z);
+            float boxLo = axis == 0 ? lo.x : (axis == 1 ? lo.y : lo.z);
+            float boxHi = axis == 0 ? hi.x : (axis == 1 ? hi.y : hi.z);
+            if (e >= boxLo && e <= boxHi) continue;
+            float plane = e < boxLo ? boxLo : boxHi;
+
+            // face corners in a loop order, winding does not matter (the rasterizer accepts both)
+            Vector3 c[4];
+            if (axis == 0) {
+                c[0] = { plane, lo.y, lo.z }; c[1] = { plane, hi.y, lo.z }; c[2] = { plane, hi.y, hi.z }; c[3] = { plane, lo.y, hi.z };
+            } else if (axis == 1) {
+                c[0] = { lo.x, plane, lo.z }; c[1] = { hi.x, plane, lo.z }; c[2] = { hi.x, plane, hi.z }; c[3] = { lo.x, plane, hi.z };
+            } else {
+                c[0] = { lo.x, lo.y, plane }; c[1] = { hi.x, lo.y, plane }; c[2] = { hi.x, hi.y, plane }; c[3] = { lo.x, hi.y, plane };
+            }
+            ClipVertex quad[4];
+            for (int i = 0; i < 4; ++i) quad[i] = toClip(c[i].x, c[i].y, c[i].z);
+            addQuad(quad);
+        }
+    }
+
+    void rasterize(ThreadPool* pool = nullptr) {
+        auto band = [this](size_t i) { rasterizeBand(static_cast<int>(i)); };
+        if (pool) pool->parallelFor(static_cast<size_t>(tilesY), band);
+        else for (int i = 0; i < tilesY; ++i) band(static_cast<size_t>(i));
+    }
+
+    // conservative: false only if every pixel the box could cover already has a closer occluder
+    [[nodiscard]] bool isVisible(const BoundingBox& box) const {
+        float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+        float nearest = 0.0f; // largest 1/w over the corners
+        for (int i = 0; i < 8; ++i) {
+            ClipVertex c = toClip((i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y, (i & 4) ? box.max.z : box.min.z);
+            if (c.w < NEAR_W) return true;
+            ScreenVertex s = toScreen(c);
+            minX = std::min(minX, s.x);
+            maxX = std::max(maxX, s.x);
+            minY = std::min(minY, s.y);
+            maxY = std::max(maxY, s.y);
+            nearest = std::max(nearest, s.z);
+        }
+
+        int x0 = std::max(0, static_cast<int>(floorf(minX)));
+        int x1 = std::min(width - 1, static_cast<int>(ceilf(maxX)));
+        int y0 = std::max(0, static_cast<int>(floorf(minY)));
+        int y1 = std::min(height - 1, static_cast<int>(ceilf(maxY)));
+        if (x0 > x1 || y0 > y1) return false; // off screen (frustum culling normally got it already)
+
+        for (int ty = y0 / TILE; ty <= y1 / TILE; ++ty) {
+            for (int tx = x0 / TILE; tx <= x1 / TILE; ++tx) {
+                if (tileMin[static_cast<size_t>(ty) * tilesX + tx] > nearest) continue; // whole tile is closer
+
+                int py0 = std::max(y0, ty * TILE), py1 = std::min(y1, ty * TILE + TILE - 1);
+                int px0 = std::max(x0, tx * TILE), px1 = std::min(x1, tx * TILE + TILE - 1);
+                for (int y = py0; y <= py1; ++y) {
+                    const float* row = &depth[static_cast<size_t>(y) * width];
+                    for (int x = px0; x <= px1; ++x) {
+                        if (row[x] <= nearest) return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] int getWidth() const { return width; }
+    [[nodiscard]] int getHeight() const { return height; }
+    [[nodiscard]] size_t triangleCount() const { return triangles.size() / 3; }
+    [[nodiscard]] float depthAt(int x, int y) const { return depth[static_cast<size_t>(y) * width + x]; }
+};
+
+// drops entities from the VisibleSet that are hidden behind walls
+// runs after frustum/portal culling, occluders are the solid (Collision) boxes closest to the camera
+class OcclusionCullingSystem : public ISystem {
+private:
+    const Camera* camera = nullptr;
+    VisibleSet& visible;
+    OcclusionSettings settings;
+    OcclusionBuffer buffer;
+    std::unique_ptr<ThreadPool> pool;
+
+    Bvh occluderBvh;
+    std::vector<BoundingBox> occluderBounds;
+    RebuildTrigger<WorldTransform, Collision> trigger; // occluders are colliders
+
+    struct Candidate {
+        float score;
+        uint32_t index;
+    };
+    std::vector<Candidate> candidates;
+
+    // rough projected size: face area over squared distance
+    static float OccluderScore(const BoundingBox& box, Vector3 eye) {
+        Vector3 size = BoundsExtent(box);
+        float area = std::max({ size.x * size.y, size.y * size.z, size.x * size.z });
+        float dx = std::max({ box.min.x - eye.x, 0.0f, eye.x - box.max.x });
+        float dy = std::max({ box.min.y - eye.y, 0.0f, eye.y - box.max.y });
+        float dz = std::max({ box.min.z - eye.z, 0.0f, eye.z - box.max.z });
+        return area / (dx * dx + dy * dy + dz * dz + 1.0f);
+    }
+
+public:
+    float aspect = 16.0f / 9.0f;
+    bool enabled = true;
+
+    // stats for the last frame
+    size_t occludersUsed = 0;
+    size_t tested = 0;
+    size_t culled = 0;
+    size_t rebuilds = 0; // occluder BVH builds so far
+
+    OcclusionCullingSystem(const Camera& cam, VisibleSet& visibleSet, const OcclusionSettings& occlusionSettings = {})
+        : camera(&cam), visible(visibleSet), settings(occlusionSettings),
+          buffer(occlusionSettings.width, occlusionSettings.height),
+          pool(std::make_unique<ThreadPool>(occlusionSettings.threads)) {}
+
+    // same rebuild hooks as CullingSystem (see RebuildTrigger): a stale occluder would hide what was just streamed in
+    void invalidate() { trigger.invalidate(); }
+    void applyWallChanges(const std::vector<WallChange>& changes) { trigger.applyWallChanges(changes); }
+    void setTransforms(const TransformSystem* transformSystem) { trigger.setTransforms(transformSystem); }
+
+    void rebuild(const Registry& reg) {
+        occluderBounds.clear();
+        for (const auto& [e, wt] : reg.view<WorldTransform>()) {
+            auto collision = reg.get<Collision>(e);
+            if (!collision || !collision->isEnabled()) continue;
+            BoundingBox box = BoundsFromTransform(*wt);
+            Vector3 size = BoundsExtent(box);
+            float sides[3] = { size.x, size.y, size.z };
+            std::sort(sides, sides + 3);
+            if (sides[1] < settings.minOccluderSize) continue;
+            occluderBounds.push_back(box);
+        }
+        occluderBvh.build(occluderBounds);
+
+        trigger.rebuilt(reg);
+        rebuilds++;
+    }
+
+    void update(Registry& reg, float deltaTime = 0.0f) override {
+        occludersUsed = tested = culled = 0;
+        if (!enabled || !visible.valid) return;
+        if (trigger.needed(reg)) rebuild(reg);
+
+        Matrix viewProj = Frustum::ViewProjection(*camera, aspect);
+        Frustum frustum = Frustum::FromMatrix(viewProj);
+        Vector3 eye = camera->position;
+
+        candidates.clear();
+        occluderBvh.queryFrustum(frustum, [&](uint32_t i) {
+            candidates.push_back(Candidate{ OccluderScore(occluderBounds[i], eye), i });
+        });
+        if (candidates.size() > settings.maxOccluders) {
+            std::nth_element(candidates.begin(), candidates.begin() + settings.maxOccluders, candidates.end(),
+                             [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+            candidates.resize(settings.maxOccluders);
+        }
+
+        buffer.begin(viewProj);
+        for (const Candidate& c : candidates) buffer.addOccluder(occluderBounds[c.index], eye);
+        buffer.rasterize(pool.get());
+        occludersUsed = candidates.size();
+
+        tested = visible.entities.size();
+        auto hidden = [&](Entity e) {
+            auto wt = reg.get<WorldTransform>(e);
+            return wt && !buffer.isVisible(DrawableBounds(reg, e, *wt));
+        };
+        visible.entities.erase(std::remove_if(visible.entities.begin(), visible.entities.end(), hidden), visible.entities.end());
+        culled = tested - visible.entities.size();
+    }
+
+    [[nodiscard]] const OcclusionBuffer& getBuffer() const { return buffer; }
+};
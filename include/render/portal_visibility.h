@@ -0,0 +1,233 @@
+#pragma once
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "../world/cell_graph.h"
+#include "../world/pvs.h"
+#include "culling.h"
+#include "frustum.h"
+#include "visible_set.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// screen-space clip rectangle in NDC ([-1, 1] on both axes)
+struct ScreenRect {
+    float minX{-1}, minY{-1}, maxX{1}, maxY{1};
+
+    bool empty() const { return minX >= maxX || minY >= maxY; }
+
+    ScreenRect intersect(const ScreenRect& o) const {
+        return ScreenRect{ std::max(minX, o.minX), std::max(minY, o.minY), std::min(maxX, o.maxX), std::min(maxY, o.maxY) };
+    }
+
+    ScreenRect unite(const ScreenRect& o) const {
+        return ScreenRect{ std::min(minX, o.minX), std::min(minY, o.minY), std::max(maxX, o.maxX), std::max(maxY, o.maxY) };
+    }
+
+    bool contains(const ScreenRect& o) const {
+        return o.minX >= minX && o.minY >= minY && o.maxX <= maxX && o.maxY <= maxY;
+    }
+};
+
+// cell-and-portal visibility: finds the camera's cell, then walks connected cells through their
+// doorway openings, narrowing the screen rect at every portal... only reachable + visible cells are drawn
+// so the cost follows what is on screen instead of level size
+// note: falls back to plain frustum culling (CullingSystem) when the camera is outside every cell
+class PortalVisibilitySystem : public ISystem {
+private:
+    const Camera* camera = nullptr;
+    VisibleSet& visible;
+    CullingSystem fallback;
+    CellGraph graph;
+    const Pvs* pvs = nullptr;
+    bool pvsActive = false; // set when the PVS was built for this exact graph
+
+    // drawables grouped by cell, resolved once per rebuild
+    std::vector<std::vector<Entity>> cellDrawables;
+    std::vector<std::vector<BoundingBox>> cellDrawableBounds;
+    std::vector<Entity> looseDrawables; // drawables that do not belong to any cell
+    std::vector<BoundingBox> looseBounds;
+
+    // per-frame traversal state
+    std::vector<ScreenRect> cellRects;
+    std::vector<uint32_t> cellStamp;
+    std::vector<char> onPath;
+    std::vector<uint32_t> visibleCells;
+    uint32_t frameStamp = 0;
+    Matrix viewProj{};
+    Vector3 eye{};
+
+    int lastCell = -1;
+    // the drawables plus what makes cells and portals (see CellGraph)
+    RebuildTrigger<WorldTransform, StaticBatched, BakedMesh, ColoredRender, TexturedRender, Anchor, Children, Parent, Wall> trigger;
+
+    // NDC bounds of a box clipped to `clip`... empty when it is fully behind the camera,
+    // the whole clip rect when it straddles the eye plane (conservative)
+    ScreenRect project(const BoundingBox& box, const ScreenRect& clip) const {
+        const Matrix& m = viewProj;
+        ScreenRect r{ INFINITY, INFINITY, -INFINITY, -INFINITY };
+        int behind = 0;
+        for (int i = 0; i < 8; ++i) {
+            float x = (i & 1) ? box.max.x : box.min.x;
+            float y = (i & 2) ? box.max.y : box.min.y;
+            float z = (i & 4) ? box.max.z : box.min.z;
+            float w = m.m3 * x + m.m7 * y + m.m11 * z + m.m15;
+            if (w <= 1e-4f) {
+                behind++;
+                continue;
+            }
+            float cx = (m.m0 * x + m.m4 * y + m.m8 * z + m.m12) / w;
+            float cy = (m.m1 * x + m.m5 * y + m.m9 * z + m.m13) / w;
+            r.minX = std::min(r.minX, cx);
+            r.maxX = std::max(r.maxX, cx);
+            r.minY = std::min(r.minY, cy);
+            r.maxY = std::max(r.maxY, cy);
+        }
+        if (behind == 8) return ScreenRect{ 0, 0, 0, 0 };
+        if (behind > 0) return clip; // straddles the eye plane... no sane projection, keep the whole rect
+        return r.intersect(clip);
+    }
+
+    void visit(uint32_t cell, const ScreenRect& rect, int depth) {
+        if (cellStamp[cell] != frameStamp) {
+            cellStamp[cell] = frameStamp;
+            cellRects[cell] = rect;
+            visibleCells.push_back(cell);
+        } else if (cellRects[cell].contains(rect)) {
+            return; // already walked with a wider view
+        } else {
+            cellRects[cell] = cellRects[cell].unite(rect);
+        }
+        cellsVisited++;
+        if (depth >= maxDepth) return;
+
+        onPath[cell] = 1;
+        const auto& portals = graph.getPortals();
+        for (uint32_t pi : graph.getCells()[cell].portals) {
+            const Portal& portal = portals[pi];
+            if (onPath[portal.toCell]) continue;
+            if (pvsActive && !pvs->isVisible(static_cast<uint32_t>(lastCell), portal.toCell)) continue;
+            portalsTested++;
+
+            // a portal can only be looked through from the side of the cell it leads out of
+            float side = Vector3DotProduct(Vector3Subtract(eye, portal.opening.min), portal.normal);
+            if (side > 0.01f) continue;
+
+            ScreenRect clipped = fabsf(side) <= 0.01f ? rect : project(portal.opening, rect);
+            if (clipped.empty()) continue;
+            visit(portal.toCell, clipped, depth + 1);
+        }
+        onPath[cell] = 0;
+    }
+
+public:
+    float aspect = 16.0f / 9.0f;
+    int maxDepth = 64;
+
+    // stats for the last frame
+    size_t cellsVisited = 0;
+    size_t portalsTested = 0;
+    bool usedPortals = false;
+    size_t rebuilds = 0; // graph builds so far
+
+    PortalVisibilitySystem(const Camera& cam, VisibleSet& visibleSet)
+        : camera(&cam), visible(visibleSet), fallback(cam, visibleSet) {}
+
+    // optional precomputed visibility... cells outside the camera cell's row are never walked into
+    void setPvs(const Pvs* precomputed) {
+        pvs = precomputed;
+        trigger.invalidate();
+    }
+
+    [[nodiscard]] bool usingPvs() const { return pvsActive; }
+
+    // same rebuild hooks as CullingSystem (see RebuildTrigger), carved doorways also reshape the portals
+    void invalidate() {
+        trigger.invalidate();
+        fallback.invalidate();
+    }
+    void applyWallChanges(const std::vector<WallChange>& changes) {
+        trigger.applyWallChanges(changes);
+        fallback.applyWallChanges(changes);
+    }
+    void setTransforms(const TransformSystem* transformSystem) {
+        trigger.setTransforms(transformSystem);
+        fallback.setTransforms(transformSystem);
+    }
+
+    void rebuild(const Registry& reg) {
+        graph.build(reg);
+        pvsActive = pvs && pvs->matches(graph);
+        const auto& cells = graph.getCells();
+        cellDrawables.assign(cells.size(), {});
+        cellDrawableBounds.assign(cells.size(), {});
+        looseDrawables.clear();
+        looseBounds.clear();
+
+        for (const auto& [e, wt] : reg.view<WorldTransform>()) {
+            if (!IsDrawable(reg, e)) continue;
+            int cell = graph.cellOf(e);
+            if (cell < 0) {
+                if (auto parent = reg.get<Parent>(e)) cell = graph.cellOf(parent->parent);
+            }
+            BoundingBox bounds = DrawableBounds(reg, e, *wt);
+            if (cell < 0) {
+                looseDrawables.push_back(e);
+                looseBounds.push_back(bounds);
+            } else {
+                cellDrawables[cell].push_back(e);
+                cellDrawableBounds[cell].push_back(bounds);
+            }
+        }
+
+        cellRects.assign(cells.size(), ScreenRect{});
+        cellStamp.assign(cells.size(), 0);
+        onPath.assign(cells.size(), 0);
+        frameStamp = 0;
+        lastCell = -1;
+        trigger.rebuilt(reg);
+        rebuilds++;
+    }
+
+    void update(Registry& reg, float deltaTime = 0.0f) override {
+        if (trigger.needed(reg)) rebuild(reg);
+
+        cellsVisited = 0;
+        portalsTested = 0;
+        eye = camera->position;
+        lastCell = graph.findCell(eye, lastCell);
+        usedPortals = lastCell >= 0;
+        if (!usedPortals) {
+            fallback.aspect = aspect;
+            fallback.update(reg, deltaTime);
+            return;
+        }
+
+        viewProj = Frustum::ViewProjection(*camera, aspect);
+        Frustum frustum = Frustum::FromMatrix(viewProj);
+
+        frameStamp++;
+        visibleCells.clear();
+        visit(static_cast<uint32_t>(lastCell), ScreenRect{}, 0);
+
+        visible.entities.clear();
+        visible.candidates = looseDrawables.size();
+        for (uint32_t cell : visibleCells) {
+            const auto& ents = cellDrawables[cell];
+            const auto& bounds = cellDrawableBounds[cell];
+            for (size_t i = 0; i < ents.size(); ++i) {
+                if (frustum.testBox(bounds[i]) != FrustumTest::Outside) visible.entities.push_back(ents[i]);
+            }
+        }
+        for (size_t i = 0; i < looseDrawables.size(); ++i) {
+            if (frustum.testBox(looseBounds[i]) != FrustumTest::Outside) visible.entities.push_back(looseDrawables[i]);
+        }
+        for (const auto& ents : cellDrawables) visible.candidates += ents.size();
+        visible.valid = true;
+    }
+
+    const CellGraph& getGraph() const { return graph; }
+    const std::vector<uint32_t>& getVisibleCells() const { return visibleCells; }
+    int currentCell() const { return lastCell; }
+};
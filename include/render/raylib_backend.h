@@ -0,0 +1,21 @@
+#pragma once
+#include "box_batch.h"
+#include "render_commands.h"
+#include <vector>
+
+// draws a command buffer through raylib
+// consecutive cube packets sharing a texture (what the sort key groups together) go out as one BoxBatch,
+// baked batches through DrawMesh()
+class RaylibBackend : public IRenderBackend {
+private:
+    RenderStats stats;
+    BoxBatch boxes;
+    std::vector<BoxInstance> pending; // the current run of cubes
+    unsigned int pendingTexture = 0;
+
+    void flushBoxes();
+
+public:
+    void submit(const RenderCommandBuffer& commands) override;
+    [[nodiscard]] const RenderStats& getStats() const override { return stats; }
+};
@@ -0,0 +1,247 @@
+#pragma once
+#include "../ecs/components.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// what a packet draws... the backend knows how to turn each kind into API calls
+enum class MeshKind : uint8_t {
+    ColoredCube,  // DrawCube()
+    TexturedCube, // DrawCubeTexture()
+    BakedBatch,   // one batch of a room's BakedMesh
+};
+
+// one draw: mesh + material + transform, plus the key it is sorted by
+// note: boxes are axis aligned (rotation ignored, same as before), so position + size is the whole transform
+struct DrawPacket {
+    uint64_t sortKey{0};
+    MeshKind kind{MeshKind::ColoredCube};
+    Color color{WHITE};
+    Texture2D texture{};            // id 0 = untextured
+    Rectangle uv{0, 1, 1, -1};      // texture region on every face (TexturedRender::uv)
+    Vector3 position{0};
+    Vector3 size{0};
+    BakedMeshBatch* batch{nullptr}; // BakedBatch only (uploaded lazily by the GPU backend)
+    uint32_t vertexCount{0};
+};
+
+// opaque draws first, then blended ones
+enum class RenderPass : uint8_t {
+    Opaque,
+    Transparent,
+};
+
+// 64-bit sort key, most significant first:
+//   [63..60] pass  [59..56] mesh kind  [55..32] texture id  [31..8] depth  [7..0] unused
+// so packets group by pass, then by pipeline state and texture, and only then by depth...
+// opaque depth goes front-to-back (early z), transparent depth back-to-front (blending)
+namespace sort_key {
+    constexpr int PASS_SHIFT = 60;
+    constexpr int KIND_SHIFT = 56;
+    constexpr int TEXTURE_SHIFT = 32;
+    constexpr int DEPTH_SHIFT = 8;
+    constexpr uint64_t TEXTURE_MASK = 0xFFFFFF;
+    constexpr uint64_t DEPTH_MAX = 0xFFFFFF;
+}
+
+// depth01: 0 = at the eye, 1 = at the far distance (clamped)
+inline uint64_t MakeSortKey(RenderPass pass, MeshKind kind, unsigned int textureId, float depth01) {
+    float d = std::clamp(depth01, 0.0f, 1.0f);
+    if (pass == RenderPass::Transparent) d = 1.0f - d;
+    auto depth = static_cast<uint64_t>(d * static_cast<float>(sort_key::DEPTH_MAX));
+    return (static_cast<uint64_t>(pass) << sort_key::PASS_SHIFT) |
+           (static_cast<uint64_t>(kind) << sort_key::KIND_SHIFT) |
+           ((static_cast<uint64_t>(textureId) & sort_key::TEXTURE_MASK) << sort_key::TEXTURE_SHIFT) |
+           (depth << sort_key::DEPTH_SHIFT);
+}
+
+inline RenderPass PassForColor(Color color) {
+    return color.a < 255 ? RenderPass::Transparent : RenderPass::Opaque;
+}
+
+// reusable buffers for RadixSortPackets() so a frame does not allocate
+struct PacketSortScratch {
+    struct KeyIndex {
+        uint64_t key;
+        uint32_t index;
+    };
+    std::vector<KeyIndex> keys;
+    std::vector<KeyIndex> keysTemp;
+    std::vector<DrawPacket> packets;
+};
+
+// stable LSD radix sort of packets by sortKey, one byte per pass
+// sorts (key, index) pairs and moves each packet once at the end... passes where every key has the
+// same byte are skipped (the unused low byte, the pass byte in most frames, ...)
+inline void RadixSortPackets(std::vector<DrawPacket>& packets, PacketSortScratch& scratch) {
+    using KeyIndex = PacketSortScratch::KeyIndex;
+    const size_t n = packets.size();
+    if (n < 2) return;
+
+    scratch.keys.resize(n);
+    scratch.keysTemp.resize(n);
+    size_t counts[8][256] = {};
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t key = packets[i].sortKey;
+        scratch.keys[i] = KeyIndex{ key, static_cast<uint32_t>(i) };
+        for (int b = 0; b < 8; ++b) counts[b][(key >> (b * 8)) & 0xFF]++;
+    }
+
+    KeyIndex* src = scratch.keys.data();
+    KeyIndex* dst = scratch.keysTemp.data();
+    bool moved = false;
+    for (int b = 0; b < 8; ++b) {
+        const size_t* count = counts[b];
+        if (count[(src[0].key >> (b * 8)) & 0xFF] == n) continue; // all keys share this byte
+
+        size_t offsets[256];
+        size_t sum = 0;
+        for (int i = 0; i < 256; ++i) {
+            offsets[i] = sum;
+            sum += count[i];
+        }
+        for (size_t i = 0; i < n; ++i) dst[offsets[(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+        moved = true;
+    }
+    if (!moved) return; // every key identical
+
+    scratch.packets.resize(n);
+    for (size_t i = 0; i < n; ++i) scratch.packets[i] = packets[src[i].index];
+    packets.swap(scratch.packets);
+}
+
+// per-frame list of draw packets, filled by DrawSystem and consumed by a backend
+class RenderCommandBuffer {
+private:
+    std::vector<DrawPacket> packets;
+    PacketSortScratch scratch;
+    Vector3 eye{0};
+    float invDepthRange = 1.0f / 1000.0f;
+
+    float depthOf(Vector3 p) const {
+        float dx = p.x - eye.x, dy = p.y - eye.y, dz = p.z - eye.z;
+        return sqrtf(dx * dx + dy * dy + dz * dz) * invDepthRange;
+    }
+
+public:
+    // depth keys are distances from `viewPoint`, normalized by `farDistance`
+    void setView(Vector3 viewPoint, float farDistance = 1000.0f) {
+        eye = viewPoint;
+        invDepthRange = farDistance > 0.0f ? 1.0f / farDistance : 0.0f;
+    }
+
+    void clear() { packets.clear(); }
+    void reserve(size_t n) { packets.reserve(n); }
+
+    void push(const DrawPacket& packet) { packets.push_back(packet); }
+
+    void pushColoredCube(Vector3 position, Vector3 size, Color color) {
+        DrawPacket p;
+        p.kind = MeshKind::ColoredCube;
+        p.color = color;
+        p.position = position;
+        p.size = size;
+        p.vertexCount = 36;
+        p.sortKey = MakeSortKey(PassForColor(color), p.kind, 0, depthOf(position));
+        packets.push_back(p);
+    }
+
+    // uv: an atlas tile keeps the atlas texture id, so cubes of every material in it share one key/bind
+    void pushTexturedCube(Vector3 position, Vector3 size, const Texture2D& texture, Color tint = WHITE,
+                          Rectangle uv = Rectangle{0, 1, 1, -1}) {
+        DrawPacket p;
+        p.kind = MeshKind::TexturedCube;
+        p.color = tint;
+        p.texture = texture;
+        p.uv = uv;
+        p.position = position;
+        p.size = size;
+        p.vertexCount = 24;
+        p.sortKey = MakeSortKey(PassForColor(tint), p.kind, texture.id, depthOf(position));
+        packets.push_back(p);
+    }
+
+    // center: where the batch sits for depth sorting (e.g. the baked room's bounds center)
+    // texture: what batch.texture resolves to (AssetCache::get), id 0 = untextured
+    void pushBakedBatch(BakedMeshBatch& batch, Vector3 center = Vector3{0, 0, 0}, Texture2D texture = Texture2D{}) {
+        DrawPacket p;
+        p.kind = MeshKind::BakedBatch;
+        p.color = batch.color;
+        p.texture = texture;
+        p.position = center;
+        p.batch = &batch;
+        p.vertexCount = static_cast<uint32_t>(batch.vertices.size() / 3);
+        p.sortKey = MakeSortKey(PassForColor(batch.color), p.kind, p.texture.id, depthOf(center));
+        packets.push_back(p);
+    }
+
+    // stable, so equal keys keep submission order
+    void sort() { RadixSortPackets(packets, scratch); }
+
+    [[nodiscard]] const std::vector<DrawPacket>& getPackets() const { return packets; }
+    [[nodiscard]] size_t size() const { return packets.size(); }
+    [[nodiscard]] bool empty() const { return packets.empty(); }
+};
+
+// totals for one submitted frame
+struct RenderStats {
+    size_t draws = 0;
+    size_t stateChanges = 0; // mesh kind or texture switches between consecutive packets
+    size_t textureBinds = 0; // texture switches only (what rlSetTexture() would flush on)
+    size_t vertices = 0;
+
+    void reset() { *this = RenderStats{}; }
+
+    // counts a packet as the next one submitted after `previous` (nullptr for the first)
+    void count(const DrawPacket& packet, const DrawPacket* previous) {
+        draws++;
+        vertices += packet.vertexCount;
+        if (!previous || previous->kind != packet.kind || previous->texture.id != packet.texture.id) stateChanges++;
+        if (!previous || previous->texture.id != packet.texture.id) textureBinds++;
+    }
+};
+
+// consumes a command buffer... the raylib backend draws it, others can just measure it
+class IRenderBackend {
+public:
+    virtual ~IRenderBackend() = default;
+    virtual void submit(const RenderCommandBuffer& commands) = 0;
+    [[nodiscard]] virtual const RenderStats& getStats() const = 0;
+};
+
+// headless backend: no GPU calls, only stats (and optionally a copy of the packets)
+// used by tests and the CPU benchmarks to measure submission cost and draw-call counts without a window
+class RecordingBackend : public IRenderBackend {
+private:
+    RenderStats stats;
+    RenderStats totals;
+    size_t frames = 0;
+    std::vector<DrawPacket> recorded;
+
+public:
+    bool keepPackets = false;
+
+    void submit(const RenderCommandBuffer& commands) override {
+        stats.reset();
+        const DrawPacket* previous = nullptr;
+        for (const DrawPacket& p : commands.getPackets()) {
+            stats.count(p, previous);
+            previous = &p;
+        }
+        if (keepPackets) recorded = commands.getPackets();
+
+        totals.draws += stats.draws;
+        totals.stateChanges += stats.stateChanges;
+        totals.textureBinds += stats.textureBinds;
+        totals.vertices += stats.vertices;
+        frames++;
+    }
+
+    [[nodiscard]] const RenderStats& getStats() const override { return stats; }
+    [[nodiscard]] const RenderStats& getTotals() const { return totals; }
+    [[nodiscard]] size_t frameCount() const { return frames; }
+    [[nodiscard]] const std::vector<DrawPacket>& getRecorded() const { return recorded; }
+};
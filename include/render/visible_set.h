@@ -0,0 +1,17 @@
+#pragma once
+#include "../ecs/registry.h"
+#include <vector>
+
+// per-frame list of entities that survived culling, filled by CullingSystem and consumed by DrawSystem
+// note: when valid is false DrawSystem falls back to drawing every entity
+struct VisibleSet {
+    std::vector<Entity> entities;
+    bool valid{false};
+    size_t candidates{0}; // drawables considered this frame (for cull ratio)
+
+    void clear() {
+        entities.clear();
+        valid = false;
+        candidates = 0;
+    }
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "raylib.h"
+#include <cmath>
+#include "../ecs/components.h"
+
+// helpers for raylib's BoundingBox (world-space AABBs)
+// note: rotation is ignored, same as rendering (see README)
+
+inline BoundingBox BoundsFromCenterSize(Vector3 center, Vector3 size) {
+    Vector3 half{ fabsf(size.x) / 2, fabsf(size.y) / 2, fabsf(size.z) / 2 };
+    return BoundingBox{
+        Vector3{ center.x - half.x, center.y - half.y, center.z - half.z },
+        Vector3{ center.x + half.x, center.y + half.y, center.z + half.z }
+    };
+}
+
+inline BoundingBox BoundsFromTransform(const WorldTransform& wt) {
+    return BoundsFromCenterSize(wt.position, wt.size);
+}
+
+// empty box that any Union() will replace
+inline BoundingBox BoundsEmpty() {
+    constexpr float inf = INFINITY;
+    return BoundingBox{ Vector3{ inf, inf, inf }, Vector3{ -inf, -inf, -inf } };
+}
+
+inline BoundingBox BoundsUnion(const BoundingBox& a, const BoundingBox& b) {
+    return BoundingBox{
+        Vector3{ fminf(a.min.x, b.min.x), fminf(a.min.y, b.min.y), fminf(a.min.z, b.min.z) },
+        Vector3{ fmaxf(a.max.x, b.max.x), fmaxf(a.max.y, b.max.y), fmaxf(a.max.z, b.max.z) }
+    };
+}
+
+inline Vector3 BoundsCenter(const BoundingBox& b) {
+    return Vector3{ (b.min.x + b.max.x) * 0.5f, (b.min.y + b.max.y) * 0.5f, (b.min.z + b.max.z) * 0.5f };
+}
+
+inline Vector3 BoundsExtent(const BoundingBox& b) {
+    return Vector3{ b.max.x - b.min.x, b.max.y - b.min.y, b.max.z - b.min.z };
+}
+
+inline float BoundsSurfaceArea(const BoundingBox& b) {
+    Vector3 e = BoundsExtent(b);
+    if (e.x < 0 || e.y < 0 || e.z < 0) return 0.0f;
+    return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+inline bool BoundsOverlap(const BoundingBox& a, const BoundingBox& b) {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+inline bool BoundsContainsPoint(const BoundingBox& b, Vector3 p) {
+    return p.x >= b.min.x && p.x <= b.max.x &&
+           p.y >= b.min.y && p.y <= b.max.y &&
+           p.z >= b.min.z && p.z <= b.max.z;
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include "raylib.h"
+#include "bounds.h"
+#include "../render/frustum.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// compact BVH node (32 bytes)
+// inner nodes: leftFirst = index of the left child (right child is leftFirst + 1), count = 0
+// leaves:      leftFirst = first slot in itemIndices, count = number of items
+struct BvhNode {
+    Vector3 min;
+    uint32_t leftFirst;
+    Vector3 max;
+    uint32_t count;
+
+    bool isLeaf() const { return count > 0; }
+    BoundingBox bounds() const { return BoundingBox{ min, max }; }
+};
+static_assert(sizeof(BvhNode) == 32, "BvhNode should stay 32 bytes");
+
+// how inner nodes are split: Median is fast to build and fine for frustum queries,
+// Sah (binned surface area heuristic) takes longer but gives much tighter trees for rays
+enum class BvhSplit { Median, Sah };
+
+// static bounding volume hierarchy over item bounds (items are referenced by their index in the build input)
+// note: rebuilt from scratch, meant for geometry that rarely changes (walls)
+class Bvh {
+private:
+    std::vector<BvhNode> nodes;
+    std::vector<uint32_t> itemIndices;   // leaf ranges point in here
+    std::vector<BoundingBox> itemBounds; // copy of the build input
+    std::vector<Vector3> centroids;
+
+    void setBounds(BvhNode& node) const {
+        BoundingBox b = BoundsEmpty();
+        for (uint32_t i = 0; i < node.count; ++i)
+            b = BoundsUnion(b, itemBounds[itemIndices[node.leftFirst + i]]);
+        node.min = b.min;
+        node.max = b.max;
+    }
+
+    static constexpr int SAH_BINS = 12;
+    static constexpr uint32_t SAH_MAX_DEPTH = 32; // median below this, keeps every tree within the 64-entry query stacks
+
+    // best binned SAH split of a node: number of items going left (0 = keep as a leaf)
+    // items are partitioned in place when a split is found
+    uint32_t sahPartition(const BvhNode& node, const BoundingBox& cb, uint32_t maxLeafSize) {
+        const uint32_t first = node.leftFirst;
+        const uint32_t count = node.count;
+        struct Bin {
+            BoundingBox bounds = BoundsEmpty();
+            uint32_t count = 0;
+        };
+
+        float bestCost = INFINITY;
+        int bestAxis = -1, bestSplit = 0;
+        const Vector3 cmin = cb.min;
+        const Vector3 cext = BoundsExtent(cb);
+        for (int axis = 0; axis < 3; ++axis) {
+            float lo = axis == 0 ? cmin.x : (axis == 1 ? cmin.y : cmin.z);
+            float extent = axis == 0 ? cext.x : (axis == 1 ? cext.y : cext.z);
+            if (extent <= 0.0f) continue;
+            float scale = SAH_BINS / extent;
+
+            Bin bins[SAH_BINS];
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t item = itemIndices[first + i];
+                const Vector3& c = centroids[item];
+                float v = axis == 0 ? c.x : (axis == 1 ? c.y : c.z);
+                int b = std::min(SAH_BINS - 1, static_cast<int>((v - lo) * scale));
+                bins[b].count++;
+                bins[b].bounds = BoundsUnion(bins[b].bounds, itemBounds[item]);
+            }
+
+            // cost of splitting after bin i = area(left) * count(left) + area(right) * count(right)
+            float leftArea[SAH_BINS - 1];
+            uint32_t leftCount[SAH_BINS - 1];
+            BoundingBox acc = BoundsEmpty();
+            uint32_t n = 0;
+            for (int i = 0; i < SAH_BINS - 1; ++i) {
+                acc = BoundsUnion(acc, bins[i].bounds);
+                n += bins[i].count;
+                leftArea[i] = BoundsSurfaceArea(acc);
+                leftCount[i] = n;
+            }
+            acc = BoundsEmpty();
+            n = 0;
+            for (int i = SAH_BINS - 1; i > 0; --i) {
+                acc = BoundsUnion(acc, bins[i].bounds);
+                n += bins[i].count;
+                if (n == 0 || leftCount[i - 1] == 0) continue;
+                float cost = leftArea[i - 1] * leftCount[i - 1] + BoundsSurfaceArea(acc) * n;
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        // a leaf costs testing every item, a split one node test (~1 item test) plus the children
+        float leafCost = BoundsSurfaceArea(node.bounds()) * count;
+        float splitCost = BoundsSurfaceArea(node.bounds()) + bestCost;
+        if (bestAxis < 0 || (count <= maxLeafSize && splitCost >= leafCost)) return 0;
+
+        float lo = bestAxis == 0 ? cmin.x : (bestAxis == 1 ? cmin.y : cmin.z);
+        float extent = bestAxis == 0 ? cext.x : (bestAxis == 1 ? cext.y : cext.z);
+        float scale = SAH_BINS / extent;
+        auto mid = std::partition(itemIndices.begin() + first, itemIndices.begin() + first + count, [&](uint32_t item) {
+            const Vector3& c = centroids[item];
+            float v = bestAxis == 0 ? c.x : (bestAxis == 1 ? c.y : c.z);
+            return std::min(SAH_BINS - 1, static_cast<int>((v - lo) * scale)) < bestSplit;
+        });
+        return static_cast<uint32_t>(mid - (itemIndices.begin() + first));
+    }
+
+    void subdivide(uint32_t nodeIndex, uint32_t maxLeafSize, BvhSplit split) {
+        // explicit stack, deep levels would otherwise recurse a lot
+        struct Entry { uint32_t node, depth; };
+        std::vector<Entry> stack{ { nodeIndex, 0 } };
+        while (!stack.empty()) {
+            auto [idx, depth] = stack.back();
+            stack.pop_back();
+            bool sah = split == BvhSplit::Sah && depth < SAH_MAX_DEPTH;
+            if (!sah && nodes[idx].count <= maxLeafSize) continue;
+            if (nodes[idx].count <= 1) continue;
+
+            uint32_t first = nodes[idx].leftFirst;
+            uint32_t count = nodes[idx].count;
+
+            // split at the median centroid along the widest centroid axis
+            BoundingBox cb = BoundsEmpty();
+            for (uint32_t i = 0; i < count; ++i) {
+                Vector3 c = centroids[itemIndices[first + i]];
+                cb = BoundsUnion(cb, BoundingBox{ c, c });
+            }
+            Vector3 extent = BoundsExtent(cb);
+            int axis = 0;
+            if (extent.y > extent.x) axis = 1;
+            if (extent.z > (axis == 0 ? extent.x : extent.y)) axis = 2;
+
+            uint32_t half = 0;
+            if (sah) {
+                half = sahPartition(nodes[idx], cb, maxLeafSize);
+                if (half == 0 && count <= maxLeafSize) continue; // cheaper as a leaf
+            }
+            if (half == 0) {
+                // median fallback (and SAH's answer when every centroid is in the same spot)
+                auto key = [&](uint32_t item) {
+                    const Vector3& c = centroids[item];
+                    return axis == 0 ? c.x : (axis == 1 ? c.y : c.z);
+                };
+                half = count / 2;
+                std::nth_element(itemIndices.begin() + first, itemIndices.begin() + first + half,
+                                 itemIndices.begin() + first + count,
+                                 [&](uint32_t a, uint32_t b) { return key(a) < key(b); });
+            }
+
+            uint32_t left = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(BvhNode{ {}, first, {}, half });
+            nodes.push_back(BvhNode{ {}, first + half, {}, count - half });
+            setBounds(nodes[left]);
+            setBounds(nodes[left + 1]);
+
+            nodes[idx].leftFirst = left;
+            nodes[idx].count = 0;
+            stack.push_back({ left, depth + 1 });
+            stack.push_back({ left + 1, depth + 1 });
+        }
+    }
+
+public:
+    void build(const std::vector<BoundingBox>& bounds, uint32_t maxLeafSize = 4, BvhSplit split = BvhSplit::Median) {
+        nodes.clear();
+        itemBounds = bounds;
+        itemIndices.resize(bounds.size());
+        centroids.resize(bounds.size());
+        for (uint32_t i = 0; i < bounds.size(); ++i) {
+            itemIndices[i] = i;
+            centroids[i] = BoundsCenter(bounds[i]);
+        }
+        if (bounds.empty()) return;
+
+        nodes.reserve(2 * bounds.size());
+        nodes.push_back(BvhNode{ {}, 0, {}, static_cast<uint32_t>(bounds.size()) });
+        setBounds(nodes[0]);
+        subdivide(0, std::max<uint32_t>(1, maxLeafSize), split);
+    }
+
+    // calls onVisible(itemIndex) for every item whose box is inside or intersecting the frustum
+    // note: subtrees fully inside the frustum are emitted without testing their items
+    template<typename Fn>
+    void queryFrustum(const Frustum& frustum, Fn&& onVisible) const {
+        if (nodes.empty()) return;
+
+        struct Entry { uint32_t node; bool inside; };
+        Entry stack[64];
+        int top = 0;
+        stack[top++] = { 0, false };
+        while (top > 0) {
+            Entry entry = stack[--top];
+            const BvhNode& node = nodes[entry.node];
+
+            bool inside = entry.inside;
+            if (!inside) {
+                FrustumTest t = frustum.testBox(node.bounds());
+                if (t == FrustumTest::Outside) continue;
+                inside = (t == FrustumTest::Inside);
+            }
+
+            if (node.isLeaf()) {
+                for (uint32_t i = 0; i < node.count; ++i) {
+                    uint32_t item = itemIndices[node.leftFirst + i];
+                    if (inside || frustum.testBox(itemBounds[item]) != FrustumTest::Outside)
+                        onVisible(item);
+                }
+            } else {
+                stack[top++] = { node.leftFirst, inside };
+                stack[top++] = { node.leftFirst + 1, inside };
+            }
+        }
+    }
+
+    // calls onHit(itemIndex) for every item overlapping box
+    template<typename Fn>
+    void queryBox(const BoundingBox& box, Fn&& onHit) const {
+        if (nodes.empty()) return;
+
+        uint32_t stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const BvhNode& node = nodes[stack[--top]];
+            if (!BoundsOverlap(node.bounds(), box)) continue;
+            if (node.isLeaf()) {
+                for (uint32_t i = 0; i < node.count; ++i) {
+                    uint32_t item = itemIndices[node.leftFirst + i];
+                    if (BoundsOverlap(itemBounds[item], box)) onHit(item);
+                }
+            } else {
+                stack[top++] = node.leftFirst;
+                stack[top++] = node.leftFirst + 1;
+            }
+        }
+    }
+
+    size_t nodeCount() const { return nodes.size(); }
+    size_t itemCount() const { return itemBounds.size(); }
+    const std::vector<BvhNode>& getNodes() const { return nodes; }
+    const std::vector<uint32_t>& getItemIndices() const { return itemIndices; }
+    const std::vector<BoundingBox>& getItemBounds() const { return itemBounds; }
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include "raylib.h"
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "bounds.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// which entities are colliders (an enabled Collision and a WorldTransform) and their boxes, kept in step with the
+// registry for a broadphase that stores them by id: CollisionSystem's SpatialHash, DynamicBroadphase's tree
+// the tracker owns the entity <-> id mapping and decides what changed, the broadphase only sees inserts/moves/removes
+// through an Index passed to every call:
+//   uint32_t insert(const BoundingBox& box)
+//   void move(uint32_t id, const BoundingBox& from, const BoundingBox& to)   (only called when the box changed)
+//   void remove(uint32_t id)
+// what gets picked up:
+//   - Collision/WorldTransform membership changes (walls added, destroyed, carved: Registry::revision) re-sync, only
+//     changed boxes touch the index
+//   - markChanged(e) for walls that moved or toggled Collision without gaining/losing a component
+//   - applyWallChanges() after carving doorways or snapping hallways, so the new segments don't cost a full re-sync
+//   - invalidate() forces a full re-sync
+class ColliderTracker {
+private:
+    std::unordered_map<Entity, uint32_t> idOf;
+    std::vector<Entity> entityOf;   // by index id
+    std::vector<BoundingBox> boxOf; // by index id
+    std::vector<uint32_t> seen;     // by index id, sync stamp
+    uint32_t syncStamp = 0;
+    std::vector<Entity> changed;
+
+    bool syncPending = true;
+    uint64_t lastTransformRevision = 0;
+    uint64_t lastCollisionRevision = 0;
+
+    static bool SameBox(const BoundingBox& a, const BoundingBox& b) {
+        return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z &&
+               a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+    }
+
+    template <typename Index>
+    void track(Index& index, Entity e, const BoundingBox& box) {
+        auto it = idOf.find(e);
+        uint32_t id;
+        if (it == idOf.end()) {
+            id = index.insert(box);
+            idOf.emplace(e, id);
+            if (id >= entityOf.size()) {
+                entityOf.resize(id + 1, INVALID_ENTITY);
+                boxOf.resize(id + 1);
+                seen.resize(id + 1, 0);
+            }
+            entityOf[id] = e;
+            boxOf[id] = box;
+        } else {
+            id = it->second;
+            if (!SameBox(boxOf[id], box)) {
+                index.move(id, boxOf[id], box);
+                boxOf[id] = box;
+            }
+        }
+        seen[id] = syncStamp;
+    }
+
+    template <typename Index>
+    void untrack(Index& index, Entity e) {
+        auto it = idOf.find(e);
+        if (it == idOf.end()) return;
+        index.remove(it->second);
+        entityOf[it->second] = INVALID_ENTITY;
+        idOf.erase(it);
+    }
+
+public:
+    size_t syncs = 0; // full re-syncs so far
+
+    // the box an entity should have in the broadphase, false if it shouldn't be there at all
+    static bool ColliderBounds(const Registry& reg, Entity e, BoundingBox& box) {
+        auto collision = reg.get<Collision>(e);
+        if (!collision || !collision->isEnabled()) return false;
+        auto wt = reg.get<WorldTransform>(e);
+        if (!wt) return false;
+        box = BoundsFromTransform(*wt);
+        return true;
+    }
+
+    void invalidate() { syncPending = true; }
+    void markChanged(Entity e) { changed.push_back(e); }
+
+    // a doorway carve's WallChanges (see CarveDoorway): the next update() re-tracks just those walls instead of the
+    // revision change forcing a full re-sync... call it right after carving, anything else added or destroyed in
+    // between still re-syncs
+    // note: the walls' boxes are read from their WorldTransforms, CarveDoorway sets those when it carves, so this
+    // needn't wait for a TransformSystem pass
+    void applyWallChanges(const Registry& reg, const std::vector<WallChange>& wallChanges) {
+        for (const WallChange& change : wallChanges) {
+            if (change.kind == WallChange::Kind::Removed) {
+                invalidate(); // gone already, can't tell which pools it was in (rare: a door as wide as the wall)
+                continue;
+            }
+            if (change.kind == WallChange::Kind::Created) {
+                lastTransformRevision += reg.has<WorldTransform>(change.wall);
+                lastCollisionRevision += reg.has<Collision>(change.wall);
+            }
+            changed.push_back(change.wall);
+        }
+    }
+
+    [[nodiscard]] bool syncNeeded(const Registry& reg) const {
+        return syncPending || reg.revision<WorldTransform>() != lastTransformRevision || reg.revision<Collision>() != lastCollisionRevision;
+    }
+
+    // full diff against the registry, O(world): new colliders are inserted, moved ones moved, gone/disabled ones removed
+    template <typename Index>
+    void sync(const Registry& reg, Index& index) {
+        if (++syncStamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            syncStamp = 1;
+        }
+        const size_t expected = reg.count<Collision>();
+        if (idOf.size() < expected) idOf.reserve(expected);
+        for (const auto& [e, collision] : reg.view<Collision>()) {
+            BoundingBox box;
+            if (ColliderBounds(reg, e, box)) track(index, e, box);
+        }
+        for (uint32_t id = 0; id < entityOf.size(); ++id)
+            if (entityOf[id] != INVALID_ENTITY && seen[id] != syncStamp) untrack(index, entityOf[id]);
+
+        changed.clear();
+        lastTransformRevision = reg.revision<WorldTransform>();
+        lastCollisionRevision = reg.revision<Collision>();
+        syncPending = false;
+        syncs++;
+    }
+
+    // re-tracks one entity (inserted, moved or removed to match the registry)
+    template <typename Index>
+    void apply(const Registry& reg, Index& index, Entity e) {
+        BoundingBox box;
+        if (ColliderBounds(reg, e, box)) track(index, e, box);
+        else untrack(index, e);
+    }
+
+    // full sync when needed, otherwise just what markChanged()/applyWallChanges() queued... true if it synced
+    template <typename Index>
+    bool update(const Registry& reg, Index& index) {
+        if (syncNeeded(reg)) {
+            sync(reg, index);
+            return true;
+        }
+        for (Entity e : changed) apply(reg, index, e);
+        changed.clear();
+        return false;
+    }
+
+    [[nodiscard]] Entity entity(uint32_t id) const { return entityOf[id]; }
+    [[nodiscard]] const BoundingBox& box(uint32_t id) const { return boxOf[id]; }
+    [[nodiscard]] size_t size() const { return idOf.size(); }
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "bounds.h"
+#include "collider_tracker.h"
+#include "spatial_hash.h"
+#include "sweep.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct CollisionSettings {
+    float cellSize = 64.0f;  // hash cell, about a third of a demo room wall (walls touch a handful of cells)
+    float skin = 0.01f;      // gap left between the player and a wall, also how far inside still counts as touching
+    int maxSlides = 4;       // sweeps per moveAndSlide(), each hit slides along the wall with what's left of the move
+    int maxIterations = 4;   // push-out passes when already inside a wall (corners need more than one)
+};
+
+// player-vs-world collision: every entity with an enabled Collision and a WorldTransform lives in a SpatialHash,
+// moveAndSlide() sweeps an axis-aligned box through it (time of impact, see sweep.h) and slides along whatever it hits
+// the hash follows the registry incrementally through a ColliderTracker (see there for what gets picked up), plus
+// TransformSystem::getChangedColliders() when given one, so walls moved or resized in place need no markChanged()
+// note: with a TransformSystem, update before its next update (its list only holds the last one)
+// note: walls are axis-aligned boxes like everywhere else (rotation ignored, see README), so the player is one too
+class CollisionSystem : public ISystem {
+private:
+    CollisionSettings settings;
+    const TransformSystem* transforms = nullptr;
+    SpatialHash hash;
+    ColliderTracker tracker;
+    SweepCandidates sweepCandidates;
+
+    // the tracker's view of the hash
+    struct HashIndex {
+        SpatialHash& hash;
+        uint32_t insert(const BoundingBox& box) { return hash.insert(box); }
+        void move(uint32_t id, const BoundingBox&, const BoundingBox& box) { hash.update(id, box); }
+        void remove(uint32_t id) { hash.remove(id); }
+    };
+
+    static float& Axis(Vector3& v, int axis) { return axis == 0 ? v.x : axis == 1 ? v.y : v.z; }
+    static float Axis(const Vector3& v, int axis) { return axis == 0 ? v.x : axis == 1 ? v.y : v.z; }
+
+    // touching is not overlapping, otherwise a player resting against a wall would keep getting pushed
+    static bool Penetrates(const BoundingBox& a, const BoundingBox& b) {
+        return a.min.x < b.max.x && a.max.x > b.min.x &&
+               a.min.y < b.max.y && a.max.y > b.min.y &&
+               a.min.z < b.max.z && a.max.z > b.min.z;
+    }
+
+    static BoundingBox BoxAt(Vector3 center, Vector3 half) {
+        return BoundingBox{ Vector3Subtract(center, half), Vector3Add(center, half) };
+    }
+
+    // pushes the box at pos out of every wall it penetrates (shallowest axis first)
+    // sweeps never end up inside a wall, this is for starting inside one (spawned there, or a wall moved onto the player)
+    bool depenetrate(Vector3& pos, Vector3 half) {
+        bool moved = false;
+        for (int iter = 0; iter < settings.maxIterations; ++iter) {
+            bool pushed = false;
+            hash.query(BoxAt(pos, half), [&](uint32_t, const BoundingBox& wall) {
+                BoundingBox box = BoxAt(pos, half); // earlier walls in this pass may have moved it already
+                if (!Penetrates(box, wall)) return;
+
+                int axis = 0;
+                float depth = INFINITY;
+                for (int a = 0; a < 3; ++a) {
+                    float d = std::min(Axis(box.max, a) - Axis(wall.min, a), Axis(wall.max, a) - Axis(box.min, a));
+                    if (d < depth) {
+                        depth = d;
+                        axis = a;
+                    }
+                }
+                float sign = Axis(pos, axis) < (Axis(wall.min, axis) + Axis(wall.max, axis)) * 0.5f ? -1.0f : 1.0f;
+                // push to the wall's face, not by the depth (stacked pushes would otherwise overshoot)
+                Axis(pos, axis) = sign < 0 ? Axis(wall.min, axis) - Axis(half, axis) - settings.skin
+                                           : Axis(wall.max, axis) + Axis(half, axis) + settings.skin;
+                moved = pushed = true;
+            });
+            if (!pushed) break;
+        }
+        return moved;
+    }
+
+public:
+    bool enabled = true; // false = noclip, moveAndSlide() passes moves through
+
+    // stats for the last moveAndSlide()
+    size_t contacts = 0;
+    size_t candidates = 0;
+    size_t syncs = 0; // full re-syncs so far
+
+    explicit CollisionSystem(const CollisionSettings& collisionSettings = {})
+        : settings(collisionSettings), hash(collisionSettings.cellSize) {}
+    explicit CollisionSystem(const TransformSystem& transformSystem, const CollisionSettings& collisionSettings = {})
+        : settings(collisionSettings), transforms(&transformSystem), hash(collisionSettings.cellSize) {}
+
+    void invalidate() { tracker.invalidate(); }
+    void markChanged(Entity e) { tracker.markChanged(e); }
+    void applyWallChanges(const Registry& reg, const std::vector<WallChange>& wallChanges) { tracker.applyWallChanges(reg, wallChanges); }
+
+    // full diff against the registry (see ColliderTracker::sync)
+    void sync(const Registry& reg) {
+        if (const size_t expected = reg.count<Collision>(); tracker.size() < expected) hash.reserve(expected);
+        HashIndex index{ hash };
+        tracker.sync(reg, index);
+        syncs = tracker.syncs;
+    }
+
+    void update(Registry& reg, float deltaTime = 0.0f) override {
+        if (tracker.syncNeeded(reg)) {
+            sync(reg);
+            return;
+        }
+        HashIndex index{ hash };
+        tracker.update(reg, index);
+        if (transforms)
+            for (Entity e : transforms->getChangedColliders()) tracker.apply(reg, index, e);
+    }
+
+    // moves a box of the given half extents from `from` towards `to` and returns where it ends up
+    // one broadphase query over the whole swept box, then up to maxSlides sweeps against those candidates: each stops
+    // at the first wall (skin away from it) and carries on with the rest of the move minus the part into the wall
+    // note: sliding only ever shortens the move per axis, so every later sweep stays inside the first query's box
+    Vector3 moveAndSlide(Vector3 from, Vector3 to, Vector3 halfExtents) {
+        contacts = candidates = 0;
+        if (!enabled || hash.size() == 0) return to;
+
+        Vector3 pos = from;
+        bool wasInside = depenetrate(pos, halfExtents);
+        Vector3 delta = Vector3Subtract(to, from);
+        if (delta.x == 0.0f && delta.y == 0.0f && delta.z == 0.0f) return pos;
+
+        BoundingBox swept = BoundsUnion(BoxAt(pos, halfExtents), BoxAt(Vector3Add(pos, delta), halfExtents));
+        sweepCandidates.clear();
+        hash.query(swept, [&](uint32_t, const BoundingBox& wall) { sweepCandidates.add(wall, halfExtents); });
+        candidates = sweepCandidates.size();
+
+        for (int slide = 0; slide < settings.maxSlides; ++slide) {
+            SweepHit hit = sweepCandidates.first(pos, delta, settings.skin);
+            if (!hit.hit()) {
+                pos = Vector3Add(pos, delta);
+                break;
+            }
+            contacts++;
+            pos = Vector3Add(pos, Vector3Scale(delta, hit.time));
+            BoundingBox wall = sweepCandidates.grown(hit.index);
+            Axis(pos, hit.axis) = hit.sign < 0 ? Axis(wall.min, hit.axis) - settings.skin : Axis(wall.max, hit.axis) + settings.skin;
+
+            delta = Vector3Scale(delta, 1.0f - hit.time);
+            Axis(delta, hit.axis) = 0.0f;
+            if (delta.x == 0.0f && delta.y == 0.0f && delta.z == 0.0f) break;
+        }
+        // out of slides: whatever is left of the move is dropped (wedged in a corner)
+        return contacts == 0 && !wasInside ? to : pos; // free moves end exactly at `to`
+    }
+
+    // calls fn(entity, box) for every collider overlapping box
+    template <typename Fn>
+    void query(const BoundingBox& box, Fn&& fn) {
+        hash.query(box, [&](uint32_t id, const BoundingBox& b) { fn(tracker.entity(id), b); });
+    }
+
+    [[nodiscard]] size_t colliderCount() const { return hash.size(); }
+    [[nodiscard]] const SpatialHash& getHash() const { return hash; }
+};
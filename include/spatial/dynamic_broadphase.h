@@ -0,0 +1,71 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "bounds.h"
+#include "collider_tracker.h"
+#include "dynamic_tree.h"
+#include <vector>
+
+// broadphase for things that move (doors, platforms): every entity with an enabled Collision and a WorldTransform
+// lives in a DynamicAabbTree, fed by TransformSystem::getChangedColliders() on top of a ColliderTracker (the rest of
+// what gets picked up, same as CollisionSystem)
+//   - a frame costs O(movers * log n), whatever the world size... movers within their fat box don't touch the tree
+//   - markChanged(e) for Collision toggles (TransformSystem only reports transform changes)
+// note: must update right after the TransformSystem it listens to, its list only holds that system's last update
+class DynamicBroadphase : public ISystem {
+private:
+    const TransformSystem* transforms;
+    DynamicAabbTree tree;
+    ColliderTracker tracker; // real boxes by proxy id (the tree only has the fat ones)
+
+    // the tracker's view of the tree, counts moves for the stats
+    struct TreeIndex {
+        DynamicBroadphase& self;
+        uint32_t insert(const BoundingBox& box) { return static_cast<uint32_t>(self.tree.insert(box)); }
+        void move(uint32_t id, const BoundingBox& from, const BoundingBox& to) {
+            self.moved++;
+            if (self.tree.move(static_cast<int32_t>(id), to, Vector3Subtract(BoundsCenter(to), BoundsCenter(from)))) self.reinserted++;
+        }
+        void remove(uint32_t id) { self.tree.remove(static_cast<int32_t>(id)); }
+    };
+
+public:
+    // stats for the last update()
+    size_t moved = 0;      // proxies whose box changed
+    size_t reinserted = 0; // of those, how many left their fat box
+
+    explicit DynamicBroadphase(const TransformSystem& transformSystem, float margin = 0.1f)
+        : transforms(&transformSystem), tree(margin) {}
+
+    void invalidate() { tracker.invalidate(); }
+    void markChanged(Entity e) { tracker.markChanged(e); }
+    void applyWallChanges(const Registry& reg, const std::vector<WallChange>& wallChanges) { tracker.applyWallChanges(reg, wallChanges); }
+
+    // full diff against the registry, O(world): only for the first update and membership changes
+    void sync(const Registry& reg) {
+        TreeIndex index{ *this };
+        tracker.sync(reg, index);
+    }
+
+    void update(Registry& reg, float deltaTime = 0.0f) override {
+        moved = reinserted = 0;
+        TreeIndex index{ *this };
+        if (tracker.update(reg, index)) return;
+        for (Entity e : transforms->getChangedColliders()) tracker.apply(reg, index, e);
+    }
+
+    // calls fn(entity, box) for every collider whose real box overlaps box
+    template <typename Fn>
+    void query(const BoundingBox& box, Fn&& fn) const {
+        tree.query(box, [&](int32_t id) {
+            const BoundingBox& real = tracker.box(static_cast<uint32_t>(id));
+            if (BoundsOverlap(real, box)) fn(tracker.entity(static_cast<uint32_t>(id)), real);
+        });
+    }
+
+    [[nodiscard]] size_t colliderCount() const { return tree.size(); }
+    [[nodiscard]] const DynamicAabbTree& getTree() const { return tree; }
+};
@@ -0,0 +1,332 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "bounds.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// dynamic AABB tree: a binary tree over "fat" boxes (the real box plus a margin) that is updated in place
+// insert/remove/move are O(log n), a move that stays inside its fat box doesn't touch the tree at all
+// inner nodes are kept balanced with AVL-style rotations, nodes come from a pool with a free list (no per-node allocation)
+// items are referenced by the proxy id insert() returned (a leaf node index)... ids are reused after remove()
+// note: unlike Bvh this is meant for things that move (doors, platforms), static walls are cheaper in a Bvh
+class DynamicAabbTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+private:
+    struct Node {
+        BoundingBox box;           // fat for leaves, union of the children for inner nodes
+        int32_t parent = NULL_NODE; // next free node while pooled
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = -1;       // leaf = 0, free = -1
+        uint32_t userData = 0;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+    size_t proxyCount = 0;
+    float margin;
+    float displacementScale;
+
+    int32_t allocateNode() {
+        if (freeList == NULL_NODE) {
+            // grow the pool and thread the new nodes onto the free list
+            const int32_t first = static_cast<int32_t>(nodes.size());
+            const int32_t grown = std::max<int32_t>(16, first);
+            nodes.resize(first + grown);
+            for (int32_t i = first; i < first + grown - 1; ++i) nodes[i].parent = i + 1;
+            nodes[first + grown - 1].parent = NULL_NODE;
+            freeList = first;
+        }
+        int32_t id = freeList;
+        freeList = nodes[id].parent;
+        nodes[id] = Node{};
+        nodes[id].height = 0;
+        return id;
+    }
+
+    void freeNode(int32_t id) {
+        nodes[id].parent = freeList;
+        nodes[id].height = -1;
+        freeList = id;
+    }
+
+    static BoundingBox Fatten(const BoundingBox& box, float m) {
+        return BoundingBox{ Vector3{ box.min.x - m, box.min.y - m, box.min.z - m },
+                            Vector3{ box.max.x + m, box.max.y + m, box.max.z + m } };
+    }
+
+    static bool Contains(const BoundingBox& outer, const BoundingBox& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    void refit(int32_t id) {
+        Node& n = nodes[id];
+        n.box = BoundsUnion(nodes[n.child1].box, nodes[n.child2].box);
+        n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+    }
+
+    // picks the sibling that grows the tree's total surface area the least (branch and bound on the descent cost)
+    int32_t findSibling(const BoundingBox& leafBox) const {
+        int32_t index = root;
+        while (!nodes[index].isLeaf()) {
+            const Node& n = nodes[index];
+            const float area = BoundsSurfaceArea(n.box);
+            const float combinedArea = BoundsSurfaceArea(BoundsUnion(n.box, leafBox));
+            const float cost = 2.0f * combinedArea;               // new parent here
+            const float inheritance = 2.0f * (combinedArea - area); // what every node below pays for growing this one
+
+            auto descendCost = [&](int32_t child) {
+                const Node& c = nodes[child];
+                float grown = BoundsSurfaceArea(BoundsUnion(c.box, leafBox));
+                if (c.isLeaf()) return grown + inheritance;
+                return grown - BoundsSurfaceArea(c.box) + inheritance;
+            };
+            const float cost1 = descendCost(n.child1);
+            const float cost2 = descendCost(n.child2);
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? n.child1 : n.child2;
+        }
+        return index;
+    }
+
+    void insertLeaf(int32_t leaf) {
+        if (root == NULL_NODE) {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+
+        const int32_t sibling = findSibling(nodes[leaf].box);
+        const int32_t oldParent = nodes[sibling].parent;
+        const int32_t newParent = allocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+        if (oldParent == NULL_NODE) root = newParent;
+        else if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+        else nodes[oldParent].child2 = newParent;
+
+        // walk back up fixing boxes and heights, rotating where a side got too deep
+        for (int32_t index = newParent; index != NULL_NODE; index = nodes[index].parent) {
+            index = balance(index);
+            refit(index);
+        }
+    }
+
+    void removeLeaf(int32_t leaf) {
+        if (leaf == root) {
+            root = NULL_NODE;
+            return;
+        }
+        const int32_t parent = nodes[leaf].parent;
+        const int32_t grandParent = nodes[parent].parent;
+        const int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        // the sibling takes the parent's place
+        if (grandParent == NULL_NODE) {
+            root = sibling;
+            nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+            return;
+        }
+        if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+        else nodes[grandParent].child2 = sibling;
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        for (int32_t index = grandParent; index != NULL_NODE; index = nodes[index].parent) {
+            index = balance(index);
+            refit(index);
+        }
+    }
+
+    // if one child of a is more than one level deeper than the other, the deeper child c moves up to a's place and
+    // a takes c's shallower grandchild... returns the node now at a's position
+    int32_t balance(int32_t a) {
+        Node& A = nodes[a];
+        if (A.isLeaf() || A.height < 2) return a;
+
+        const int32_t b = A.child1, c = A.child2;
+        const int32_t diff = nodes[c].height - nodes[b].height;
+        if (diff > 1) return rotateUp(a, c);
+        if (diff < -1) return rotateUp(a, b);
+        return a;
+    }
+
+    // up = the deeper child of a
+    int32_t rotateUp(int32_t a, int32_t up) {
+        Node& U = nodes[up];
+        const int32_t f = U.child1, g = U.child2;
+
+        // up replaces a
+        U.child1 = a;
+        U.parent = nodes[a].parent;
+        nodes[a].parent = up;
+        if (U.parent == NULL_NODE) root = up;
+        else if (nodes[U.parent].child1 == a) nodes[U.parent].child1 = up;
+        else nodes[U.parent].child2 = up;
+
+        // the taller grandchild stays under up, the shorter one goes to a (in up's old slot)
+        const bool fTaller = nodes[f].height > nodes[g].height;
+        const int32_t keep = fTaller ? f : g;
+        const int32_t give = fTaller ? g : f;
+        U.child2 = keep;
+        nodes[keep].parent = up;
+        if (nodes[a].child1 == up) nodes[a].child1 = give;
+        else nodes[a].child2 = give;
+        nodes[give].parent = a;
+
+        refit(a);
+        refit(up);
+        return up;
+    }
+
+public:
+    // margin: how far a leaf's box is fattened on every side, moves within it cost nothing
+    // displacementScale: fat boxes are also stretched along the last move by this many frames of it (predicted motion)
+    explicit DynamicAabbTree(float margin = 0.1f, float displacementScale = 4.0f)
+        : margin(margin), displacementScale(displacementScale) {}
+
+    int32_t insert(const BoundingBox& box, uint32_t userData = 0) {
+        int32_t id = allocateNode();
+        nodes[id].box = Fatten(box, margin);
+        nodes[id].userData = userData;
+        insertLeaf(id);
+        proxyCount++;
+        return id;
+    }
+
+    void remove(int32_t id) {
+        if (!contains(id)) return;
+        removeLeaf(id);
+        freeNode(id);
+        proxyCount--;
+    }
+
+    // returns true if the leaf had to be re-inserted (box left its fat box, or the fat box became far too big for it)
+    // displacement: how far it moved this frame, the new fat box is stretched in that direction
+    bool move(int32_t id, const BoundingBox& box, Vector3 displacement = { 0, 0, 0 }) {
+        if (!contains(id)) return false;
+        const Vector3 d = { displacement.x * displacementScale, displacement.y * displacementScale, displacement.z * displacementScale };
+        const BoundingBox& fat = nodes[id].box;
+        if (Contains(fat, box)) {
+            // still inside... unless it slowed down or stopped and the stretched box is now much bigger than needed
+            BoundingBox huge = Fatten(box, 4.0f * margin);
+            huge.min = Vector3Subtract(huge.min, { 2.0f * fabsf(d.x), 2.0f * fabsf(d.y), 2.0f * fabsf(d.z) });
+            huge.max = Vector3Add(huge.max, { 2.0f * fabsf(d.x), 2.0f * fabsf(d.y), 2.0f * fabsf(d.z) });
+            if (Contains(huge, fat)) return false;
+        }
+
+        removeLeaf(id);
+        BoundingBox grown = Fatten(box, margin);
+        if (d.x < 0) grown.min.x += d.x; else grown.max.x += d.x;
+        if (d.y < 0) grown.min.y += d.y; else grown.max.y += d.y;
+        if (d.z < 0) grown.min.z += d.z; else grown.max.z += d.z;
+        nodes[id].box = grown;
+        insertLeaf(id);
+        return true;
+    }
+
+    // calls fn(id) for every leaf whose fat box overlaps box (callers check the real box if they need exact hits)
+    template <typename Fn>
+    void query(const BoundingBox& box, Fn&& fn) const {
+        if (root == NULL_NODE) return;
+        // balanced trees stay far below 64 levels... the rotations don't guarantee it though (see maxBalance()), so
+        // whatever doesn't fit spills over into a vector (the newest entries, popped first)
+        int32_t stack[64];
+        std::vector<int32_t> spill;
+        int sp = 0;
+        auto push = [&](int32_t id) {
+            if (sp < 64) stack[sp++] = id;
+            else spill.push_back(id);
+        };
+        push(root);
+        while (sp > 0) {
+            int32_t id;
+            if (!spill.empty()) {
+                id = spill.back();
+                spill.pop_back();
+            } else {
+                id = stack[--sp];
+            }
+            const Node& n = nodes[id];
+            if (!BoundsOverlap(n.box, box)) continue;
+            if (n.isLeaf()) {
+                fn(id);
+                continue;
+            }
+            push(n.child1);
+            push(n.child2);
+        }
+    }
+
+    void clear() {
+        nodes.clear();
+        root = freeList = NULL_NODE;
+        proxyCount = 0;
+    }
+
+    [[nodiscard]] bool contains(int32_t id) const {
+        return id >= 0 && id < static_cast<int32_t>(nodes.size()) && nodes[id].height == 0 && nodes[id].isLeaf();
+    }
+    [[nodiscard]] const BoundingBox& fatBounds(int32_t id) const { return nodes[id].box; }
+    [[nodiscard]] uint32_t userData(int32_t id) const { return nodes[id].userData; }
+    [[nodiscard]] size_t size() const { return proxyCount; }
+    [[nodiscard]] size_t nodeCount() const { return proxyCount == 0 ? 0 : 2 * proxyCount - 1; }
+    [[nodiscard]] size_t poolSize() const { return nodes.size(); }
+    [[nodiscard]] int32_t height() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+    // total inner node surface area relative to the root, the usual tree quality measure (lower = fewer visits)
+    [[nodiscard]] float areaRatio() const {
+        if (root == NULL_NODE) return 0.0f;
+        float rootArea = BoundsSurfaceArea(nodes[root].box), total = 0.0f;
+        for (const Node& n : nodes)
+            if (n.height > 0) total += BoundsSurfaceArea(n.box);
+        return rootArea > 0.0f ? total / rootArea : 0.0f;
+    }
+
+    // largest height difference between two siblings... rotations look one level down only, so this can exceed 1
+    // (unlike a strict AVL tree) but stays small
+    [[nodiscard]] int32_t maxBalance() const {
+        int32_t worst = 0;
+        for (const Node& n : nodes)
+            if (n.height > 1) worst = std::max(worst, std::abs(nodes[n.child1].height - nodes[n.child2].height));
+        return worst;
+    }
+
+    // DEV: checks parent links, heights and boxes of the whole tree (tests only, O(n))
+    [[nodiscard]] bool validate() const {
+        if (root == NULL_NODE) return proxyCount == 0;
+        if (nodes[root].parent != NULL_NODE) return false;
+        size_t leaves = 0;
+        bool ok = true;
+        auto check = [&](auto&& self, int32_t id) -> void {
+            const Node& n = nodes[id];
+            if (n.isLeaf()) {
+                leaves++;
+                ok &= n.height == 0;
+                return;
+            }
+            const Node& c1 = nodes[n.child1];
+            const Node& c2 = nodes[n.child2];
+            ok &= c1.parent == id && c2.parent == id;
+            ok &= n.height == 1 + std::max(c1.height, c2.height);
+            ok &= Contains(n.box, c1.box) && Contains(n.box, c2.box);
+            self(self, n.child1);
+            self(self, n.child2);
+        };
+        check(check, root);
+        return ok && leaves == proxyCount;
+    }
+};
@@ -0,0 +1,349 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "bounds.h"
+#include "bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAYCAST_SSE 1
+#endif
+
+struct RayHit {
+    Entity entity = INVALID_ENTITY;
+    float distance = INFINITY;
+    Vector3 point{};
+    Vector3 normal{};                 // face of the box that was hit (zero when the ray starts inside it)
+    bool isWall = false;              // side is only meaningful for entities with a Wall
+    Wall::Side side = Wall::Side::Front;
+
+    bool hit() const { return entity != INVALID_ENTITY; }
+};
+
+// N rays traversed together (AI line of sight: one eye, several targets)
+// rays with maxDistance <= 0 are unused lanes
+template <int N>
+struct RayPacket {
+    static_assert(N == 4 || N == 8, "packets are 4 or 8 rays");
+    Vector3 origin[N]{};
+    Vector3 direction[N]{};  // normalized by the queries
+    float maxDistance[N]{};
+
+    // lane i looks from `from` to `to` (any-hit then means "something is in between")
+    void set(int i, Vector3 from, Vector3 to) {
+        Vector3 d = Vector3Subtract(to, from);
+        origin[i] = from;
+        direction[i] = d;
+        maxDistance[i] = Vector3Length(d);
+    }
+};
+
+// ray queries against every collidable box (enabled Collision + WorldTransform), the hitscan/crosshair/LOS service
+// backed by a SAH-built Bvh (32-byte nodes), item boxes are copied in leaf order so leaves read one contiguous range
+// rebuilt when an entity gains or loses a Collision/WorldTransform (Registry::revision) or after invalidate()
+// note: walls that move or toggle Collision in place need invalidate()
+class RaycastQuery : public ISystem {
+private:
+    struct Item {
+        Entity entity;
+        bool isWall;
+        Wall::Side side;
+    };
+
+    Bvh bvh;
+    std::vector<BoundingBox> ordered; // leaf order (bvh item indices resolved)
+    std::vector<Item> items;          // leaf order
+    bool rebuildPending = true;
+    uint64_t lastTransformRevision = 0;
+    uint64_t lastCollisionRevision = 0;
+
+    static Vector3 Inverse(Vector3 d) {
+        return Vector3{ 1.0f / d.x, 1.0f / d.y, 1.0f / d.z }; // +-inf for axis-parallel rays, the slabs handle it
+    }
+
+    // entry distance of the ray into box (0 if it starts inside), INFINITY if it misses or enters at/after tMax
+    static float Slab(const Vector3& mn, const Vector3& mx, Vector3 o, Vector3 inv, float tMax) {
+        float tx1 = (mn.x - o.x) * inv.x, tx2 = (mx.x - o.x) * inv.x;
+        float ty1 = (mn.y - o.y) * inv.y, ty2 = (mx.y - o.y) * inv.y;
+        float tz1 = (mn.z - o.z) * inv.z, tz2 = (mx.z - o.z) * inv.z;
+        // std::min/max, not fminf/fmaxf: those are NaN-aware library calls unless -ffast-math
+        float tNear = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.0f));
+        float tFar = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::max(tz1, tz2));
+        return tNear <= tFar && tNear < tMax ? tNear : INFINITY;
+    }
+
+    // closest (or, with ANY, first found) item within tBest, tBest shrinks to its distance
+    template <bool ANY>
+    int64_t traverse(Vector3 o, Vector3 inv, float& tBest) const {
+        const std::vector<BvhNode>& nodes = bvh.getNodes();
+        if (nodes.empty()) return -1;
+        struct Entry { uint32_t node; float t; };
+        Entry stack[64];
+        int top = 0;
+        float t = Slab(nodes[0].min, nodes[0].max, o, inv, tBest);
+        if (t == INFINITY) return -1;
+        stack[top++] = { 0, t };
+
+        int64_t best = -1;
+        while (top > 0) {
+            Entry entry = stack[--top];
+            if (entry.t >= tBest) continue; // a closer hit was found since this was pushed
+            const BvhNode& node = nodes[entry.node];
+            if (node.isLeaf()) {
+                for (uint32_t k = node.leftFirst; k < node.leftFirst + node.count; ++k) {
+                    float tk = Slab(ordered[k].min, ordered[k].max, o, inv, tBest);
+                    if (tk == INFINITY) continue;
+                    tBest = tk;
+                    best = k;
+                    if constexpr (ANY) return best;
+                }
+                continue;
+            }
+            // nearer child goes on top
+            uint32_t l = node.leftFirst;
+            float tl = Slab(nodes[l].min, nodes[l].max, o, inv, tBest);
+            float tr = Slab(nodes[l + 1].min, nodes[l + 1].max, o, inv, tBest);
+            Entry nearChild{ l, tl }, farChild{ l + 1, tr };
+            if (tr < tl) std::swap(nearChild, farChild);
+            if (farChild.t != INFINITY) stack[top++] = farChild;
+            if (nearChild.t != INFINITY) stack[top++] = nearChild;
+        }
+        return best;
+    }
+
+    RayHit makeHit(int64_t k, Vector3 o, Vector3 d, float t) const {
+        RayHit hit;
+        if (k < 0) return hit;
+        const Item& item = items[k];
+        hit.entity = item.entity;
+        hit.isWall = item.isWall;
+        hit.side = item.side;
+        hit.distance = t;
+        hit.point = Vector3Add(o, Vector3Scale(d, t));
+        if (t > 0.0f) {
+            // the face hit is on the axis the ray entered last
+            const BoundingBox& b = ordered[k];
+            float best = -INFINITY;
+            int axis = 0;
+            const float oa[3] = { o.x, o.y, o.z }, da[3] = { d.x, d.y, d.z };
+            const float lo[3] = { b.min.x, b.min.y, b.min.z }, hi[3] = { b.max.x, b.max.y, b.max.z };
+            for (int a = 0; a < 3; ++a) {
+                if (da[a] == 0.0f) continue;
+                float tn = ((da[a] > 0 ? lo[a] : hi[a]) - oa[a]) / da[a];
+                if (tn > best) {
+                    best = tn;
+                    axis = a;
+                }
+            }
+            float n = da[axis] > 0 ? -1.0f : 1.0f;
+            hit.normal = axis == 0 ? Vector3{ n, 0, 0 } : axis == 1 ? Vector3{ 0, n, 0 } : Vector3{ 0, 0, n };
+        }
+        return hit;
+    }
+
+#ifdef RAYCAST_SSE
+    // 4 rays per group, G groups per packet
+    template <int G>
+    struct Lanes {
+        __m128 ox[G], oy[G], oz[G], ix[G], iy[G], iz[G];
+        __m128 best[G];      // tMax, shrinks to the closest hit
+        __m128i index[G];    // leaf-order item per lane, -1 = none
+        __m128 active[G];    // any-hit: lanes still looking
+    };
+
+    // per lane: entry distance into the box, mask of lanes that hit it before their best
+    static __m128 SlabMask(const Vector3& mn, const Vector3& mx, __m128 ox, __m128 oy, __m128 oz, __m128 ix, __m128 iy,
+                           __m128 iz, __m128 best, __m128& tNear) {
+        __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(mn.x), ox), ix);
+        __m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(mx.x), ox), ix);
+        __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(mn.y), oy), iy);
+        __m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(mx.y), oy), iy);
+        __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(mn.z), oz), iz);
+        __m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(mx.z), oz), iz);
+        tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)), _mm_max_ps(_mm_min_ps(tz1, tz2), _mm_setzero_ps()));
+        __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)), _mm_max_ps(tz1, tz2));
+        return _mm_and_ps(_mm_cmple_ps(tNear, tFar), _mm_cmplt_ps(tNear, best));
+    }
+
+    template <bool ANY, int N>
+    void traversePacket(const RayPacket<N>& packet, Vector3 (&dir)[N], float (&tOut)[N], int64_t (&indexOut)[N]) const {
+        constexpr int G = N / 4;
+        Lanes<G> lanes;
+        for (int g = 0; g < G; ++g) {
+            float ox[4], oy[4], oz[4], ix[4], iy[4], iz[4], tm[4];
+            for (int l = 0; l < 4; ++l) {
+                int r = g * 4 + l;
+                Vector3 inv = Inverse(dir[r]);
+                ox[l] = packet.origin[r].x; oy[l] = packet.origin[r].y; oz[l] = packet.origin[r].z;
+                ix[l] = inv.x; iy[l] = inv.y; iz[l] = inv.z;
+                tm[l] = packet.maxDistance[r] > 0.0f ? packet.maxDistance[r] : -1.0f; // unused lanes never hit
+            }
+            lanes.ox[g] = _mm_loadu_ps(ox); lanes.oy[g] = _mm_loadu_ps(oy); lanes.oz[g] = _mm_loadu_ps(oz);
+            lanes.ix[g] = _mm_loadu_ps(ix); lanes.iy[g] = _mm_loadu_ps(iy); lanes.iz[g] = _mm_loadu_ps(iz);
+            lanes.best[g] = _mm_loadu_ps(tm);
+            lanes.index[g] = _mm_set1_epi32(-1);
+            lanes.active[g] = _mm_cmpgt_ps(lanes.best[g], _mm_setzero_ps());
+        }
+
+        const std::vector<BvhNode>& nodes = bvh.getNodes();
+        uint32_t stack[64];
+        int top = 0;
+        if (!nodes.empty()) stack[top++] = 0;
+        const Vector3 lead = dir[0]; // children are ordered along the first ray
+        while (top > 0) {
+            const BvhNode& node = nodes[stack[--top]];
+            bool any = false;
+            for (int g = 0; g < G && !any; ++g) {
+                __m128 tNear;
+                __m128 m = _mm_and_ps(SlabMask(node.min, node.max, lanes.ox[g], lanes.oy[g], lanes.oz[g], lanes.ix[g],
+                                               lanes.iy[g], lanes.iz[g], lanes.best[g], tNear), lanes.active[g]);
+                any = _mm_movemask_ps(m) != 0;
+            }
+            if (!any) continue;
+
+            if (!node.isLeaf()) {
+                uint32_t l = node.leftFirst;
+                Vector3 cl = BoundsCenter(nodes[l].bounds()), cr = BoundsCenter(nodes[l + 1].bounds());
+                bool rightFirst = Vector3DotProduct(Vector3Subtract(cr, cl), lead) < 0.0f;
+                stack[top++] = rightFirst ? l : l + 1;
+                stack[top++] = rightFirst ? l + 1 : l;
+                continue;
+            }
+
+            bool done = true;
+            for (uint32_t k = node.leftFirst; k < node.leftFirst + node.count; ++k) {
+                const __m128i kk = _mm_set1_epi32(static_cast<int>(k));
+                for (int g = 0; g < G; ++g) {
+                    __m128 tNear;
+                    __m128 m = _mm_and_ps(SlabMask(ordered[k].min, ordered[k].max, lanes.ox[g], lanes.oy[g], lanes.oz[g],
+                                                   lanes.ix[g], lanes.iy[g], lanes.iz[g], lanes.best[g], tNear), lanes.active[g]);
+                    lanes.best[g] = _mm_or_ps(_mm_and_ps(m, tNear), _mm_andnot_ps(m, lanes.best[g]));
+                    __m128i mi = _mm_castps_si128(m);
+                    lanes.index[g] = _mm_or_si128(_mm_and_si128(mi, kk), _mm_andnot_si128(mi, lanes.index[g]));
+                    if constexpr (ANY) lanes.active[g] = _mm_andnot_ps(m, lanes.active[g]);
+                }
+            }
+            if constexpr (ANY) {
+                for (int g = 0; g < G; ++g) done = done && _mm_movemask_ps(lanes.active[g]) == 0;
+                if (done) break; // every ray is blocked
+            }
+        }
+
+        for (int g = 0; g < G; ++g) {
+            alignas(16) float t[4];
+            alignas(16) int32_t idx[4];
+            _mm_store_ps(t, lanes.best[g]);
+            _mm_store_si128(reinterpret_cast<__m128i*>(idx), lanes.index[g]);
+            for (int l = 0; l < 4; ++l) {
+                tOut[g * 4 + l] = t[l];
+                indexOut[g * 4 + l] = idx[l];
+            }
+        }
+    }
+#endif
+
+public:
+    uint32_t maxLeafSize = 4;
+
+    void invalidate() { rebuildPending = true; }
+
+    void rebuild(const Registry& reg) {
+        std::vector<BoundingBox> bounds;
+        std::vector<Item> source;
+        for (const auto& [e, wt] : reg.view<WorldTransform>()) {
+            auto collision = reg.get<Collision>(e);
+            if (!collision || !collision->isEnabled()) continue;
+            auto wall = reg.get<Wall>(e);
+            bounds.push_back(BoundsFromTransform(*wt));
+            source.push_back(Item{ e, wall != nullptr, wall ? wall->side : Wall::Side::Front });
+        }
+        bvh.build(bounds, maxLeafSize, BvhSplit::Sah);
+
+        const std::vector<uint32_t>& order = bvh.getItemIndices();
+        ordered.resize(order.size());
+        items.resize(order.size());
+        for (size_t k = 0; k < order.size(); ++k) {
+            ordered[k] = bounds[order[k]];
+            items[k] = source[order[k]];
+        }
+
+        lastTransformRevision = reg.revision<WorldTransform>();
+        lastCollisionRevision = reg.revision<Collision>();
+        rebuildPending = false;
+    }
+
+    void update(Registry& reg, float deltaTime = 0.0f) override {
+        if (rebuildPending || reg.revision<WorldTransform>() != lastTransformRevision || reg.revision<Collision>() != lastCollisionRevision)
+            rebuild(reg);
+    }
+
+    // nearest box along the ray within maxDistance (the direction doesn't have to be normalized)
+    [[nodiscard]] RayHit closest(Ray ray, float maxDistance = INFINITY) const {
+        Vector3 d = Vector3Normalize(ray.direction);
+        float t = maxDistance;
+        int64_t k = traverse<false>(ray.position, Inverse(d), t);
+        return makeHit(k, ray.position, d, t);
+    }
+
+    // true if anything is within maxDistance along the ray (stops at the first box found, not the nearest)
+    [[nodiscard]] bool any(Ray ray, float maxDistance = INFINITY) const {
+        Vector3 d = Vector3Normalize(ray.direction);
+        float t = maxDistance;
+        return traverse<true>(ray.position, Inverse(d), t) >= 0;
+    }
+
+    // true if nothing collidable is between the two points
+    [[nodiscard]] bool lineOfSight(Vector3 from, Vector3 to) const {
+        Vector3 d = Vector3Subtract(to, from);
+        return !any(Ray{ from, d }, Vector3Length(d));
+    }
+
+    // closest hit for every ray of the packet
+    template <int N>
+    void closest(const RayPacket<N>& packet, RayHit (&out)[N]) const {
+        Vector3 dir[N];
+        for (int i = 0; i < N; ++i) dir[i] = Vector3Normalize(packet.direction[i]);
+#ifdef RAYCAST_SSE
+        float t[N];
+        int64_t index[N];
+        traversePacket<false>(packet, dir, t, index);
+        for (int i = 0; i < N; ++i) out[i] = makeHit(index[i], packet.origin[i], dir[i], t[i]);
+#else
+        for (int i = 0; i < N; ++i) {
+            float t = packet.maxDistance[i] > 0.0f ? packet.maxDistance[i] : -1.0f;
+            out[i] = t > 0.0f ? makeHit(traverse<false>(packet.origin[i], Inverse(dir[i]), t), packet.origin[i], dir[i], t) : RayHit{};
+        }
+#endif
+    }
+
+    // bit i set = ray i hit something within its maxDistance (for line of sight: blocked)
+    template <int N>
+    [[nodiscard]] uint32_t any(const RayPacket<N>& packet) const {
+        Vector3 dir[N];
+        for (int i = 0; i < N; ++i) dir[i] = Vector3Normalize(packet.direction[i]);
+        uint32_t mask = 0;
+#ifdef RAYCAST_SSE
+        float t[N];
+        int64_t index[N];
+        traversePacket<true>(packet, dir, t, index);
+        for (int i = 0; i < N; ++i)
+            if (index[i] >= 0) mask |= 1u << i;
+#else
+        for (int i = 0; i < N; ++i) {
+            float t = packet.maxDistance[i];
+            if (t > 0.0f && traverse<true>(packet.origin[i], Inverse(dir[i]), t) >= 0) mask |= 1u << i;
+        }
+#endif
+        return mask;
+    }
+
+    [[nodiscard]] size_t boxCount() const { return ordered.size(); }
+    [[nodiscard]] const Bvh& getBvh() const { return bvh; }
+};
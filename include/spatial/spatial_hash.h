@@ -0,0 +1,187 @@
+#pragma once
+#include "raylib.h"
+#include "bounds.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// uniform grid over world-space boxes, only the cells something touches are stored (hashed by cell coordinate)
+// items are referenced by the id insert() returned... ids are reused after remove()
+// note: unlike Bvh this is meant to be updated in place, moving an item only touches the cells it enters/leaves
+class SpatialHash {
+public:
+    static constexpr uint32_t INVALID = UINT32_MAX;
+
+private:
+    struct CellRange {
+        int x0, y0, z0, x1, y1, z1; // inclusive
+
+        bool operator==(const CellRange&) const = default;
+        size_t cellCount() const { return size_t(x1 - x0 + 1) * size_t(y1 - y0 + 1) * size_t(z1 - z0 + 1); }
+    };
+
+    struct Item {
+        BoundingBox box;
+        CellRange cells;
+        uint32_t stamp = 0;
+        bool live = false;
+        bool oversized = false; // too many cells: kept in a plain list instead
+    };
+
+    float cellSize;
+    float invCellSize;
+    size_t maxCellsPerItem;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+    std::vector<Item> items;
+    std::vector<uint32_t> freeIds;
+    std::vector<uint32_t> oversized;
+    size_t liveCount = 0;
+    uint32_t queryStamp = 0;
+
+    // 21 bits per axis, enough for +-1M cells
+    static uint64_t CellKey(int x, int y, int z) {
+        constexpr uint64_t MASK = (1u << 21) - 1;
+        return (uint64_t(x) & MASK) | ((uint64_t(y) & MASK) << 21) | ((uint64_t(z) & MASK) << 42);
+    }
+
+    int cellCoord(float v) const { return static_cast<int>(floorf(v * invCellSize)); }
+
+    CellRange rangeOf(const BoundingBox& box) const {
+        return CellRange{ cellCoord(box.min.x), cellCoord(box.min.y), cellCoord(box.min.z),
+                          cellCoord(box.max.x), cellCoord(box.max.y), cellCoord(box.max.z) };
+    }
+
+    template <typename Fn>
+    static void ForEachCell(const CellRange& r, Fn&& fn) {
+        for (int z = r.z0; z <= r.z1; ++z)
+            for (int y = r.y0; y <= r.y1; ++y)
+                for (int x = r.x0; x <= r.x1; ++x) fn(CellKey(x, y, z));
+    }
+
+    void link(uint32_t id) {
+        Item& item = items[id];
+        item.oversized = item.cells.cellCount() > maxCellsPerItem;
+        if (item.oversized) {
+            oversized.push_back(id);
+            return;
+        }
+        ForEachCell(item.cells, [&](uint64_t key) { cells[key].push_back(id); });
+    }
+
+    void unlink(uint32_t id) {
+        Item& item = items[id];
+        auto drop = [id](std::vector<uint32_t>& list) {
+            auto it = std::find(list.begin(), list.end(), id);
+            if (it != list.end()) {
+                *it = list.back();
+                list.pop_back();
+            }
+        };
+        if (item.oversized) {
+            drop(oversized);
+            return;
+        }
+        ForEachCell(item.cells, [&](uint64_t key) {
+            auto cell = cells.find(key);
+            if (cell == cells.end()) return;
+            drop(cell->second);
+            if (cell->second.empty()) cells.erase(cell);
+        });
+    }
+
+public:
+    // cellSize: big enough that a typical item only touches a few cells, small enough that a cell holds only a few
+    // items covering more than maxCellsPerItem cells are tested on every query instead of being bucketed
+    explicit SpatialHash(float cellSize = 16.0f, size_t maxCellsPerItem = 4096)
+        : cellSize(cellSize), invCellSize(1.0f / cellSize), maxCellsPerItem(maxCellsPerItem) {}
+
+    uint32_t insert(const BoundingBox& box) {
+        uint32_t id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+        } else {
+            id = static_cast<uint32_t>(items.size());
+            items.emplace_back();
+        }
+        Item& item = items[id];
+        item.box = box;
+        item.cells = rangeOf(box);
+        item.live = true;
+        link(id);
+        liveCount++;
+        return id;
+    }
+
+    void remove(uint32_t id) {
+        if (id >= items.size() || !items[id].live) return;
+        unlink(id);
+        items[id].live = false;
+        freeIds.push_back(id);
+        liveCount--;
+    }
+
+    // cheap when the box stays within the same cells (only the stored box changes)
+    void update(uint32_t id, const BoundingBox& box) {
+        if (id >= items.size() || !items[id].live) return;
+        CellRange range = rangeOf(box);
+        if (range != items[id].cells) {
+            unlink(id);
+            items[id].cells = range;
+            link(id);
+        }
+        items[id].box = box;
+    }
+
+    // calls fn(id, box) once for every item overlapping box
+    template <typename Fn>
+    void query(const BoundingBox& box, Fn&& fn) {
+        if (++queryStamp == 0) { // wrapped: old stamps could collide
+            for (Item& item : items) item.stamp = 0;
+            queryStamp = 1;
+        }
+        auto visit = [&](uint32_t id) {
+            Item& item = items[id];
+            if (item.stamp == queryStamp) return;
+            item.stamp = queryStamp;
+            if (BoundsOverlap(item.box, box)) fn(id, item.box);
+        };
+
+        CellRange range = rangeOf(box);
+        if (range.cellCount() <= cells.size()) {
+            ForEachCell(range, [&](uint64_t key) {
+                auto cell = cells.find(key);
+                if (cell == cells.end()) return;
+                for (uint32_t id : cell->second) visit(id);
+            });
+        } else {
+            // huge query: walking the stored cells is cheaper than probing every covered one
+            for (const auto& [key, list] : cells)
+                for (uint32_t id : list) visit(id);
+        }
+        for (uint32_t id : oversized) visit(id);
+    }
+
+    // room for n items (and roughly as many cells) without rehashing
+    void reserve(size_t n) {
+        items.reserve(n);
+        cells.reserve(n);
+    }
+
+    void clear() {
+        cells.clear();
+        items.clear();
+        freeIds.clear();
+        oversized.clear();
+        liveCount = 0;
+    }
+
+    [[nodiscard]] const BoundingBox& bounds(uint32_t id) const { return items[id].box; }
+    [[nodiscard]] bool contains(uint32_t id) const { return id < items.size() && items[id].live; }
+    [[nodiscard]] size_t size() const { return liveCount; }
+    [[nodiscard]] size_t cellCount() const { return cells.size(); }
+    [[nodiscard]] size_t oversizedCount() const { return oversized.size(); }
+    [[nodiscard]] float getCellSize() const { return cellSize; }
+};
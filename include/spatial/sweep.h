@@ -0,0 +1,184 @@
+#pragma once
+#include "raylib.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SWEEP_SSE 1
+#endif
+
+// swept AABB vs AABB (time of impact): the moving box is shrunk to a point and every wall grown by its half extents,
+// so each test is a ray (p, p + delta) against a box with slabs
+struct SweepHit {
+    float time = 1.0f;   // fraction of delta travelled before touching
+    int axis = -1;       // -1 = no hit
+    float sign = 0.0f;   // side of the wall that was hit along axis (-1 = its min face)
+    uint32_t index = 0;  // candidate index
+
+    bool hit() const { return axis >= 0; }
+};
+
+namespace sweep {
+
+// one axis of the slab test... a zero delta can't enter or leave, it's either inside the slab all along or never
+inline bool Slab(float p, float d, float lo, float hi, float& tNear, float& tFar) {
+    if (d == 0.0f) {
+        tNear = -INFINITY;
+        tFar = INFINITY;
+        return p > lo && p < hi;
+    }
+    float inv = 1.0f / d;
+    float t1 = (lo - p) * inv;
+    float t2 = (hi - p) * inv;
+    tNear = t1 < t2 ? t1 : t2;
+    tFar = t1 < t2 ? t2 : t1;
+    return true;
+}
+
+} // namespace sweep
+
+// scalar reference: point p moving by delta against an (already grown) box
+// hits entering within [0, 1] count... a point up to `tolerance` past the face it enters through counts as touching
+// it (hit at time 0, rounding far from the origin can put a resting player a hair inside), anything deeper is the
+// depenetration's problem
+inline SweepHit SweepPoint(Vector3 p, Vector3 delta, const BoundingBox& grown, float tolerance = 0.0f) {
+    SweepHit hit;
+    float nearT[3], farT[3];
+    const float pa[3] = { p.x, p.y, p.z };
+    const float da[3] = { delta.x, delta.y, delta.z };
+    const float lo[3] = { grown.min.x, grown.min.y, grown.min.z };
+    const float hi[3] = { grown.max.x, grown.max.y, grown.max.z };
+    float tEnter = -INFINITY, tExit = INFINITY, depth = 0.0f;
+    int axis = -1;
+    for (int a = 0; a < 3; ++a) {
+        if (!sweep::Slab(pa[a], da[a], lo[a], hi[a], nearT[a], farT[a])) return hit;
+        if (nearT[a] > tEnter) {
+            tEnter = nearT[a];
+            depth = -nearT[a] * fabsf(da[a]);
+            axis = a;
+        }
+        tExit = fminf(tExit, farT[a]);
+    }
+    if (axis < 0 || tEnter > 1.0f || tEnter >= tExit || tExit <= 0.0f) return hit;
+    if (tEnter < 0.0f && depth > tolerance) return hit;
+
+    hit.time = fmaxf(tEnter, 0.0f);
+    hit.axis = axis;
+    hit.sign = da[axis] > 0 ? -1.0f : 1.0f; // moving +x enters through the min face
+    return hit;
+}
+
+// broadphase candidates for one move, grown by the mover's half extents and kept as structure-of-arrays
+// so first() can test four of them per instruction
+class SweepCandidates {
+private:
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+public:
+    void clear() {
+        minX.clear(); minY.clear(); minZ.clear();
+        maxX.clear(); maxY.clear(); maxZ.clear();
+    }
+
+    void add(const BoundingBox& box, Vector3 half) {
+        minX.push_back(box.min.x - half.x);
+        minY.push_back(box.min.y - half.y);
+        minZ.push_back(box.min.z - half.z);
+        maxX.push_back(box.max.x + half.x);
+        maxY.push_back(box.max.y + half.y);
+        maxZ.push_back(box.max.z + half.z);
+    }
+
+    [[nodiscard]] size_t size() const { return minX.size(); }
+    [[nodiscard]] BoundingBox grown(size_t i) const {
+        return BoundingBox{ Vector3{ minX[i], minY[i], minZ[i] }, Vector3{ maxX[i], maxY[i], maxZ[i] } };
+    }
+
+    // earliest hit along p -> p + delta (ties go to the lowest index, same on every path)
+    [[nodiscard]] SweepHit first(Vector3 p, Vector3 delta, float tolerance = 0.0f) const {
+        SweepHit best;
+        const size_t n = size();
+        size_t i = 0;
+#ifdef SWEEP_SSE
+        // per axis: a moving axis gives near/far times, a still one only a pass/fail "inside the slab" mask
+        const float pa[3] = { p.x, p.y, p.z };
+        const float da[3] = { delta.x, delta.y, delta.z };
+        const std::vector<float>* lo[3] = { &minX, &minY, &minZ };
+        const std::vector<float>* hi[3] = { &maxX, &maxY, &maxZ };
+        __m128 pos[3], inv[3], absd[3];
+        for (int a = 0; a < 3; ++a) {
+            pos[a] = _mm_set1_ps(pa[a]);
+            inv[a] = _mm_set1_ps(da[a] != 0.0f ? 1.0f / da[a] : 0.0f);
+            absd[a] = _mm_set1_ps(fabsf(da[a]));
+        }
+        const __m128 tol = _mm_set1_ps(tolerance);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        __m128 bestT = _mm_set1_ps(INFINITY);
+        __m128i bestIndex = _mm_set1_epi32(-1);
+        __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i four = _mm_set1_epi32(4);
+
+        for (; i + 4 <= n; i += 4, index = _mm_add_epi32(index, four)) {
+            __m128 tEnter = _mm_set1_ps(-INFINITY);
+            __m128 tExit = _mm_set1_ps(INFINITY);
+            __m128 depth = zero;
+            __m128 valid = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int a = 0; a < 3; ++a) {
+                __m128 l = _mm_loadu_ps(lo[a]->data() + i);
+                __m128 h = _mm_loadu_ps(hi[a]->data() + i);
+                if (da[a] == 0.0f) {
+                    valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(pos[a], l), _mm_cmplt_ps(pos[a], h)));
+                    continue;
+                }
+                __m128 t1 = _mm_mul_ps(_mm_sub_ps(l, pos[a]), inv[a]);
+                __m128 t2 = _mm_mul_ps(_mm_sub_ps(h, pos[a]), inv[a]);
+                __m128 tNear = _mm_min_ps(t1, t2);
+                __m128 later = _mm_cmpgt_ps(tNear, tEnter);
+                tEnter = _mm_or_ps(_mm_and_ps(later, tNear), _mm_andnot_ps(later, tEnter));
+                __m128 past = _mm_sub_ps(zero, _mm_mul_ps(tNear, absd[a]));
+                depth = _mm_or_ps(_mm_and_ps(later, past), _mm_andnot_ps(later, depth));
+                tExit = _mm_min_ps(tExit, _mm_max_ps(t1, t2));
+            }
+            valid = _mm_and_ps(valid, _mm_cmple_ps(tEnter, one));
+            valid = _mm_and_ps(valid, _mm_cmplt_ps(tEnter, tExit));
+            valid = _mm_and_ps(valid, _mm_cmpgt_ps(tExit, zero));
+            valid = _mm_and_ps(valid, _mm_or_ps(_mm_cmpge_ps(tEnter, zero), _mm_cmple_ps(depth, tol)));
+            tEnter = _mm_max_ps(tEnter, zero);
+            // strictly earlier only, so each lane keeps its lowest index on ties
+            __m128 better = _mm_and_ps(valid, _mm_cmplt_ps(tEnter, bestT));
+            bestT = _mm_or_ps(_mm_and_ps(better, tEnter), _mm_andnot_ps(better, bestT));
+            __m128i betterI = _mm_castps_si128(better);
+            bestIndex = _mm_or_si128(_mm_and_si128(betterI, index), _mm_andnot_si128(betterI, bestIndex));
+        }
+
+        alignas(16) float laneT[4];
+        alignas(16) int32_t laneIndex[4];
+        _mm_store_ps(laneT, bestT);
+        _mm_store_si128(reinterpret_cast<__m128i*>(laneIndex), bestIndex);
+        int32_t found = -1;
+        float foundT = INFINITY;
+        for (int l = 0; l < 4; ++l) {
+            if (laneIndex[l] < 0) continue;
+            if (laneT[l] < foundT || (laneT[l] == foundT && laneIndex[l] < found)) {
+                foundT = laneT[l];
+                found = laneIndex[l];
+            }
+        }
+        if (found >= 0) {
+            best = SweepPoint(p, delta, grown(found), tolerance); // axis + side, same math as the lanes
+            best.index = static_cast<uint32_t>(found);
+        }
+#endif
+        for (; i < n; ++i) {
+            SweepHit hit = SweepPoint(p, delta, grown(i), tolerance);
+            if (hit.hit() && (!best.hit() || hit.time < best.time)) {
+                best = hit;
+                best.index = static_cast<uint32_t>(i);
+            }
+        }
+        return best;
+    }
+};
@@ -0,0 +1,185 @@
+#pragma once
+#include "raylib.h"
+#include "managed_texture.h"
+#include "texture_handle.h"
+#include "async_texture_loader.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+// FNV-1a, for content keys of in-memory images
+inline uint64_t HashBytes(const void* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// owns every texture in the game and hands out TextureHandles
+// - files are keyed by their normalized path, in-memory images by a hash of their pixels, so nothing is loaded twice
+// - components only store the handle (plain integer, no atomic refcount on copies)
+// - owners (levels, atlases, ...) take a reference per handle they keep... release() only drops the count,
+//   textures are unloaded in collect(), called at a safe point (end of frame) when no draw can be using them
+class AssetCache {
+private:
+    struct Slot {
+        std::shared_ptr<ManagedTexture> texture; // shared with AsyncTextureLoader while it is still uploading
+        std::string key;
+        uint32_t refs = 0;
+        uint32_t generation = 0;
+        bool live = false;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> byKey;
+    AsyncTextureLoader* loader = nullptr;
+
+    const Slot* resolve(TextureHandle h) const {
+        if (!h.valid() || h.index() >= slots.size()) return nullptr;
+        const Slot& slot = slots[h.index()];
+        return slot.live && (slot.generation & 0xFFF) == h.generation() ? &slot : nullptr;
+    }
+
+    Slot* resolve(TextureHandle h) { return const_cast<Slot*>(std::as_const(*this).resolve(h)); }
+
+    TextureHandle insert(const std::string& key, std::shared_ptr<ManagedTexture> texture) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        Slot& slot = slots[index];
+        slot.texture = std::move(texture);
+        slot.key = key;
+        slot.refs = 1;
+        slot.live = true;
+        byKey[key] = index;
+        return TextureHandle(index, slot.generation);
+    }
+
+    // existing entry: one more reference
+    TextureHandle share(const std::string& key) {
+        auto it = byKey.find(key);
+        if (it == byKey.end()) return TextureHandle{};
+        Slot& slot = slots[it->second];
+        slot.refs++;
+        return TextureHandle(it->second, slot.generation);
+    }
+
+public:
+    AssetCache() = default;
+    explicit AssetCache(AsyncTextureLoader* asyncLoader) : loader(asyncLoader) {}
+
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    // with a loader, loadTexture() returns immediately and the texture shows the loader's placeholder until it lands
+    void setLoader(AsyncTextureLoader* asyncLoader) { loader = asyncLoader; }
+
+    static std::string NormalizePath(const std::string& path) {
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+
+    // +1 reference... loads the file only the first time its path is seen
+    TextureHandle loadTexture(const std::string& path, const TextureLoadOptions& options = {}) {
+        std::string key = NormalizePath(path);
+        if (TextureHandle h = share(key)) return h;
+        // cooked textures are one read and a direct upload, nothing to gain from the loader's workers
+        auto texture = loader && !IsCookedTexturePath(key.c_str()) ? loader->load(key, options)
+                                                                   : std::make_shared<ManagedTexture>(key.c_str());
+        return insert(key, std::move(texture));
+    }
+
+    // +1 reference... registers a texture made elsewhere (e.g. an atlas) under `key`, or shares the existing one
+    TextureHandle addTexture(const std::string& key, std::shared_ptr<ManagedTexture> texture) {
+        if (TextureHandle h = share(key)) return h;
+        return insert(key, std::move(texture));
+    }
+
+    // +1 reference... uploads an in-memory image unless one with the same pixels is already cached
+    TextureHandle addImage(const Image& image) {
+        char key[48];
+        uint64_t hash = HashBytes(image.data, static_cast<size_t>(GetPixelDataSize(image.width, image.height, image.format)));
+        std::snprintf(key, sizeof(key), "mem:%dx%d:%016llx", image.width, image.height, static_cast<unsigned long long>(hash));
+        if (TextureHandle h = share(key)) return h;
+        return insert(key, std::make_shared<ManagedTexture>(image));
+    }
+
+    // no reference taken
+    [[nodiscard]] TextureHandle find(const std::string& key) const {
+        auto it = byKey.find(key);
+        if (it == byKey.end()) return TextureHandle{};
+        return TextureHandle(it->second, slots[it->second].generation);
+    }
+
+    // what find() takes, empty for stale/empty handles (level files store textures by key)
+    [[nodiscard]] std::string keyOf(TextureHandle h) const {
+        const Slot* slot = resolve(h);
+        return slot ? slot->key : std::string{};
+    }
+
+    void retain(TextureHandle h) {
+        if (Slot* slot = resolve(h)) slot->refs++;
+    }
+
+    void release(TextureHandle h) {
+        if (Slot* slot = resolve(h); slot && slot->refs > 0) slot->refs--;
+    }
+
+    // unloads every texture nobody references anymore (or every texture with force), returns how many...
+    // only call between frames
+    size_t collect(bool force = false) {
+        size_t unloaded = 0;
+        for (uint32_t i = 0; i < slots.size(); ++i) {
+            Slot& slot = slots[i];
+            if (!slot.live || (slot.refs > 0 && !force)) continue;
+            byKey.erase(slot.key);
+            slot.texture.reset();
+            slot.key.clear();
+            slot.refs = 0;
+            slot.live = false;
+            slot.generation++; // stale handles to this slot now resolve to nothing
+            freeSlots.push_back(i);
+            unloaded++;
+        }
+        return unloaded;
+    }
+
+    // unloads everything (before CloseWindow())
+    void clear() { collect(true); }
+
+    // the texture to draw: the placeholder while still loading, an empty texture (id 0) for stale/empty handles
+    [[nodiscard]] Texture2D get(TextureHandle h) const {
+        const Slot* slot = resolve(h);
+        return slot ? slot->texture->get() : Texture2D{};
+    }
+
+    [[nodiscard]] const ManagedTexture* texture(TextureHandle h) const {
+        const Slot* slot = resolve(h);
+        return slot ? slot->texture.get() : nullptr;
+    }
+
+    [[nodiscard]] bool isReady(TextureHandle h) const {
+        const Slot* slot = resolve(h);
+        return slot && slot->texture->isReady();
+    }
+
+    [[nodiscard]] uint32_t refCount(TextureHandle h) const {
+        const Slot* slot = resolve(h);
+        return slot ? slot->refs : 0;
+    }
+
+    [[nodiscard]] size_t size() const { return byKey.size(); }
+};
@@ -0,0 +1,222 @@
+#pragma once
+#include "raylib.h"
+#include "rlgl.h"
+#include "managed_texture.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TextureLoadOptions {
+    int maxSize = 0;          // downscale (keeping aspect) so neither side is larger, 0 = keep
+    bool mipmaps = false;     // generate mips once the texture is on the GPU
+    int filter = TEXTURE_FILTER_BILINEAR;
+};
+
+// builds the final image from the decoded files of one request (runs on a worker)
+// gets every file in request order (an empty Image where decoding failed) and owns them
+using TextureComposeFn = std::function<Image(std::vector<Image>& decoded)>;
+
+// file read + decode (+ downscale / compose) on worker threads, GPU upload on the main thread
+// load() hands back a placeholder-backed ManagedTexture right away, update() (once per frame, main thread)
+// streams finished images to the GPU in rows, at most uploadBudget bytes per call, and swaps them in
+// note: needs the window (GL context) for the placeholder and the uploads, so create it after InitWindow()
+class AsyncTextureLoader {
+private:
+    struct Job {
+        std::shared_ptr<ManagedTexture> target;
+        std::vector<std::string> paths;
+        TextureComposeFn compose;
+        TextureLoadOptions options;
+    };
+
+    // a decoded image on its way to the GPU
+    struct Upload {
+        std::shared_ptr<ManagedTexture> target;
+        Image image{};
+        TextureLoadOptions options;
+        unsigned int id = 0; // GPU texture, created on the first slice
+        int nextRow = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;      // waiting for a worker
+    std::deque<Upload> decoded; // waiting for update()
+    std::deque<Upload> uploading; // main thread only: taken by update(), the front one may be partly uploaded
+    size_t decoding = 0;        // jobs a worker is busy with
+    bool stopping = false;
+
+    ManagedTexture placeholder;
+    size_t uploadBudget;
+
+    static Image Decode(const Job& job) {
+        std::vector<Image> images;
+        images.reserve(job.paths.size());
+        for (const std::string& path : job.paths) images.push_back(LoadImage(path.c_str()));
+
+        Image image{};
+        if (job.compose) {
+            image = job.compose(images);
+        } else if (!images.empty()) {
+            image = images.front();
+            for (size_t i = 1; i < images.size(); ++i) UnloadImage(images[i]);
+        }
+        if (image.data == nullptr) return image;
+
+        const int maxSize = job.options.maxSize;
+        if (maxSize > 0 && (image.width > maxSize || image.height > maxSize)) {
+            float scale = static_cast<float>(maxSize) / static_cast<float>(std::max(image.width, image.height));
+            ImageResize(&image, std::max(1, static_cast<int>(image.width * scale)), std::max(1, static_cast<int>(image.height * scale)));
+        }
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8); // rows are uploaded as plain RGBA8
+        return image;
+    }
+
+    void workerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                decoding++;
+            }
+            Image image = Decode(job);
+            {
+                std::lock_guard lock(mutex);
+                decoding--;
+                decoded.push_back(Upload{ std::move(job.target), image, job.options });
+            }
+        }
+    }
+
+    // uploads the next rows of `u` within `budget` bytes, true once the whole image is on the GPU
+    static bool UploadSlice(Upload& u, size_t& budget) {
+        const Image& image = u.image;
+        const size_t rowBytes = static_cast<size_t>(image.width) * 4;
+        if (u.id == 0) {
+            u.id = rlLoadTexture(nullptr, image.width, image.height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+            if (u.id == 0) return true; // nothing more we can do, the placeholder stays
+        }
+
+        // always at least one row so a tiny budget still makes progress
+        int rows = static_cast<int>(std::max<size_t>(1, budget / rowBytes));
+        rows = std::min(rows, image.height - u.nextRow);
+        rlUpdateTexture(u.id, 0, u.nextRow, image.width, rows, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+                        static_cast<const uint8_t*>(image.data) + static_cast<size_t>(u.nextRow) * rowBytes);
+        u.nextRow += rows;
+        budget -= std::min(budget, static_cast<size_t>(rows) * rowBytes);
+        return u.nextRow >= image.height;
+    }
+
+    static void Finish(Upload& u) {
+        if (u.id == 0) return;
+        Texture2D texture{};
+        texture.id = u.id;
+        texture.width = u.image.width;
+        texture.height = u.image.height;
+        texture.mipmaps = 1;
+        texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        if (u.options.mipmaps) rlGenTextureMipmaps(texture.id, texture.width, texture.height, texture.format, &texture.mipmaps);
+        SetTextureFilter(texture, u.options.filter);
+        u.target->adopt(texture);
+    }
+
+public:
+    // threads: decode workers, uploadBudget: bytes handed to the GPU per update()
+    explicit AsyncTextureLoader(unsigned threads = 2, size_t uploadBudget = 8u << 20) : uploadBudget(uploadBudget) {
+        // grey/magenta checker so a missing texture is obvious
+        Image checker = GenImageChecked(64, 64, 8, 8, Color{ 128, 128, 128, 255 }, Color{ 200, 0, 200, 255 });
+        placeholder = ManagedTexture(checker);
+        UnloadImage(checker);
+
+        threads = std::max(1u, threads);
+        for (unsigned i = 0; i < threads; ++i) workers.emplace_back([this] { workerLoop(); });
+    }
+
+    AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+    ~AsyncTextureLoader() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+        for (Upload& u : decoded) UnloadImage(u.image);
+        for (Upload& u : uploading) {
+            if (u.id != 0) rlUnloadTexture(u.id);
+            UnloadImage(u.image);
+        }
+    }
+
+    // queues one file, the returned texture shows the placeholder until update() has uploaded it
+    std::shared_ptr<ManagedTexture> load(const std::string& path, const TextureLoadOptions& options = {}) {
+        auto texture = std::make_shared<ManagedTexture>();
+        load(texture, { path }, nullptr, options);
+        return texture;
+    }
+
+    // queues several files combined into one texture by `compose` (e.g. an atlas), delivered into `target`
+    void load(std::shared_ptr<ManagedTexture> target, std::vector<std::string> paths, TextureComposeFn compose,
+              const TextureLoadOptions& options = {}) {
+        target->setPlaceholder(placeholder.get());
+        {
+            std::lock_guard lock(mutex);
+            jobs.push_back(Job{ std::move(target), std::move(paths), std::move(compose), options });
+        }
+        wake.notify_one();
+    }
+
+    // main thread, once per frame: uploads up to the byte budget, returns how many textures were completed
+    size_t update() {
+        {
+            std::lock_guard lock(mutex);
+            while (!decoded.empty()) {
+                uploading.push_back(std::move(decoded.front()));
+                decoded.pop_front();
+            }
+        }
+
+        size_t completed = 0;
+        size_t budget = uploadBudget;
+        while (!uploading.empty() && budget > 0) {
+            Upload& u = uploading.front();
+            bool done = u.image.data == nullptr || UploadSlice(u, budget); // failed decodes keep the placeholder
+            if (!done) break;
+            Finish(u);
+            UnloadImage(u.image);
+            uploading.pop_front();
+            completed++;
+        }
+        return completed;
+    }
+
+    // nothing queued, decoding or uploading
+    [[nodiscard]] bool idle() {
+        std::lock_guard lock(mutex);
+        return jobs.empty() && decoding == 0 && decoded.empty() && uploading.empty();
+    }
+
+    // blocks until every queued texture is on the GPU (tools/tests, or a loading screen)
+    void finish() {
+        while (!idle()) {
+            if (update() == 0) std::this_thread::yield();
+        }
+    }
+
+    [[nodiscard]] Texture2D getPlaceholder() const { return placeholder.get(); }
+    [[nodiscard]] size_t getUploadBudget() const { return uploadBudget; }
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include "raylib.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// .ctex: a texture cooked offline by tools/texture_cooker (see texture_cooker.h)
+// header, then every mip level back to back (level 0 first), already in the GPU format... exactly the layout
+// raylib expects in Image::data, so loading is one read and LoadTextureFromImage() uploads it as is
+// note: little-endian only, the cooker and the game run on the same kind of machine
+struct CookedTextureHeader {
+    static constexpr uint32_t MAGIC = 0x58455443; // "CTEX"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t mipmaps = 0;
+    int32_t format = 0;   // raylib PixelFormat
+    uint64_t dataSize = 0; // bytes of mip data after the header
+};
+static_assert(sizeof(CookedTextureHeader) == 32);
+
+// in-memory result of cooking, what gets written to a .ctex
+struct CookedTexture {
+    int width = 0;
+    int height = 0;
+    int mipmaps = 0;
+    int format = 0;
+    std::vector<uint8_t> data;
+};
+
+inline bool IsCookedTexturePath(const char* path) {
+    const char* ext = std::strrchr(path, '.');
+    return ext && std::strcmp(ext, ".ctex") == 0;
+}
+
+// bytes of a whole mip chain the way raylib sizes it when uploading (GetPixelDataSize per level, sides halved down
+// to 1, anything under a block is one block)... 0 for anything but the two formats the cooker writes
+inline uint64_t CookedMipChainSize(int width, int height, int mipmaps, int format) {
+    if (format != PIXELFORMAT_COMPRESSED_DXT1_RGB && format != PIXELFORMAT_COMPRESSED_DXT5_RGBA) return 0;
+    if (width <= 0 || height <= 0 || width > 65536 || height > 65536 || mipmaps <= 0 || mipmaps > 17) return 0;
+    const uint64_t bpp = format == PIXELFORMAT_COMPRESSED_DXT1_RGB ? 4 : 8;
+    uint64_t w = static_cast<uint64_t>(width), h = static_cast<uint64_t>(height), total = 0;
+    for (int l = 0; l < mipmaps; ++l) {
+        total += w < 4 && h < 4 ? bpp * 2 : w * h * bpp / 8;
+        w = std::max<uint64_t>(1, w / 2);
+        h = std::max<uint64_t>(1, h / 2);
+    }
+    return total;
+}
+
+inline bool SaveCookedTexture(const CookedTexture& cooked, const char* path) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    CookedTextureHeader header;
+    header.width = cooked.width;
+    header.height = cooked.height;
+    header.mipmaps = cooked.mipmaps;
+    header.format = cooked.format;
+    header.dataSize = cooked.data.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+              std::fwrite(cooked.data.data(), 1, cooked.data.size(), f) == cooked.data.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// reads a .ctex into an Image (with all its mips)... an empty Image if the file is missing or not a .ctex, or if its
+// data doesn't match the mip chain the header describes (the upload would read past it)
+// the pixels are compressed, so only hand it to LoadTextureFromImage()/ManagedTexture, not to Image* functions
+inline Image LoadCookedImage(const char* path) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return Image{};
+
+    Image image{};
+    CookedTextureHeader header;
+    if (std::fread(&header, sizeof(header), 1, f) == 1 && header.magic == CookedTextureHeader::MAGIC &&
+        header.version == CookedTextureHeader::VERSION && header.dataSize > 0 && header.dataSize <= UINT32_MAX &&
+        header.dataSize == CookedMipChainSize(header.width, header.height, header.mipmaps, header.format)) {
+        void* data = MemAlloc(static_cast<unsigned int>(header.dataSize));
+        if (data && std::fread(data, 1, header.dataSize, f) == header.dataSize) {
+            image.data = data;
+            image.width = header.width;
+            image.height = header.height;
+            image.mipmaps = header.mipmaps;
+            image.format = header.format;
+        } else {
+            MemFree(data);
+        }
+    }
+    std::fclose(f);
+    return image;
+}
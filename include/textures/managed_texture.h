@@ -1,15 +1,31 @@
 #pragma once
 #include "raylib.h"
+#include "cooked_texture.h"
 
 // RAII wrapper for raylib textures (no accidental copying)
+// a texture can also start out empty with a placeholder (see AsyncTextureLoader): until the real one is adopted,
+// get() returns the placeholder so walls keep drawing with it
 class ManagedTexture {
 private:
     Texture2D texture{};
+    Texture2D placeholder{}; // not owned
 
 public:
     ManagedTexture() = default;
+    // .ctex (cooked by tools/texture_cooker) goes to the GPU as is, with its mips... anything else through LoadTexture()
     explicit ManagedTexture(const char* filePath) {
-        texture = LoadTexture(filePath);
+        if (IsCookedTexturePath(filePath)) {
+            Image cooked = LoadCookedImage(filePath);
+            if (cooked.data) texture = LoadTextureFromImage(cooked);
+            UnloadImage(cooked);
+        } else {
+            texture = LoadTexture(filePath);
+        }
+    }
+
+    // uploads an image already in memory (the caller still owns/unloads the image)
+    explicit ManagedTexture(const Image& image) {
+        texture = LoadTextureFromImage(image);
     }
 
     // no copying (textures are GPU resources)
@@ -17,7 +33,7 @@ public:
     ManagedTexture& operator=(const ManagedTexture&) = delete;
 
     // move semantics
-    ManagedTexture(ManagedTexture&& other) noexcept : texture(other.texture) {
+    ManagedTexture(ManagedTexture&& other) noexcept : texture(other.texture), placeholder(other.placeholder) {
         other.texture.id = 0;
     }
 
@@ -25,6 +41,7 @@ public:
         if (this != &other) {
             Unload();
             texture = other.texture;
+            placeholder = other.placeholder;
             other.texture.id = 0;
         }
         return *this;
@@ -34,13 +51,25 @@ public:
         Unload();
     }
 
-    // access underlying raylib texture
-    [[nodiscard]] Texture2D get() const { return texture; }
+    // drawn while the real texture is not there yet (owned by whoever set it, must outlive this)
+    void setPlaceholder(Texture2D fallback) { placeholder = fallback; }
+
+    // takes ownership of an uploaded texture, replacing the current one
+    void adopt(Texture2D uploaded) {
+        Unload();
+        texture = uploaded;
+    }
+
+    [[nodiscard]] bool isReady() const { return texture.id != 0; }
+
+    // access underlying raylib texture (the placeholder until ready)
+    [[nodiscard]] Texture2D get() const { return texture.id != 0 ? texture : placeholder; }
 
 private:
     void Unload() {
         if (texture.id != 0) {
             UnloadTexture(texture);
         }
+        texture = Texture2D{};
     }
 };
@@ -0,0 +1,164 @@
+#pragma once
+#include "raylib.h"
+#include "managed_texture.h"
+#include "async_texture_loader.h"
+#include "asset_cache.h"
+#include "../ecs/components.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// where each tile of a TextureAtlas sits, in pixels
+// tiles are square and all the same size, laid out row by row in a near-square grid...
+// every tile has `padding` pixels of its own edge repeated around it so filtering never reads a neighbour
+struct AtlasLayout {
+    int tileSize = 0;
+    int padding = 0;
+    int columns = 0;
+    int rows = 0;
+
+    AtlasLayout() = default;
+    AtlasLayout(int tiles, int size, int pad) : tileSize(size), padding(pad) {
+        if (tiles <= 0) return;
+        columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(tiles))));
+        rows = (tiles + columns - 1) / columns;
+    }
+
+    [[nodiscard]] int cellSize() const { return tileSize + 2 * padding; }
+    [[nodiscard]] int width() const { return columns * cellSize(); }
+    [[nodiscard]] int height() const { return rows * cellSize(); }
+
+    // the tile itself (without its padding)
+    [[nodiscard]] Rectangle source(int tile) const {
+        return Rectangle{
+            static_cast<float>((tile % columns) * cellSize() + padding),
+            static_cast<float>((tile / columns) * cellSize() + padding),
+            static_cast<float>(tileSize),
+            static_cast<float>(tileSize)
+        };
+    }
+
+    // normalized uv rect with v flipped, so a tile maps onto a face the way DrawCubeTexture() maps a whole texture
+    [[nodiscard]] Rectangle uv(int tile) const {
+        Rectangle s = source(tile);
+        float w = static_cast<float>(width()), h = static_cast<float>(height());
+        return Rectangle{ s.x / w, (s.y + s.height) / h, s.width / w, -s.height / h };
+    }
+};
+
+// copies a tileSize x tileSize RGBA8 tile into the atlas at its cell and fills the padding by clamping to its edges
+inline void BlitAtlasTile(const AtlasLayout& layout, int tile, const uint8_t* tilePixels, uint8_t* atlasPixels) {
+    const int size = layout.tileSize;
+    const int pad = layout.padding;
+    const int cell = layout.cellSize();
+    const size_t atlasStride = static_cast<size_t>(layout.width()) * 4;
+    const int cellX = (tile % layout.columns) * cell;
+    const int cellY = (tile / layout.columns) * cell;
+
+    for (int y = 0; y < cell; ++y) {
+        int srcY = std::clamp(y - pad, 0, size - 1);
+        const uint8_t* srcRow = tilePixels + static_cast<size_t>(srcY) * size * 4;
+        uint8_t* dstRow = atlasPixels + static_cast<size_t>(cellY + y) * atlasStride + static_cast<size_t>(cellX) * 4;
+
+        for (int x = 0; x < pad; ++x) std::memcpy(dstRow + x * 4, srcRow, 4);
+        std::memcpy(dstRow + pad * 4, srcRow, static_cast<size_t>(size) * 4);
+        for (int x = 0; x < pad; ++x) std::memcpy(dstRow + (pad + size + x) * 4, srcRow + (size - 1) * 4, 4);
+    }
+}
+
+// composes decoded tiles into one atlas image (tiles are converted/resized as needed, then unloaded)
+// missing tiles (failed decodes) stay transparent
+inline Image ComposeAtlas(const AtlasLayout& layout, std::vector<Image>& tiles) {
+    Image atlas = GenImageColor(layout.width(), layout.height(), BLANK);
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        Image& tile = tiles[i];
+        if (tile.data == nullptr) continue;
+        ImageFormat(&tile, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        if (tile.width != layout.tileSize || tile.height != layout.tileSize) ImageResize(&tile, layout.tileSize, layout.tileSize);
+        BlitAtlasTile(layout, static_cast<int>(i), static_cast<const uint8_t*>(tile.data), static_cast<uint8_t*>(atlas.data));
+        UnloadImage(tile);
+    }
+    tiles.clear();
+    return atlas;
+}
+
+// packs same-sized wall textures into one texture, so walls with different materials share one bind
+// (and the renderer can put them all in one batch)... raylib has no texture arrays, so this is a 2D atlas
+// usage: add() every material, build() once, then hand material(tile) to CreateRoom()/CreateHallway()...
+// or buildAsync() with the file list, which returns at once and lets walls draw the placeholder until it lands
+// the atlas texture is registered in an AssetCache under `key` and the atlas holds one reference to it
+// (released in the destructor, so the cache has to outlive the atlas)
+// note: a tile is put on a face once, it can't repeat (the baker stretches it instead of tiling)
+class TextureAtlas {
+private:
+    int tileSize;
+    int padding;
+    std::vector<Image> tiles; // converted to RGBA8 tileSize x tileSize and freed by build()
+    AtlasLayout layout;
+    std::shared_ptr<ManagedTexture> texture;
+    AssetCache* cache = nullptr;
+    TextureHandle handle;
+
+public:
+    // padding: pixels of clamped border around each tile (keeps bilinear filtering from bleeding)
+    explicit TextureAtlas(int tileSize = 1024, int padding = 8) : tileSize(tileSize), padding(padding) {}
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    ~TextureAtlas() {
+        for (Image& image : tiles) UnloadImage(image);
+        if (cache) cache->release(handle);
+    }
+
+    // takes ownership of the image, resizes it to the tile size if needed... returns the tile index, -1 on failure
+    int add(Image image) {
+        if (image.data == nullptr || texture) return -1;
+        tiles.push_back(image);
+        return static_cast<int>(tiles.size()) - 1;
+    }
+
+    int add(const char* filePath) { return add(LoadImage(filePath)); }
+
+    // composes every tile into one image and uploads it... tiles can't be added afterwards
+    bool build(AssetCache& assets, const std::string& key = "atlas") {
+        if (tiles.empty() || texture) return false;
+        layout = AtlasLayout(static_cast<int>(tiles.size()), tileSize, padding);
+
+        Image atlas = ComposeAtlas(layout, tiles);
+        texture = std::make_shared<ManagedTexture>(atlas);
+        UnloadImage(atlas);
+        cache = &assets;
+        handle = assets.addTexture(key, texture);
+        return texture->get().id != 0;
+    }
+
+    // tile i is paths[i]... decoding and packing run on the loader's workers, the upload in loader.update()
+    bool buildAsync(AsyncTextureLoader& loader, AssetCache& assets, std::vector<std::string> paths,
+                    const std::string& key = "atlas", const TextureLoadOptions& options = {}) {
+        if (paths.empty() || texture || !tiles.empty()) return false;
+        layout = AtlasLayout(static_cast<int>(paths.size()), tileSize, padding);
+        texture = std::make_shared<ManagedTexture>();
+        cache = &assets;
+        handle = assets.addTexture(key, texture);
+        loader.load(texture, std::move(paths), [layout = layout](std::vector<Image>& decoded) {
+            return ComposeAtlas(layout, decoded);
+        }, options);
+        return true;
+    }
+
+    [[nodiscard]] bool isBuilt() const { return texture != nullptr; }
+    [[nodiscard]] const AtlasLayout& getLayout() const { return layout; }
+    [[nodiscard]] const std::shared_ptr<ManagedTexture>& getTexture() const { return texture; }
+    [[nodiscard]] TextureHandle getHandle() const { return handle; }
+
+    // what a wall using this tile carries (the atlas texture handle + the tile's uv rect)
+    [[nodiscard]] TexturedRender material(int tile) const {
+        if (!handle || tile < 0) return TexturedRender{};
+        return TexturedRender{ handle, layout.uv(tile) };
+    }
+};
@@ -0,0 +1,386 @@
+#pragma once
+#include "raylib.h"
+#include "cooked_texture.h"
+#include "../core/thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// offline texture cooking (used by tools/texture_cooker, not by the game itself):
+// RGBA8 image -> power-of-two mip chain -> BC1 (DXT1) or BC3 (DXT5) blocks -> CookedTexture / .ctex
+// everything is per pixel/block with a fixed order, so the output is byte-identical whatever the thread count
+struct CookSettings {
+    enum class Format { Auto, BC1, BC3 }; // Auto: BC3 if any pixel has alpha < 255, BC1 otherwise
+
+    Format format = Format::Auto;
+    bool mipmaps = true;
+    bool srgb = true;  // color textures: filter mips in linear light (keeps them from darkening)
+    int maxSize = 0;   // clamp the largest side (after rounding up to a power of two), 0 = keep
+};
+
+namespace texture_cooker {
+
+// RGBA in 0..1, linear when cooked as sRGB
+struct FloatImage {
+    int width = 0;
+    int height = 0;
+    std::vector<float> rgba;
+};
+
+inline float SrgbToLinear(uint8_t v) {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> t{};
+        for (int i = 0; i < 256; ++i) {
+            float c = i / 255.0f;
+            t[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return t;
+    }();
+    return table[v];
+}
+
+inline uint8_t LinearToSrgb(float v) {
+    v = std::clamp(v, 0.0f, 1.0f);
+    float c = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(c * 255.0f + 0.5f);
+}
+
+inline uint8_t ToByte(float v) { return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f); }
+
+inline int NextPow2(int v) {
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+inline FloatImage ToFloat(const uint8_t* rgba, int width, int height, bool srgb) {
+    FloatImage img{ width, height, std::vector<float>(static_cast<size_t>(width) * height * 4) };
+    for (size_t i = 0; i < img.rgba.size(); ++i) {
+        bool alpha = (i & 3) == 3;
+        img.rgba[i] = (srgb && !alpha) ? SrgbToLinear(rgba[i]) : rgba[i] / 255.0f;
+    }
+    return img;
+}
+
+inline std::vector<uint8_t> ToBytes(const FloatImage& img, bool srgb) {
+    std::vector<uint8_t> out(img.rgba.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        bool alpha = (i & 3) == 3;
+        out[i] = (srgb && !alpha) ? LinearToSrgb(img.rgba[i]) : ToByte(img.rgba[i]);
+    }
+    return out;
+}
+
+// halves both sides with a separable [1 3 3 1]/8 tent (edges clamped)... softer aliasing than a 2x2 box
+// and it still only reads the level above
+inline FloatImage Downsample(const FloatImage& src, ThreadPool* pool = nullptr) {
+    FloatImage dst{ std::max(1, src.width / 2), std::max(1, src.height / 2), {} };
+    dst.rgba.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+    static constexpr float W[4] = { 1.0f / 8, 3.0f / 8, 3.0f / 8, 1.0f / 8 };
+
+    auto row = [&](size_t y) {
+        for (int x = 0; x < dst.width; ++x) {
+            float sum[4] = {};
+            for (int ky = 0; ky < 4; ++ky) {
+                int sy = std::clamp(static_cast<int>(y) * 2 - 1 + ky, 0, src.height - 1);
+                for (int kx = 0; kx < 4; ++kx) {
+                    int sx = std::clamp(x * 2 - 1 + kx, 0, src.width - 1);
+                    float w = W[ky] * W[kx];
+                    const float* p = &src.rgba[(static_cast<size_t>(sy) * src.width + sx) * 4];
+                    for (int c = 0; c < 4; ++c) sum[c] += p[c] * w;
+                }
+            }
+            std::memcpy(&dst.rgba[(y * dst.width + x) * 4], sum, sizeof(sum));
+        }
+    };
+    if (pool) pool->parallelFor(static_cast<size_t>(dst.height), row);
+    else for (int y = 0; y < dst.height; ++y) row(static_cast<size_t>(y));
+    return dst;
+}
+
+// ---- BC1 / BC3 blocks (4x4 pixels, RGBA8 in, row-major) ----
+
+inline uint16_t To565(const float c[3]) {
+    int r = std::clamp(static_cast<int>(c[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+    int g = std::clamp(static_cast<int>(c[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+    int b = std::clamp(static_cast<int>(c[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+inline void From565(uint16_t c, int out[3]) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// the 4 colors of a 4-color-mode block
+inline void Bc1Palette(uint16_t c0, uint16_t c1, int palette[4][3]) {
+    From565(c0, palette[0]);
+    From565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+}
+
+// picks the nearest palette entry per pixel, returns the packed indices and the total squared error
+inline uint32_t Bc1Indices(const uint8_t* px, uint16_t c0, uint16_t c1, int& error) {
+    int palette[4][3];
+    Bc1Palette(c0, c1, palette);
+    uint32_t indices = 0;
+    error = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0, bestDist = INT32_MAX;
+        for (int p = 0; p < 4; ++p) {
+            int dr = px[i * 4] - palette[p][0], dg = px[i * 4 + 1] - palette[p][1], db = px[i * 4 + 2] - palette[p][2];
+            int dist = dr * dr + dg * dg + db * db;
+            if (dist < bestDist) { bestDist = dist; best = p; }
+        }
+        indices |= static_cast<uint32_t>(best) << (i * 2);
+        error += bestDist;
+    }
+    return indices;
+}
+
+// endpoints that best fit the given indices (least squares per channel), false if the system is singular
+inline bool Bc1Refine(const uint8_t* px, uint32_t indices, float e0[3], float e1[3]) {
+    static constexpr float WEIGHT[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f }; // share of endpoint 0
+    float aa = 0, ab = 0, bb = 0, ax[3] = {}, bx[3] = {};
+    for (int i = 0; i < 16; ++i) {
+        float a = WEIGHT[(indices >> (i * 2)) & 3], b = 1.0f - a;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < 3; ++c) {
+            ax[c] += a * px[i * 4 + c];
+            bx[c] += b * px[i * 4 + c];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-6f) return false;
+    for (int c = 0; c < 3; ++c) {
+        e0[c] = (ax[c] * bb - bx[c] * ab) / det;
+        e1[c] = (bx[c] * aa - ax[c] * ab) / det;
+    }
+    return true;
+}
+
+inline void WriteBc1(uint8_t* out, uint16_t c0, uint16_t c1, uint32_t indices) {
+    // c0 > c1 selects 4-color mode... swapping the endpoints swaps indices 0<->1 and 2<->3
+    if (c0 < c1) {
+        std::swap(c0, c1);
+        indices ^= 0x55555555u;
+    } else if (c0 == c1) {
+        indices = 0;
+    }
+    out[0] = static_cast<uint8_t>(c0);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+// 8 bytes: endpoints along the principal axis of the block's colors, then one least-squares refinement
+inline void EncodeBc1Block(const uint8_t* px, uint8_t* out) {
+    float mean[3] = {};
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c) mean[c] += px[i * 4 + c];
+    for (float& m : mean) m /= 16.0f;
+
+    float cov[6] = {}; // rr rg rb gg gb bb
+    for (int i = 0; i < 16; ++i) {
+        float r = px[i * 4] - mean[0], g = px[i * 4 + 1] - mean[1], b = px[i * 4 + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // power iteration for the principal axis
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int it = 0; it < 6; ++it) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float len = std::max({ std::fabs(x), std::fabs(y), std::fabs(z) });
+        if (len < 1e-6f) break;
+        axis[0] = x / len; axis[1] = y / len; axis[2] = z / len;
+    }
+
+    float minP = 0, maxP = 0;
+    for (int i = 0; i < 16; ++i) {
+        float p = (px[i * 4] - mean[0]) * axis[0] + (px[i * 4 + 1] - mean[1]) * axis[1] + (px[i * 4 + 2] - mean[2]) * axis[2];
+        minP = std::min(minP, p);
+        maxP = std::max(maxP, p);
+    }
+    float axisLen2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    float e0[3], e1[3];
+    for (int c = 0; c < 3; ++c) {
+        e0[c] = mean[c] + axis[c] * maxP / axisLen2;
+        e1[c] = mean[c] + axis[c] * minP / axisLen2;
+    }
+
+    uint16_t c0 = To565(e0), c1 = To565(e1);
+    int error;
+    uint32_t indices = Bc1Indices(px, c0, c1, error);
+
+    if (error > 0 && Bc1Refine(px, indices, e0, e1)) {
+        uint16_t r0 = To565(e0), r1 = To565(e1);
+        int refinedError;
+        uint32_t refined = Bc1Indices(px, r0, r1, refinedError);
+        if (refinedError < error) {
+            c0 = r0; c1 = r1; indices = refined;
+        }
+    }
+    WriteBc1(out, c0, c1, indices);
+}
+
+// 8 bytes: min/max alpha and 8 interpolated steps
+inline void EncodeBc3AlphaBlock(const uint8_t* px, uint8_t* out) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max<int>(a0, px[i * 4 + 3]);
+        a1 = std::min<int>(a1, px[i * 4 + 3]);
+    }
+    out[0] = static_cast<uint8_t>(a0);
+    out[1] = static_cast<uint8_t>(a1);
+
+    uint64_t bits = 0;
+    if (a0 > a1) {
+        int palette[8] = { a0, a1 };
+        for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int a = px[i * 4 + 3], best = 0;
+            for (int p = 1; p < 8; ++p)
+                if (std::abs(a - palette[p]) < std::abs(a - palette[best])) best = p;
+            bits |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+}
+
+// 16 bytes: alpha block then a BC1 color block
+inline void EncodeBc3Block(const uint8_t* px, uint8_t* out) {
+    EncodeBc3AlphaBlock(px, out);
+    EncodeBc1Block(px, out + 8);
+}
+
+// decoders, only for checking the encoders (tests, the cooker's error report)
+inline void DecodeBc1Block(const uint8_t* in, uint8_t* px) {
+    uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    uint32_t indices;
+    std::memcpy(&indices, in + 4, 4);
+
+    int palette[4][3];
+    Bc1Palette(c0, c1, palette);
+    bool transparent = false;
+    if (c0 <= c1) { // 3-color mode
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        transparent = true;
+    }
+    for (int i = 0; i < 16; ++i) {
+        int idx = (indices >> (i * 2)) & 3;
+        for (int c = 0; c < 3; ++c) px[i * 4 + c] = static_cast<uint8_t>(palette[idx][c]);
+        px[i * 4 + 3] = (transparent && idx == 3) ? 0 : 255;
+    }
+}
+
+inline void DecodeBc3Block(const uint8_t* in, uint8_t* px) {
+    DecodeBc1Block(in + 8, px);
+    int a0 = in[0], a1 = in[1];
+    int palette[8] = { a0, a1 };
+    if (a0 > a1) {
+        for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+    } else {
+        for (int i = 2; i < 6; ++i) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i) bits |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+    for (int i = 0; i < 16; ++i) px[i * 4 + 3] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+}
+
+inline int BlockBytes(int format) { return format == PIXELFORMAT_COMPRESSED_DXT5_RGBA ? 16 : 8; }
+
+// compresses one RGBA8 level (both sides multiples of 4) into `out`, one block row per job
+inline void EncodeLevel(const uint8_t* rgba, int width, int height, int format, uint8_t* out, ThreadPool* pool = nullptr) {
+    const int blocksX = width / 4, blocksY = height / 4;
+    const int blockBytes = BlockBytes(format);
+
+    auto blockRow = [&](size_t by) {
+        uint8_t block[64];
+        for (int bx = 0; bx < blocksX; ++bx) {
+            for (int y = 0; y < 4; ++y)
+                std::memcpy(block + y * 16, rgba + ((by * 4 + y) * static_cast<size_t>(width) + bx * 4) * 4, 16);
+            uint8_t* dst = out + (by * blocksX + bx) * blockBytes;
+            if (format == PIXELFORMAT_COMPRESSED_DXT5_RGBA) EncodeBc3Block(block, dst);
+            else EncodeBc1Block(block, dst);
+        }
+    };
+    if (pool) pool->parallelFor(static_cast<size_t>(blocksY), blockRow);
+    else for (int by = 0; by < blocksY; ++by) blockRow(static_cast<size_t>(by));
+}
+
+} // namespace texture_cooker
+
+// cooks an image (any raylib format, the caller keeps ownership)... sides are rounded up to powers of two
+// (at least 4) so every mip level is whole blocks, and the chain stops before a side would drop below 4
+// (raylib sizes compressed mips as w*h*bpp/8, which is only right for whole blocks)
+inline CookedTexture CookTexture(const Image& source, const CookSettings& settings = {}, ThreadPool* pool = nullptr) {
+    using namespace texture_cooker;
+    CookedTexture cooked;
+    if (source.data == nullptr || source.width <= 0 || source.height <= 0) return cooked;
+
+    Image image = ImageCopy(source);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    int width = std::max(4, NextPow2(image.width)), height = std::max(4, NextPow2(image.height));
+    while (settings.maxSize > 0 && std::max(width, height) > settings.maxSize && std::min(width, height) > 4) {
+        width /= 2;
+        height /= 2;
+    }
+    if (width != image.width || height != image.height) ImageResize(&image, width, height);
+
+    const auto* pixels = static_cast<const uint8_t*>(image.data);
+    int format = PIXELFORMAT_COMPRESSED_DXT1_RGB;
+    if (settings.format == CookSettings::Format::BC3) {
+        format = PIXELFORMAT_COMPRESSED_DXT5_RGBA;
+    } else if (settings.format == CookSettings::Format::Auto) {
+        for (size_t i = 3; i < static_cast<size_t>(width) * height * 4; i += 4)
+            if (pixels[i] < 255) { format = PIXELFORMAT_COMPRESSED_DXT5_RGBA; break; }
+    }
+
+    int levels = 1;
+    if (settings.mipmaps)
+        while (std::min(width >> levels, height >> levels) >= 4) levels++;
+
+    size_t total = 0;
+    for (int l = 0; l < levels; ++l) total += static_cast<size_t>((width >> l) / 4) * ((height >> l) / 4) * BlockBytes(format);
+
+    cooked.width = width;
+    cooked.height = height;
+    cooked.mipmaps = levels;
+    cooked.format = format;
+    cooked.data.resize(total);
+
+    // level 0 straight from the source bytes, the rest filtered in float from the level above
+    EncodeLevel(pixels, width, height, format, cooked.data.data(), pool);
+    size_t offset = static_cast<size_t>(width / 4) * (height / 4) * BlockBytes(format);
+    if (levels > 1) {
+        FloatImage level = ToFloat(pixels, width, height, settings.srgb);
+        for (int l = 1; l < levels; ++l) {
+            level = Downsample(level, pool);
+            std::vector<uint8_t> bytes = ToBytes(level, settings.srgb);
+            EncodeLevel(bytes.data(), level.width, level.height, format, cooked.data.data() + offset, pool);
+            offset += static_cast<size_t>(level.width / 4) * (level.height / 4) * BlockBytes(format);
+        }
+    }
+    UnloadImage(image);
+    return cooked;
+}
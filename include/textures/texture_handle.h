@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+// small copyable reference to a texture owned by an AssetCache
+// low 20 bits: slot index + 1 (0 = no texture), high 12 bits: slot generation, so a handle to an
+// unloaded and reused slot resolves to nothing instead of to the new texture
+struct TextureHandle {
+    uint32_t value{0};
+
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    constexpr TextureHandle() = default;
+    constexpr TextureHandle(uint32_t index, uint32_t generation)
+        : value(((generation & 0xFFF) << INDEX_BITS) | ((index + 1) & INDEX_MASK)) {}
+
+    [[nodiscard]] constexpr bool valid() const { return (value & INDEX_MASK) != 0; }
+    [[nodiscard]] constexpr uint32_t index() const { return (value & INDEX_MASK) - 1; }
+    [[nodiscard]] constexpr uint32_t generation() const { return value >> INDEX_BITS; }
+
+    constexpr explicit operator bool() const { return valid(); }
+    constexpr bool operator==(const TextureHandle&) const = default;
+};
@@ -1,46 +1,69 @@
 #pragma once
 #include "../ecs/components.h"
 #include "../ecs/registry.h"
+#include "anchor_index.h"
 #include "doorway.h"
 #include "../ecs/entity_utils.h"
+#include "../ecs/systems.h"
+#include <vector>
 
-inline Wall::Side AnchorToWallSide(Vector3 dir) {
-    if (dir.z < -0.9f) return Wall::Side::Front;
-    if (dir.z > 0.9f)  return Wall::Side::Back;
-    if (dir.x < -0.9f) return Wall::Side::Left;
-    if (dir.x > 0.9f)  return Wall::Side::Right;
-    return Wall::Side::Front;
+// AnchorDir and Wall::Side list the four horizontal sides in the same order
+inline Wall::Side AnchorToWallSide(AnchorDir dir) {
+    return static_cast<Wall::Side>(static_cast<int>(dir));
 }
 
-inline void CarveDoorwayInWall(Registry& reg, Entity room, Wall::Side side) {
-    if (auto children = reg.get<Children>(room)) {
-        // make a copy to avoid modifying while iterating
-        auto childEntities = children->entities;
-        
-        for (Entity child : childEntities) {
-            if (auto wall = reg.get<Wall>(child)) {
-                if (wall->side == side) {
-                    if (auto t = reg.get<TransformComp>(child)) {
-                        Vector3 pos = t->position;
-                        Vector3 size = t->size;
-                        
-                        std::shared_ptr<ManagedTexture> tex = nullptr;
-                        if (auto tr = reg.get<TexturedRender>(child)) {
-                            tex = tr->texture;
-                        }
-                        
-                        // destroy the wall and create a doorway
-                        DestroyEntityWithChildren(reg, child);
-                        MakeWallWithDoor(reg, room, pos, size, tex, true);
-                        break; // only carve one doorway per side
-                    }
-                }
-            }
-        }
+// a room's/hallway's anchor facing dir, O(1) through the owner's AnchorSlots (INVALID_ENTITY if it has none)
+inline Entity FindAnchor(const Registry& reg, Entity owner, AnchorDir dir) {
+    auto slots = reg.get<AnchorSlots>(owner);
+    return slots ? slots->get(dir) : INVALID_ENTITY;
+}
+
+// a doorway in the middle of the wall on `side` (see CarveDoorway), false if there's no wall or the middle is open
+inline bool CarveDoorwayInWall(Registry& reg, Entity room, Wall::Side side, std::vector<WallChange>* changes = nullptr) {
+    auto children = reg.get<Children>(room);
+    if (!children) return false;
+    const bool alongZ = side == Wall::Side::Left || side == Wall::Side::Right;
+    // the middle of everything on that side, earlier doorways split the wall into several segments
+    float lo = INFINITY, hi = -INFINITY;
+    for (Entity child : children->entities) {
+        auto wall = reg.get<Wall>(child);
+        auto t = reg.get<TransformComp>(child);
+        if (!wall || !t || wall->side != side) continue;
+        float centre = alongZ ? t->position.z : t->position.x;
+        float half = (alongZ ? t->size.z : t->size.x) / 2;
+        lo = std::min(lo, centre - half);
+        hi = std::max(hi, centre + half);
     }
+    if (lo > hi) return false;
+    return CarveDoorway(reg, room, side, (lo + hi) / 2, 2.0f, 3.0f, changes);
 }
 
-inline void ConnectAnchors(Registry& reg, Entity roomAnchor, Entity hallAnchor) {
+// re-places e's placed descendants from their TransformComps (TransformSystem::Compose), where the next TransformSystem
+// pass would put them... colliders that moved go to changes as Moved walls of owner
+// note: only entities that already have a WorldTransform, nothing gets added
+inline void PlaceChildren(Registry& reg, Entity e, Entity owner, std::vector<WallChange>* changes) {
+    auto children = reg.get<Children>(e);
+    auto world = reg.get<WorldTransform>(e);
+    if (!children || !world) return;
+    for (Entity child : children->entities) {
+        auto t = reg.get<TransformComp>(child);
+        auto wt = reg.get<WorldTransform>(child);
+        if (!t || !wt) continue;
+        const WorldTransform placed = TransformSystem::Compose(world, *t);
+        const bool moved = wt->position.x != placed.position.x || wt->position.y != placed.position.y || wt->position.z != placed.position.z;
+        *wt = placed;
+        if (moved && changes && reg.has<Collision>(child)) changes->push_back(WallChange{ child, owner, WallChange::Kind::Moved });
+        PlaceChildren(reg, child, owner, changes);
+    }
+}
+
+// snaps the hallway so hallAnchor meets roomAnchor, carves both doorways and links the pair
+// the hallway and everything under it are re-placed right after the snap (see PlaceChildren), so the hallway's
+// doorway pieces land where the snap put it and collider caches needn't wait for a TransformSystem pass
+// anchorIndex: if given, both anchors leave it and the hallway's other free anchors are moved along with it
+// changes: if given, gets the WallChanges of both doorways, plus a Moved one per hallway wall the snap moved
+inline void ConnectAnchors(Registry& reg, Entity roomAnchor, Entity hallAnchor, AnchorIndex* anchorIndex = nullptr,
+                           std::vector<WallChange>* changes = nullptr) {
     auto ra = reg.get<Anchor>(roomAnchor);
     auto ha = reg.get<Anchor>(hallAnchor);
     if (!ra || !ha) return;
@@ -59,16 +82,27 @@ inline void ConnectAnchors(Registry& reg, Entity roomAnchor, Entity hallAnchor)
     if (!rt || !ht || !hallT) return;
     
     Vector3 delta = Vector3Subtract(rt->position, ht->position);
-    hallT->position = Vector3Add(hallT->position, delta);
+    if (delta.x != 0.0f || delta.y != 0.0f || delta.z != 0.0f) {
+        hallT->position = Vector3Add(hallT->position, delta);
+        if (auto hallWorld = reg.get<WorldTransform>(hall)) {
+            auto hallParent = reg.get<Parent>(hall);
+            *hallWorld = TransformSystem::Compose(hallParent ? reg.get<WorldTransform>(hallParent->parent) : nullptr, *hallT);
+            PlaceChildren(reg, hall, hall, changes);
+        }
+    }
     
     // carve doorway in room
-    Wall::Side roomSide = AnchorToWallSide(ra->direction);
-    CarveDoorwayInWall(reg, room, roomSide);
+    // at the anchor rather than the middle of the wall, so a wall can have one doorway per anchor on it
+    auto along = [](const Anchor* a) { return a->dir == AnchorDir::Left || a->dir == AnchorDir::Right ? a->localPos.z : a->localPos.x; };
+    CarveDoorway(reg, room, AnchorToWallSide(ra->dir), along(ra), 2.0f, 3.0f, changes);
     
     // carve doorway in hallway
-    Wall::Side hallSide = AnchorToWallSide(ha->direction);
-    CarveDoorwayInWall(reg, hall, hallSide);
+    CarveDoorway(reg, hall, AnchorToWallSide(ha->dir), along(ha), 2.0f, 3.0f, changes);
     
     ra->connectedTo = hallAnchor;
     ha->connectedTo = roomAnchor;
+    if (anchorIndex) {
+        anchorIndex->remove(roomAnchor);
+        anchorIndex->addOwner(reg, hall);
+    }
 }
\ No newline at end of file
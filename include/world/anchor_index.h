@@ -0,0 +1,105 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../spatial/bounds.h"
+#include "../spatial/spatial_hash.h"
+#include <unordered_map>
+#include <vector>
+
+// spatial index of free (unconnected) anchors, so generators can ask "is there a free anchor facing this way near
+// here" without scanning rooms... fed by CreateRoom/CreateHallway (anchorIndex argument) and ConnectAnchors
+// positions are world space: owner position + anchor localPos, the owners are roots (rooms/hallways have no parent)
+// note: rotation is ignored like everywhere else
+class AnchorIndex {
+private:
+    struct Item {
+        Entity anchor;
+        Vector3 position;
+        AnchorDir dir;
+    };
+
+    SpatialHash hash;
+    std::vector<Item> items;                    // by hash id
+    std::unordered_map<Entity, uint32_t> idOf;  // anchor -> hash id
+
+public:
+    // cellSize: about the distance between neighbouring anchors (a room's half size)
+    explicit AnchorIndex(float cellSize = 64.0f) : hash(cellSize) {}
+
+    void add(Entity anchor, Vector3 position, AnchorDir dir) {
+        remove(anchor);
+        uint32_t id = hash.insert(BoundingBox{ position, position });
+        if (id >= items.size()) items.resize(id + 1);
+        items[id] = Item{ anchor, position, dir };
+        idOf.emplace(anchor, id);
+    }
+
+    void remove(Entity anchor) {
+        auto it = idOf.find(anchor);
+        if (it == idOf.end()) return;
+        hash.remove(it->second);
+        items[it->second].anchor = INVALID_ENTITY;
+        idOf.erase(it);
+    }
+
+    // (re)registers every free anchor of a room/hallway from its AnchorSlots, connected ones are dropped
+    void addOwner(const Registry& reg, Entity owner) {
+        auto slots = reg.get<AnchorSlots>(owner);
+        auto t = reg.get<TransformComp>(owner);
+        if (!slots || !t) return;
+        for (Entity e : slots->anchors) {
+            auto a = e != INVALID_ENTITY ? reg.get<Anchor>(e) : nullptr;
+            if (!a) continue;
+            if (a->connectedTo != INVALID_ENTITY) remove(e);
+            else add(e, Vector3Add(t->position, a->localPos), a->dir);
+        }
+    }
+
+    void removeOwner(const Registry& reg, Entity owner) {
+        if (auto slots = reg.get<AnchorSlots>(owner))
+            for (Entity e : slots->anchors) remove(e);
+    }
+
+    // every free anchor of every owner in the registry
+    void rebuild(const Registry& reg) {
+        clear();
+        for (const auto& [owner, slots] : reg.view<AnchorSlots>()) addOwner(reg, owner);
+    }
+
+    // calls fn(anchor, position, dir) for every free anchor inside box
+    template <typename Fn>
+    void query(const BoundingBox& box, Fn&& fn) {
+        hash.query(box, [&](uint32_t id, const BoundingBox&) {
+            const Item& item = items[id];
+            fn(item.anchor, item.position, item.dir);
+        });
+    }
+
+    // closest free anchor facing dir within radius of position, INVALID_ENTITY if none
+    // e.g. findFree(end of a new hallway, OppositeDir(hallway direction), 0.01f) finds the room it should join
+    Entity findFree(Vector3 position, AnchorDir dir, float radius) {
+        Entity best = INVALID_ENTITY;
+        float bestDistance = radius * radius;
+        Vector3 r{ radius, radius, radius };
+        query(BoundingBox{ Vector3Subtract(position, r), Vector3Add(position, r) }, [&](Entity e, Vector3 p, AnchorDir d) {
+            if (d != dir) return;
+            float distance = Vector3DistanceSqr(p, position);
+            if (distance <= bestDistance) {
+                bestDistance = distance;
+                best = e;
+            }
+        });
+        return best;
+    }
+
+    void clear() {
+        hash.clear();
+        items.clear();
+        idOf.clear();
+    }
+
+    [[nodiscard]] bool contains(Entity anchor) const { return idOf.count(anchor) > 0; }
+    [[nodiscard]] size_t size() const { return idOf.size(); }
+};
@@ -0,0 +1,168 @@
+#pragma once
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../spatial/bounds.h"
+#include "../spatial/bvh.h"
+#include "raymath.h"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// opening between two cells, stored once per direction
+struct Portal {
+    uint32_t fromCell;
+    uint32_t toCell;
+    Entity anchor;       // anchor on the fromCell side
+    Vector3 normal;      // points out of fromCell
+    BoundingBox opening; // flat box in the shared wall plane
+};
+
+// a room or hallway: an entity with Children that own anchors
+struct Cell {
+    Entity entity;
+    BoundingBox bounds;
+    std::vector<uint32_t> portals; // indices into CellGraph::portals (leading out of this cell)
+};
+
+// cell-and-portal view of the world built from rooms/hallways and their connected Anchor pairs
+// note: only anchors that actually touch (after ConnectAnchors snapped them) become portals, their opening is the
+// doorway carved into both cells' walls
+class CellGraph {
+private:
+    std::vector<Cell> cells;
+    std::vector<Portal> portals;
+    std::unordered_map<Entity, uint32_t> cellIndex;
+    Bvh cellBvh; // point location when the last known cell is no help
+
+    static constexpr float TOUCH_EPSILON = 0.01f;
+
+    static bool IsCell(const Registry& reg, Entity e) {
+        auto children = reg.get<Children>(e);
+        if (!children || !reg.has<WorldTransform>(e)) return false;
+        for (Entity child : children->entities) {
+            if (reg.has<Anchor>(child)) return true;
+        }
+        return false;
+    }
+
+    static int DominantAxis(Vector3 v) {
+        float ax = fabsf(v.x), ay = fabsf(v.y), az = fabsf(v.z);
+        if (ax >= ay && ax >= az) return 0;
+        return ay >= az ? 1 : 2;
+    }
+
+    static float Axis(const Vector3& v, int a) { return a == 0 ? v.x : (a == 1 ? v.y : v.z); }
+
+    static void SetAxis(Vector3& v, int a, float value) {
+        if (a == 0) v.x = value;
+        else if (a == 1) v.y = value;
+        else v.z = value;
+    }
+
+    // where cell's wall facing `dir` is open around `at` (a point in the wall plane), as a flat box in that plane: the
+    // gap between the wall pieces either side of `at`, from the bottom up to the lintel over it (see CarveDoorway)...
+    // the whole face when there's no wall on that side (hallway ends, walls merged into the neighbour's)
+    // note: empty (min > max on the up axis) when a wall piece covers `at` all the way down
+    static BoundingBox WallOpening(const Registry& reg, const Cell& cell, AnchorDir dir, int axis, Vector3 at) {
+        const int along = axis == 0 ? 2 : 0;
+        const float p = Axis(at, along);
+        const float eps = 1e-3f;
+        BoundingBox opening = cell.bounds;
+        const Wall::Side side = static_cast<Wall::Side>(static_cast<int>(dir));
+        for (Entity child : reg.get<Children>(cell.entity)->entities) {
+            auto wall = reg.get<Wall>(child);
+            auto wt = reg.get<WorldTransform>(child);
+            if (!wall || !wt || wall->side != side) continue;
+            BoundingBox box = BoundsFromTransform(*wt);
+            if (Axis(box.max, along) <= p + eps) {
+                SetAxis(opening.min, along, fmaxf(Axis(opening.min, along), Axis(box.max, along)));
+            } else if (Axis(box.min, along) >= p - eps) {
+                SetAxis(opening.max, along, fminf(Axis(opening.max, along), Axis(box.min, along)));
+            } else {
+                opening.max.y = fminf(opening.max.y, box.min.y); // over the door (or no door at all)
+            }
+        }
+        return opening;
+    }
+
+public:
+    void build(const Registry& reg) {
+        cells.clear();
+        portals.clear();
+        cellIndex.clear();
+
+        for (const auto& [e, wt] : reg.view<WorldTransform>()) {
+            if (!IsCell(reg, e)) continue;
+            cellIndex[e] = static_cast<uint32_t>(cells.size());
+            cells.push_back(Cell{ e, BoundsFromTransform(*wt), {} });
+        }
+
+        for (uint32_t c = 0; c < cells.size(); ++c) {
+            const auto* children = reg.get<Children>(cells[c].entity);
+            for (Entity child : children->entities) {
+                auto anchor = reg.get<Anchor>(child);
+                if (!anchor || anchor->connectedTo == INVALID_ENTITY) continue;
+
+                auto other = reg.get<Parent>(anchor->connectedTo);
+                if (!other) continue;
+                auto it = cellIndex.find(other->parent);
+                if (it == cellIndex.end() || it->second == c) continue;
+
+                auto aw = reg.get<WorldTransform>(child);
+                auto bw = reg.get<WorldTransform>(anchor->connectedTo);
+                if (!aw || !bw) continue;
+                if (Vector3Distance(aw->position, bw->position) > TOUCH_EPSILON) continue; // not actually joined
+
+                // opening = overlap of the two cells' doorways (see WallOpening) in the shared wall plane
+                Vector3 dir = Vector3Normalize(anchor->direction);
+                int axis = DominantAxis(dir);
+                const BoundingBox a = WallOpening(reg, cells[c], anchor->dir, axis, aw->position);
+                const BoundingBox b = WallOpening(reg, cells[it->second], reg.get<Anchor>(anchor->connectedTo)->dir, axis, bw->position);
+                BoundingBox opening{
+                    Vector3{ fmaxf(a.min.x, b.min.x), fmaxf(a.min.y, b.min.y), fmaxf(a.min.z, b.min.z) },
+                    Vector3{ fminf(a.max.x, b.max.x), fminf(a.max.y, b.max.y), fminf(a.max.z, b.max.z) }
+                };
+                float plane = Axis(aw->position, axis);
+                SetAxis(opening.min, axis, plane);
+                SetAxis(opening.max, axis, plane);
+                if (opening.min.x > opening.max.x || opening.min.y >= opening.max.y || opening.min.z > opening.max.z) continue; // or walled up
+
+                Vector3 normal{ 0, 0, 0 };
+                SetAxis(normal, axis, Axis(dir, axis) > 0 ? 1.0f : -1.0f);
+
+                cells[c].portals.push_back(static_cast<uint32_t>(portals.size()));
+                portals.push_back(Portal{ c, it->second, child, normal, opening });
+            }
+        }
+
+        std::vector<BoundingBox> bounds;
+        bounds.reserve(cells.size());
+        for (const auto& cell : cells) bounds.push_back(cell.bounds);
+        cellBvh.build(bounds, 2);
+    }
+
+    // index of the cell containing p, or -1... checks hint and its neighbours before the BVH
+    int findCell(Vector3 p, int hint = -1) const {
+        if (hint >= 0 && hint < static_cast<int>(cells.size())) {
+            if (BoundsContainsPoint(cells[hint].bounds, p)) return hint;
+            for (uint32_t pi : cells[hint].portals) {
+                uint32_t n = portals[pi].toCell;
+                if (BoundsContainsPoint(cells[n].bounds, p)) return static_cast<int>(n);
+            }
+        }
+        int found = -1;
+        cellBvh.queryBox(BoundingBox{ p, p }, [&](uint32_t i) {
+            if (found < 0 || i < static_cast<uint32_t>(found)) found = static_cast<int>(i);
+        });
+        return found;
+    }
+
+    int cellOf(Entity e) const {
+        auto it = cellIndex.find(e);
+        return it == cellIndex.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    const std::vector<Cell>& getCells() const { return cells; }
+    const std::vector<Portal>& getPortals() const { return portals; }
+};
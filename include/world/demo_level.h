@@ -0,0 +1,69 @@
+#pragma once
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "../textures/managed_texture.h"
+#include "anchor.h"
+#include "hallway.h"
+#include "room.h"
+#include "raymath.h"
+#include <iostream>
+#include <memory>
+
+struct DemoLevel {
+    Entity room1 = INVALID_ENTITY;
+    Entity room2 = INVALID_ENTITY;
+    Entity hall = INVALID_ENTITY;
+};
+
+// two rooms joined by a hallway... shared by the game and the offline tools (pvs_builder)
+inline DemoLevel BuildDemoLevel(Registry& reg, TransformSystem& transforms, const TexturedRender& brick = {}) {
+    DemoLevel level;
+
+    // scale factor
+    const float S = 20.0f;
+
+    // room and hallway dimensions
+    Vector3 roomSize = {10*S, 2.5f*S, 10*S};  // 200 x 50 x 200
+    Vector3 hallSize = {4*S, 2.5f*S, 12*S};   // 240 x 50 x 80  (long along Z)
+
+    // spacing for front/back alignment
+    float spacing = roomSize.z/2 + hallSize.z/2; // 200/2 + 80/2 = 140
+
+    // place rooms in front and back, hallway in between
+    level.room1 = CreateRoom(reg, { 0, 0, -spacing }, roomSize, brick, std::vector<Wall::Side>{ Wall::Side::Back });  // open back
+    level.room2 = CreateRoom(reg, { 0, 0,  spacing }, roomSize, brick, std::vector<Wall::Side>{ Wall::Side::Front }); // open front    
+    level.hall  = CreateHallway(reg, { 0, 0, 0 }, hallSize, AnchorDir::Back, brick);
+
+    // now calc WorldTransforms for all entities and anchors
+    transforms.update(reg);
+
+    // connect room1's right anchor to hall's left anchor
+    Entity r1_right = FindAnchor(reg, level.room1, AnchorDir::Right);
+    Entity hall_left = FindAnchor(reg, level.hall, AnchorDir::Left);
+
+
+    // ConnectAnchors is called twice 
+    // in order to link room1 to hall and room2 to hall 
+    // this snaps positions and carves doorways
+    if (r1_right != INVALID_ENTITY && hall_left != INVALID_ENTITY) {
+        ConnectAnchors(reg, r1_right, hall_left);
+    } else {
+        std::cerr << "DEV Warning: missing anchors for room1<->hall connection\n";
+    }
+
+    // connect room2's left anchor to hall's right anchor
+    Entity r2_left = FindAnchor(reg, level.room2, AnchorDir::Left);
+    Entity hall_right = FindAnchor(reg, level.hall, AnchorDir::Right);
+
+    if (r2_left != INVALID_ENTITY && hall_right != INVALID_ENTITY) {
+        ConnectAnchors(reg, r2_left, hall_right);
+    } else {
+        std::cerr << "DEV Warning: missing anchors for room2<->hall connection\n";
+    }
+
+    // called again to update transforms after the connection adjustments
+    transforms.update(reg);
+
+    return level;
+}
@@ -1,86 +1,125 @@
 #pragma once
 #include "../ecs/components.h"
 #include "../ecs/registry.h"
+#include "../ecs/entity_utils.h"
+#include "../ecs/systems.h"
 #include "../textures/managed_texture.h"
+#include "wall_builder.h"
 #include <algorithm>
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
-inline void MakeWallWithDoor(Registry& reg, Entity parent, Vector3 localPos, Vector3 size, std::shared_ptr<ManagedTexture> texture, bool hasDoor = false, float doorWidth = 2.0f, float doorHeight = 3.0f) {
-    if (!hasDoor) {
-        Entity wall = reg.create();
-        reg.add<TransformComp>(wall, TransformComp{ localPos, size });
-        
-        if (texture) 
-            reg.add<TexturedRender>(wall, TexturedRender{ texture });
-        else 
-            reg.add<ColoredRender>(wall, ColoredRender{ GRAY });
-            
-        reg.add<Collision>(wall, Collision{});
-        reg.add<Parent>(wall, Parent{ parent });
-        
-        if (auto children = reg.get<Children>(parent)) 
-            children->entities.push_back(wall);
-        
-        return;
+// one doorway centred along the wall: doorWidth wide, from the bottom of the wall up to doorHeight / 2 above its centre
+// (3 pieces, see MakeWallWithOpenings for anything else)
+inline void MakeWallWithDoor(Registry& reg, Entity parent, Vector3 localPos, Vector3 size, const TexturedRender& material, bool hasDoor = false, float doorWidth = 2.0f, float doorHeight = 3.0f) {
+    const float length = size.z > size.x ? size.z : size.x;
+    const Rectangle door{ (length - doorWidth) / 2, 0, doorWidth, size.y / 2 + doorHeight / 2 };
+    MakeWallWithOpenings(reg, parent, localPos, size, hasDoor ? std::span<const Rectangle>(&door, 1) : std::span<const Rectangle>{}, material);
+}
+
+// cuts a doorway into owner's wall on `side`, centred at `along` (owner-local x for front/back walls, z for left/right)
+// the wall is split in place: whichever full-height segment holds the door keeps its entity as the piece left of the
+// door, the right piece and the lintel above are created in one batch... every piece keeps the Wall, material and
+// Collision, so later doorways can split them again (one side can have any number of doorways)
+// same opening as MakeWallWithDoor: doorWidth wide, from the bottom of the wall up to doorHeight / 2 above its centre
+// the pieces get their WorldTransform right away (TransformSystem::Compose under the owner's current one), so a
+// collider cache can take `changes` (see CollisionSystem::applyWallChanges) and update before the next TransformSystem
+// pass... only the owner has to be placed already
+// changes: if given, gets one WallChange per touched entity
+// returns false if no single full-height segment spans the door (overlaps an existing doorway or the wall's end)
+inline constexpr size_t MaxDoorwayPieces = 3; // one door in one rectangle: at most left, right and lintel
+inline bool CarveDoorway(Registry& reg, Entity owner, Wall::Side side, float along, float doorWidth = 2.0f, float doorHeight = 3.0f,
+                         std::vector<WallChange>* changes = nullptr) {
+    auto children = reg.get<Children>(owner);
+    if (!children || side == Wall::Side::Floor || side == Wall::Side::Ceiling) return false;
+    const bool alongZ = side == Wall::Side::Left || side == Wall::Side::Right;
+    const float eps = 1e-3f;
+    const float doorLo = along - doorWidth / 2;
+    const float doorHi = along + doorWidth / 2;
+
+    // lintels are shorter than the wall, only full-height segments can take another door
+    float fullHeight = 0.0f;
+    for (Entity child : children->entities) {
+        auto wall = reg.get<Wall>(child);
+        auto t = reg.get<TransformComp>(child);
+        if (wall && t && wall->side == side) fullHeight = std::max(fullHeight, t->size.y);
+    }
+    Entity target = INVALID_ENTITY;
+    for (Entity child : children->entities) {
+        auto wall = reg.get<Wall>(child);
+        auto t = reg.get<TransformComp>(child);
+        if (!wall || !t || wall->side != side || t->size.y < fullHeight - eps) continue;
+        float centre = alongZ ? t->position.z : t->position.x;
+        float half = (alongZ ? t->size.z : t->size.x) / 2;
+        if (centre - half <= doorLo + eps && centre + half >= doorHi - eps) {
+            target = child;
+            break;
+        }
+    }
+    if (target == INVALID_ENTITY) return false;
+
+    const TransformComp segment = *reg.get<TransformComp>(target);
+    const float centre = alongZ ? segment.position.z : segment.position.x;
+    const float half = (alongZ ? segment.size.z : segment.size.x) / 2;
+    const float halfH = segment.size.y / 2;
+    const float doorHalfH = doorHeight / 2;
+    // the segment minus the door in the wall's plane (along, up)... door edges within eps of the segment's ends snap to
+    // them, so rounding doesn't leave slivers
+    const Rectangle rect{ centre - half, segment.position.y - halfH, 2 * half, segment.size.y };
+    const float lo = doorLo - rect.x < eps ? rect.x : doorLo;
+    const float hi = rect.x + rect.width - doorHi < eps ? rect.x + rect.width : doorHi;
+    const float top = halfH - doorHalfH < eps ? segment.size.y : halfH + doorHalfH;
+    const Rectangle door{ lo, rect.y, hi - lo, top };
+    std::vector<TransformComp> pieces;
+    for (const Rectangle& r : DecomposeWall(rect, std::span<const Rectangle>(&door, 1))) {
+        TransformComp t = segment;
+        (alongZ ? t.position.z : t.position.x) = r.x + r.width / 2;
+        (alongZ ? t.size.z : t.size.x) = r.width;
+        t.position.y = r.y + r.height / 2;
+        t.size.y = r.height;
+        pieces.push_back(t);
+    }
+    const size_t count = pieces.size();
+    if (count > MaxDoorwayPieces) return false; // can't happen with DecomposeWall's minimum partition, but never overrun `created`
+
+    if (auto baked = reg.get<BakedMesh>(owner)) baked->dirty = true;
+    if (count == 0) { // the door is the whole wall
+        DestroyEntityWithChildren(reg, target);
+        if (changes) changes->push_back(WallChange{ target, owner, WallChange::Kind::Removed });
+        return true;
+    }
+
+    // copied, reg.add() may grow the pool the pointer points into
+    const auto ownerWorld = reg.has<WorldTransform>(owner) ? std::optional{ *reg.get<WorldTransform>(owner) } : std::nullopt;
+    auto placed = [&](const TransformComp& t) { return TransformSystem::Compose(ownerWorld ? &*ownerWorld : nullptr, t); };
+
+    *reg.get<TransformComp>(target) = pieces[0];
+    if (auto wt = reg.get<WorldTransform>(target)) *wt = placed(pieces[0]);
+    if (changes) changes->push_back(WallChange{ target, owner, WallChange::Kind::Resized });
+
+    Entity created[MaxDoorwayPieces - 1];
+    std::span<Entity> rest(created, count - 1);
+    reg.create(rest);
+    // copies, reg.add() may grow the pools the pointers point into
+    const auto textured = reg.has<TexturedRender>(target) ? std::optional{ *reg.get<TexturedRender>(target) } : std::nullopt;
+    const auto colored = reg.has<ColoredRender>(target) ? std::optional{ *reg.get<ColoredRender>(target) } : std::nullopt;
+    const auto collision = reg.has<Collision>(target) ? std::optional{ *reg.get<Collision>(target) } : std::nullopt;
+    const bool world = reg.has<WorldTransform>(target);
+    const bool batched = reg.has<StaticBatched>(target);
+    for (size_t i = 0; i < rest.size(); ++i) {
+        Entity e = rest[i];
+        reg.add<TransformComp>(e, pieces[i + 1]);
+        if (world) reg.add<WorldTransform>(e, placed(pieces[i + 1]));
+        if (textured) reg.add<TexturedRender>(e, *textured);
+        if (colored) reg.add<ColoredRender>(e, *colored);
+        if (collision) reg.add<Collision>(e, *collision);
+        if (batched) reg.add<StaticBatched>(e, StaticBatched{});
+        reg.add<Wall>(e, Wall{ side });
+        reg.add<Parent>(e, Parent{ owner });
+        if (changes) changes->push_back(WallChange{ e, owner, WallChange::Kind::Created });
     }
-    
-    float halfW = size.x / 2;
-    float halfH = size.y / 2;
-    float doorHalfW = doorWidth / 2;
-    float doorHalfH = doorHeight / 2;
-    
-    // left segment
-    Entity left = reg.create();
-    reg.add<TransformComp>(left, TransformComp{ 
-        { localPos.x - (halfW - doorHalfW)/2, localPos.y, localPos.z },
-        { halfW - doorHalfW, size.y, size.z } 
-    });
-    
-    if (texture) 
-        reg.add<TexturedRender>(left, TexturedRender{ texture });
-    else 
-        reg.add<ColoredRender>(left, ColoredRender{ GRAY });
-        
-    reg.add<Collision>(left, Collision{});
-    reg.add<Parent>(left, Parent{ parent });
-    
-    if (auto children = reg.get<Children>(parent)) 
-        children->entities.push_back(left);    
-    
-    // right segment
-    Entity right = reg.create();
-    reg.add<TransformComp>(right, TransformComp{ 
-        { localPos.x + (halfW - doorHalfW)/2, localPos.y, localPos.z },
-        { halfW - doorHalfW, size.y, size.z } 
-    });
-    
-    if (texture) 
-        reg.add<TexturedRender>(right, TexturedRender{ texture });
-    else 
-        reg.add<ColoredRender>(right, ColoredRender{ GRAY });
-        
-    reg.add<Collision>(right, Collision{});
-    reg.add<Parent>(right, Parent{ parent });
-    
-    if (auto children = reg.get<Children>(parent)) 
-        children->entities.push_back(right);    
-    
-    // top segment above door
-    Entity top = reg.create();
-    reg.add<TransformComp>(top, TransformComp{ 
-        { localPos.x, localPos.y + (halfH - doorHalfH)/2, localPos.z },
-        { doorWidth, halfH - doorHalfH, size.z } 
-    });
-    
-    if (texture) 
-        reg.add<TexturedRender>(top, TexturedRender{ texture });
-    else 
-        reg.add<ColoredRender>(top, ColoredRender{ GRAY });
-        
-    reg.add<Collision>(top, Collision{});
-    reg.add<Parent>(top, Parent{ parent });
-    
-    if (auto children = reg.get<Children>(parent)) 
-        children->entities.push_back(top);    
-        
-}
\ No newline at end of file
+    children->entities.insert(children->entities.end(), rest.begin(), rest.end());
+    return true;
+}
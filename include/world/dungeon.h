@@ -0,0 +1,288 @@
+#pragma once
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include "../ecs/systems.h"
+#include "../core/thread_pool.h"
+#include "../spatial/bounds.h"
+#include "../spatial/spatial_hash.h"
+#include "../textures/managed_texture.h"
+#include "anchor.h"
+#include "hallway.h"
+#include "prefabs.h"
+#include "room.h"
+#include "raymath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// seeded procedural dungeons: rooms grown out of each other's anchors through straight hallways
+//   1. layout (GenerateDungeonLayout): plain boxes, no registry... the world is cut into square regions of
+//      ~regionRooms rooms that grow independently (in parallel), each rejecting overlaps through its own SpatialHash
+//   2. merge: regions are appended in index order, then their root rooms are linked by long hallways through lanes
+//      every region kept free, so the result only depends on the seed (not on thread count or timing)
+//   3. BuildDungeon: every room and hallway stamped from prefabs in one batch, ConnectAnchors per hallway end (carves
+//      the doorways)
+// note: every room has the same height, anchors sit at mid-height so connected rooms have to share it
+
+struct DungeonSettings {
+    uint64_t seed = 1;
+    int rooms = 1000;
+    int regionRooms = 256;                // rooms per region, the unit of parallel work
+    Vector3 minRoomSize = { 80, 50, 80 };  // y ignored, see roomHeight
+    Vector3 maxRoomSize = { 200, 50, 200 };
+    float roomHeight = 50.0f;
+    float hallWidth = 40.0f;              // must fit the narrowest wall (<= minRoomSize.x/z)
+    float minHallLength = 20.0f;
+    float maxHallLength = 80.0f;
+    float clearance = 2.0f;               // minimum gap between unconnected rooms/hallways
+    int maxAttempts = 8;                  // failed placements before an anchor is given up
+};
+
+struct DungeonRoom {
+    Vector3 position;
+    Vector3 size;
+};
+
+// hallway from room `from` (leaving through its `side` wall) to room `to` (entering through the opposite wall)
+struct DungeonHall {
+    Vector3 position;
+    Vector3 size;
+    uint32_t from;
+    uint32_t to;
+    AnchorDir side;
+};
+
+struct DungeonLayout {
+    std::vector<DungeonRoom> rooms;
+    std::vector<DungeonHall> halls;
+    size_t regions = 0;
+    size_t rejected = 0; // placements that overlapped something or left their region
+};
+
+struct DungeonEntities {
+    std::vector<Entity> rooms; // by layout index
+    std::vector<Entity> halls;
+};
+
+namespace dungeon {
+
+// splitmix64: tiny and the same sequence on every platform (std distributions are implementation-defined)
+struct Rng {
+    uint64_t state;
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    float uniform(float lo, float hi) { return lo + (hi - lo) * static_cast<float>(next() >> 40) * (1.0f / 16777216.0f); }
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>(next() % n); }
+};
+
+// half the room's extent along a horizontal direction
+inline float HalfAlong(Vector3 size, Vector3 dir) { return dir.x != 0.0f ? size.x * 0.5f : size.z * 0.5f; }
+
+inline Vector3 HallSize(const DungeonSettings& s, Vector3 dir, float length) {
+    return dir.x != 0.0f ? Vector3{ length, s.roomHeight, s.hallWidth } : Vector3{ s.hallWidth, s.roomHeight, length };
+}
+
+inline BoundingBox Inflate(const BoundingBox& b, float m) {
+    return BoundingBox{ Vector3{ b.min.x - m, b.min.y - m, b.min.z - m }, Vector3{ b.max.x + m, b.max.y + m, b.max.z + m } };
+}
+
+inline bool Inside(const BoundingBox& outer, const BoundingBox& inner) {
+    return inner.min.x >= outer.min.x && inner.max.x <= outer.max.x && inner.min.z >= outer.min.z && inner.max.z <= outer.max.z;
+}
+
+struct Region {
+    std::vector<DungeonRoom> rooms; // rooms[0] is the root, at the region's centre
+    std::vector<DungeonHall> halls; // indices local to the region
+    size_t rejected = 0;
+};
+
+// grows up to `target` rooms inside bounds, starting from a root room at its centre
+// links[side]: the root's side is taken by a hallway to a neighbouring region, the lane from it to the region's
+// edge is reserved so nothing grows across it
+inline Region GrowRegion(const DungeonSettings& s, const BoundingBox& bounds, int target, uint64_t seed, const bool (&links)[4]) {
+    Region region;
+    Rng rng{ seed };
+    SpatialHash index(s.maxRoomSize.x + s.maxHallLength);
+    auto randomRoomSize = [&] {
+        return Vector3{ rng.uniform(s.minRoomSize.x, s.maxRoomSize.x), s.roomHeight, rng.uniform(s.minRoomSize.z, s.maxRoomSize.z) };
+    };
+
+    Vector3 center = BoundsCenter(bounds);
+    region.rooms.push_back(DungeonRoom{ center, randomRoomSize() });
+    index.insert(BoundsFromCenterSize(center, region.rooms[0].size));
+
+    struct Frontier {
+        uint32_t room;
+        AnchorDir side;
+        int attempts;
+    };
+    std::vector<Frontier> frontier;
+    for (int side = 0; side < 4; ++side) {
+        AnchorDir ad = static_cast<AnchorDir>(side);
+        if (!links[side]) {
+            frontier.push_back(Frontier{ 0, ad, 0 });
+            continue;
+        }
+        Vector3 dir = AnchorDirVector(ad);
+        float wall = HalfAlong(region.rooms[0].size, dir);
+        float edge = dir.x != 0.0f ? (dir.x > 0 ? bounds.max.x - center.x : center.x - bounds.min.x)
+                                   : (dir.z > 0 ? bounds.max.z - center.z : center.z - bounds.min.z);
+        Vector3 laneCenter = Vector3Add(center, Vector3Scale(dir, (wall + edge) * 0.5f));
+        Vector3 laneSize = HallSize(s, dir, edge - wall);
+        index.insert(Inflate(BoundsFromCenterSize(laneCenter, laneSize), s.clearance));
+    }
+
+    while (static_cast<int>(region.rooms.size()) < target && !frontier.empty()) {
+        uint32_t pick = rng.below(static_cast<uint32_t>(frontier.size()));
+        Frontier f = frontier[pick];
+        const DungeonRoom from = region.rooms[f.room];
+        Vector3 dir = AnchorDirVector(f.side);
+        float length = rng.uniform(s.minHallLength, s.maxHallLength);
+        Vector3 size = randomRoomSize();
+
+        Vector3 anchor = Vector3Add(from.position, Vector3Scale(dir, HalfAlong(from.size, dir)));
+        Vector3 hallCenter = Vector3Add(anchor, Vector3Scale(dir, length * 0.5f));
+        Vector3 hallSize = HallSize(s, dir, length);
+        Vector3 roomCenter = Vector3Add(anchor, Vector3Scale(dir, length + HalfAlong(size, dir)));
+
+        BoundingBox roomBox = BoundsFromCenterSize(roomCenter, size);
+        // the hallway touches both rooms at its ends, only its sides need the clearance
+        Vector3 along = { fabsf(dir.x), 0, fabsf(dir.z) };
+        Vector3 across = { fabsf(dir.z), 0, fabsf(dir.x) };
+        Vector3 hallCheck = Vector3Add(hallSize, Vector3Scale(Vector3Subtract(across, along), 2.0f * s.clearance));
+        BoundingBox hallBox = BoundsFromCenterSize(hallCenter, hallCheck);
+        bool free = Inside(Inflate(bounds, -s.clearance), roomBox);
+        if (free) {
+            index.query(Inflate(roomBox, s.clearance), [&](uint32_t, const BoundingBox&) { free = false; });
+            if (free) index.query(hallBox, [&](uint32_t, const BoundingBox&) { free = false; });
+        }
+        if (!free) {
+            region.rejected++;
+            if (++frontier[pick].attempts >= s.maxAttempts) {
+                frontier[pick] = frontier.back();
+                frontier.pop_back();
+            }
+            continue;
+        }
+
+        uint32_t id = static_cast<uint32_t>(region.rooms.size());
+        region.rooms.push_back(DungeonRoom{ roomCenter, size });
+        region.halls.push_back(DungeonHall{ hallCenter, hallSize, f.room, id, f.side });
+        index.insert(roomBox);
+        index.insert(BoundsFromCenterSize(hallCenter, hallSize));
+
+        frontier[pick] = frontier.back();
+        frontier.pop_back();
+        for (int side = 0; side < 4; ++side) {
+            AnchorDir ad = static_cast<AnchorDir>(side);
+            if (ad != OppositeDir(f.side)) frontier.push_back(Frontier{ id, ad, 0 });
+        }
+    }
+    return region;
+}
+
+} // namespace dungeon
+
+// boxes only, see the top of the file... pool = nullptr grows the regions one after another (same result)
+inline DungeonLayout GenerateDungeonLayout(const DungeonSettings& s, ThreadPool* pool = nullptr) {
+    using namespace dungeon;
+    DungeonLayout layout;
+    const int regionCount = std::max(1, (s.rooms + s.regionRooms - 1) / std::max(1, s.regionRooms));
+    int columns = 1;
+    while (columns * columns < regionCount) columns++;
+
+    // generous square per region: room + hallway pitch per room, with slack for rejected placements
+    const float pitch = std::max(s.maxRoomSize.x, s.maxRoomSize.z) + s.maxHallLength;
+    const float regionSide = ceilf(sqrtf(static_cast<float>(s.regionRooms))) * pitch * 1.6f;
+
+    // spanning "comb" over the region grid: every region links to its left neighbour, the first column links down
+    auto hasRegion = [&](int i, int j) { return i >= 0 && j >= 0 && i < columns && j * columns + i < regionCount; };
+    std::vector<Region> regions(regionCount);
+    auto grow = [&](size_t r) {
+        const int i = static_cast<int>(r) % columns, j = static_cast<int>(r) / columns;
+        bool links[4] = {};
+        links[static_cast<int>(AnchorDir::Left)] = hasRegion(i - 1, j);
+        links[static_cast<int>(AnchorDir::Right)] = hasRegion(i + 1, j);
+        links[static_cast<int>(AnchorDir::Front)] = i == 0 && hasRegion(i, j - 1);
+        links[static_cast<int>(AnchorDir::Back)] = i == 0 && hasRegion(i, j + 1);
+        BoundingBox bounds{ Vector3{ i * regionSide, -s.roomHeight, j * regionSide },
+                            Vector3{ (i + 1) * regionSide, s.roomHeight, (j + 1) * regionSide } };
+        const int target = s.rooms / regionCount + (static_cast<int>(r) < s.rooms % regionCount ? 1 : 0);
+        Rng seeder{ s.seed ^ (0xD1B54A32D192ED03ull * (r + 1)) };
+        regions[r] = GrowRegion(s, bounds, target, seeder.next(), links);
+    };
+    if (pool) pool->parallelFor(regions.size(), grow);
+    else for (size_t r = 0; r < regions.size(); ++r) grow(r);
+
+    // deterministic merge: region order, local indices offset by the rooms before them
+    std::vector<uint32_t> roots(regionCount);
+    for (int r = 0; r < regionCount; ++r) {
+        const uint32_t offset = static_cast<uint32_t>(layout.rooms.size());
+        roots[r] = offset;
+        layout.rooms.insert(layout.rooms.end(), regions[r].rooms.begin(), regions[r].rooms.end());
+        for (DungeonHall h : regions[r].halls) {
+            h.from += offset;
+            h.to += offset;
+            layout.halls.push_back(h);
+        }
+        layout.rejected += regions[r].rejected;
+    }
+    auto link = [&](uint32_t a, uint32_t b, AnchorDir side) {
+        const DungeonRoom& ra = layout.rooms[a];
+        const DungeonRoom& rb = layout.rooms[b];
+        Vector3 dir = AnchorDirVector(side);
+        Vector3 start = Vector3Add(ra.position, Vector3Scale(dir, HalfAlong(ra.size, dir)));
+        Vector3 end = Vector3Subtract(rb.position, Vector3Scale(dir, HalfAlong(rb.size, dir)));
+        float length = Vector3Length(Vector3Subtract(end, start));
+        layout.halls.push_back(DungeonHall{ Vector3Scale(Vector3Add(start, end), 0.5f), HallSize(s, dir, length), a, b, side });
+    };
+    for (int r = 0; r < regionCount; ++r) {
+        const int i = r % columns, j = r / columns;
+        if (i > 0) link(roots[r - 1], roots[r], AnchorDir::Right);
+        else if (j > 0) link(roots[r - columns], roots[r], AnchorDir::Back);
+    }
+    layout.regions = regionCount;
+    return layout;
+}
+
+// turns a layout into entities: rooms and hallways are prefab copies (same entities CreateRoom/CreateHallway would
+// make), both hallway ends joined with ConnectAnchors (the hallway is already in place, so the snap doesn't move it...
+// it only carves the doorways)
+inline DungeonEntities BuildDungeon(Registry& reg, TransformSystem& transforms, const DungeonLayout& layout, const TexturedRender& material = {}) {
+    using namespace dungeon;
+    DungeonEntities out;
+    std::vector<PrefabInstance> instances;
+    instances.reserve(layout.rooms.size());
+    for (const DungeonRoom& room : layout.rooms) instances.push_back(PrefabInstance{ room.position, room.size });
+    out.rooms = InstantiateRooms(reg, MakeRoomPrefab(material), instances);
+    instances.clear();
+    std::vector<AnchorDir> travel;
+    travel.reserve(layout.halls.size());
+    for (const DungeonHall& hall : layout.halls) {
+        instances.push_back(PrefabInstance{ hall.position, hall.size });
+        travel.push_back(hall.side);
+    }
+    out.halls = InstantiateHallways(reg, MakeHallwayPrefabs(material), instances, travel);
+
+    // anchors need their world positions for ConnectAnchors
+    transforms.update(reg);
+
+    for (size_t h = 0; h < layout.halls.size(); ++h) {
+        const DungeonHall& hall = layout.halls[h];
+        AnchorDir back = OppositeDir(hall.side);
+        Entity fromAnchor = FindAnchor(reg, out.rooms[hall.from], hall.side);
+        Entity toAnchor = FindAnchor(reg, out.rooms[hall.to], back);
+        Entity hallStart = FindAnchor(reg, out.halls[h], back);
+        Entity hallEnd = FindAnchor(reg, out.halls[h], hall.side);
+        ConnectAnchors(reg, fromAnchor, hallStart);
+        ConnectAnchors(reg, toAnchor, hallEnd);
+    }
+    transforms.update(reg);
+    return out;
+}
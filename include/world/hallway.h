@@ -2,29 +2,35 @@
 #include "../ecs/components.h"
 #include "../ecs/registry.h"
 #include "../textures/managed_texture.h"
+#include "anchor_index.h"
 #include "room.h"
 #include <memory>
 
-// a hallway is just a skinny room
+// true for hallways that run along x (travel Left/Right), false along z (Front/Back)
+inline bool HallRunsAlongX(AnchorDir travel) { return travel == AnchorDir::Left || travel == AnchorDir::Right; }
+
+// a hallway is just a skinny room, open at both ends of the axis it's walked along (`travel`, either direction)
+// note: the axis isn't taken from the size... short hallways can be narrower along their travel axis than across it
 // note: ConnectAnchors will carve openings automatically
-inline Entity CreateHallway(Registry& reg, Vector3 pos, Vector3 size,
-                         std::shared_ptr<ManagedTexture> texture = nullptr)
+inline Entity CreateHallway(Registry& reg, Vector3 pos, Vector3 size, AnchorDir travel,
+                         const TexturedRender& material = {}, AnchorIndex* anchorIndex = nullptr)
 {
     Entity hall = reg.create();
     reg.add<TransformComp>(hall, TransformComp{ pos, size });
     reg.add<WorldTransform>(hall, WorldTransform{});
     reg.add<Children>(hall, Children{});
+    reg.add<AnchorSlots>(hall, AnchorSlots{});
     
     Vector3 half = { size.x/2, size.y/2, size.z/2 }; // TODO: refactor with room?
     
-    // create side walls... no front/back walls for a hallway
+    // create side walls... no walls across the ends of a hallway
     auto makeWall = [&](Vector3 localPos, Vector3 sz, Wall::Side side) -> Entity {
         Entity wall = reg.create();
         reg.add<TransformComp>(wall, TransformComp{ localPos, sz });
         reg.add<WorldTransform>(wall, WorldTransform{});
         
-        if (texture) 
-            reg.add<TexturedRender>(wall, TexturedRender{ texture });
+        if (material.texture) 
+            reg.add<TexturedRender>(wall, material);
         else 
             reg.add<ColoredRender>(wall, ColoredRender{ GRAY });
             
@@ -39,14 +45,19 @@ inline Entity CreateHallway(Registry& reg, Vector3 pos, Vector3 size,
     };
     
     // floor and ceiling
-    makeWall({0, -half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Front);
-    makeWall({0,  half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Back);
+    makeWall({0, -half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Floor);
+    makeWall({0,  half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Ceiling);
     
     // side walls
-    makeWall({-half.x, 0, 0}, { 0.1f, size.y, size.z }, Wall::Side::Left);
-    makeWall({ half.x, 0, 0}, { 0.1f, size.y, size.z }, Wall::Side::Right);
+    if (HallRunsAlongX(travel)) {
+        makeWall({0, 0, -half.z}, { size.x, size.y, 0.1f }, Wall::Side::Front);
+        makeWall({0, 0,  half.z}, { size.x, size.y, 0.1f }, Wall::Side::Back);
+    } else {
+        makeWall({-half.x, 0, 0}, { 0.1f, size.y, size.z }, Wall::Side::Left);
+        makeWall({ half.x, 0, 0}, { 0.1f, size.y, size.z }, Wall::Side::Right);
+    }
     
-    auto addAnchor = [&](Vector3 localPos, Vector3 dir) -> Entity {
+    auto addAnchor = [&](Vector3 localPos, AnchorDir dir) -> Entity {
         Entity a = reg.create();
         reg.add<TransformComp>(a, TransformComp{ localPos, {0.1f, 0.1f, 0.1f} });
         reg.add<WorldTransform>(a, WorldTransform{});
@@ -55,13 +66,15 @@ inline Entity CreateHallway(Registry& reg, Vector3 pos, Vector3 size,
         
         if (auto children = reg.get<Children>(hall)) 
             children->entities.push_back(a);
+        if (auto slots = reg.get<AnchorSlots>(hall)) slots->anchors[static_cast<int>(dir)] = a;
+        if (anchorIndex) anchorIndex->add(a, Vector3Add(pos, localPos), dir);
              
         return a;
     };
     
-    addAnchor({0, 0, -half.z}, {0, 0, -1}); // front
-    addAnchor({0, 0, half.z}, {0, 0, 1}); // back
-    addAnchor({-half.x, 0, 0}, {-1, 0, 0}); // left
-    addAnchor({ half.x, 0, 0}, {1, 0, 0});  // right    
+    addAnchor({0, 0, -half.z}, AnchorDir::Front);
+    addAnchor({0, 0, half.z}, AnchorDir::Back);
+    addAnchor({-half.x, 0, 0}, AnchorDir::Left);
+    addAnchor({ half.x, 0, 0}, AnchorDir::Right);
     return hall;
 }
\ No newline at end of file
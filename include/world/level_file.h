@@ -0,0 +1,396 @@
+#pragma once
+#include "../core/mapped_file.h"
+#include "../ecs/components.h"
+#include "../ecs/prefab.h"
+#include "../ecs/registry.h"
+#include "../textures/asset_cache.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// .level: a whole world (rooms, hallways, walls, anchors and their links, texture references) laid out the way the
+// component pools hold it, so loading is a few range inserts instead of rebuilding the level entity by entity:
+//   header | sections[sectionCount] | textures[textureCount] | key chars | per section: entities, values, extra
+// - one section per component type: its entities (ascending) and their values, plain structs as they sit in memory
+// - entities are renumbered 1..entityCount, version 1... exactly what a fresh Registry hands out, so loading into an
+//   empty registry adds the plain sections straight from the mapped file (entity references included); otherwise
+//   every reference goes through a remap table
+// - Children are ranges into the section's extra block, TexturedRender keeps an index into the texture table
+//   (AssetCache keys) instead of a handle
+// - the writer starts every block on a 16 byte boundary, the parser only insists on 4 (all any stored value needs)
+// note: caches (BakedMesh, broadphases) aren't stored, they get rebuilt like for any new entity
+// note: the layout is the in-memory one (sizes are checked on load, endianness isn't)... bump VERSION when a
+//       component changes
+struct LevelFileHeader {
+    static constexpr uint32_t MAGIC = 0x4C56454C; // "LEVL"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t entityCount = 0;
+    uint32_t sectionCount = 0;
+    uint32_t textureCount = 0;
+    uint32_t keyBytes = 0;
+    uint64_t texturesAt = 0;
+    uint64_t keysAt = 0;
+};
+static_assert(sizeof(LevelFileHeader) == 40);
+
+struct LevelSection {
+    uint32_t component = 0;  // index into LevelComponents
+    uint32_t count = 0;
+    uint32_t valueSize = 0;  // sizeof the stored value, checked against this build's
+    uint32_t extraCount = 0; // Children: entities in the extra block
+    uint64_t entitiesAt = 0;
+    uint64_t valuesAt = 0;
+    uint64_t extraAt = 0;
+};
+static_assert(sizeof(LevelSection) == 40);
+
+struct LevelTexture {
+    uint32_t keyOffset = 0;
+    uint32_t keyLength = 0;
+};
+
+// a Children list in the file
+struct LevelRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+// what gets saved, in section order (append only, the index is the on-disk id)
+using LevelComponents = std::tuple<TransformComp, WorldTransform, Parent, Children, ColoredRender, TexturedRender, Collision,
+                                   Wall, Anchor, AnchorSlots, StaticBatched>;
+
+template<typename T>
+using LevelValue = std::conditional_t<std::is_same_v<T, Children>, LevelRange, T>;
+
+// f.template operator()<T>(id) for every saved component type
+template<typename F>
+void ForEachLevelComponent(F&& f) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        (f.template operator()<std::tuple_element_t<I, LevelComponents>>(static_cast<uint32_t>(I)), ...);
+    }(std::make_index_sequence<std::tuple_size_v<LevelComponents>>{});
+}
+
+// types whose file value is used as is (when the entity ids line up)
+template<typename T>
+constexpr bool LevelValueInPlace = !std::is_same_v<T, Children> && !std::is_same_v<T, TexturedRender>;
+
+// pointers into a loaded .level (a MappedFile, or a LevelFile in memory), nothing is copied
+struct LevelFileView {
+    const uint8_t* bytes = nullptr;
+    const LevelFileHeader* header = nullptr;
+    const LevelSection* sections = nullptr;
+    const LevelTexture* textures = nullptr;
+    const char* keys = nullptr;
+
+    [[nodiscard]] bool valid() const { return header != nullptr; }
+    [[nodiscard]] std::string_view textureKey(uint32_t i) const { return { keys + textures[i].keyOffset, textures[i].keyLength }; }
+
+    template<typename T>
+    [[nodiscard]] std::span<const T> block(uint64_t at, size_t count) const { return { reinterpret_cast<const T*>(bytes + at), count }; }
+    [[nodiscard]] std::span<const Entity> entities(const LevelSection& s) const { return block<Entity>(s.entitiesAt, s.count); }
+};
+
+// enum fields a file could put out of range... they index fixed tables (AnchorDirVector, OppositeDir, AnchorSlots)
+inline bool LevelEnumsInRange(const Wall& w) { return static_cast<uint32_t>(w.side) <= static_cast<uint32_t>(Wall::Side::Ceiling); }
+inline bool LevelEnumsInRange(const Anchor& a) { return static_cast<uint32_t>(a.dir) <= static_cast<uint32_t>(AnchorDir::Right); }
+
+// checks sizes, ranges and entity ids, including the references inside values (Parent, Anchor links, Children...),
+// and enums (Wall::side, Anchor::dir), never trusts the file... points the view into `data`, false if it isn't a
+// valid .level for this build
+inline bool ParseLevelFile(const void* data, size_t size, LevelFileView& view) {
+    view = LevelFileView{};
+    if (data == nullptr || size < sizeof(LevelFileHeader)) return false;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const auto* header = reinterpret_cast<const LevelFileHeader*>(bytes);
+    if (header->magic != LevelFileHeader::MAGIC || header->version != LevelFileHeader::VERSION || header->entityCount >= (1u << 24))
+        return false;
+    auto fits = [&](uint64_t at, uint64_t count, uint64_t stride) {
+        return at % 4 == 0 && at <= size && count <= (size - at) / std::max<uint64_t>(stride, 1);
+    };
+    // a reference stored in a value: null, or one of the file's entities (what WriteLevel's renumbering produces)
+    auto refersIntoFile = [&](Entity e) { return e == INVALID_ENTITY || (e.id >= 1 && e.id <= header->entityCount && e.version == 1); };
+    if (!fits(sizeof(LevelFileHeader), header->sectionCount, sizeof(LevelSection)) ||
+        !fits(header->texturesAt, header->textureCount, sizeof(LevelTexture)) || !fits(header->keysAt, header->keyBytes, 1))
+        return false;
+
+    const auto* sections = reinterpret_cast<const LevelSection*>(bytes + sizeof(LevelFileHeader));
+    const auto* textures = reinterpret_cast<const LevelTexture*>(bytes + header->texturesAt);
+    for (uint32_t t = 0; t < header->textureCount; ++t)
+        if (uint64_t{ textures[t].keyOffset } + textures[t].keyLength > header->keyBytes) return false;
+
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < header->sectionCount; ++i) {
+        const LevelSection& s = sections[i];
+        if (s.component >= std::tuple_size_v<LevelComponents> || (seen & (1u << s.component)) || s.count > header->entityCount) return false;
+        seen |= 1u << s.component;
+        bool ok = true;
+        ForEachLevelComponent([&]<typename T>(uint32_t id) {
+            static_assert(alignof(LevelValue<T>) <= 4, "fits() only checks 4 byte alignment");
+            if (id != s.component) return;
+            ok = s.valueSize == sizeof(LevelValue<T>) && fits(s.valuesAt, s.count, sizeof(LevelValue<T>)) &&
+                 fits(s.entitiesAt, s.count, sizeof(Entity)) && fits(s.extraAt, s.extraCount, sizeof(Entity));
+            if (!ok) return;
+            if constexpr (std::is_same_v<T, Children>) {
+                for (const LevelRange& r : std::span(reinterpret_cast<const LevelRange*>(bytes + s.valuesAt), s.count))
+                    if (uint64_t{ r.first } + r.count > s.extraCount) ok = false;
+                for (Entity e : std::span(reinterpret_cast<const Entity*>(bytes + s.extraAt), s.extraCount))
+                    if (!refersIntoFile(e)) ok = false;
+            } else if constexpr (requires(T& v) { ForEachEntityRef(v, [](Entity e) { return e; }); }) {
+                // the same walk InstantiateLevel remaps with, on a copy
+                for (T value : std::span(reinterpret_cast<const T*>(bytes + s.valuesAt), s.count))
+                    ForEachEntityRef(value, [&](Entity e) {
+                        if (!refersIntoFile(e)) ok = false;
+                        return e;
+                    });
+            }
+            if constexpr (requires(const T& v) { LevelEnumsInRange(v); }) {
+                for (const T& value : std::span(reinterpret_cast<const T*>(bytes + s.valuesAt), s.count))
+                    if (!LevelEnumsInRange(value)) ok = false;
+            }
+        });
+        if (!ok) return false;
+        // strictly ascending, in range, version 1: no entity twice in a pool
+        uint32_t last = 0;
+        for (Entity e : std::span(reinterpret_cast<const Entity*>(bytes + s.entitiesAt), s.count)) {
+            if (e.id <= last || e.id > header->entityCount || e.version != 1) return false;
+            last = e.id;
+        }
+    }
+
+    view.bytes = bytes;
+    view.header = header;
+    view.sections = sections;
+    view.textures = textures;
+    view.keys = reinterpret_cast<const char*>(bytes + header->keysAt);
+    return true;
+}
+
+// the whole .level in memory, SaveLevel() writes it as is and ParseLevelFile() reads it back
+struct LevelFile {
+    std::vector<uint8_t> bytes;
+
+    [[nodiscard]] LevelFileView view() const {
+        LevelFileView v;
+        ParseLevelFile(bytes.data(), bytes.size(), v);
+        return v;
+    }
+};
+
+// every entity that has one of the LevelComponents... textures are saved by their AssetCache key (without a cache,
+// or for handles it doesn't know, as no texture)
+inline LevelFile WriteLevel(const Registry& reg, const AssetCache* assets = nullptr) {
+    // renumber by id, so parents come before their children like they were created
+    std::vector<Entity> liveById;
+    ForEachLevelComponent([&]<typename T>(uint32_t) {
+        for (const auto& [e, value] : reg.view<T>()) {
+            if (e.id >= liveById.size()) liveById.resize(e.id + 1, INVALID_ENTITY);
+            liveById[e.id] = e;
+        }
+    });
+    std::vector<uint32_t> fileId(liveById.size(), 0);
+    uint32_t entityCount = 0;
+    for (uint32_t id = 1; id < liveById.size(); ++id)
+        if (liveById[id] != INVALID_ENTITY) fileId[id] = ++entityCount;
+    auto toFile = [&](Entity e) { return e.id != 0 && e.id < liveById.size() && liveById[e.id] == e ? Entity{ fileId[e.id], 1 } : INVALID_ENTITY; };
+
+    std::vector<std::string> keys;
+    std::vector<std::pair<uint32_t, uint32_t>> textureIndex; // handle value -> key index + 1
+    auto textureOf = [&](TextureHandle h) -> uint32_t {
+        if (!h || !assets) return 0;
+        auto it = std::find_if(textureIndex.begin(), textureIndex.end(), [&](const auto& p) { return p.first == h.value; });
+        if (it != textureIndex.end()) return it->second;
+        std::string key = assets->keyOf(h);
+        uint32_t index = 0;
+        if (!key.empty()) {
+            auto same = std::find(keys.begin(), keys.end(), key);
+            index = static_cast<uint32_t>(same - keys.begin()) + 1;
+            if (same == keys.end()) keys.push_back(std::move(key));
+        }
+        textureIndex.push_back({ h.value, index });
+        return index;
+    };
+
+    // sections first, offsets once everything is known
+    struct Pending {
+        LevelSection section;
+        std::vector<Entity> entities;
+        std::vector<uint8_t> values;
+        std::vector<Entity> extra;
+    };
+    std::vector<Pending> pending;
+    ForEachLevelComponent([&]<typename T>(uint32_t id) {
+        std::vector<std::pair<uint32_t, const T*>> rows;
+        for (const auto& [e, value] : reg.view<T>()) rows.push_back({ fileId[e.id], value });
+        if (rows.empty()) return;
+        std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        Pending p;
+        std::vector<LevelValue<T>> values;
+        values.reserve(rows.size());
+        p.entities.reserve(rows.size());
+        for (const auto& [file, value] : rows) {
+            p.entities.push_back(Entity{ file, 1 });
+            if constexpr (std::is_same_v<T, Children>) {
+                values.push_back(LevelRange{ static_cast<uint32_t>(p.extra.size()), static_cast<uint32_t>(value->entities.size()) });
+                for (Entity child : value->entities) p.extra.push_back(toFile(child));
+            } else {
+                T copy = *value;
+                if constexpr (requires(T& v) { ForEachEntityRef(v, [](Entity e) { return e; }); })
+                    ForEachEntityRef(copy, toFile);
+                if constexpr (std::is_same_v<T, TexturedRender>) copy.texture.value = textureOf(copy.texture);
+                values.push_back(copy);
+            }
+        }
+        p.values.resize(values.size() * sizeof(LevelValue<T>));
+        std::memcpy(p.values.data(), values.data(), p.values.size());
+        p.section.component = id;
+        p.section.count = static_cast<uint32_t>(rows.size());
+        p.section.valueSize = sizeof(LevelValue<T>);
+        p.section.extraCount = static_cast<uint32_t>(p.extra.size());
+        pending.push_back(std::move(p));
+    });
+
+    std::vector<LevelTexture> textures;
+    std::string keyChars;
+    for (const std::string& key : keys) {
+        textures.push_back(LevelTexture{ static_cast<uint32_t>(keyChars.size()), static_cast<uint32_t>(key.size()) });
+        keyChars += key;
+    }
+
+    auto align = [](uint64_t at) { return (at + 15) & ~uint64_t{ 15 }; };
+    LevelFileHeader header;
+    header.entityCount = entityCount;
+    header.sectionCount = static_cast<uint32_t>(pending.size());
+    header.textureCount = static_cast<uint32_t>(textures.size());
+    header.keyBytes = static_cast<uint32_t>(keyChars.size());
+    uint64_t at = sizeof(LevelFileHeader) + pending.size() * sizeof(LevelSection);
+    header.texturesAt = align(at);
+    header.keysAt = align(header.texturesAt + textures.size() * sizeof(LevelTexture));
+    at = align(header.keysAt + keyChars.size());
+    for (Pending& p : pending) {
+        p.section.entitiesAt = at;
+        p.section.valuesAt = align(at + p.entities.size() * sizeof(Entity));
+        p.section.extraAt = align(p.section.valuesAt + p.values.size());
+        at = align(p.section.extraAt + p.extra.size() * sizeof(Entity));
+    }
+
+    LevelFile file;
+    file.bytes.assign(at, 0);
+    auto put = [&](uint64_t offset, const void* src, size_t n) {
+        if (n) std::memcpy(file.bytes.data() + offset, src, n);
+    };
+    put(0, &header, sizeof(header));
+    for (size_t i = 0; i < pending.size(); ++i) put(sizeof(header) + i * sizeof(LevelSection), &pending[i].section, sizeof(LevelSection));
+    put(header.texturesAt, textures.data(), textures.size() * sizeof(LevelTexture));
+    put(header.keysAt, keyChars.data(), keyChars.size());
+    for (const Pending& p : pending) {
+        put(p.section.entitiesAt, p.entities.data(), p.entities.size() * sizeof(Entity));
+        put(p.section.valuesAt, p.values.data(), p.values.size());
+        put(p.section.extraAt, p.extra.data(), p.extra.size() * sizeof(Entity));
+    }
+    return file;
+}
+
+inline bool SaveLevel(const LevelFile& file, const char* path) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(file.bytes.data(), 1, file.bytes.size(), f) == file.bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// what InstantiateLevel made: the new entity of each file id (entities[id - 1]) and the texture references it took
+struct LevelInstance {
+    std::vector<Entity> entities;
+    std::vector<TextureHandle> textures; // one reference each, see ReleaseLevelTextures
+};
+
+// drops the references InstantiateLevel took, once the level's entities are gone (collect() unloads what's unused)
+inline void ReleaseLevelTextures(LevelInstance& level, AssetCache& assets) {
+    for (TextureHandle h : level.textures) assets.release(h);
+    level.textures.clear();
+}
+
+// creates the level's entities and adds every section
+// - into an empty registry the new ids are the file's, plain sections go from the view into the pools as ranges
+// - otherwise (or for Children/TexturedRender) values are copied with their references remapped
+// - texture keys resolve through assets: a key it already has (an atlas, say) or a file that exists... one reference
+//   taken per key, like loadTexture(), and handed back in LevelInstance::textures
+inline LevelInstance InstantiateLevel(Registry& reg, const LevelFileView& view, AssetCache* assets = nullptr) {
+    if (!view.valid()) return {};
+    LevelInstance level;
+    std::vector<Entity>& entities = level.entities;
+    entities.resize(view.header->entityCount);
+    reg.create(entities);
+    bool sameIds = true;
+    for (uint32_t i = 0; i < entities.size() && sameIds; ++i) sameIds = entities[i] == Entity{ i + 1, 1 };
+    auto fromFile = [&](Entity e) { return e.id >= 1 && e.id <= entities.size() && e.version == 1 ? entities[e.id - 1] : INVALID_ENTITY; };
+
+    std::vector<TextureHandle> handles(view.header->textureCount);
+    for (uint32_t t = 0; t < handles.size() && assets; ++t) {
+        std::string key(view.textureKey(t));
+        handles[t] = assets->find(key);
+        if (handles[t]) assets->retain(handles[t]);
+        else if (std::filesystem::exists(key)) handles[t] = assets->loadTexture(key);
+        if (handles[t]) level.textures.push_back(handles[t]);
+    }
+
+    for (uint32_t i = 0; i < view.header->sectionCount; ++i) {
+        const LevelSection& s = view.sections[i];
+        ForEachLevelComponent([&]<typename T>(uint32_t id) {
+            if (id != s.component) return;
+            std::span<const LevelValue<T>> values = view.block<LevelValue<T>>(s.valuesAt, s.count);
+            if constexpr (LevelValueInPlace<T>) {
+                if (sameIds) {
+                    reg.add<T>(view.entities(s), values);
+                    return;
+                }
+            }
+            std::vector<Entity> es;
+            es.reserve(s.count);
+            for (Entity e : view.entities(s)) es.push_back(fromFile(e));
+            std::vector<T> out;
+            out.reserve(s.count);
+            if constexpr (std::is_same_v<T, Children>) {
+                std::span<const Entity> extra = view.block<Entity>(s.extraAt, s.extraCount);
+                for (const LevelRange& r : values) {
+                    Children& c = out.emplace_back();
+                    c.entities.reserve(r.count);
+                    for (Entity child : extra.subspan(r.first, r.count)) c.entities.push_back(fromFile(child));
+                }
+            } else {
+                for (const T& value : values) {
+                    T& copy = out.emplace_back(value);
+                    if constexpr (requires(T& v) { ForEachEntityRef(v, [](Entity e) { return e; }); })
+                        ForEachEntityRef(copy, fromFile);
+                    if constexpr (std::is_same_v<T, TexturedRender>)
+                        copy.texture = copy.texture.value >= 1 && copy.texture.value <= handles.size() ? handles[copy.texture.value - 1] : TextureHandle{};
+                }
+            }
+            reg.add<T>(std::span<const Entity>(es), std::span<const T>(out));
+        });
+    }
+    return level;
+}
+
+// maps the file, instantiates it and unmaps it again... false (and nothing created) if it isn't a valid .level
+// note: with assets, keep `level` to ReleaseLevelTextures() later... without it the references can't be dropped
+inline bool LoadLevel(Registry& reg, const std::string& path, AssetCache* assets = nullptr, LevelInstance* level = nullptr) {
+    MappedFile file(path);
+    LevelFileView view;
+    if (!file.isOpen() || !ParseLevelFile(file.data(), file.size(), view)) return false;
+    LevelInstance created = InstantiateLevel(reg, view, assets);
+    if (level) *level = std::move(created);
+    return true;
+}
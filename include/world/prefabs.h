@@ -0,0 +1,74 @@
+#pragma once
+#include "../ecs/components.h"
+#include "../ecs/prefab.h"
+#include "../ecs/registry.h"
+#include "anchor_index.h"
+#include "hallway.h"
+#include "room.h"
+#include <cassert>
+#include <span>
+#include <vector>
+
+// prefab versions of CreateRoom/CreateHallway: the layout is built once in a scratch registry and captured, then
+// stamped out per room (PrefabInstance: position, size, material)... same entities, components and child order as
+// the Create* functions, minus the per-entity adds
+// note: prefabs are captured at a round template size, so the +-half positions stretch exactly (see PrefabStretchPosition)
+
+inline Prefab MakeRoomPrefab(const TexturedRender& material = {}, const std::vector<Wall::Side>& skipWalls = {}) {
+    Registry scratch;
+    return Prefab::Capture(scratch, CreateRoom(scratch, { 0, 0, 0 }, { 10, 10, 10 }, material, skipWalls));
+}
+
+// hallways lay out their side walls by their travel axis, so there's one prefab per axis
+struct HallwayPrefabs {
+    Prefab alongZ;
+    Prefab alongX;
+
+    const Prefab& forTravel(AnchorDir travel) const { return HallRunsAlongX(travel) ? alongX : alongZ; }
+};
+
+inline HallwayPrefabs MakeHallwayPrefabs(const TexturedRender& material = {}) {
+    Registry scratch;
+    HallwayPrefabs prefabs;
+    prefabs.alongZ = Prefab::Capture(scratch, CreateHallway(scratch, { 0, 0, 0 }, { 4, 10, 20 }, AnchorDir::Back, material));
+    prefabs.alongX = Prefab::Capture(scratch, CreateHallway(scratch, { 0, 0, 0 }, { 20, 10, 4 }, AnchorDir::Right, material));
+    return prefabs;
+}
+
+// the copies' anchors, registered as free (what CreateRoom/CreateHallway do with their anchorIndex argument)
+inline void AddPrefabAnchors(const Registry& reg, std::span<const Entity> owners, std::span<const PrefabInstance> instances, AnchorIndex& index) {
+    for (size_t k = 0; k < owners.size(); ++k) {
+        auto slots = reg.get<AnchorSlots>(owners[k]);
+        if (!slots) continue;
+        for (Entity a : slots->anchors)
+            if (auto anchor = reg.get<Anchor>(a)) index.add(a, Vector3Add(instances[k].position, anchor->localPos), anchor->dir);
+    }
+}
+
+inline std::vector<Entity> InstantiateRooms(Registry& reg, const Prefab& room, std::span<const PrefabInstance> instances,
+                                            AnchorIndex* anchorIndex = nullptr) {
+    std::vector<Entity> rooms = room.instantiate(reg, instances);
+    if (anchorIndex) AddPrefabAnchors(reg, rooms, instances, *anchorIndex);
+    return rooms;
+}
+
+// travel[k]: which way instances[k] is walked (CreateHallway's travel)... returned in instance order
+inline std::vector<Entity> InstantiateHallways(Registry& reg, const HallwayPrefabs& prefabs, std::span<const PrefabInstance> instances,
+                                               std::span<const AnchorDir> travel, AnchorIndex* anchorIndex = nullptr) {
+    assert(travel.size() == instances.size());
+    std::vector<PrefabInstance> byAxis[2];
+    std::vector<size_t> order[2];
+    for (size_t k = 0; k < instances.size(); ++k) {
+        int axis = HallRunsAlongX(travel[k]) ? 1 : 0; // forTravel()
+        byAxis[axis].push_back(instances[k]);
+        order[axis].push_back(k);
+    }
+    std::vector<Entity> halls(instances.size());
+    for (int axis = 0; axis < 2; ++axis) {
+        const Prefab& prefab = axis ? prefabs.alongX : prefabs.alongZ;
+        std::vector<Entity> made = prefab.instantiate(reg, byAxis[axis]);
+        for (size_t i = 0; i < made.size(); ++i) halls[order[axis][i]] = made[i];
+    }
+    if (anchorIndex) AddPrefabAnchors(reg, halls, instances, *anchorIndex);
+    return halls;
+}
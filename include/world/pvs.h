@@ -0,0 +1,247 @@
+#pragma once
+#include "cell_graph.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// potentially-visible set: one bit row per cell, bit j set if cell j can ever be seen from inside cell i
+// built offline from the CellGraph (see tools/pvs_builder.cpp), looked up at runtime by PortalVisibilitySystem
+class Pvs {
+private:
+    uint32_t cellCount = 0;
+    uint32_t wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+    std::vector<BoundingBox> cellBounds; // to check a loaded file still matches the level
+
+    static constexpr uint32_t MAGIC = 0x31535650; // "PVS1"
+    static constexpr uint32_t VERSION = 1;
+
+public:
+    Pvs() = default;
+
+    void reset(const CellGraph& graph) {
+        cellCount = static_cast<uint32_t>(graph.getCells().size());
+        wordsPerRow = (cellCount + 63) / 64;
+        bits.assign(static_cast<size_t>(cellCount) * wordsPerRow, 0);
+        cellBounds.clear();
+        for (const auto& cell : graph.getCells()) cellBounds.push_back(cell.bounds);
+    }
+
+    void set(uint32_t from, uint32_t to) {
+        bits[static_cast<size_t>(from) * wordsPerRow + to / 64] |= uint64_t{1} << (to % 64);
+    }
+
+    [[nodiscard]] bool isVisible(uint32_t from, uint32_t to) const {
+        if (from >= cellCount || to >= cellCount) return true; // unknown cells are never culled
+        return (bits[static_cast<size_t>(from) * wordsPerRow + to / 64] >> (to % 64)) & 1;
+    }
+
+    [[nodiscard]] size_t visibleCount(uint32_t from) const {
+        size_t n = 0;
+        for (uint32_t w = 0; w < wordsPerRow; ++w)
+            n += static_cast<size_t>(__builtin_popcountll(bits[static_cast<size_t>(from) * wordsPerRow + w]));
+        return n;
+    }
+
+    [[nodiscard]] uint32_t size() const { return cellCount; }
+    [[nodiscard]] bool empty() const { return cellCount == 0; }
+
+    // same cells in the same order... a stale file (level edited after the build) is ignored
+    [[nodiscard]] bool matches(const CellGraph& graph) const {
+        const auto& cells = graph.getCells();
+        if (cells.size() != cellCount) return false;
+        for (uint32_t i = 0; i < cellCount; ++i) {
+            const BoundingBox& a = cells[i].bounds;
+            const BoundingBox& b = cellBounds[i];
+            if (fabsf(a.min.x - b.min.x) > 0.01f || fabsf(a.min.y - b.min.y) > 0.01f || fabsf(a.min.z - b.min.z) > 0.01f ||
+                fabsf(a.max.x - b.max.x) > 0.01f || fabsf(a.max.y - b.max.y) > 0.01f || fabsf(a.max.z - b.max.z) > 0.01f)
+                return false;
+        }
+        return true;
+    }
+
+    // layout: magic, version, cellCount, wordsPerRow, cell bounds (6 floats each), bit rows
+    bool save(const std::string& path) const {
+        FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        const uint32_t header[4] = { MAGIC, VERSION, cellCount, wordsPerRow };
+        bool ok = std::fwrite(header, sizeof(header), 1, f) == 1;
+        if (ok && cellCount > 0) {
+            ok = std::fwrite(cellBounds.data(), sizeof(BoundingBox), cellCount, f) == cellCount &&
+                 std::fwrite(bits.data(), sizeof(uint64_t), bits.size(), f) == bits.size();
+        }
+        std::fclose(f);
+        return ok;
+    }
+
+    bool load(const std::string& path) {
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        uint32_t header[4];
+        bool ok = std::fread(header, sizeof(header), 1, f) == 1 &&
+                  header[0] == MAGIC && header[1] == VERSION && header[3] == (header[2] + 63) / 64;
+        if (ok) {
+            cellCount = header[2];
+            wordsPerRow = header[3];
+            cellBounds.resize(cellCount);
+            bits.resize(static_cast<size_t>(cellCount) * wordsPerRow);
+            ok = std::fread(cellBounds.data(), sizeof(BoundingBox), cellCount, f) == cellCount &&
+                 std::fread(bits.data(), sizeof(uint64_t), bits.size(), f) == bits.size();
+        }
+        std::fclose(f);
+        if (!ok) *this = Pvs{};
+        return ok;
+    }
+};
+
+struct PvsBuildSettings {
+    unsigned threads = 0; // 0 = hardware_concurrency
+    uint8_t maxDepth = 255; // longest portal chain followed from a source cell (chain lengths are stored as bytes)
+};
+
+namespace pvs_detail {
+    // portal normals are axis aligned: index = axis * 2 + (negative ? 1 : 0), opposite = index ^ 1
+    inline int DirIndex(const Vector3& n) {
+        if (fabsf(n.x) > 0.5f) return n.x > 0 ? 0 : 1;
+        if (fabsf(n.y) > 0.5f) return n.y > 0 ? 2 : 3;
+        return n.z > 0 ? 4 : 5;
+    }
+
+    // furthest signed extent of a box along direction d (e.g. -min.x for -x)
+    inline float Reach(const BoundingBox& b, int d) {
+        const Vector3& v = (d & 1) ? b.min : b.max;
+        float c = (d >> 1) == 0 ? v.x : ((d >> 1) == 1 ? v.y : v.z);
+        return (d & 1) ? -c : c;
+    }
+
+    // conservative portal flow from one source cell
+    // a straight sight line crosses every portal along its normal, so along a chain of portals
+    //  - no two portals can face opposite ways
+    //  - along every direction already crossed the line only moves forward, so the next portal must
+    //    reach past the furthest plane crossed so far in that direction ("frontier")
+    // both are necessary conditions, so a cell is only dropped when no line can reach it
+    // paths are merged per (cell, direction mask) keeping the weakest frontier, which keeps it polynomial
+    // a chain never holds opposite directions, so a mask is one of 3^3 = 27 combinations
+    constexpr size_t MASK_CODES = 27;
+
+    inline size_t MaskCode(uint8_t mask) {
+        size_t code = 0, scale = 1;
+        for (int axis = 0; axis < 3; ++axis, scale *= 3) {
+            if (mask & (1u << (axis * 2))) code += scale;
+            else if (mask & (1u << (axis * 2 + 1))) code += 2 * scale;
+        }
+        return code;
+    }
+
+    struct FlowState {
+        uint32_t cell;
+        uint8_t mask;
+        float frontier[6];
+    };
+
+    struct Flow {
+        const CellGraph& graph;
+        uint8_t maxDepth;
+        std::vector<float> best;        // [cell * 27 + mask code][6] weakest frontier seen, NAN = never reached
+        std::vector<uint8_t> depth;     // [cell * 27 + mask code] chain length of that state
+        std::vector<uint32_t> touched;  // states to reset before the next source
+        std::vector<FlowState> work;
+
+        Flow(const CellGraph& g, uint8_t depthLimit)
+            : graph(g), maxDepth(depthLimit), best(g.getCells().size() * MASK_CODES * 6, NAN), depth(g.getCells().size() * MASK_CODES, 0) {}
+
+        // true if the state was new or got a weaker frontier (needs (re)expanding)
+        bool merge(const FlowState& s, uint8_t d) {
+            size_t key = static_cast<size_t>(s.cell) * MASK_CODES + MaskCode(s.mask);
+            float* stored = &best[key * 6];
+            if (std::isnan(stored[0])) {
+                std::copy(s.frontier, s.frontier + 6, stored);
+                depth[key] = d;
+                touched.push_back(static_cast<uint32_t>(key));
+                return true;
+            }
+            bool weaker = false;
+            for (int i = 0; i < 6; ++i) {
+                if (s.frontier[i] < stored[i]) {
+                    stored[i] = s.frontier[i];
+                    weaker = true;
+                }
+            }
+            if (d < depth[key]) {
+                depth[key] = d;
+                weaker = true;
+            }
+            return weaker;
+        }
+
+        void run(Pvs& pvs, uint32_t source) {
+            for (uint32_t key : touched) best[static_cast<size_t>(key) * 6] = NAN;
+            touched.clear();
+            work.clear();
+
+            FlowState start{ source, 0, { -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY, -INFINITY } };
+            merge(start, 0);
+            work.push_back(start);
+
+            const auto& portals = graph.getPortals();
+            while (!work.empty()) {
+                FlowState s = work.back();
+                work.pop_back();
+                size_t key = static_cast<size_t>(s.cell) * MASK_CODES + MaskCode(s.mask);
+                std::copy(&best[key * 6], &best[key * 6] + 6, s.frontier); // may have been weakened since it was queued
+                pvs.set(source, s.cell);
+                uint8_t d = depth[key];
+                if (d >= maxDepth) continue;
+
+                for (uint32_t pi : graph.getCells()[s.cell].portals) {
+                    const Portal& portal = portals[pi];
+                    int dir = DirIndex(portal.normal);
+                    if (s.mask & (1u << (dir ^ 1))) continue;
+
+                    bool reaches = true;
+                    for (int k = 0; k < 6 && reaches; ++k) {
+                        if (s.mask & (1u << k)) reaches = Reach(portal.opening, k) >= s.frontier[k] - 0.001f;
+                    }
+                    if (!reaches) continue;
+
+                    FlowState next = s;
+                    next.cell = portal.toCell;
+                    next.mask = static_cast<uint8_t>(s.mask | (1u << dir));
+                    // the portal is flat in its own axis, so min/max agree on the plane crossed
+                    next.frontier[dir] = std::max(s.frontier[dir], Reach(portal.opening, dir));
+                    if (merge(next, static_cast<uint8_t>(d + 1))) work.push_back(next);
+                }
+            }
+        }
+    };
+}
+
+// one row per source cell, rows are independent so they are split across threads...
+// every row is written by exactly one worker, the result does not depend on the thread count
+inline Pvs BuildPvs(const CellGraph& graph, const PvsBuildSettings& settings = {}) {
+    Pvs pvs;
+    pvs.reset(graph);
+    const uint32_t cellCount = pvs.size();
+    if (cellCount == 0) return pvs;
+
+    unsigned threadCount = settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<unsigned>(threadCount, cellCount);
+
+    std::atomic<uint32_t> nextCell{0};
+    auto worker = [&]() {
+        pvs_detail::Flow flow(graph, settings.maxDepth);
+        for (uint32_t source = nextCell++; source < cellCount; source = nextCell++) {
+            flow.run(pvs, source);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threadCount; ++i) workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers) t.join();
+    return pvs;
+}
@@ -2,17 +2,20 @@
 #include "../ecs/components.h"
 #include "../ecs/registry.h"
 #include "../textures/managed_texture.h"
+#include "anchor_index.h"
 #include <algorithm>
 #include <vector>
-#include <iostream>
 #include <memory>
 
 // room with optional skipped walls (skipWalls are currently full openings)
-inline Entity CreateRoom(Registry& reg, Vector3 pos, Vector3 size, std::shared_ptr<ManagedTexture> texture = nullptr, const std::vector<Wall::Side>& skipWalls = {}) {
+// material: texture (+ atlas tile) for every wall, untextured = flat gray
+// anchorIndex: if given, the room's four anchors are registered there as free
+inline Entity CreateRoom(Registry& reg, Vector3 pos, Vector3 size, const TexturedRender& material = {}, const std::vector<Wall::Side>& skipWalls = {}, AnchorIndex* anchorIndex = nullptr) {
     Entity room = reg.create();
     reg.add<TransformComp>(room, TransformComp{ pos, size });
     reg.add<WorldTransform>(room, WorldTransform{});
     reg.add<Children>(room, Children{});
+    reg.add<AnchorSlots>(room, AnchorSlots{});
     
     Vector3 half = { size.x/2, size.y/2, size.z/2 };
     
@@ -25,8 +28,8 @@ inline Entity CreateRoom(Registry& reg, Vector3 pos, Vector3 size, std::shared_p
         reg.add<TransformComp>(wall, TransformComp{ localPos, sz });
         reg.add<WorldTransform>(wall, WorldTransform{});
         
-        if (texture) 
-            reg.add<TexturedRender>(wall, TexturedRender{ texture });
+        if (material.texture) 
+            reg.add<TexturedRender>(wall, material);
         else 
             reg.add<ColoredRender>(wall, ColoredRender{ GRAY });
             
@@ -42,8 +45,8 @@ inline Entity CreateRoom(Registry& reg, Vector3 pos, Vector3 size, std::shared_p
     };
     
     // floor and ceiling
-    makeWall({0, -half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Front);
-    makeWall({0,  half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Back);
+    makeWall({0, -half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Floor);
+    makeWall({0,  half.y, 0}, { size.x, 0.1f, size.z }, Wall::Side::Ceiling);
     
     // side walls
     makeWall({-half.x, 0, 0}, { 0.1f, size.y, size.z }, Wall::Side::Left);
@@ -54,7 +57,7 @@ inline Entity CreateRoom(Registry& reg, Vector3 pos, Vector3 size, std::shared_p
     makeWall({0, 0,  half.z}, { size.x, size.y, 0.1f }, Wall::Side::Back);
     
     // anchors for connections (all walls have anchors)
-    auto addAnchor = [&](Vector3 localPos, Vector3 dir) -> Entity {
+    auto addAnchor = [&](Vector3 localPos, AnchorDir dir) -> Entity {
         Entity a = reg.create();
         reg.add<TransformComp>(a, TransformComp{ localPos, {0.1f, 0.1f, 0.1f} });
         reg.add<WorldTransform>(a, WorldTransform{});
@@ -62,14 +65,14 @@ inline Entity CreateRoom(Registry& reg, Vector3 pos, Vector3 size, std::shared_p
         reg.add<Parent>(a, Parent{ room }); // add new parent component to anchor entity, associating anchor with the room (as its parent)
         
         if (auto children = reg.get<Children>(room)) children->entities.push_back(a);
-        
-        std::cout << "DEV: Anchor at (" << localPos.x << "," << localPos.y << "," << localPos.z << ") dir (" << dir.x << "," << dir.y << "," << dir.z << ")\n";                  
+        if (auto slots = reg.get<AnchorSlots>(room)) slots->anchors[static_cast<int>(dir)] = a;
+        if (anchorIndex) anchorIndex->add(a, Vector3Add(pos, localPos), dir);
         return a;
     };
     
-    addAnchor({0, 0, -half.z}, {0, 0, -1}); // front
-    addAnchor({0, 0, half.z}, {0, 0, 1}); // back
-    addAnchor({-half.x, 0, 0}, {-1, 0, 0}); // left
-    addAnchor({ half.x, 0, 0}, {1, 0, 0});  // right    
+    addAnchor({0, 0, -half.z}, AnchorDir::Front);
+    addAnchor({0, 0, half.z}, AnchorDir::Back);
+    addAnchor({-half.x, 0, 0}, AnchorDir::Left);
+    addAnchor({ half.x, 0, 0}, AnchorDir::Right);
     return room;
 }
\ No newline at end of file
@@ -0,0 +1,469 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "../ecs/components.h"
+#include "../ecs/entity_utils.h"
+#include "../ecs/prefab.h"
+#include "../ecs/registry.h"
+#include "anchor.h"
+#include "doorway.h"
+#include "dungeon.h"
+#include "prefabs.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct StreamingSettings {
+    float cellSize = 1000.0f;    // square cells on the xz plane, rooms/hallways belong to the cell of their centre
+    float loadRadius = 1500.0f;  // cells whose bounds come this close to the camera get loaded (< 0: graphRadius only)...
+    float unloadMargin = 250.0f; // ...and unloaded once they're this much further out (no thrashing along a border)
+    int graphRadius = -1;        // >= 0: also keep the cells up to this many hallway hops from the camera's cell
+    double frameBudgetMs = 2.0;  // main-thread merge/unload time per update() (one step always runs)
+    size_t chunkRoots = 64;      // rooms + hallways per staged chunk, the unit of merging
+    unsigned threads = 1;        // background builders, 0 = build inside update() (tests, tools)
+    TexturedRender material;
+};
+
+struct StreamingStats {
+    size_t residentCells = 0;
+    size_t pendingCells = 0;   // wanted, still building or being merged
+    size_t mergedChunks = 0;   // by the last update()
+    size_t unloadedCells = 0;  // by the last update()
+    double updateMs = 0.0;     // the last update() on the main thread
+};
+
+// keeps only the part of a (dungeon) layout around the camera in the registry
+//   - the layout is cut into cells (cellSize squares), two cells are neighbours when a hallway joins them
+//   - update() once per frame: cells within loadRadius (or graphRadius hops) are requested, a background thread
+//     builds each one into its own staging Registry (prefab rooms/hallways, doorways carved like BuildDungeon) and
+//     captures it as a few multi-root prefabs ("chunks")... the main thread stamps chunks into the real registry and
+//     destroys cells that fell out of range, until frameBudgetMs is used up
+//   - anchors are linked across cells as soon as both sides are resident, and unlinked again when one side leaves
+// so the registry only ever holds the neighbourhood of the camera, however big the layout is (freed entity ids and
+// pool slots are reused by the next cell)
+// note: baked meshes see loaded walls like any other new entity (loaded() lists the new rooms/hallways), collider
+// caches are told through invalidate(...) after each update()... render caches (CullingSystem, PortalVisibilitySystem,
+// OcclusionCullingSystem) rebuild on registry revisions by themselves, even when a step unloads and merges the same counts
+// note: cells should be larger than the rooms in them, a room reaching far out of its cell may show up late
+class StreamingWorld {
+private:
+    enum class CellState : uint8_t { Unloaded, Building, Merging, Resident, Unloading };
+
+    // a built piece of a cell: roots in items order (room index, or hall index | HALL_BIT)
+    struct Chunk {
+        Prefab prefab;
+        Vector3 origin;
+        std::vector<uint32_t> items;
+    };
+
+    struct Cell {
+        int32_t x, z;
+        BoundingBox bounds;
+        std::vector<uint32_t> rooms, halls;
+        std::vector<uint32_t> neighbours;
+        CellState state = CellState::Unloaded;
+        uint32_t generation = 0; // bumped when a build is cancelled, its result gets dropped
+        uint64_t wantedFrame = 0, keptFrame = 0, visitedFrame = 0; // last frame it was in range / kept / reached by the graph walk
+        std::vector<Chunk> chunks; // built, chunks[nextChunk..] wait to be merged
+        size_t nextChunk = 0;
+    };
+
+    struct Job {
+        uint32_t cell;
+        uint32_t generation;
+    };
+
+    struct Built {
+        uint32_t cell;
+        uint32_t generation;
+        std::vector<Chunk> chunks;
+    };
+
+    static constexpr uint32_t HALL_BIT = 1u << 31;
+
+    // read-only once constructed (the builders use them)
+    DungeonLayout layout;
+    StreamingSettings settings;
+    Prefab roomPrefab;
+    HallwayPrefabs hallPrefabs;
+    std::vector<std::vector<uint32_t>> hallsOfRoom;
+    std::vector<Cell> cells;
+    std::unordered_map<uint64_t, uint32_t> cellAt;
+
+    // main thread
+    std::vector<Entity> roomEntities, hallEntities; // INVALID_ENTITY when not resident
+    std::vector<uint32_t> active;                   // cells that aren't Unloaded
+    std::deque<uint32_t> mergeQueue, unloadQueue;
+    std::vector<Entity> loadedRoots;
+    bool touched = false; // the current update()/finish() merged or destroyed something
+    StreamingStats stats;
+    uint64_t frame = 0;
+
+    // builders
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable builtReady;
+    std::deque<Job> jobs;
+    std::deque<Built> built;
+    bool stopping = false;
+
+    static uint64_t Key(int32_t x, int32_t z) { return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z); }
+    int32_t gridCoord(float v) const { return static_cast<int32_t>(std::floor(v / settings.cellSize)); }
+
+    static float DistanceToBox(Vector3 p, const BoundingBox& b) {
+        Vector3 d{ std::max({ b.min.x - p.x, 0.0f, p.x - b.max.x }), std::max({ b.min.y - p.y, 0.0f, p.y - b.max.y }),
+                   std::max({ b.min.z - p.z, 0.0f, p.z - b.max.z }) };
+        return Vector3Length(d);
+    }
+
+    // the anchor a hallway end uses on each side (BuildDungeon's pairing)
+    static AnchorDir RoomDir(const DungeonHall& h, uint32_t room) { return room == h.from ? h.side : OppositeDir(h.side); }
+    static AnchorDir HallDir(const DungeonHall& h, uint32_t room) { return room == h.from ? OppositeDir(h.side) : h.side; }
+
+    // worker side: everything in the cell, with its doorways, captured in chunks
+    std::vector<Chunk> buildCell(const Cell& cell) const {
+        Registry staging;
+        std::vector<PrefabInstance> instances;
+        for (uint32_t r : cell.rooms) instances.push_back(PrefabInstance{ layout.rooms[r].position, layout.rooms[r].size });
+        std::vector<Entity> roots = InstantiateRooms(staging, roomPrefab, instances);
+        for (size_t i = 0; i < cell.rooms.size(); ++i)
+            for (uint32_t h : hallsOfRoom[cell.rooms[i]]) {
+                AnchorDir dir = RoomDir(layout.halls[h], cell.rooms[i]);
+                auto anchor = staging.get<Anchor>(FindAnchor(staging, roots[i], dir));
+                float along = dir == AnchorDir::Left || dir == AnchorDir::Right ? anchor->localPos.z : anchor->localPos.x;
+                CarveDoorway(staging, roots[i], AnchorToWallSide(dir), along);
+            }
+        instances.clear();
+        std::vector<AnchorDir> travel;
+        for (uint32_t h : cell.halls) {
+            instances.push_back(PrefabInstance{ layout.halls[h].position, layout.halls[h].size });
+            travel.push_back(layout.halls[h].side);
+        }
+        std::vector<Entity> halls = InstantiateHallways(staging, hallPrefabs, instances, travel);
+        roots.insert(roots.end(), halls.begin(), halls.end());
+
+        std::vector<uint32_t> items(cell.rooms);
+        for (uint32_t h : cell.halls) items.push_back(h | HALL_BIT);
+        std::vector<Chunk> chunks;
+        const size_t step = std::max<size_t>(1, settings.chunkRoots);
+        for (size_t first = 0; first < roots.size(); first += step) {
+            size_t count = std::min(step, roots.size() - first);
+            std::span<const Entity> part(roots.data() + first, count);
+            chunks.push_back(Chunk{ Prefab::Capture(staging, part), staging.get<TransformComp>(part.front())->position,
+                                    std::vector<uint32_t>(items.begin() + first, items.begin() + first + count) });
+        }
+        return chunks;
+    }
+
+    void workerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            std::vector<Chunk> chunks = buildCell(cells[job.cell]);
+            {
+                std::lock_guard lock(mutex);
+                built.push_back(Built{ job.cell, job.generation, std::move(chunks) });
+            }
+            builtReady.notify_all();
+        }
+    }
+
+    void request(uint32_t c) {
+        Cell& cell = cells[c];
+        cell.state = CellState::Building;
+        active.push_back(c);
+        if (workers.empty()) {
+            built.push_back(Built{ c, cell.generation, buildCell(cell) });
+            return;
+        }
+        {
+            std::lock_guard lock(mutex);
+            jobs.push_back(Job{ c, cell.generation });
+        }
+        wake.notify_one();
+    }
+
+    void cancel(uint32_t c) {
+        Cell& cell = cells[c];
+        if (cell.state == CellState::Building) {
+            cell.generation++;
+            cell.state = CellState::Unloaded;
+            std::lock_guard lock(mutex);
+            jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [&](const Job& j) { return j.cell == c; }), jobs.end());
+        } else if (cell.state == CellState::Merging || cell.state == CellState::Resident) {
+            cell.chunks.clear();
+            cell.nextChunk = 0;
+            cell.state = CellState::Unloading;
+            unloadQueue.push_back(c);
+        }
+    }
+
+    void link(Registry& reg, uint32_t h, uint32_t room, bool connect) {
+        const DungeonHall& hall = layout.halls[h];
+        Entity roomAnchor = FindAnchor(reg, roomEntities[room], RoomDir(hall, room));
+        Entity hallAnchor = FindAnchor(reg, hallEntities[h], HallDir(hall, room));
+        if (auto a = reg.get<Anchor>(roomAnchor)) a->connectedTo = connect ? hallAnchor : INVALID_ENTITY;
+        if (auto a = reg.get<Anchor>(hallAnchor)) a->connectedTo = connect ? roomAnchor : INVALID_ENTITY;
+    }
+
+    // every hallway end between item and something resident
+    template<typename F>
+    void forEachResidentLink(uint32_t item, F&& f) {
+        if (item & HALL_BIT) {
+            uint32_t h = item & ~HALL_BIT;
+            for (uint32_t room : { layout.halls[h].from, layout.halls[h].to })
+                if (roomEntities[room] != INVALID_ENTITY) f(h, room);
+        } else {
+            for (uint32_t h : hallsOfRoom[item])
+                if (hallEntities[h] != INVALID_ENTITY) f(h, item);
+        }
+    }
+
+    Entity& entityOf(uint32_t item) { return item & HALL_BIT ? hallEntities[item & ~HALL_BIT] : roomEntities[item]; }
+
+    void mergeChunk(Registry& reg, Chunk& chunk) {
+        const PrefabInstance instance{ chunk.origin };
+        std::vector<Entity> roots = chunk.prefab.instantiate(reg, std::span<const PrefabInstance>(&instance, 1));
+        for (size_t i = 0; i < chunk.items.size(); ++i) entityOf(chunk.items[i]) = roots[i];
+        for (uint32_t item : chunk.items) forEachResidentLink(item, [&](uint32_t h, uint32_t room) { link(reg, h, room, true); });
+        loadedRoots.insert(loadedRoots.end(), roots.begin(), roots.end());
+        stats.mergedChunks++;
+        touched = true;
+    }
+
+    void unloadCell(Registry& reg, Cell& cell) {
+        auto unload = [&](uint32_t item) {
+            Entity& e = entityOf(item);
+            if (e == INVALID_ENTITY) return;
+            // unlink first, the other side may stay
+            forEachResidentLink(item, [&](uint32_t h, uint32_t room) { link(reg, h, room, false); });
+            DestroyEntityWithChildren(reg, e);
+            e = INVALID_ENTITY;
+        };
+        for (uint32_t r : cell.rooms) unload(r);
+        for (uint32_t h : cell.halls) unload(h | HALL_BIT);
+        cell.state = CellState::Unloaded;
+        stats.unloadedCells++;
+        touched = true;
+    }
+
+    void step(Registry& reg, Vector3 camera, double budgetMs) {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        auto elapsedMs = [&] { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); };
+        frame++;
+        loadedRoots.clear();
+        stats.mergedChunks = stats.unloadedCells = 0;
+
+        // which cells should be here: the ones near the camera, plus graph hops from the camera's cell
+        std::vector<std::pair<float, uint32_t>> wanted;
+        const float keepRadius = settings.loadRadius + settings.unloadMargin;
+        const int32_t reach = static_cast<int32_t>(std::ceil(keepRadius / settings.cellSize)) + 1;
+        const int32_t cx = gridCoord(camera.x), cz = gridCoord(camera.z);
+        for (int32_t z = cz - reach; z <= cz + reach; ++z)
+            for (int32_t x = cx - reach; x <= cx + reach; ++x) {
+                auto it = cellAt.find(Key(x, z));
+                if (it == cellAt.end()) continue;
+                Cell& cell = cells[it->second];
+                float d = DistanceToBox(camera, cell.bounds);
+                if (d <= keepRadius) cell.keptFrame = frame;
+                if (d <= settings.loadRadius) {
+                    cell.wantedFrame = frame;
+                    wanted.push_back({ d, it->second });
+                }
+            }
+        if (auto it = cellAt.find(Key(cx, cz)); settings.graphRadius >= 0 && it != cellAt.end()) {
+            std::vector<uint32_t> ring = { it->second }, next;
+            cells[it->second].visitedFrame = frame;
+            for (int hop = 0; hop <= settings.graphRadius && !ring.empty(); ++hop) {
+                for (uint32_t c : ring) {
+                    if (cells[c].wantedFrame != frame) {
+                        cells[c].wantedFrame = frame;
+                        wanted.push_back({ DistanceToBox(camera, cells[c].bounds), c });
+                    }
+                    cells[c].keptFrame = frame;
+                    if (hop == settings.graphRadius) continue;
+                    for (uint32_t n : cells[c].neighbours)
+                        if (cells[n].visitedFrame != frame) {
+                            cells[n].visitedFrame = frame;
+                            next.push_back(n);
+                        }
+                }
+                std::swap(ring, next);
+                next.clear();
+            }
+        }
+
+        // drop what's out of range, then request what's missing (nearest first)
+        for (uint32_t c : active)
+            if (cells[c].keptFrame != frame) cancel(c);
+        std::sort(wanted.begin(), wanted.end());
+        for (const auto& [d, c] : wanted)
+            if (cells[c].state == CellState::Unloaded) request(c);
+
+        // finished builds
+        {
+            std::lock_guard lock(mutex);
+            for (Built& b : built) {
+                Cell& cell = cells[b.cell];
+                if (b.generation != cell.generation || cell.state != CellState::Building) continue; // cancelled meanwhile
+                cell.chunks = std::move(b.chunks);
+                cell.nextChunk = 0;
+                cell.state = CellState::Merging;
+                mergeQueue.push_back(b.cell);
+            }
+            built.clear();
+        }
+
+        // main-thread work within the budget: unloads first (they free what the merges reuse)
+        for (bool first = true;; first = false) {
+            if (!first && elapsedMs() >= budgetMs) break;
+            if (!unloadQueue.empty()) {
+                uint32_t c = unloadQueue.front();
+                unloadQueue.pop_front();
+                if (cells[c].state == CellState::Unloading) unloadCell(reg, cells[c]);
+            } else if (!mergeQueue.empty()) {
+                Cell& cell = cells[mergeQueue.front()];
+                if (cell.state != CellState::Merging || cell.nextChunk >= cell.chunks.size()) {
+                    mergeQueue.pop_front();
+                    continue;
+                }
+                mergeChunk(reg, cell.chunks[cell.nextChunk++]);
+                if (cell.nextChunk == cell.chunks.size()) {
+                    cell.chunks.clear();
+                    cell.state = CellState::Resident;
+                    mergeQueue.pop_front();
+                }
+            } else {
+                break;
+            }
+        }
+
+        active.erase(std::remove_if(active.begin(), active.end(), [&](uint32_t c) { return cells[c].state == CellState::Unloaded; }), active.end());
+        stats.residentCells = stats.pendingCells = 0;
+        for (uint32_t c : active) {
+            if (cells[c].state == CellState::Resident) stats.residentCells++;
+            else if (cells[c].state != CellState::Unloading) stats.pendingCells++;
+        }
+        stats.updateMs = elapsedMs();
+    }
+
+public:
+    explicit StreamingWorld(DungeonLayout worldLayout, const StreamingSettings& streamingSettings = {})
+        : layout(std::move(worldLayout)), settings(streamingSettings) {
+        roomPrefab = MakeRoomPrefab(settings.material);
+        hallPrefabs = MakeHallwayPrefabs(settings.material);
+        roomEntities.assign(layout.rooms.size(), INVALID_ENTITY);
+        hallEntities.assign(layout.halls.size(), INVALID_ENTITY);
+        hallsOfRoom.resize(layout.rooms.size());
+
+        auto cellFor = [&](Vector3 p) -> uint32_t {
+            int32_t x = gridCoord(p.x), z = gridCoord(p.z);
+            auto [it, added] = cellAt.try_emplace(Key(x, z), static_cast<uint32_t>(cells.size()));
+            if (added) {
+                cells.emplace_back();
+                cells.back().x = x;
+                cells.back().z = z;
+                cells.back().bounds = { { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } };
+            }
+            return it->second;
+        };
+        auto grow = [](BoundingBox& b, Vector3 position, Vector3 size) {
+            Vector3 half = Vector3Scale(size, 0.5f);
+            b.min = Vector3Min(b.min, Vector3Subtract(position, half));
+            b.max = Vector3Max(b.max, Vector3Add(position, half));
+        };
+        std::vector<uint32_t> roomCell(layout.rooms.size());
+        for (uint32_t r = 0; r < layout.rooms.size(); ++r) {
+            roomCell[r] = cellFor(layout.rooms[r].position);
+            cells[roomCell[r]].rooms.push_back(r);
+            grow(cells[roomCell[r]].bounds, layout.rooms[r].position, layout.rooms[r].size);
+        }
+        for (uint32_t h = 0; h < layout.halls.size(); ++h) {
+            const DungeonHall& hall = layout.halls[h];
+            uint32_t c = cellFor(hall.position);
+            cells[c].halls.push_back(h);
+            grow(cells[c].bounds, hall.position, hall.size);
+            hallsOfRoom[hall.from].push_back(h);
+            hallsOfRoom[hall.to].push_back(h);
+            for (uint32_t a : { c, roomCell[hall.from], roomCell[hall.to] })
+                for (uint32_t b : { c, roomCell[hall.from], roomCell[hall.to] })
+                    if (a != b) cells[a].neighbours.push_back(b);
+        }
+        for (Cell& cell : cells) {
+            std::sort(cell.neighbours.begin(), cell.neighbours.end());
+            cell.neighbours.erase(std::unique(cell.neighbours.begin(), cell.neighbours.end()), cell.neighbours.end());
+        }
+
+        for (unsigned i = 0; i < settings.threads; ++i) workers.emplace_back([this] { workerLoop(); });
+    }
+
+    StreamingWorld(const StreamingWorld&) = delete;
+    StreamingWorld& operator=(const StreamingWorld&) = delete;
+
+    ~StreamingWorld() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    // main thread, once per frame
+    void update(Registry& reg, Vector3 camera) {
+        touched = false;
+        step(reg, camera, settings.frameBudgetMs);
+    }
+
+    // blocks until everything around camera is resident, no budget (the first load, teleports)
+    void finish(Registry& reg, Vector3 camera) {
+        std::vector<Entity> merged;
+        touched = false;
+        for (;;) {
+            step(reg, camera, INFINITY);
+            merged.insert(merged.end(), loadedRoots.begin(), loadedRoots.end());
+            if (stats.pendingCells == 0) {
+                loadedRoots = std::move(merged);
+                return;
+            }
+            std::unique_lock lock(mutex);
+            builtReady.wait_for(lock, std::chrono::milliseconds(5), [&] { return !built.empty(); });
+        }
+    }
+
+    // rooms/hallways merged by the last update()/finish(), e.g. for EnableMeshBaking
+    const std::vector<Entity>& loaded() const { return loadedRoots; }
+
+    // whether the last update()/finish() added or destroyed any entity
+    [[nodiscard]] bool changedRegistry() const { return touched; }
+
+    // publishes the last update()/finish() to collider caches (CollisionSystem, DynamicBroadphase, RaycastQuery):
+    // each does a full re-sync when anything was merged or unloaded... call it right after update(), then update the
+    // caches once TransformSystem has placed the new entities (their world boxes are only right from then on)
+    // note: anything with an invalidate() can go in, the render caches don't need to (see the class comment)
+    template <typename... Caches>
+    void invalidate(Caches&... caches) const {
+        if (touched) (caches.invalidate(), ...);
+    }
+    const StreamingStats& getStats() const { return stats; }
+    size_t cellCount() const { return cells.size(); }
+
+    // the entity of a layout room/hallway, INVALID_ENTITY while it isn't resident
+    Entity room(size_t i) const { return roomEntities[i]; }
+    Entity hall(size_t i) const { return hallEntities[i]; }
+};
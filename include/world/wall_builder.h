@@ -0,0 +1,249 @@
+#pragma once
+#include "raylib.h"
+#include "../ecs/components.h"
+#include "../ecs/registry.h"
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <vector>
+
+// walls with any number of openings (doors, windows, overlapping or touching the edges) as the fewest boxes possible
+// DecomposeWall() is the classic minimum rectangle partition of a rectilinear polygon with holes:
+//   - rectangles = concave corners - non-crossing chords - holes + 1, so pick as many non-crossing chords
+//     (axis-aligned cuts joining two concave corners) as possible: a maximum independent set of the
+//     horizontal/vertical chord crossing graph, which is bipartite (König: |H| + |V| - maximum matching)
+//   - cut those chords, then one cut from every concave corner still left (vertical, up to the first boundary or cut)
+// all of it on the grid made by the wall's and openings' edges, so it's exact (output coordinates are input ones)
+namespace walls {
+
+// the cell grid: solid = inside the wall and outside every opening, cells indexed j * nx + i (j = row from the bottom)
+struct Grid {
+    std::vector<float> xs, ys;
+    std::vector<char> solid;
+    int nx = 0, ny = 0;
+
+    bool cell(int i, int j) const { return i >= 0 && j >= 0 && i < nx && j < ny && solid[j * nx + i]; }
+    // the edge from vertex (i, j) to (i + 1, j) / (i, j + 1) has solid cells on both sides
+    bool interiorH(int i, int j) const { return cell(i, j - 1) && cell(i, j); }
+    bool interiorV(int i, int j) const { return cell(i - 1, j) && cell(i, j); }
+    // exactly 3 of the 4 cells around vertex (i, j) are solid
+    bool concave(int i, int j) const { return cell(i - 1, j - 1) + cell(i, j - 1) + cell(i - 1, j) + cell(i, j) == 3; }
+};
+
+inline Grid MakeGrid(Rectangle wall, std::span<const Rectangle> openings) {
+    Grid g;
+    g.xs = { wall.x, wall.x + wall.width };
+    g.ys = { wall.y, wall.y + wall.height };
+    for (const Rectangle& o : openings) {
+        if (o.width <= 0 || o.height <= 0) continue;
+        for (float x : { o.x, o.x + o.width })
+            if (x > wall.x && x < wall.x + wall.width) g.xs.push_back(x);
+        for (float y : { o.y, o.y + o.height })
+            if (y > wall.y && y < wall.y + wall.height) g.ys.push_back(y);
+    }
+    for (auto* v : { &g.xs, &g.ys }) {
+        std::sort(v->begin(), v->end());
+        v->erase(std::unique(v->begin(), v->end()), v->end());
+    }
+    g.nx = static_cast<int>(g.xs.size()) - 1;
+    g.ny = static_cast<int>(g.ys.size()) - 1;
+    g.solid.assign(static_cast<size_t>(std::max(g.nx, 0)) * std::max(g.ny, 0), 1);
+    for (const Rectangle& o : openings) {
+        if (o.width <= 0 || o.height <= 0) continue;
+        // every grid line is an edge of the wall or an opening, so a cell is either fully inside an opening or outside it
+        for (int j = 0; j < g.ny; ++j) {
+            float cy = (g.ys[j] + g.ys[j + 1]) * 0.5f;
+            if (cy <= o.y || cy >= o.y + o.height) continue;
+            for (int i = 0; i < g.nx; ++i) {
+                float cx = (g.xs[i] + g.xs[i + 1]) * 0.5f;
+                if (cx > o.x && cx < o.x + o.width) g.solid[j * g.nx + i] = 0;
+            }
+        }
+    }
+    return g;
+}
+
+// a cut along grid line `line` (a row of vertices for horizontal chords, a column for vertical ones) from vertex from to to
+struct Chord {
+    int line, from, to;
+};
+
+} // namespace walls
+
+// the minimum set of non-overlapping rectangles covering exactly `wall` minus every opening
+// openings may overlap each other, touch or cross the wall's edges (the part outside is ignored) or be empty
+inline std::vector<Rectangle> DecomposeWall(Rectangle wall, std::span<const Rectangle> openings) {
+    using namespace walls;
+    std::vector<Rectangle> out;
+    if (wall.width <= 0 || wall.height <= 0) return out;
+    const Grid g = MakeGrid(wall, openings);
+    const int nx = g.nx, ny = g.ny;
+
+    // chords: walk from each concave corner into the interior until the next concave corner (a chord) or a boundary
+    // a concave corner's interior runs away from its missing cell, so only the walk right/up has to be tried
+    std::vector<Chord> hChords, vChords;
+    for (int j = 1; j < ny; ++j)
+        for (int i = 1; i < nx; ++i) {
+            if (!g.concave(i, j)) continue;
+            if (g.interiorH(i, j))
+                for (int k = i + 1; k <= nx && g.interiorH(k - 1, j); ++k)
+                    if (g.concave(k, j)) {
+                        hChords.push_back(Chord{ j, i, k });
+                        break;
+                    }
+            if (g.interiorV(i, j))
+                for (int k = j + 1; k <= ny && g.interiorV(i, k - 1); ++k)
+                    if (g.concave(i, k)) {
+                        vChords.push_back(Chord{ i, j, k });
+                        break;
+                    }
+        }
+
+    // crossing graph (touching counts: chords sharing a corner can't both be used) and a maximum matching (Kuhn)
+    std::vector<std::vector<int>> crosses(hChords.size());
+    for (size_t h = 0; h < hChords.size(); ++h)
+        for (size_t v = 0; v < vChords.size(); ++v) {
+            const Chord& a = hChords[h];
+            const Chord& b = vChords[v];
+            if (a.from <= b.line && b.line <= a.to && b.from <= a.line && a.line <= b.to) crosses[h].push_back(static_cast<int>(v));
+        }
+    std::vector<int> matchOfV(vChords.size(), -1), matchOfH(hChords.size(), -1);
+    std::vector<char> visited;
+    auto augment = [&](auto&& self, int h) -> bool {
+        for (int v : crosses[h]) {
+            if (visited[v]) continue;
+            visited[v] = 1;
+            if (matchOfV[v] < 0 || self(self, matchOfV[v])) {
+                matchOfV[v] = h;
+                matchOfH[h] = v;
+                return true;
+            }
+        }
+        return false;
+    };
+    for (size_t h = 0; h < hChords.size(); ++h) {
+        visited.assign(vChords.size(), 0);
+        augment(augment, static_cast<int>(h));
+    }
+
+    // König: Z = everything reachable from unmatched horizontal chords along alternating paths,
+    // the maximum independent set is (H in Z) + (V not in Z)
+    std::vector<char> hInZ(hChords.size(), 0), vInZ(vChords.size(), 0);
+    std::vector<int> open;
+    for (size_t h = 0; h < hChords.size(); ++h)
+        if (matchOfH[h] < 0) {
+            hInZ[h] = 1;
+            open.push_back(static_cast<int>(h));
+        }
+    while (!open.empty()) {
+        int h = open.back();
+        open.pop_back();
+        for (int v : crosses[h]) {
+            if (vInZ[v] || matchOfH[h] == v) continue;
+            vInZ[v] = 1;
+            int next = matchOfV[v];
+            if (next >= 0 && !hInZ[next]) {
+                hInZ[next] = 1;
+                open.push_back(next);
+            }
+        }
+    }
+
+    // cut edges: hCut[j * nx + i] is the edge from vertex (i, j) to (i + 1, j), vCut[j * (nx + 1) + i] from (i, j) to (i, j + 1)
+    std::vector<char> hCut(static_cast<size_t>(nx) * (ny + 1), 0), vCut(static_cast<size_t>(nx + 1) * ny, 0);
+    std::vector<char> resolved(static_cast<size_t>(nx + 1) * (ny + 1), 0);
+    for (size_t h = 0; h < hChords.size(); ++h) {
+        if (!hInZ[h]) continue;
+        const Chord& c = hChords[h];
+        for (int i = c.from; i < c.to; ++i) hCut[c.line * nx + i] = 1;
+        resolved[c.line * (nx + 1) + c.from] = resolved[c.line * (nx + 1) + c.to] = 1;
+    }
+    for (size_t v = 0; v < vChords.size(); ++v) {
+        if (vInZ[v]) continue;
+        const Chord& c = vChords[v];
+        for (int j = c.from; j < c.to; ++j) vCut[j * (nx + 1) + c.line] = 1;
+        resolved[c.from * (nx + 1) + c.line] = resolved[c.to * (nx + 1) + c.line] = 1;
+    }
+
+    // every other concave corner: cut straight up/down (its interior side) until a boundary or an earlier cut
+    for (int j = 1; j < ny; ++j)
+        for (int i = 1; i < nx; ++i) {
+            if (!g.concave(i, j) || resolved[j * (nx + 1) + i]) continue;
+            int step = g.interiorV(i, j) ? 1 : -1;
+            int k = j;
+            while (true) {
+                int edge = step > 0 ? k : k - 1;
+                if (edge < 0 || edge >= ny || !g.interiorV(i, edge) || vCut[edge * (nx + 1) + i]) break;
+                vCut[edge * (nx + 1) + i] = 1;
+                k += step;
+                // stop on a horizontal cut through the vertex we reached
+                if ((i > 0 && hCut[k * nx + i - 1]) || (i < nx && hCut[k * nx + i])) break;
+            }
+        }
+
+    // what's left are rectangles: flood the cells across uncut interior edges
+    std::vector<char> done(g.solid.size(), 0);
+    std::vector<int> stack;
+    for (int j = 0; j < ny; ++j)
+        for (int i = 0; i < nx; ++i) {
+            if (!g.cell(i, j) || done[j * nx + i]) continue;
+            int i0 = i, i1 = i, j0 = j, j1 = j;
+            done[j * nx + i] = 1;
+            stack.push_back(j * nx + i);
+            while (!stack.empty()) {
+                int c = stack.back();
+                stack.pop_back();
+                int ci = c % nx, cj = c / nx;
+                i0 = std::min(i0, ci);
+                i1 = std::max(i1, ci);
+                j0 = std::min(j0, cj);
+                j1 = std::max(j1, cj);
+                auto visit = [&](int ni, int nj, bool cut) {
+                    if (cut || !g.cell(ni, nj) || done[nj * nx + ni]) return;
+                    done[nj * nx + ni] = 1;
+                    stack.push_back(nj * nx + ni);
+                };
+                if (ci > 0) visit(ci - 1, cj, vCut[cj * (nx + 1) + ci]);
+                if (ci + 1 < nx) visit(ci + 1, cj, vCut[cj * (nx + 1) + ci + 1]);
+                if (cj > 0) visit(ci, cj - 1, hCut[cj * nx + ci]);
+                if (cj + 1 < ny) visit(ci, cj + 1, hCut[(cj + 1) * nx + ci]);
+            }
+            out.push_back(Rectangle{ g.xs[i0], g.ys[j0], g.xs[i1 + 1] - g.xs[i0], g.ys[j1 + 1] - g.ys[j0] });
+        }
+    return out;
+}
+
+// a wall box (parent-local localPos/size, thin in x or z like every wall here) with openings cut out, one entity per
+// DecomposeWall() rectangle, all created in one batch
+// openings are in the wall's plane: x along the wall from its -x (or -z) end, y up from its bottom
+// side: tags the pieces with a Wall so doorways can be carved into them later (see CarveDoorway)
+inline std::vector<Entity> MakeWallWithOpenings(Registry& reg, Entity parent, Vector3 localPos, Vector3 size, std::span<const Rectangle> openings,
+                                                const TexturedRender& material = {}, std::optional<Wall::Side> side = std::nullopt) {
+    const bool alongZ = size.z > size.x;
+    const float length = alongZ ? size.z : size.x;
+    std::vector<Rectangle> rects = DecomposeWall(Rectangle{ 0, 0, length, size.y }, openings);
+
+    std::vector<Entity> pieces(rects.size());
+    reg.create(std::span<Entity>(pieces));
+    for (size_t k = 0; k < rects.size(); ++k) {
+        const Rectangle& r = rects[k];
+        Entity e = pieces[k];
+        float along = (alongZ ? localPos.z : localPos.x) - length / 2 + r.x + r.width / 2;
+        Vector3 pos = alongZ ? Vector3{ localPos.x, 0, along } : Vector3{ along, 0, localPos.z };
+        pos.y = localPos.y - size.y / 2 + r.y + r.height / 2;
+        Vector3 pieceSize = alongZ ? Vector3{ size.x, r.height, r.width } : Vector3{ r.width, r.height, size.z };
+        reg.add<TransformComp>(e, TransformComp{ pos, pieceSize });
+
+        if (material.texture)
+            reg.add<TexturedRender>(e, material);
+        else
+            reg.add<ColoredRender>(e, ColoredRender{ GRAY });
+
+        reg.add<Collision>(e, Collision{});
+        if (side) reg.add<Wall>(e, Wall{ *side });
+        reg.add<Parent>(e, Parent{ parent });
+    }
+    if (auto children = reg.get<Children>(parent))
+        children->entities.insert(children->entities.end(), pieces.begin(), pieces.end());
+    return pieces;
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "../ecs/components.h"
+#include "../ecs/entity_utils.h"
+#include "../ecs/registry.h"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+struct WallMergeSettings {
+    float epsilon = 0.001f;   // faces this close count as touching / equal
+    bool acrossOwners = true; // merge a hallway's walls into the room next to it (or the next hallway)
+};
+
+struct WallMergeStats {
+    size_t merged = 0;     // boxes folded into a neighbour
+    size_t duplicates = 0; // of those, exact copies of the box they went into
+};
+
+// post-pass over a built level: walls, floors and ceilings that share a material and line up so their union is still
+// a box are merged into one entity (long corridors made of many hallways, a hallway floor continuing a room's floor,
+// two rooms' coincident walls)... cuts entities, colliders and draw work
+//   - runs along x, y and z in turn until nothing merges, each pass sorts the boxes of a row/column and sweeps them
+//   - the first entity keeps the merged box (TransformComp re-expressed in its own parent's space), the others are
+//     destroyed... WallChange events (Resized/Removed) for the broadphases, BakedMesh of every touched owner goes dirty
+//   - owners: rooms/hallways to look at, empty = every entity with AnchorSlots
+// note: a box spanning two rooms belongs to the one it kept, so portal culling shows all of it with that room...
+//       and doorways have to be carved before merging (CarveDoorway only looks at its own owner's walls)
+// note: rotated walls are left alone, like everywhere else that works on boxes
+inline WallMergeStats MergeCoplanarWalls(Registry& reg, std::span<const Entity> owners = {}, const WallMergeSettings& settings = {},
+                                         std::vector<WallChange>* changes = nullptr) {
+    struct Item {
+        Entity e;
+        Entity owner;
+        Vector3 min, max;
+        int material;
+        bool alive = true;
+        bool changed = false;
+    };
+    struct Material {
+        bool textured;
+        TexturedRender textures;
+        Color color;
+        int collision; // 0 none, 1 disabled, 2 enabled
+    };
+    auto axis = [](const Vector3& v, int a) { return a == 0 ? v.x : (a == 1 ? v.y : v.z); };
+    auto setAxis = [](Vector3& v, int a, float value) { (a == 0 ? v.x : (a == 1 ? v.y : v.z)) = value; };
+
+    std::vector<Entity> ownerList(owners.begin(), owners.end());
+    if (ownerList.empty())
+        for (const auto& [owner, slots] : reg.view<AnchorSlots>()) ownerList.push_back(owner);
+
+    std::vector<Material> materials;
+    std::vector<Item> items;
+    for (Entity owner : ownerList) {
+        auto children = reg.get<Children>(owner);
+        if (!children) continue;
+        for (Entity child : children->entities) {
+            auto local = reg.get<TransformComp>(child);
+            auto world = reg.get<WorldTransform>(child);
+            if (!local || !world || reg.has<Anchor>(child) || reg.has<Children>(child)) continue;
+            if (local->rotation.x != 0 || local->rotation.y != 0 || local->rotation.z != 0) continue;
+            if (world->rotation.x != 0 || world->rotation.y != 0 || world->rotation.z != 0) continue;
+
+            Material m{};
+            if (auto tr = reg.get<TexturedRender>(child)) {
+                m.textured = true;
+                m.textures = *tr;
+            } else if (auto cr = reg.get<ColoredRender>(child)) {
+                m.color = cr->color;
+            } else {
+                continue;
+            }
+            if (auto c = reg.get<Collision>(child)) m.collision = c->enabled ? 2 : 1;
+            auto same = [&](const Material& o) {
+                if (o.textured != m.textured || o.collision != m.collision) return false;
+                if (m.textured) {
+                    const Rectangle &a = o.textures.uv, &b = m.textures.uv;
+                    return o.textures.texture == m.textures.texture && a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+                }
+                return o.color.r == m.color.r && o.color.g == m.color.g && o.color.b == m.color.b && o.color.a == m.color.a;
+            };
+            auto found = std::find_if(materials.begin(), materials.end(), same);
+            int material = static_cast<int>(found - materials.begin());
+            if (found == materials.end()) materials.push_back(m);
+
+            Vector3 half{ fabsf(world->size.x) / 2, fabsf(world->size.y) / 2, fabsf(world->size.z) / 2 };
+            items.push_back(Item{ child, owner, Vector3Subtract(world->position, half), Vector3Add(world->position, half), material });
+        }
+    }
+
+    WallMergeStats stats;
+    const float eps = settings.epsilon;
+    const double quantum = 1.0 / eps;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> rows;
+    bool mergedAny = true;
+    while (mergedAny) {
+        mergedAny = false;
+        for (int a = 0; a < 3; ++a) {
+            // a row: same material (and owner, unless acrossOwners) and the same extent on the other two axes
+            rows.clear();
+            const int u = (a + 1) % 3, v = (a + 2) % 3;
+            for (uint32_t i = 0; i < items.size(); ++i) {
+                const Item& it = items[i];
+                if (!it.alive) continue;
+                uint64_t key = static_cast<uint64_t>(it.material) * 0x9E3779B97F4A7C15ull;
+                if (!settings.acrossOwners) key ^= std::hash<Entity>{}(it.owner) * 0xC2B2AE3D27D4EB4Full;
+                for (float c : { axis(it.min, u), axis(it.max, u), axis(it.min, v), axis(it.max, v) })
+                    key = (key ^ static_cast<uint64_t>(std::llround(c * quantum))) * 0x100000001B3ull;
+                rows[key].push_back(i);
+            }
+            for (auto& [key, row] : rows) {
+                if (row.size() < 2) continue;
+                std::sort(row.begin(), row.end(), [&](uint32_t x, uint32_t y) {
+                    float mx = axis(items[x].min, a), my = axis(items[y].min, a);
+                    return mx != my ? mx < my : x < y; // ties: the earlier entity keeps the box
+                });
+                // hash collisions / rounding: only merge what really lines up
+                auto linedUp = [&](const Item& x, const Item& y) {
+                    if (x.material != y.material || (!settings.acrossOwners && x.owner != y.owner)) return false;
+                    for (int b : { u, v })
+                        if (fabsf(axis(x.min, b) - axis(y.min, b)) > eps || fabsf(axis(x.max, b) - axis(y.max, b)) > eps) return false;
+                    return true;
+                };
+                // sweep: each box folds into the first box of the run that reaches it
+                for (size_t k = 0; k < row.size(); ++k) {
+                    Item& keep = items[row[k]];
+                    if (!keep.alive) continue;
+                    for (size_t n = k + 1; n < row.size(); ++n) {
+                        Item& next = items[row[n]];
+                        if (!next.alive || !linedUp(keep, next)) continue;
+                        if (axis(next.min, a) > axis(keep.max, a) + eps) break;
+                        bool duplicate = fabsf(axis(next.min, a) - axis(keep.min, a)) <= eps && fabsf(axis(next.max, a) - axis(keep.max, a)) <= eps;
+                        setAxis(keep.max, a, std::max(axis(keep.max, a), axis(next.max, a)));
+                        next.alive = false;
+                        keep.changed = true;
+                        stats.merged++;
+                        stats.duplicates += duplicate;
+                        mergedAny = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // write back: survivors get their new box, the rest go
+    auto markDirty = [&](Entity owner) {
+        if (auto baked = reg.get<BakedMesh>(owner)) baked->dirty = true;
+    };
+    for (const Item& it : items) {
+        if (!it.alive) {
+            DestroyEntityWithChildren(reg, it.e);
+            markDirty(it.owner);
+            if (changes) changes->push_back(WallChange{ it.e, it.owner, WallChange::Kind::Removed });
+            continue;
+        }
+        if (!it.changed) continue;
+        Vector3 center = Vector3Scale(Vector3Add(it.min, it.max), 0.5f);
+        Vector3 size = Vector3Subtract(it.max, it.min);
+        // parent-local like everything else, the owners are unrotated roots (see rotation note above)
+        Vector3 parentPos{ 0, 0, 0 };
+        if (auto pw = reg.get<WorldTransform>(it.owner)) parentPos = pw->position;
+        auto local = reg.get<TransformComp>(it.e);
+        local->position = Vector3Subtract(center, parentPos);
+        local->size = size;
+        auto world = reg.get<WorldTransform>(it.e);
+        world->position = center;
+        world->size = size;
+        markDirty(it.owner);
+        if (changes) changes->push_back(WallChange{ it.e, it.owner, WallChange::Kind::Resized });
+    }
+    return stats;
+}
@@ -4,13 +4,20 @@
 #include "include/core/custom_camera.h"
 #include "include/ecs/registry.h"
 #include "include/ecs/systems.h"
-#include "include/world/room.h"
-#include "include/world/hallway.h"
-#include "include/world/anchor.h"
+#include "include/world/demo_level.h"
 #include "include/textures/managed_texture.h"
+#include "include/textures/texture_atlas.h"
+#include "include/textures/async_texture_loader.h"
+#include "include/textures/asset_cache.h"
 #include "include/render/draw_utils.h"
+#include "include/render/mesh_baker.h"
+#include "include/render/portal_visibility.h"
+#include "include/render/occlusion.h"
+#include "include/spatial/collision.h"
+#include "include/spatial/raycast.h"
+#include <cstdio>
 
-// g++ -std=c++23 main.cpp src/render/draw_utils.cpp -o main -Iinclude -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
+// g++ -std=c++23 main.cpp src/render/draw_utils.cpp src/render/raylib_backend.cpp src/render/box_batch.cpp -o main -Iinclude -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
 
 int main(void)
 {
@@ -32,88 +39,76 @@ int main(void)
 
     SetTargetFPS(60);
 
-    auto brick = std::make_shared<ManagedTexture>("assets/models/brick/textures/Brick_Wall_5M_Berlin_yhtvxwB_4K_baseColor.png");
-    if (brick->get().id == 0) {
-        std::cerr << "DEV: Texture failed to load!\n";
-        // TODO:
-    }
+    // every wall material goes into one atlas so all walls share a single texture bind
+    // decoding the 4K png happens on the loader's threads... walls draw a placeholder until it is uploaded
+    double startTime = GetTime();
+    AsyncTextureLoader textureLoader;
+    AssetCache assets(&textureLoader); // every texture lives here, components only keep handles
+    TextureAtlas wallAtlas(4096);
+    const int brickTile = 0;
+    wallAtlas.buildAsync(textureLoader, assets, { "assets/models/brick/textures/Brick_Wall_5M_Berlin_yhtvxwB_4K_baseColor.png" }, "atlas:walls");
+    TexturedRender brick = wallAtlas.material(brickTile);
+    bool firstFrame = true;
     
     Registry registry;
     
     SystemManager systemManager(registry);
 
     TransformSystem& transformSystem = systemManager.addSystem<TransformSystem>();
-    DrawSystem& drawSystem = systemManager.addSystem<DrawSystem>();
+    systemManager.addSystem<MeshBakeSystem>();
+
+    // portal visibility fills visibleSet (plain frustum culling when outside every room), DrawSystem only draws what survived
+    VisibleSet visibleSet;
+    PortalVisibilitySystem& visibilitySystem = systemManager.addSystem<PortalVisibilitySystem>(camera, visibleSet);
+    visibilitySystem.aspect = (float)screenWidth / (float)screenHeight;
+    visibilitySystem.setTransforms(&transformSystem); // rebuilds when walls move
+
+    // then drop whatever the nearest walls hide (CPU depth buffer)
+    OcclusionCullingSystem& occlusionSystem = systemManager.addSystem<OcclusionCullingSystem>(camera, visibleSet);
+    occlusionSystem.aspect = visibilitySystem.aspect;
+    occlusionSystem.setTransforms(&transformSystem);
+
+    DrawSystem& drawSystem = systemManager.addSystem<DrawSystem>(&visibleSet);
+    drawSystem.setCamera(&camera); // front-to-back within each texture
+    drawSystem.setAssets(&assets);
     
-    // scale factor
-    const float S = 20.0f;
-
-    // room and hallway dimensions
-    Vector3 roomSize = {10*S, 2.5f*S, 10*S};  // 200 x 50 x 200
-    Vector3 hallSize = {4*S, 2.5f*S, 12*S};   // 240 x 50 x 80  (long along Z)
-
-    // spacing for front/back alignment
-    float spacing = roomSize.z/2 + hallSize.z/2; // 200/2 + 80/2 = 140
-
-    // place rooms in front and back, hallway in between
-    Entity room1 = CreateRoom(registry, { 0, 0, -spacing }, roomSize, brick, std::vector<Wall::Side>{ Wall::Side::Back });  // open back
-    Entity room2 = CreateRoom(registry, { 0, 0,  spacing }, roomSize, brick, std::vector<Wall::Side>{ Wall::Side::Front }); // open front    
-    Entity hall  = CreateHallway(registry, { 0, 0, 0 }, hallSize, brick);
-
-    // now calc WorldTransforms for all entities and anchors
-    transformSystem.update(registry);
-
-    // helper to find anchor on a parent with a specific direction
-    // used to locate the specific anchor entities on room1, room2, and hall based on their intended connection directions
-    auto findAnchorByDir = [&](Entity parentEntity, Vector3 dir)->Entity {
-        if (auto children = registry.get<Children>(parentEntity)) {
-            for (Entity child : children->entities) {
-                // if the child entity has an anchor component, it normalizes both the given direction and the anchor direction
-                if (auto a = registry.get<Anchor>(child)) {
-                    // normalize and compare directions
-                    Vector3 normalizedDir = Vector3Normalize(dir);
-                    Vector3 normalizedAnchorDir = Vector3Normalize(a->direction);
-                    
-                    float dot = Vector3DotProduct(normalizedAnchorDir, normalizedDir);
-                    if (dot > 0.99f) return child; // the directions are close enough
-                }
-            }
-        }
-        // if no suitable anchor entity is found, return INVALID_ENTITY
-        return INVALID_ENTITY;
-    };
-
-    // connect room1's right anchor to hall's left anchor
-    Entity r1_right = findAnchorByDir(room1, { 1, 0, 0 });
-    Entity hall_left = findAnchorByDir(hall, { -1, 0, 0 });
-
-
-    // ConnectAnchors is called twice 
-    // in order to link room1 to hall and room2 to hall 
-    // this snaps positions and carves doorways
-    if (r1_right != INVALID_ENTITY && hall_left != INVALID_ENTITY) {
-        ConnectAnchors(registry, r1_right, hall_left);
-    } else {
-        std::cerr << "DEV Warning: missing anchors for room1<->hall connection\n";
-    }
+    DemoLevel level = BuildDemoLevel(registry, transformSystem, brick);
 
-    // connect room2's left anchor to hall's right anchor
-    Entity r2_left = findAnchorByDir(room2, { -1, 0, 0 });
-    Entity hall_right = findAnchorByDir(hall, { 1, 0, 0 });
+    // merge each room's/hallway's walls into one cached mesh (re-baked when a doorway is carved)
+    for (Entity e : { level.room1, level.room2, level.hall })
+        EnableMeshBaking(registry, e);
 
-    if (r2_left != INVALID_ENTITY && hall_right != INVALID_ENTITY) {
-        ConnectAnchors(registry, r2_left, hall_right);
-    } else {
-        std::cerr << "DEV Warning: missing anchors for room2<->hall connection\n";
-    }
+    // precomputed visibility from pvs_builder, ignored if it was built for a different level
+    Pvs pvs;
+    if (pvs.load("level.pvs")) visibilitySystem.setPvs(&pvs);
+
+    // keeps the camera out of walls, N toggles noclip
+    // note: the eye sits in the middle of the player box for now (no gravity, the player floats at camera height)
+    CollisionSystem collisionSystem(transformSystem); // also follows walls the TransformSystem moved
+    const Vector3 playerHalfExtents = { 0.4f, 1.0f, 0.4f };
 
-    // called again to update transforms after the connection adjustments
-    transformSystem.update(registry);
+    // crosshair readout: what the camera is looking at
+    RaycastQuery raycastQuery;
 
     while (!WindowShouldClose())
     {   
+        Vector3 previousPosition = camera.position;
         UpdateCamera(&camera, cameraMode); 
 
+        if (IsKeyPressed(KEY_N)) collisionSystem.enabled = !collisionSystem.enabled;
+        collisionSystem.update(registry); // picks up carved/added walls
+        Vector3 resolved = collisionSystem.moveAndSlide(previousPosition, camera.position, playerHalfExtents);
+        Vector3 correction = Vector3Subtract(resolved, camera.position);
+        camera.position = resolved;
+        camera.target = Vector3Add(camera.target, correction); // same view direction
+
+        raycastQuery.update(registry);
+        RayHit aim = raycastQuery.closest(Ray{ camera.position, Vector3Subtract(camera.target, camera.position) });
+
+        // bounded GPU upload per frame (textures swap in when their last rows land)
+        if (textureLoader.update() > 0 && wallAtlas.getTexture()->isReady())
+            std::cout << "DEV: wall textures ready after " << (GetTime() - startTime) * 1000.0 << " ms\n";
+
         float dt = GetFrameTime();
         
         // transformSystem.update(reg, dt); // currently nothing moves, but system supports it
@@ -127,9 +122,28 @@ int main(void)
                 systemManager.update(dt);
 
             EndMode3D();
+
+            int cx = GetScreenWidth() / 2, cy = GetScreenHeight() / 2;
+            DrawLine(cx - 8, cy, cx + 8, cy, DARKGRAY);
+            DrawLine(cx, cy - 8, cx, cy + 8, DARKGRAY);
+            if (aim.hit()) {
+                static const char* sideNames[] = { "front", "back", "left", "right", "floor", "ceiling" };
+                char label[64];
+                snprintf(label, sizeof(label), "entity %u%s%s, %.1f m", static_cast<unsigned>(aim.entity.id), aim.isWall ? " wall " : "",
+                         aim.isWall ? sideNames[static_cast<int>(aim.side)] : "", aim.distance);
+                DrawText(label, cx + 12, cy + 12, 10, DARKGRAY);
+            }
         EndDrawing();
+
+        assets.collect(); // safe point: unload textures nothing references anymore
+
+        if (firstFrame) {
+            std::cout << "DEV: first frame after " << (GetTime() - startTime) * 1000.0 << " ms\n";
+            firstFrame = false;
+        }
     }
     
+    assets.clear(); // GPU textures go before the context does
     CloseWindow();
 
     return 0;
@@ -0,0 +1,94 @@
+#include "../../include/render/box_batch.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <algorithm>
+
+// raylib 5.5 takes a byte offset, older versions the same offset passed as a pointer
+static void SetAttribute(unsigned int location, int components, int type, bool normalized, size_t offset)
+{
+#if RAYLIB_VERSION_MAJOR > 5 || (RAYLIB_VERSION_MAJOR == 5 && RAYLIB_VERSION_MINOR >= 5)
+    rlSetVertexAttribute(location, components, type, normalized, sizeof(BoxVertex), static_cast<int>(offset));
+#else
+    rlSetVertexAttribute(location, components, type, normalized, sizeof(BoxVertex), reinterpret_cast<const void*>(offset));
+#endif
+    rlEnableVertexAttribute(location);
+}
+
+void BoxBatch::Unload()
+{
+    for (Chunk& chunk : chunks) {
+        if (chunk.vao == 0) continue;
+        rlUnloadVertexArray(chunk.vao);
+        rlUnloadVertexBuffer(chunk.vbo);
+        rlUnloadVertexBuffer(chunk.ebo);
+    }
+    chunks.clear();
+}
+
+void BoxBatch::draw(const Texture2D& texture)
+{
+    if (boxCount == 0) return;
+    const size_t chunkTotal = chunkCount();
+
+    if (dirty) {
+        if (chunks.size() < chunkTotal) chunks.resize(chunkTotal);
+        for (size_t c = 0; c < chunkTotal; ++c) {
+            Chunk& chunk = chunks[c];
+            const size_t first = c * box_batch::MAX_BOXES_PER_CHUNK;
+            const size_t count = std::min(box_batch::MAX_BOXES_PER_CHUNK, boxCount - first);
+            const BoxVertex* src = vertices.data() + first * box_batch::VERTICES_PER_BOX;
+            const int bytes = static_cast<int>(count * box_batch::VERTICES_PER_BOX * sizeof(BoxVertex));
+
+            if (count <= chunk.capacity) {
+                rlUpdateVertexBuffer(chunk.vbo, src, bytes, 0);
+                continue;
+            }
+
+            // (re)create the chunk's buffers at the new size... the index pattern only depends on the box count
+            if (chunk.vao != 0) {
+                rlUnloadVertexArray(chunk.vao);
+                rlUnloadVertexBuffer(chunk.vbo);
+                rlUnloadVertexBuffer(chunk.ebo);
+            }
+            if (indices.size() < count * box_batch::INDICES_PER_BOX) GenerateBoxIndices(count, indices);
+
+            chunk.vao = rlLoadVertexArray();
+            rlEnableVertexArray(chunk.vao);
+            chunk.vbo = rlLoadVertexBuffer(src, bytes, true);
+            SetAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false, offsetof(BoxVertex, position));
+            SetAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 3, RL_FLOAT, false, offsetof(BoxVertex, normal));
+            SetAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, offsetof(BoxVertex, texcoord));
+            SetAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, offsetof(BoxVertex, color));
+            chunk.ebo = rlLoadVertexBufferElement(indices.data(), static_cast<int>(count * box_batch::INDICES_PER_BOX * sizeof(uint16_t)), false);
+            rlDisableVertexArray();
+            chunk.capacity = count;
+        }
+        dirty = false;
+    }
+
+    // anything queued through rlBegin()/DrawCube() so far has to reach the screen first to keep draw order
+    rlDrawRenderBatchActive();
+
+    // same setup DrawMesh() does for the default material, with the tint already baked into the vertices
+    int* locs = rlGetShaderLocsDefault();
+    rlEnableShader(rlGetShaderIdDefault());
+    Matrix mvp = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+    rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], mvp);
+    const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], white, SHADER_UNIFORM_VEC4, 1);
+    const int slot = 0;
+    rlActiveTextureSlot(slot);
+    rlEnableTexture(texture.id != 0 ? texture.id : rlGetTextureIdDefault());
+    rlSetUniform(locs[SHADER_LOC_MAP_DIFFUSE], &slot, SHADER_UNIFORM_INT, 1);
+
+    for (size_t c = 0; c < chunkTotal; ++c) {
+        const size_t first = c * box_batch::MAX_BOXES_PER_CHUNK;
+        const size_t count = std::min(box_batch::MAX_BOXES_PER_CHUNK, boxCount - first);
+        rlEnableVertexArray(chunks[c].vao);
+        rlDrawVertexArrayElements(0, static_cast<int>(count * box_batch::INDICES_PER_BOX), nullptr);
+    }
+
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+}
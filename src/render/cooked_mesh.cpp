@@ -0,0 +1,122 @@
+#include "../../include/render/cooked_mesh.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <utility>
+
+// rlgl only names GL_FLOAT and GL_UNSIGNED_BYTE, glVertexAttribPointer takes these as they are
+static constexpr int GL_BYTE_TYPE = 0x1400;
+static constexpr int GL_UNSIGNED_SHORT_TYPE = 0x1403;
+
+// raylib 5.5 takes a byte offset, older versions the same offset passed as a pointer
+static void SetAttribute(unsigned int location, int components, int type, bool normalized, size_t offset)
+{
+#if RAYLIB_VERSION_MAJOR > 5 || (RAYLIB_VERSION_MAJOR == 5 && RAYLIB_VERSION_MINOR >= 5)
+    rlSetVertexAttribute(location, components, type, normalized, sizeof(CookedVertex), static_cast<int>(offset));
+#else
+    rlSetVertexAttribute(location, components, type, normalized, sizeof(CookedVertex), reinterpret_cast<const void*>(offset));
+#endif
+    rlEnableVertexAttribute(location);
+}
+
+void CookedMesh::Unload()
+{
+    for (Part& part : parts) rlUnloadVertexArray(part.vao);
+    if (vbo != 0) rlUnloadVertexBuffer(vbo);
+    if (ebo != 0) rlUnloadVertexBuffer(ebo);
+    parts.clear();
+    vbo = ebo = 0;
+}
+
+CookedMesh::CookedMesh(CookedMesh&& other) noexcept
+    : vbo(std::exchange(other.vbo, 0)), ebo(std::exchange(other.ebo, 0)), parts(std::move(other.parts)), bounds(other.bounds)
+{
+    other.parts.clear();
+}
+
+CookedMesh& CookedMesh::operator=(CookedMesh&& other) noexcept
+{
+    if (this != &other) {
+        Unload();
+        vbo = std::exchange(other.vbo, 0);
+        ebo = std::exchange(other.ebo, 0);
+        parts = std::move(other.parts);
+        other.parts.clear();
+        bounds = other.bounds;
+    }
+    return *this;
+}
+
+bool CookedMesh::load(const std::string& path)
+{
+    MappedFile file(path);
+    CookedMeshView view;
+    return file.isOpen() && ParseCookedMesh(file.data(), file.size(), view) && upload(view);
+}
+
+bool CookedMesh::upload(const CookedMeshView& view)
+{
+    Unload();
+    if (!view.valid() || view.header->vertexCount == 0 || view.header->indexCount == 0) return false;
+    const CookedMeshHeader& h = *view.header;
+
+    // the file's bytes go to the GPU as they are
+    vbo = rlLoadVertexBuffer(view.vertices, static_cast<int>(h.vertexCount * sizeof(CookedVertex)), false);
+    ebo = rlLoadVertexBufferElement(view.indices, static_cast<int>(h.indexCount * sizeof(uint16_t)), false);
+    bounds = view.bounds();
+
+    for (uint32_t p = 0; p < h.partCount; ++p) {
+        Part part;
+        part.range = view.parts[p];
+        part.vao = rlLoadVertexArray();
+        rlEnableVertexArray(part.vao);
+        rlEnableVertexBuffer(vbo);
+        // each part's VAO starts at its first vertex, so its 16-bit indices can stay part-relative
+        const size_t base = size_t{ part.range.firstVertex } * sizeof(CookedVertex);
+        SetAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, GL_UNSIGNED_SHORT_TYPE, true, base + offsetof(CookedVertex, position));
+        SetAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 3, GL_BYTE_TYPE, true, base + offsetof(CookedVertex, normal));
+        SetAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, base + offsetof(CookedVertex, texcoord));
+        rlEnableVertexBufferElement(ebo);
+        rlDisableVertexArray();
+        parts.push_back(part);
+    }
+    rlDisableVertexBuffer();
+    rlDisableVertexBufferElement();
+    return vbo != 0 && ebo != 0;
+}
+
+void CookedMesh::draw(const Matrix& transform, const Texture2D& texture, Color tint) const
+{
+    if (parts.empty()) return;
+
+    // anything queued through rlBegin()/DrawCube() so far has to reach the screen first to keep draw order
+    rlDrawRenderBatchActive();
+
+    // positions come in as 0..1 across the bounds: scale + offset back to model space, then place the mesh
+    const Vector3 extent = Vector3Subtract(bounds.max, bounds.min);
+    Matrix dequantize = MatrixMultiply(MatrixScale(extent.x, extent.y, extent.z), MatrixTranslate(bounds.min.x, bounds.min.y, bounds.min.z));
+    Matrix model = MatrixMultiply(MatrixMultiply(dequantize, transform), rlGetMatrixTransform());
+    Matrix mvp = MatrixMultiply(MatrixMultiply(model, rlGetMatrixModelview()), rlGetMatrixProjection());
+
+    int* locs = rlGetShaderLocsDefault();
+    rlEnableShader(rlGetShaderIdDefault());
+    rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], mvp);
+    const float color[4] = { tint.r / 255.0f, tint.g / 255.0f, tint.b / 255.0f, tint.a / 255.0f };
+    rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], color, SHADER_UNIFORM_VEC4, 1);
+    const int slot = 0;
+    rlActiveTextureSlot(slot);
+    rlEnableTexture(texture.id != 0 ? texture.id : rlGetTextureIdDefault());
+    rlSetUniform(locs[SHADER_LOC_MAP_DIFFUSE], &slot, SHADER_UNIFORM_INT, 1);
+
+    // no vertex colors in the file: white, like DrawMesh() does for meshes without them
+    const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (const Part& part : parts) {
+        rlEnableVertexArray(part.vao);
+        rlSetVertexAttributeDefault(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, white, SHADER_ATTRIB_VEC4, 4);
+        rlDisableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+        rlDrawVertexArrayElements(static_cast<int>(part.range.firstIndex), static_cast<int>(part.range.indexCount), nullptr);
+    }
+
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+}
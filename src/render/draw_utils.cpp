@@ -14,155 +14,105 @@
 ********************************************************************************************/
 
 #include "../../include/render/draw_utils.h"
-#include <iostream>
+#include "../../include/ecs/components.h"
+#include "../../include/textures/asset_cache.h"
+#include "raymath.h"
 
+// note: single boxes still go through rlBegin()... for many boxes use BoxBatch (box_batch.h)
 void DrawCubeTexture(const Texture2D& texture, const Vector3& position,
                      float width, float height, float length, Color color)
 {
-    std::cout << "DrawCubeTexture called  " << std::endl;
-    float x = position.x;
-    float y = position.y;
-    float z = position.z;
-
-    // Set desired texture to be enabled while drawing following vertex data
-    rlSetTexture(texture.id);
-
-    // Vertex data transformation can be defined with the commented lines,
-    // but in this example we calculate the transformed vertex data directly when calling rlVertex3f()
-    //rlPushMatrix();
-        // NOTE: Transformation is applied in inverse order (scale -> rotate -> translate)
-        //rlTranslatef(2.0f, 0.0f, 0.0f);
-        //rlRotatef(45, 0, 1, 0);
-        //rlScalef(2.0f, 2.0f, 2.0f);
-
-        rlBegin(RL_QUADS);
-            rlColor4ub(color.r, color.g, color.b, color.a);
-            // Front Face
-            rlNormal3f(0.0f, 0.0f, 1.0f);       // Normal Pointing Towards Viewer
-            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(x - width/2, y - height/2, z + length/2);  // Bottom Left Of The Texture and Quad
-            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(x + width/2, y - height/2, z + length/2);  // Bottom Right Of The Texture and Quad
-            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(x + width/2, y + height/2, z + length/2);  // Top Right Of The Texture and Quad
-            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(x - width/2, y + height/2, z + length/2);  // Top Left Of The Texture and Quad
-            // Back Face
-            rlNormal3f(0.0f, 0.0f, - 1.0f);     // Normal Pointing Away From Viewer
-            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(x - width/2, y - height/2, z - length/2);  // Bottom Right Of The Texture and Quad
-            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(x - width/2, y + height/2, z - length/2);  // Top Right Of The Texture and Quad
-            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(x + width/2, y + height/2, z - length/2);  // Top Left Of The Texture and Quad
-            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(x + width/2, y - height/2, z - length/2);  // Bottom Left Of The Texture and Quad
-            // Top Face
-            rlNormal3f(0.0f, 1.0f, 0.0f);       // Normal Pointing Up
-            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(x - width/2, y + height/2, z - length/2);  // Top Left Of The Texture and Quad
-            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(x - width/2, y + height/2, z + length/2);  // Bottom Left Of The Texture and Quad
-            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(x + width/2, y + height/2, z + length/2);  // Bottom Right Of The Texture and Quad
-            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(x + width/2, y + height/2, z - length/2);  // Top Right Of The Texture and Quad
-            // Bottom Face
-            rlNormal3f(0.0f, - 1.0f, 0.0f);     // Normal Pointing Down
-            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(x - width/2, y - height/2, z - length/2);  // Top Right Of The Texture and Quad
-            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(x + width/2, y - height/2, z - length/2);  // Top Left Of The Texture and Quad
-            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(x + width/2, y - height/2, z + length/2);  // Bottom Left Of The Texture and Quad
-            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(x - width/2, y - height/2, z + length/2);  // Bottom Right Of The Texture and Quad
-            // Right face
-            rlNormal3f(1.0f, 0.0f, 0.0f);       // Normal Pointing Right
-            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(x + width/2, y - height/2, z - length/2);  // Bottom Right Of The Texture and Quad
-            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(x + width/2, y + height/2, z - length/2);  // Top Right Of The Texture and Quad
-            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(x + width/2, y + height/2, z + length/2);  // Top Left Of The Texture and Quad
-            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(x + width/2, y - height/2, z + length/2);  // Bottom Left Of The Texture and Quad
-            // Left Face
-            rlNormal3f( - 1.0f, 0.0f, 0.0f);    // Normal Pointing Left
-            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(x - width/2, y - height/2, z - length/2);  // Bottom Left Of The Texture and Quad
-            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(x - width/2, y - height/2, z + length/2);  // Bottom Right Of The Texture and Quad
-            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(x - width/2, y + height/2, z + length/2);  // Top Right Of The Texture and Quad
-            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(x - width/2, y + height/2, z - length/2);  // Top Left Of The Texture and Quad
-        rlEnd();
-    //rlPopMatrix();
-
-    rlSetTexture(0);
+    // whole texture on every face... the negative height keeps the original v = 0 at the bottom of each face
+    DrawCubeTextureRec(texture, Rectangle{ 0, (float)texture.height, (float)texture.width, -(float)texture.height },
+                       position, width, height, length, color);
 }
 
 void DrawCubeTextureRec(const Texture2D& texture, const Rectangle& source, const Vector3& position,
                         float width, float height, float length, Color color)
 {
-    float x = position.x;
-    float y = position.y;
-    float z = position.z;
-    float texWidth = (float)texture.width;
-    float texHeight = (float)texture.height;
+    // corners and texture coordinates are computed once per box, not once per vertex
+    const float x0 = position.x - width/2, x1 = position.x + width/2;
+    const float y0 = position.y - height/2, y1 = position.y + height/2;
+    const float z0 = position.z - length/2, z1 = position.z + length/2;
+
+    // normalized texture coordinates for the source rectangle ([0.0f, 1.0f] range)
+    const float texWidth = (float)texture.width;
+    const float texHeight = (float)texture.height;
+    const float u0 = texWidth > 0 ? source.x/texWidth : 0.0f;
+    const float u1 = texWidth > 0 ? (source.x + source.width)/texWidth : 1.0f;
+    const float v0 = texHeight > 0 ? source.y/texHeight : 0.0f;
+    const float v1 = texHeight > 0 ? (source.y + source.height)/texHeight : 1.0f;
 
     // Set desired texture to be enabled while drawing following vertex data
     rlSetTexture(texture.id);
 
-    // We calculate the normalized texture coordinates for the desired texture-source-rectangle
-    // It means converting from (tex.width, tex.height) coordinates to [0.0f, 1.0f] equivalent
     rlBegin(RL_QUADS);
         rlColor4ub(color.r, color.g, color.b, color.a);
 
         // Front face
         rlNormal3f(0.0f, 0.0f, 1.0f);
-        rlTexCoord2f(source.x/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x - width/2, y - height/2, z + length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x + width/2, y - height/2, z + length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, source.y/texHeight);
-        rlVertex3f(x + width/2, y + height/2, z + length/2);
-        rlTexCoord2f(source.x/texWidth, source.y/texHeight);
-        rlVertex3f(x - width/2, y + height/2, z + length/2);
+        rlTexCoord2f(u0, v1); rlVertex3f(x0, y0, z1);
+        rlTexCoord2f(u1, v1); rlVertex3f(x1, y0, z1);
+        rlTexCoord2f(u1, v0); rlVertex3f(x1, y1, z1);
+        rlTexCoord2f(u0, v0); rlVertex3f(x0, y1, z1);
 
         // Back face
         rlNormal3f(0.0f, 0.0f, - 1.0f);
-        rlTexCoord2f((source.x + source.width)/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x - width/2, y - height/2, z - length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, source.y/texHeight);
-        rlVertex3f(x - width/2, y + height/2, z - length/2);
-        rlTexCoord2f(source.x/texWidth, source.y/texHeight);
-        rlVertex3f(x + width/2, y + height/2, z - length/2);
-        rlTexCoord2f(source.x/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x + width/2, y - height/2, z - length/2);
+        rlTexCoord2f(u1, v1); rlVertex3f(x0, y0, z0);
+        rlTexCoord2f(u1, v0); rlVertex3f(x0, y1, z0);
+        rlTexCoord2f(u0, v0); rlVertex3f(x1, y1, z0);
+        rlTexCoord2f(u0, v1); rlVertex3f(x1, y0, z0);
 
         // Top face
         rlNormal3f(0.0f, 1.0f, 0.0f);
-        rlTexCoord2f(source.x/texWidth, source.y/texHeight);
-        rlVertex3f(x - width/2, y + height/2, z - length/2);
-        rlTexCoord2f(source.x/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x - width/2, y + height/2, z + length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x + width/2, y + height/2, z + length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, source.y/texHeight);
-        rlVertex3f(x + width/2, y + height/2, z - length/2);
+        rlTexCoord2f(u0, v0); rlVertex3f(x0, y1, z0);
+        rlTexCoord2f(u0, v1); rlVertex3f(x0, y1, z1);
+        rlTexCoord2f(u1, v1); rlVertex3f(x1, y1, z1);
+        rlTexCoord2f(u1, v0); rlVertex3f(x1, y1, z0);
 
         // Bottom face
         rlNormal3f(0.0f, - 1.0f, 0.0f);
-        rlTexCoord2f((source.x + source.width)/texWidth, source.y/texHeight);
-        rlVertex3f(x - width/2, y - height/2, z - length/2);
-        rlTexCoord2f(source.x/texWidth, source.y/texHeight);
-        rlVertex3f(x + width/2, y - height/2, z - length/2);
-        rlTexCoord2f(source.x/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x + width/2, y - height/2, z + length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x - width/2, y - height/2, z + length/2);
+        rlTexCoord2f(u1, v0); rlVertex3f(x0, y0, z0);
+        rlTexCoord2f(u0, v0); rlVertex3f(x1, y0, z0);
+        rlTexCoord2f(u0, v1); rlVertex3f(x1, y0, z1);
+        rlTexCoord2f(u1, v1); rlVertex3f(x0, y0, z1);
 
         // Right face
         rlNormal3f(1.0f, 0.0f, 0.0f);
-        rlTexCoord2f((source.x + source.width)/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x + width/2, y - height/2, z - length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, source.y/texHeight);
-        rlVertex3f(x + width/2, y + height/2, z - length/2);
-        rlTexCoord2f(source.x/texWidth, source.y/texHeight);
-        rlVertex3f(x + width/2, y + height/2, z + length/2);
-        rlTexCoord2f(source.x/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x + width/2, y - height/2, z + length/2);
+        rlTexCoord2f(u1, v1); rlVertex3f(x1, y0, z0);
+        rlTexCoord2f(u1, v0); rlVertex3f(x1, y1, z0);
+        rlTexCoord2f(u0, v0); rlVertex3f(x1, y1, z1);
+        rlTexCoord2f(u0, v1); rlVertex3f(x1, y0, z1);
 
         // Left face
         rlNormal3f( - 1.0f, 0.0f, 0.0f);
-        rlTexCoord2f(source.x/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x - width/2, y - height/2, z - length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, (source.y + source.height)/texHeight);
-        rlVertex3f(x - width/2, y - height/2, z + length/2);
-        rlTexCoord2f((source.x + source.width)/texWidth, source.y/texHeight);
-        rlVertex3f(x - width/2, y + height/2, z + length/2);
-        rlTexCoord2f(source.x/texWidth, source.y/texHeight);
-        rlVertex3f(x - width/2, y + height/2, z - length/2);
+        rlTexCoord2f(u0, v1); rlVertex3f(x0, y0, z0);
+        rlTexCoord2f(u1, v1); rlVertex3f(x0, y0, z1);
+        rlTexCoord2f(u1, v0); rlVertex3f(x0, y1, z1);
+        rlTexCoord2f(u0, v0); rlVertex3f(x0, y1, z0);
 
     rlEnd();
 
     rlSetTexture(0);
+}
+
+void DrawBakedBatch(BakedMeshBatch& batch, const Texture2D& texture)
+{
+    // one shared material, only the diffuse map/tint changes per batch
+    static Material material = LoadMaterialDefault();
+    static Texture2D defaultTexture = material.maps[MATERIAL_MAP_DIFFUSE].texture;
+
+    if (batch.indices.empty()) return;
+    if (!batch.gpu.isUploaded())
+        batch.gpu.upload(batch.vertices, batch.texcoords, batch.normals, batch.indices);
+
+    material.maps[MATERIAL_MAP_DIFFUSE].texture = texture.id != 0 ? texture : defaultTexture;
+    material.maps[MATERIAL_MAP_DIFFUSE].color = batch.color;
+    DrawMesh(batch.gpu.get(), material, MatrixIdentity());
+}
+
+void DrawBakedMesh(BakedMesh& mesh, const AssetCache& assets)
+{
+    for (auto& batch : mesh.batches)
+        DrawBakedBatch(batch, assets.get(batch.texture));
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "../../include/render/raylib_backend.h"
+#include "../../include/render/draw_utils.h"
+
+void RaylibBackend::flushBoxes()
+{
+    if (pending.empty()) return;
+    boxes.build(pending);
+    Texture2D texture{};
+    texture.id = pendingTexture;
+    boxes.draw(texture);
+    pending.clear();
+}
+
+void RaylibBackend::submit(const RenderCommandBuffer& commands)
+{
+    stats.reset();
+    const DrawPacket* previous = nullptr;
+    for (const DrawPacket& p : commands.getPackets()) {
+        switch (p.kind) {
+            case MeshKind::ColoredCube:
+            case MeshKind::TexturedCube:
+                if (!pending.empty() && p.texture.id != pendingTexture) flushBoxes();
+                pendingTexture = p.texture.id;
+                pending.push_back(BoxInstance{ p.position, p.size, p.uv, p.color });
+                break;
+            case MeshKind::BakedBatch:
+                flushBoxes();
+                if (p.batch) DrawBakedBatch(*p.batch, p.texture);
+                break;
+        }
+        stats.count(p, previous);
+        previous = &p;
+    }
+    flushBoxes();
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/anchor.h"
+#include "../include/world/anchor_index.h"
+#include "../include/world/hallway.h"
+#include "../include/world/room.h"
+
+TEST(AnchorIndexTest, DirectionsRoundTrip) {
+    for (int i = 0; i < 4; ++i) {
+        AnchorDir dir = static_cast<AnchorDir>(i);
+        EXPECT_EQ(AnchorDirFromVector(AnchorDirVector(dir)), dir);
+        EXPECT_EQ(OppositeDir(OppositeDir(dir)), dir);
+        Vector3 sum = Vector3Add(AnchorDirVector(dir), AnchorDirVector(OppositeDir(dir)));
+        EXPECT_FLOAT_EQ(Vector3Length(sum), 0.0f);
+    }
+    EXPECT_EQ(AnchorDirFromVector({ 0.9f, 0, 0.1f }), AnchorDir::Right);
+    EXPECT_EQ(AnchorToWallSide(AnchorDir::Left), Wall::Side::Left);
+
+    Anchor a({ 0, 0, 0 }, Vector3{ 0, 0, -1 }, INVALID_ENTITY);
+    EXPECT_EQ(a.dir, AnchorDir::Front);
+}
+
+TEST(AnchorIndexTest, CreateFillsSlotsAndIndex) {
+    Registry reg;
+    AnchorIndex index;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 }, {}, {}, &index);
+    EXPECT_EQ(index.size(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        AnchorDir dir = static_cast<AnchorDir>(i);
+        Entity e = FindAnchor(reg, room, dir);
+        ASSERT_NE(e, INVALID_ENTITY);
+        auto a = reg.get<Anchor>(e);
+        EXPECT_EQ(a->dir, dir);
+        EXPECT_EQ(reg.get<Parent>(e)->parent, room);
+        EXPECT_TRUE(index.contains(e));
+        // the anchor sits in the middle of that wall
+        Vector3 expected = Vector3Scale(AnchorDirVector(dir), 10.0f);
+        EXPECT_EQ(index.findFree(expected, dir, 0.5f), e);
+        EXPECT_EQ(index.findFree(expected, OppositeDir(dir), 0.5f), INVALID_ENTITY);
+    }
+
+    Entity hall = CreateHallway(reg, { 0, 0, 50 }, { 8, 10, 60 }, AnchorDir::Back, {}, &index);
+    EXPECT_EQ(reg.get<Anchor>(FindAnchor(reg, hall, AnchorDir::Back))->localPos.z, 30.0f);
+    EXPECT_EQ(index.size(), 8u);
+    EXPECT_EQ(FindAnchor(reg, reg.create(), AnchorDir::Front), INVALID_ENTITY); // no slots at all
+}
+
+TEST(AnchorIndexTest, ConnectRemovesBothAnchorsAndMovesTheHallway) {
+    Registry reg;
+    TransformSystem transforms;
+    AnchorIndex index;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 }, {}, {}, &index);
+    Entity hall = CreateHallway(reg, { 100, 0, 100 }, { 8, 10, 30 }, AnchorDir::Back, {}, &index); // somewhere else, gets snapped
+    transforms.update(reg);
+
+    // a generator looking for the end of the hallway that should meet the room's back wall
+    Entity roomBack = FindAnchor(reg, room, AnchorDir::Back);
+    Entity hallFront = FindAnchor(reg, hall, AnchorDir::Front);
+    Entity hallBack = FindAnchor(reg, hall, AnchorDir::Back);
+    ConnectAnchors(reg, roomBack, hallFront, &index);
+    transforms.update(reg);
+
+    EXPECT_FALSE(index.contains(roomBack));
+    EXPECT_FALSE(index.contains(hallFront));
+    EXPECT_TRUE(index.contains(hallBack));
+    EXPECT_EQ(index.size(), 6u);
+
+    // the hallway's far end is indexed where it ended up: room back wall (z = 10) + hallway length
+    EXPECT_EQ(index.findFree({ 0, 0, 40 }, AnchorDir::Back, 0.5f), hallBack);
+    EXPECT_EQ(index.findFree({ 100, 0, 115 }, AnchorDir::Back, 0.5f), INVALID_ENTITY);
+
+    // rebuilding from the registry gives the same set
+    AnchorIndex rebuilt;
+    rebuilt.rebuild(reg);
+    EXPECT_EQ(rebuilt.size(), index.size());
+    EXPECT_FALSE(rebuilt.contains(roomBack));
+    EXPECT_EQ(rebuilt.findFree({ 0, 0, 40 }, AnchorDir::Back, 0.5f), hallBack);
+}
+
+TEST(AnchorIndexTest, AddRemoveAndQuery) {
+    AnchorIndex index(10.0f);
+    Registry reg;
+    Entity a = reg.create(), b = reg.create(), c = reg.create();
+    index.add(a, { 0, 0, 0 }, AnchorDir::Right);
+    index.add(b, { 3, 0, 0 }, AnchorDir::Right);
+    index.add(c, { 100, 0, 0 }, AnchorDir::Right);
+    index.add(a, { 1, 0, 0 }, AnchorDir::Right); // re-adding moves it
+    EXPECT_EQ(index.size(), 3u);
+
+    EXPECT_EQ(index.findFree({ 0, 0, 0 }, AnchorDir::Right, 5.0f), a);
+    EXPECT_EQ(index.findFree({ 2.9f, 0, 0 }, AnchorDir::Right, 5.0f), b);
+    EXPECT_EQ(index.findFree({ 50, 0, 0 }, AnchorDir::Right, 5.0f), INVALID_ENTITY);
+
+    int found = 0;
+    index.query(BoundingBox{ { -1, -1, -1 }, { 4, 1, 1 } }, [&](Entity, Vector3, AnchorDir) { found++; });
+    EXPECT_EQ(found, 2);
+
+    index.remove(a);
+    index.remove(a); // twice is fine
+    EXPECT_EQ(index.findFree({ 0, 0, 0 }, AnchorDir::Right, 5.0f), b);
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_EQ(index.findFree({ 3, 0, 0 }, AnchorDir::Right, 5.0f), INVALID_ENTITY);
+}
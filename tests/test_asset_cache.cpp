@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include "../include/ecs/components.h"
+#include "../include/textures/asset_cache.h"
+
+// components only carry a handle, copying one is a plain memcpy
+static_assert(std::is_trivially_copyable_v<TextureHandle>);
+static_assert(std::is_trivially_copyable_v<TexturedRender>);
+
+TEST(AssetCacheTest, HandlePacksIndexAndGeneration) {
+    TextureHandle empty;
+    EXPECT_FALSE(empty);
+
+    TextureHandle h(5, 3);
+    EXPECT_TRUE(h);
+    EXPECT_EQ(h.index(), 5u);
+    EXPECT_EQ(h.generation(), 3u);
+    EXPECT_NE(h, TextureHandle(5, 4));
+}
+
+TEST(AssetCacheTest, SamePathLoadsOnce) {
+    AssetCache cache;
+    TextureHandle a = cache.loadTexture("assets/textures/wall.png");
+    TextureHandle b = cache.loadTexture("assets/./textures/../textures/wall.png"); // same file, different spelling
+    TextureHandle c = cache.loadTexture("assets/textures/floor.png");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.refCount(a), 2u);
+    EXPECT_EQ(cache.find("assets/textures/wall.png"), a);
+}
+
+TEST(AssetCacheTest, SameImageUploadsOnce) {
+    AssetCache cache;
+    Image red = GenImageColor(8, 8, RED);
+    Image red2 = GenImageColor(8, 8, RED);
+    Image blue = GenImageColor(8, 8, BLUE);
+
+    TextureHandle a = cache.addImage(red);
+    TextureHandle b = cache.addImage(red2);
+    TextureHandle c = cache.addImage(blue);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(cache.get(a).id, cache.get(b).id);
+    EXPECT_EQ(cache.get(a).width, 8);
+
+    UnloadImage(red);
+    UnloadImage(red2);
+    UnloadImage(blue);
+}
+
+TEST(AssetCacheTest, CollectOnlyUnloadsUnreferenced) {
+    AssetCache cache;
+    Image image = GenImageColor(4, 4, GREEN);
+    TextureHandle h = cache.addImage(image);
+    cache.retain(h);
+
+    cache.release(h);
+    EXPECT_EQ(cache.collect(), 0u); // still one reference
+    EXPECT_TRUE(cache.isReady(h));
+
+    cache.release(h);
+    EXPECT_EQ(cache.refCount(h), 0u);
+    EXPECT_TRUE(cache.isReady(h)); // release() alone never unloads
+    EXPECT_EQ(cache.collect(), 1u);
+    EXPECT_EQ(cache.size(), 0u);
+    UnloadImage(image);
+}
+
+TEST(AssetCacheTest, StaleHandlesResolveToNothing) {
+    AssetCache cache;
+    Image a = GenImageColor(4, 4, GREEN);
+    Image b = GenImageColor(2, 2, GREEN);
+
+    TextureHandle old = cache.addImage(a);
+    cache.release(old);
+    cache.collect();
+
+    // the slot gets reused, the old handle must not see the new texture
+    TextureHandle fresh = cache.addImage(b);
+    EXPECT_EQ(fresh.index(), old.index());
+    EXPECT_NE(fresh, old);
+    EXPECT_EQ(cache.get(old).id, 0u);
+    EXPECT_EQ(cache.texture(old), nullptr);
+    EXPECT_EQ(cache.get(fresh).width, 2);
+
+    cache.release(old); // no-op, doesn't touch the new owner's count
+    EXPECT_EQ(cache.refCount(fresh), 1u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    UnloadImage(a);
+    UnloadImage(b);
+}
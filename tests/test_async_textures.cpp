@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "../include/textures/async_texture_loader.h"
+#include "../include/textures/texture_atlas.h"
+#include "../include/textures/asset_cache.h"
+
+// writes a solid test image next to the test binary
+static std::string WriteImage(const char* name, int w, int h) {
+    std::string path = std::string("async_tex_") + name + ".png";
+    Image image = GenImageColor(w, h, RED);
+    EXPECT_TRUE(ExportImage(image, path.c_str()));
+    UnloadImage(image);
+    return path;
+}
+
+TEST(AsyncTextureTest, PlaceholderUntilUploaded) {
+    std::string path = WriteImage("plain", 64, 32);
+    AsyncTextureLoader loader(2);
+    auto texture = loader.load(path);
+
+    // usable straight away, drawing the placeholder
+    EXPECT_FALSE(texture->isReady());
+    EXPECT_EQ(texture->get().id, loader.getPlaceholder().id);
+
+    loader.finish();
+    EXPECT_TRUE(texture->isReady());
+    EXPECT_NE(texture->get().id, loader.getPlaceholder().id);
+    EXPECT_EQ(texture->get().width, 64);
+    EXPECT_EQ(texture->get().height, 32);
+    EXPECT_TRUE(loader.idle());
+    std::remove(path.c_str());
+}
+
+TEST(AsyncTextureTest, UploadIsSpreadOverFrames) {
+    std::string path = WriteImage("budget", 64, 64);
+    AsyncTextureLoader loader(1, 64 * 4 * 16); // 16 rows per update
+    auto texture = loader.load(path);
+
+    // frames before the decode finishes count too, so this only checks the lower bound
+    int frames = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!texture->isReady() && std::chrono::steady_clock::now() < deadline) {
+        loader.update();
+        frames++;
+        std::this_thread::yield();
+    }
+    EXPECT_TRUE(texture->isReady());
+    EXPECT_GE(frames, 4); // 64 rows at 16 per frame
+    std::remove(path.c_str());
+}
+
+TEST(AsyncTextureTest, DownscaleAndMissingFiles) {
+    std::string path = WriteImage("big", 256, 128);
+    AsyncTextureLoader loader(2);
+    TextureLoadOptions options;
+    options.maxSize = 64;
+    auto small = loader.load(path, options);
+    auto missing = loader.load("does/not/exist.png");
+    loader.finish();
+
+    EXPECT_EQ(small->get().width, 64);
+    EXPECT_EQ(small->get().height, 32);
+    EXPECT_FALSE(missing->isReady()); // keeps drawing the placeholder
+    EXPECT_EQ(missing->get().id, loader.getPlaceholder().id);
+    std::remove(path.c_str());
+}
+
+TEST(AsyncTextureTest, AtlasBuildsInTheBackground) {
+    std::string a = WriteImage("tile_a", 32, 32);
+    std::string b = WriteImage("tile_b", 16, 16);
+    AsyncTextureLoader loader(2);
+    AssetCache assets;
+    TextureAtlas atlas(32, 2);
+    ASSERT_TRUE(atlas.buildAsync(loader, assets, { a, b }));
+
+    // materials (uv rects) exist before the pixels do
+    TexturedRender m = atlas.material(1);
+    ASSERT_TRUE(m.texture);
+    EXPECT_FALSE(assets.isReady(m.texture));
+    EXPECT_TRUE(m.isSubRegion());
+
+    loader.finish();
+    EXPECT_TRUE(assets.isReady(m.texture));
+    EXPECT_EQ(assets.get(m.texture).width, atlas.getLayout().width());
+    std::remove(a.c_str());
+    std::remove(b.c_str());
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "../include/render/box_batch.h"
+#include "../include/render/raylib_backend.h"
+
+static std::vector<BoxInstance> RandomBoxes(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 20.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<BoxInstance> boxes(n);
+    for (auto& b : boxes) {
+        b.position = { pos(rng), pos(rng), pos(rng) };
+        b.size = { size(rng), size(rng), size(rng) };
+        b.uv = { unit(rng), unit(rng), unit(rng), unit(rng) };
+        b.color = { static_cast<unsigned char>(rng()), static_cast<unsigned char>(rng()),
+                    static_cast<unsigned char>(rng()), 255 };
+    }
+    return boxes;
+}
+
+TEST(BoxBatchTest, SimdMatchesScalar) {
+    auto boxes = RandomBoxes(257, 7);
+    std::vector<BoxVertex> simd(boxes.size() * box_batch::VERTICES_PER_BOX);
+    std::vector<BoxVertex> scalar(simd.size());
+    GenerateBoxVertices(boxes, simd.data());
+    GenerateBoxVerticesScalar(boxes, scalar.data());
+
+    for (size_t i = 0; i < simd.size(); ++i) {
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_FLOAT_EQ(simd[i].position[k], scalar[i].position[k]) << "vertex " << i;
+            EXPECT_FLOAT_EQ(simd[i].normal[k], scalar[i].normal[k]) << "vertex " << i;
+        }
+        EXPECT_FLOAT_EQ(simd[i].texcoord[0], scalar[i].texcoord[0]);
+        EXPECT_FLOAT_EQ(simd[i].texcoord[1], scalar[i].texcoord[1]);
+        for (int k = 0; k < 4; ++k) EXPECT_EQ(simd[i].color[k], scalar[i].color[k]);
+    }
+}
+
+TEST(BoxBatchTest, CornersAndFaces) {
+    BoxInstance box;
+    box.position = { 10, 2, -4 };
+    box.size = { 4, 2, 6 };
+    const Color red = RED;
+    box.color = red;
+    BoxVertex v[box_batch::VERTICES_PER_BOX];
+    GenerateBoxVertices(std::span<const BoxInstance>(&box, 1), v);
+
+    // every vertex sits on a corner, on the face its normal points out of
+    for (const BoxVertex& vert : v) {
+        EXPECT_FLOAT_EQ(fabsf(vert.position[0] - 10), 2);
+        EXPECT_FLOAT_EQ(fabsf(vert.position[1] - 2), 1);
+        EXPECT_FLOAT_EQ(fabsf(vert.position[2] + 4), 3);
+        float along = (vert.position[0] - 10) * vert.normal[0] / 2 + (vert.position[1] - 2) * vert.normal[1] +
+                      (vert.position[2] + 4) * vert.normal[2] / 3;
+        EXPECT_FLOAT_EQ(along, 1);
+        EXPECT_EQ(vert.color[0], red.r);
+        EXPECT_EQ(vert.color[3], red.a);
+    }
+
+    // front face, bottom left: same texcoord as DrawCubeTexture() (0, 0)
+    EXPECT_FLOAT_EQ(v[0].position[0], 8);
+    EXPECT_FLOAT_EQ(v[0].position[1], 1);
+    EXPECT_FLOAT_EQ(v[0].position[2], -1);
+    EXPECT_FLOAT_EQ(v[0].texcoord[0], 0);
+    EXPECT_FLOAT_EQ(v[0].texcoord[1], 0);
+}
+
+TEST(BoxBatchTest, SourceRectUvs) {
+    // same mapping as DrawCubeTextureRec(): bottom left of the front face is (x, y + height) in pixels
+    BoxInstance box;
+    box.uv = BoxUvFromSource(Rectangle{ 32, 64, 16, 32 }, 128, 256);
+    BoxVertex v[box_batch::VERTICES_PER_BOX];
+    GenerateBoxVertices(std::span<const BoxInstance>(&box, 1), v);
+    EXPECT_FLOAT_EQ(v[0].texcoord[0], 32.0f / 128);
+    EXPECT_FLOAT_EQ(v[0].texcoord[1], 96.0f / 256);
+    EXPECT_FLOAT_EQ(v[2].texcoord[0], 48.0f / 128);
+    EXPECT_FLOAT_EQ(v[2].texcoord[1], 64.0f / 256);
+}
+
+TEST(BoxBatchTest, IndicesAndChunks) {
+    std::vector<uint16_t> indices;
+    GenerateBoxIndices(2, indices);
+    ASSERT_EQ(indices.size(), 72);
+    EXPECT_EQ(indices[0], 0);
+    EXPECT_EQ(indices[5], 3);
+    EXPECT_EQ(indices[36], 24);
+    EXPECT_EQ(indices[71], 47);
+
+    GenerateBoxIndices(box_batch::MAX_BOXES_PER_CHUNK, indices);
+    EXPECT_LE(*std::max_element(indices.begin(), indices.end()), 65535);
+
+    BoxBatch batch;
+    batch.build(RandomBoxes(box_batch::MAX_BOXES_PER_CHUNK + 10, 3));
+    EXPECT_EQ(batch.chunkCount(), 2);
+    batch.append(RandomBoxes(5, 4));
+    EXPECT_EQ(batch.size(), box_batch::MAX_BOXES_PER_CHUNK + 15);
+    EXPECT_EQ(batch.vertexCount(), batch.size() * box_batch::VERTICES_PER_BOX);
+    batch.build(RandomBoxes(3, 5));
+    EXPECT_EQ(batch.chunkCount(), 1);
+}
+
+TEST(BoxBatchTest, BackendCountsEveryPacket) {
+    // the raylib backend batches runs of cubes, stats still count the packets
+    RenderCommandBuffer commands;
+    for (int i = 0; i < 10; ++i) commands.pushColoredCube({ float(i), 0, 0 }, { 1, 1, 1 }, GRAY);
+    Texture2D texture{};
+    texture.id = 3;
+    for (int i = 0; i < 5; ++i) commands.pushTexturedCube({ 0, float(i), 0 }, { 1, 1, 1 }, texture);
+    commands.sort();
+
+    RaylibBackend backend;
+    backend.submit(commands);
+    EXPECT_EQ(backend.getStats().draws, 15);
+    EXPECT_EQ(backend.getStats().textureBinds, 2);
+}
@@ -0,0 +1,318 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/entity_utils.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/collision.h"
+#include "../include/spatial/dynamic_broadphase.h"
+#include "../include/spatial/spatial_hash.h"
+#include "../include/spatial/sweep.h"
+#include "../include/world/room.h"
+
+static Entity AddCollider(Registry& reg, Vector3 position, Vector3 size) {
+    Entity e = reg.create();
+    reg.add<WorldTransform>(e, WorldTransform{ position, size });
+    reg.add<Collision>(e, Collision{});
+    return e;
+}
+
+static std::vector<uint32_t> QueryIds(SpatialHash& hash, const BoundingBox& box) {
+    std::vector<uint32_t> ids;
+    hash.query(box, [&](uint32_t id, const BoundingBox&) { ids.push_back(id); });
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+TEST(SpatialHashTest, QueriesMatchBruteForce) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 30.0f);
+    auto randomBox = [&] { return BoundsFromCenterSize({ pos(rng), pos(rng), pos(rng) }, { size(rng), size(rng), size(rng) }); };
+
+    SpatialHash hash(8.0f, 64); // small limit so some boxes land in the oversized list
+    std::vector<BoundingBox> boxes;
+    std::vector<bool> live;
+    for (int i = 0; i < 500; ++i) {
+        boxes.push_back(randomBox());
+        live.push_back(true);
+        EXPECT_EQ(hash.insert(boxes.back()), static_cast<uint32_t>(i));
+    }
+    EXPECT_GT(hash.oversizedCount(), 0u);
+    // move some, remove some
+    for (uint32_t i = 0; i < 500; i += 3) {
+        boxes[i] = randomBox();
+        hash.update(i, boxes[i]);
+    }
+    for (uint32_t i = 1; i < 500; i += 7) {
+        hash.remove(i);
+        live[i] = false;
+    }
+
+    for (int q = 0; q < 200; ++q) {
+        BoundingBox query = randomBox();
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < boxes.size(); ++i)
+            if (live[i] && BoundsOverlap(boxes[i], query)) expected.push_back(i);
+        EXPECT_EQ(QueryIds(hash, query), expected);
+    }
+
+    // removed ids are handed out again
+    uint32_t reused = hash.insert(randomBox());
+    EXPECT_FALSE(live[reused]);
+}
+
+TEST(SpatialHashTest, MovingWithinCellsKeepsBuckets) {
+    SpatialHash hash(10.0f);
+    uint32_t id = hash.insert(BoundsFromCenterSize({ 5, 5, 5 }, { 2, 2, 2 }));
+    size_t cells = hash.cellCount();
+    hash.update(id, BoundsFromCenterSize({ 5.5f, 5, 5 }, { 2, 2, 2 }));
+    EXPECT_EQ(hash.cellCount(), cells);
+    EXPECT_EQ(QueryIds(hash, BoundsFromCenterSize({ 6.4f, 5, 5 }, { 0.1f, 0.1f, 0.1f })).size(), 1u);
+
+    hash.update(id, BoundsFromCenterSize({ 55, 5, 5 }, { 2, 2, 2 }));
+    EXPECT_TRUE(QueryIds(hash, BoundsFromCenterSize({ 5, 5, 5 }, { 4, 4, 4 })).empty());
+    EXPECT_EQ(QueryIds(hash, BoundsFromCenterSize({ 55, 5, 5 }, { 1, 1, 1 })).size(), 1u);
+    hash.remove(id);
+    EXPECT_EQ(hash.cellCount(), 0u); // empty cells are dropped
+}
+
+TEST(CollisionTest, StopsAtWallAndSlidesAlongIt) {
+    Registry reg;
+    AddCollider(reg, { 0, 0, -5 }, { 20, 10, 0.1f }); // wall across z = -5
+    CollisionSystem collision;
+    collision.update(reg);
+    ASSERT_EQ(collision.colliderCount(), 1u);
+
+    const Vector3 half{ 0.3f, 1.0f, 0.3f };
+    Vector3 p = collision.moveAndSlide({ 0, 0, 0 }, { 0, 0, -10 }, half);
+    EXPECT_NEAR(p.z, -5 + 0.05f + half.z, 0.02f);
+    EXPECT_GT(collision.contacts, 0u);
+
+    // diagonal into the wall keeps the sideways part of the move
+    Vector3 q = collision.moveAndSlide({ 0, 0, -4 }, { 3, 0, -7 }, half);
+    EXPECT_NEAR(q.x, 3.0f, 1e-4f);
+    EXPECT_NEAR(q.z, -5 + 0.05f + half.z, 0.02f);
+
+    // moving away or along it is untouched
+    Vector3 r = collision.moveAndSlide({ 0, 0, -4 }, { 2, 0, 0 }, half);
+    EXPECT_FLOAT_EQ(r.x, 2.0f);
+    EXPECT_FLOAT_EQ(r.z, 0.0f);
+
+    collision.enabled = false; // noclip
+    Vector3 s = collision.moveAndSlide({ 0, 0, 0 }, { 0, 0, -10 }, half);
+    EXPECT_FLOAT_EQ(s.z, -10.0f);
+}
+
+TEST(CollisionTest, FastMovesDoNotTunnelThroughThinWalls) {
+    Registry reg;
+    AddCollider(reg, { 0, 0, -5 }, { 20, 10, 0.1f });
+    CollisionSystem collision;
+    collision.update(reg);
+
+    // CAMERA_MOVE_SPEED over frames from a normal 60 Hz one up to a 2 s hitch, always the same answer
+    const Vector3 half{ 0.3f, 1.0f, 0.3f };
+    const float stop = -5 + 0.05f + half.z;
+    for (float dt : { 1.0f / 60.0f, 0.1f, 0.5f, 2.0f }) {
+        float distance = 85.0f * dt;
+        Vector3 p = collision.moveAndSlide({ 0, 0, -4 }, { 0, 0, -4 - distance }, half);
+        EXPECT_GE(p.z, stop) << dt;
+        if (distance > 1.0f) {
+            EXPECT_NEAR(p.z, stop, 0.02f) << dt;
+        }
+        // a thin mover too: no substep size to hide behind
+        Vector3 q = collision.moveAndSlide({ 0, 0, -4 }, { 0, 0, -4 - distance }, { 0.01f, 0.01f, 0.01f });
+        EXPECT_GT(q.z, -4.95f) << dt;
+    }
+}
+
+TEST(CollisionTest, LongMovesSlideAndStopAtTheFirstWall) {
+    Registry reg;
+    TransformSystem transformSystem;
+    CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    CreateRoom(reg, { 30, 0, 0 }, { 20, 10, 20 }); // a second room behind the +x wall
+    transformSystem.update(reg);
+    CollisionSystem collision;
+    collision.update(reg);
+
+    // one huge frame at a shallow angle: hits +x, slides along it, hits +z, ends in the corner of the first room
+    const Vector3 half{ 0.3f, 1.0f, 0.3f };
+    Vector3 p = collision.moveAndSlide({ 0, 0, 0 }, { 200, 0, 60 }, half);
+    EXPECT_EQ(collision.contacts, 2u);
+    EXPECT_NEAR(p.x, 10.0f - 0.05f - half.x, 0.02f);
+    EXPECT_NEAR(p.z, 10.0f - 0.05f - half.z, 0.02f);
+}
+
+TEST(CollisionTest, RestingFarFromOriginStaysOutside) {
+    // float spacing near 40000 is ~0.004, rounding alone can put a player resting on a wall just inside it
+    Registry reg;
+    AddCollider(reg, { 40000.0f, 0, 40000.0f }, { 20, 10, 0.1f });
+    CollisionSystem collision;
+    collision.update(reg);
+
+    const Vector3 half{ 0.3f, 1.0f, 0.3f };
+    Vector3 p{ 40000.0f, 0, 40001.0f };
+    for (int frame = 0; frame < 240; ++frame) {
+        float side = frame % 2 ? 0.7f : -0.7f; // strafe while walking into the wall
+        p = collision.moveAndSlide(p, { p.x + side, p.y, p.z - 1.4f }, half);
+        ASSERT_GT(p.z, 40000.0f + 0.05f) << frame;
+    }
+}
+
+TEST(SweepTest, BatchMatchesScalarReference) {
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> pos(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> size(0.05f, 8.0f);
+    std::uniform_int_distribution<int> still(0, 3);
+    const Vector3 half{ 0.3f, 1.0f, 0.3f };
+
+    for (int round = 0; round < 200; ++round) {
+        SweepCandidates candidates;
+        int count = 1 + round % 23; // SIMD body plus every tail length
+        for (int i = 0; i < count; ++i)
+            candidates.add(BoundsFromCenterSize({ pos(rng), pos(rng) * 0.2f, pos(rng) }, { size(rng), size(rng), size(rng) }), half);
+        Vector3 p{ pos(rng), 0, pos(rng) };
+        Vector3 delta{ pos(rng), pos(rng) * 0.1f, pos(rng) };
+        int s = still(rng); // some moves have still axes
+        if (s == 0) delta.x = 0;
+        if (s == 1) delta.y = 0;
+
+        SweepHit reference;
+        for (int i = 0; i < count; ++i) {
+            SweepHit hit = SweepPoint(p, delta, candidates.grown(i), 0.01f);
+            if (hit.hit() && (!reference.hit() || hit.time < reference.time)) {
+                reference = hit;
+                reference.index = static_cast<uint32_t>(i);
+            }
+        }
+        SweepHit batch = candidates.first(p, delta, 0.01f);
+        ASSERT_EQ(batch.hit(), reference.hit()) << round;
+        if (!reference.hit()) continue;
+        EXPECT_EQ(batch.index, reference.index) << round;
+        EXPECT_EQ(batch.time, reference.time) << round; // bit-identical, not just close
+        EXPECT_EQ(batch.axis, reference.axis) << round;
+        EXPECT_EQ(batch.sign, reference.sign) << round;
+    }
+}
+
+TEST(CollisionTest, CornersAndRoomsKeepThePlayerInside) {
+    Registry reg;
+    TransformSystem transformSystem;
+    CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    transformSystem.update(reg);
+    CollisionSystem collision;
+    collision.update(reg);
+    EXPECT_GE(collision.colliderCount(), 6u);
+
+    // walk into a corner from the middle and keep pushing
+    const Vector3 half{ 0.3f, 1.0f, 0.3f };
+    Vector3 p{ 0, 0, 0 };
+    for (int frame = 0; frame < 60; ++frame) p = collision.moveAndSlide(p, { p.x + 1.4f, p.y, p.z + 1.4f }, half);
+    EXPECT_LT(p.x, 10.0f - half.x + 0.01f);
+    EXPECT_LT(p.z, 10.0f - half.z + 0.01f);
+    EXPECT_GT(p.x, 9.0f); // slid all the way into the corner
+    EXPECT_GT(p.z, 9.0f);
+}
+
+TEST(CollisionTest, HashFollowsRegistryChanges) {
+    Registry reg;
+    Entity a = AddCollider(reg, { 0, 0, -5 }, { 20, 10, 0.1f });
+    Entity b = AddCollider(reg, { 0, 0, 5 }, { 20, 10, 0.1f });
+    CollisionSystem collision;
+    collision.update(reg);
+    EXPECT_EQ(collision.colliderCount(), 2u);
+
+    auto hits = [&](const BoundingBox& box) {
+        std::vector<Entity> found;
+        collision.query(box, [&](Entity e, const BoundingBox&) { found.push_back(e); });
+        return found;
+    };
+    EXPECT_EQ(hits(BoundsFromCenterSize({ 0, 0, -5 }, { 1, 1, 1 })), std::vector<Entity>{ a });
+
+    // moved without any count changing: needs markChanged()
+    reg.get<WorldTransform>(a)->position = { 0, 0, -50 };
+    collision.markChanged(a);
+    collision.update(reg);
+    EXPECT_TRUE(hits(BoundsFromCenterSize({ 0, 0, -5 }, { 1, 1, 1 })).empty());
+    EXPECT_EQ(hits(BoundsFromCenterSize({ 0, 0, -50 }, { 1, 1, 1 })), std::vector<Entity>{ a });
+
+    // disabled collision drops out
+    reg.get<Collision>(b)->enabled = false;
+    collision.markChanged(b);
+    collision.update(reg);
+    EXPECT_EQ(collision.colliderCount(), 1u);
+
+    // destroyed / added entities are picked up without being told
+    reg.destroy(a);
+    Entity c = AddCollider(reg, { 30, 0, 0 }, { 0.1f, 10, 20 });
+    Entity d = AddCollider(reg, { 40, 0, 0 }, { 0.1f, 10, 20 });
+    collision.update(reg);
+    EXPECT_EQ(collision.colliderCount(), 2u);
+    EXPECT_TRUE(hits(BoundsFromCenterSize({ 0, 0, -50 }, { 1, 1, 1 })).empty());
+    EXPECT_EQ(hits(BoundsFromCenterSize({ 30, 0, 0 }, { 1, 1, 1 })), std::vector<Entity>{ c });
+    EXPECT_EQ(hits(BoundsFromCenterSize({ 40, 0, 0 }, { 1, 1, 1 })), std::vector<Entity>{ d });
+}
+
+TEST(CollisionTest, WallsMovedInPlaceFollowTheTransformSystem) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    CollisionSystem collision(transforms);
+    collision.update(reg);
+
+    // the room slides 100 along x, no markChanged(), no component added or removed
+    reg.get<TransformComp>(room)->position.x = 100.0f;
+    transforms.update(reg);
+    collision.update(reg);
+    EXPECT_EQ(collision.syncs, 1u);
+
+    const Vector3 half = { 0.4f, 0.8f, 0.4f };
+    EXPECT_FLOAT_EQ(collision.moveAndSlide({ 0, -4, 0 }, { 0, -4, -14 }, half).z, -14.0f); // the old room is gone
+    EXPECT_GT(collision.moveAndSlide({ 100, -4, 0 }, { 100, -4, -14 }, half).z, -9.6f);
+
+    // a wall resized in place, too
+    Entity front = INVALID_ENTITY;
+    for (Entity child : reg.get<Children>(room)->entities)
+        if (auto wall = reg.get<Wall>(child); wall && wall->side == Wall::Side::Front) front = child;
+    ASSERT_NE(front, INVALID_ENTITY);
+    reg.get<TransformComp>(front)->size.x = 4.0f;
+    transforms.update(reg);
+    collision.update(reg);
+    EXPECT_FLOAT_EQ(collision.moveAndSlide({ 105, -4, 0 }, { 105, -4, -14 }, half).z, -14.0f);
+    EXPECT_EQ(collision.syncs, 1u);
+}
+
+TEST(CollisionTest, RoomSwappedInOneFrameIsPickedUp) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    CollisionSystem collision;
+    DynamicBroadphase broadphase(transforms);
+    collision.update(reg);
+    broadphase.update(reg);
+
+    // same number of everything afterwards, so no count changes
+    const size_t colliders = collision.colliderCount();
+    DestroyEntityWithChildren(reg, room);
+    CreateRoom(reg, { 100, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    collision.update(reg);
+    broadphase.update(reg);
+
+    auto count = [](auto& system, Vector3 at) {
+        size_t found = 0;
+        system.query(BoundsFromCenterSize(at, { 30, 30, 30 }), [&](Entity, const BoundingBox&) { found++; });
+        return found;
+    };
+    EXPECT_EQ(collision.colliderCount(), colliders);
+    EXPECT_EQ(count(collision, { 0, 0, 0 }), 0u);
+    EXPECT_EQ(count(collision, { 100, 0, 0 }), colliders);
+    EXPECT_EQ(broadphase.colliderCount(), colliders);
+    EXPECT_EQ(count(broadphase, { 0, 0, 0 }), 0u);
+    EXPECT_EQ(count(broadphase, { 100, 0, 0 }), colliders);
+    EXPECT_TRUE(broadphase.getTree().validate());
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/entity_utils.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/culling.h"
+#include "../include/world/room.h"
+
+static Camera MakeCamera(Vector3 position, Vector3 target) {
+    Camera camera{};
+    camera.position = position;
+    camera.target = target;
+    camera.up = Vector3{0, 1, 0};
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    return camera;
+}
+
+TEST(FrustumTest, BoxInFrontVisible_BehindCulled) {
+    Frustum f = Frustum::FromCamera(MakeCamera({0, 0, 0}, {0, 0, -1}), 16.0f / 9.0f);
+    EXPECT_NE(f.testBox(BoundsFromCenterSize({0, 0, -10}, {1, 1, 1})), FrustumTest::Outside);
+    EXPECT_EQ(f.testBox(BoundsFromCenterSize({0, 0, 10}, {1, 1, 1})), FrustumTest::Outside);
+    EXPECT_EQ(f.testBox(BoundsFromCenterSize({100, 0, -10}, {1, 1, 1})), FrustumTest::Outside);
+}
+
+TEST(FrustumTest, InsideVsIntersect) {
+    Frustum f = Frustum::FromCamera(MakeCamera({0, 0, 0}, {0, 0, -1}), 1.0f);
+    EXPECT_EQ(f.testBox(BoundsFromCenterSize({0, 0, -10}, {1, 1, 1})), FrustumTest::Inside);
+    EXPECT_EQ(f.testBox(BoundsFromCenterSize({0, 0, -10}, {100, 1, 1})), FrustumTest::Intersect);
+}
+
+TEST(BvhTest, FrustumQueryMatchesBruteForce) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> sz(0.1f, 10.0f);
+
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 2000; ++i)
+        boxes.push_back(BoundsFromCenterSize({pos(rng), pos(rng) * 0.1f, pos(rng)}, {sz(rng), sz(rng), sz(rng)}));
+
+    Bvh bvh;
+    bvh.build(boxes);
+    Frustum f = Frustum::FromCamera(MakeCamera({0, 2, 0}, {30, 2, -40}), 16.0f / 9.0f);
+
+    std::vector<uint32_t> fromBvh;
+    bvh.queryFrustum(f, [&](uint32_t i) { fromBvh.push_back(i); });
+    std::vector<uint32_t> brute;
+    for (uint32_t i = 0; i < boxes.size(); ++i)
+        if (f.testBox(boxes[i]) != FrustumTest::Outside) brute.push_back(i);
+
+    std::sort(fromBvh.begin(), fromBvh.end());
+    EXPECT_EQ(fromBvh, brute);
+    EXPECT_GT(brute.size(), 0);
+    EXPECT_LT(brute.size(), boxes.size());
+}
+
+TEST(BvhTest, BoxQuery) {
+    Bvh bvh;
+    bvh.build({ BoundsFromCenterSize({0, 0, 0}, {1, 1, 1}), BoundsFromCenterSize({10, 0, 0}, {1, 1, 1}) });
+    std::vector<uint32_t> hits;
+    bvh.queryBox(BoundsFromCenterSize({10, 0, 0}, {2, 2, 2}), [&](uint32_t i) { hits.push_back(i); });
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0], 1);
+}
+
+TEST(CullingSystemTest, SkipsAnchorsAndRoomsBehindCamera) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity front = CreateRoom(reg, {0, 0, -50}, {10, 5, 10});
+    Entity behind = CreateRoom(reg, {0, 0, 50}, {10, 5, 10});
+    transforms.update(reg);
+
+    Camera camera = MakeCamera({0, 0, 0}, {0, 0, -1});
+    VisibleSet visible;
+    CullingSystem culling(camera, visible);
+    culling.update(reg);
+
+    ASSERT_TRUE(visible.valid);
+    EXPECT_EQ(visible.candidates, 12); // 6 walls per room, no anchors
+    EXPECT_FALSE(visible.entities.empty());
+    for (Entity e : visible.entities) {
+        EXPECT_FALSE(reg.has<Anchor>(e));
+        EXPECT_EQ(reg.get<Parent>(e)->parent, front);
+        EXPECT_NE(reg.get<Parent>(e)->parent, behind);
+    }
+}
+
+TEST(CullingSystemTest, BakedRoomCulledAsOneDrawable) {
+    Registry reg;
+    TransformSystem transforms;
+    MeshBakeSystem baker;
+    Entity room = CreateRoom(reg, {0, 0, -50}, {10, 5, 10});
+    transforms.update(reg);
+    EnableMeshBaking(reg, room);
+    baker.update(reg);
+
+    Camera camera = MakeCamera({0, 0, 0}, {0, 0, -1});
+    VisibleSet visible;
+    CullingSystem culling(camera, visible);
+    culling.update(reg);
+
+    ASSERT_EQ(visible.entities.size(), 1);
+    EXPECT_EQ(visible.entities[0], room);
+}
+
+TEST(CullingSystemTest, RoomSwappedInOneFrameIsPickedUp) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity old = CreateRoom(reg, {0, 0, 50}, {10, 5, 10});
+    transforms.update(reg);
+
+    Camera camera = MakeCamera({0, 0, 0}, {0, 0, -1});
+    VisibleSet visible;
+    CullingSystem culling(camera, visible);
+    culling.update(reg);
+    EXPECT_TRUE(visible.entities.empty());
+
+    // same shape, every count stays the same
+    DestroyEntityWithChildren(reg, old);
+    Entity room = CreateRoom(reg, {0, 0, -50}, {10, 5, 10});
+    transforms.update(reg);
+    culling.update(reg);
+    EXPECT_EQ(culling.rebuilds, 2u);
+    ASSERT_FALSE(visible.entities.empty());
+    for (Entity e : visible.entities) EXPECT_EQ(reg.get<Parent>(e)->parent, room);
+}
+
+TEST(CullingSystemTest, FollowsMovesBakesAndWallChanges) {
+    Registry reg;
+    TransformSystem transforms;
+    MeshBakeSystem baker;
+    Entity room = CreateRoom(reg, {0, 0, -50}, {10, 5, 10});
+    Entity box = reg.create();
+    reg.add<TransformComp>(box, TransformComp{ {0, 0, 50}, {1, 1, 1} });
+    reg.add<ColoredRender>(box, ColoredRender{ RED });
+    reg.add<Collision>(box, Collision{});
+    transforms.update(reg);
+
+    Camera camera = MakeCamera({0, 0, 0}, {0, 0, -1});
+    VisibleSet visible;
+    CullingSystem culling(camera, visible);
+    culling.setTransforms(&transforms);
+    culling.update(reg);
+    EXPECT_EQ(std::count(visible.entities.begin(), visible.entities.end(), box), 0);
+
+    // moved in front of the camera in place: the TransformSystem reports it
+    reg.get<TransformComp>(box)->position.z = -20;
+    transforms.update(reg);
+    culling.update(reg);
+    EXPECT_EQ(std::count(visible.entities.begin(), visible.entities.end(), box), 1);
+    const size_t rebuilds = culling.rebuilds;
+    transforms.update(reg);
+    culling.update(reg);
+    EXPECT_EQ(culling.rebuilds, rebuilds); // nothing moved
+
+    // baked after the rebuild that saw it dirty: once more for the baked bounds
+    EnableMeshBaking(reg, room);
+    culling.update(reg);
+    baker.update(reg);
+    culling.update(reg);
+    EXPECT_EQ(culling.rebuilds, rebuilds + 2);
+    EXPECT_EQ(std::count(visible.entities.begin(), visible.entities.end(), room), 1);
+
+    std::vector<WallChange> changes{ WallChange{ reg.get<Children>(room)->entities[0], room, WallChange::Kind::Resized } };
+    culling.applyWallChanges(changes);
+    culling.update(reg);
+    EXPECT_EQ(culling.rebuilds, rebuilds + 3);
+}
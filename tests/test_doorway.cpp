@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/collision.h"
+#include "../include/spatial/dynamic_broadphase.h"
+#include "../include/world/anchor.h"
+#include "../include/world/doorway.h"
+#include "../include/world/hallway.h"
+#include "../include/world/room.h"
+
+static std::vector<Entity> SideWalls(Registry& reg, Entity room, Wall::Side side) {
+    std::vector<Entity> walls;
+    for (Entity child : reg.get<Children>(room)->entities)
+        if (auto wall = reg.get<Wall>(child); wall && wall->side == side) walls.push_back(child);
+    return walls;
+}
+
+TEST(DoorwayTest, CarveKeepsTheWallEntity) {
+    Registry reg;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 30 });
+    std::vector<Entity> before = SideWalls(reg, room, Wall::Side::Right);
+    ASSERT_EQ(before.size(), 1u);
+    Entity wall = before[0];
+    Color color = reg.get<ColoredRender>(wall)->color;
+    size_t entities = reg.entityCount();
+
+    std::vector<WallChange> changes;
+    ASSERT_TRUE(CarveDoorwayInWall(reg, room, Wall::Side::Right, &changes));
+
+    // the old handle is still good, it's the piece in front of the door now
+    ASSERT_NE(reg.get<TransformComp>(wall), nullptr);
+    EXPECT_FLOAT_EQ(reg.get<TransformComp>(wall)->size.z, 15.0f - 1.0f);
+    EXPECT_FLOAT_EQ(reg.get<TransformComp>(wall)->position.z, -8.0f);
+    EXPECT_EQ(reg.entityCount(), entities + 2);
+
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[0].wall, wall);
+    EXPECT_EQ(changes[0].kind, WallChange::Kind::Resized);
+    for (size_t i = 1; i < changes.size(); ++i) {
+        EXPECT_EQ(changes[i].kind, WallChange::Kind::Created);
+        EXPECT_EQ(changes[i].owner, room);
+        // same look and collision as the wall they came from
+        EXPECT_EQ(reg.get<ColoredRender>(changes[i].wall)->color.r, color.r);
+        EXPECT_TRUE(reg.has<Collision>(changes[i].wall));
+        EXPECT_EQ(reg.get<Parent>(changes[i].wall)->parent, room);
+    }
+    EXPECT_EQ(SideWalls(reg, room, Wall::Side::Right).size(), 3u);
+}
+
+TEST(DoorwayTest, SeveralDoorwaysPerWall) {
+    Registry reg;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 40, 10, 20 });
+    EXPECT_TRUE(CarveDoorway(reg, room, Wall::Side::Front, -10.0f));
+    EXPECT_TRUE(CarveDoorway(reg, room, Wall::Side::Front, 10.0f));
+    EXPECT_TRUE(CarveDoorwayInWall(reg, room, Wall::Side::Front)); // the middle is still solid
+
+    EXPECT_FALSE(CarveDoorway(reg, room, Wall::Side::Front, 10.5f)); // overlaps a doorway (would land in its lintel)
+    EXPECT_FALSE(CarveDoorway(reg, room, Wall::Side::Front, 19.5f)); // past the end of the wall
+    EXPECT_FALSE(CarveDoorwayInWall(reg, room, Wall::Side::Floor));
+
+    // 4 full-height pieces and 3 lintels, no overlaps, covering everything but the three doors
+    float covered = 0.0f;
+    int lintels = 0;
+    std::vector<Entity> walls = SideWalls(reg, room, Wall::Side::Front);
+    EXPECT_EQ(walls.size(), 7u);
+    for (Entity e : walls) {
+        auto t = reg.get<TransformComp>(e);
+        EXPECT_FLOAT_EQ(t->position.z, -10.0f);
+        if (t->size.y == 10.0f) covered += t->size.x;
+        else lintels++;
+    }
+    EXPECT_FLOAT_EQ(covered, 40.0f - 3 * 2.0f);
+    EXPECT_EQ(lintels, 3);
+}
+
+TEST(DoorwayTest, ConnectCarvesAtTheAnchor) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    Entity hall = CreateHallway(reg, { 0, 0, 30 }, { 4, 10, 20 }, AnchorDir::Back);
+    transforms.update(reg);
+
+    // move the room's back anchor off centre: the doorway follows it
+    Entity back = FindAnchor(reg, room, AnchorDir::Back);
+    reg.get<Anchor>(back)->localPos.x = 5.0f;
+    reg.get<TransformComp>(back)->position.x = 5.0f;
+    transforms.update(reg);
+
+    std::vector<WallChange> changes;
+    ConnectAnchors(reg, back, FindAnchor(reg, hall, AnchorDir::Front), nullptr, &changes);
+    // the hallway has no end walls, only the room was carved... the snap moved all four hallway walls
+    EXPECT_EQ(std::count_if(changes.begin(), changes.end(), [](const WallChange& c) { return c.kind == WallChange::Kind::Moved; }), 4);
+    EXPECT_EQ(changes.size(), 7u);
+
+    float lo = INFINITY, hi = -INFINITY;
+    for (Entity e : SideWalls(reg, room, Wall::Side::Back)) {
+        auto t = reg.get<TransformComp>(e);
+        if (t->size.y < 10.0f) {
+            lo = t->position.x - t->size.x / 2;
+            hi = t->position.x + t->size.x / 2;
+        }
+    }
+    EXPECT_FLOAT_EQ(lo, 4.0f);
+    EXPECT_FLOAT_EQ(hi, 6.0f);
+}
+
+TEST(DoorwayTest, BroadphasesFollowCarvesWithoutResync) {
+    Registry reg;
+    TransformSystem transforms;
+    CollisionSystem collision;
+    DynamicBroadphase broadphase(transforms);
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    collision.update(reg);
+    broadphase.update(reg);
+    ASSERT_EQ(collision.syncs, 1u);
+
+    std::vector<WallChange> changes;
+    ASSERT_TRUE(CarveDoorwayInWall(reg, room, Wall::Side::Front, &changes));
+    collision.applyWallChanges(reg, changes);
+    broadphase.applyWallChanges(reg, changes);
+    transforms.update(reg);
+    collision.update(reg);
+    broadphase.update(reg);
+
+    EXPECT_EQ(collision.syncs, 1u);
+    EXPECT_EQ(broadphase.moved, 1u); // the resized wall (new pieces are plain inserts)... a re-sync reports nothing moved
+    EXPECT_EQ(broadphase.colliderCount(), reg.count<Collision>());
+
+    // walks out through the doorway, but not through the wall next to it
+    const Vector3 half = { 0.4f, 0.8f, 0.4f };
+    Vector3 through = collision.moveAndSlide({ 0, -4, -8 }, { 0, -4, -14 }, half);
+    EXPECT_FLOAT_EQ(through.z, -14.0f);
+    Vector3 blocked = collision.moveAndSlide({ 5, -4, -8 }, { 5, -4, -14 }, half);
+    EXPECT_GT(blocked.z, -9.6f); // wall face at -9.95, minus the half extent
+
+    // same answers as a system that synced from scratch
+    CollisionSystem fresh;
+    fresh.update(reg);
+    EXPECT_FLOAT_EQ(fresh.moveAndSlide({ 0, -4, -8 }, { 0, -4, -14 }, half).z, through.z);
+    EXPECT_FLOAT_EQ(fresh.moveAndSlide({ 5, -4, -8 }, { 5, -4, -14 }, half).z, blocked.z);
+
+    int hits = 0;
+    broadphase.query(BoundsFromCenterSize({ 0, -4, -10 }, { 0.5f, 0.5f, 0.5f }), [&](Entity, const BoundingBox&) { hits++; });
+    EXPECT_EQ(hits, 0);
+}
+
+TEST(DoorwayTest, CarvedPiecesArePlacedBeforeTheTransformPass) {
+    Registry reg;
+    TransformSystem transforms;
+    CollisionSystem collision;
+    Entity room = CreateRoom(reg, { 30, 0, 40 }, { 20, 10, 20 });
+    transforms.update(reg);
+    collision.update(reg);
+
+    // main's order: the collision update runs before this frame's TransformSystem pass
+    std::vector<WallChange> changes;
+    ASSERT_TRUE(CarveDoorwayInWall(reg, room, Wall::Side::Front, &changes));
+    collision.applyWallChanges(reg, changes);
+    collision.update(reg);
+    EXPECT_EQ(collision.syncs, 1u);
+    const Vector3 half = { 0.4f, 0.8f, 0.4f };
+    EXPECT_FLOAT_EQ(collision.moveAndSlide({ 30, -4, 32 }, { 30, -4, 26 }, half).z, 26.0f);
+    EXPECT_GT(collision.moveAndSlide({ 35, -4, 32 }, { 35, -4, 26 }, half).z, 30.4f);
+
+    // and exactly where the pass puts them
+    std::vector<WorldTransform> before;
+    for (const WallChange& change : changes) before.push_back(*reg.get<WorldTransform>(change.wall));
+    transforms.update(reg);
+    for (size_t i = 0; i < changes.size(); ++i) {
+        const WorldTransform* after = reg.get<WorldTransform>(changes[i].wall);
+        EXPECT_EQ(after->position.x, before[i].position.x);
+        EXPECT_EQ(after->position.y, before[i].position.y);
+        EXPECT_EQ(after->position.z, before[i].position.z);
+        EXPECT_EQ(after->size.x, before[i].size.x);
+        EXPECT_EQ(after->size.y, before[i].size.y);
+    }
+    EXPECT_TRUE(transforms.getChangedColliders().empty());
+}
+
+TEST(DoorwayTest, SnappedHallwayWallsReachTheColliderCaches) {
+    Registry reg;
+    TransformSystem transforms;
+    CollisionSystem collision;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    Entity hall = CreateHallway(reg, { 0, 0, 50 }, { 4, 10, 20 }, AnchorDir::Back);
+    transforms.update(reg);
+    collision.update(reg);
+
+    // the snap moves the hallway from z 40..60 to 10..30
+    std::vector<WallChange> changes;
+    ConnectAnchors(reg, FindAnchor(reg, room, AnchorDir::Back), FindAnchor(reg, hall, AnchorDir::Front), nullptr, &changes);
+    collision.applyWallChanges(reg, changes);
+    collision.update(reg);
+    EXPECT_EQ(collision.syncs, 1u);
+
+    // walks into the hallway through the doorway, then into its side wall (at x 2, minus the half extent)
+    const Vector3 half = { 0.4f, 0.8f, 0.4f };
+    EXPECT_FLOAT_EQ(collision.moveAndSlide({ 0, -4, 8 }, { 0, -4, 20 }, half).z, 20.0f);
+    Vector3 side = collision.moveAndSlide({ 0, -4, 20 }, { 5, -4, 20 }, half);
+    EXPECT_LT(side.x, 1.6f);
+
+    CollisionSystem fresh;
+    fresh.update(reg);
+    EXPECT_FLOAT_EQ(fresh.moveAndSlide({ 0, -4, 20 }, { 5, -4, 20 }, half).x, side.x);
+
+    // already where the next TransformSystem pass puts them
+    transforms.update(reg);
+    EXPECT_TRUE(transforms.getChangedColliders().empty());
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/core/thread_pool.h"
+#include "../include/world/anchor.h"
+#include "../include/world/dungeon.h"
+#include "../include/world/room.h"
+
+static bool SameLayout(const DungeonLayout& a, const DungeonLayout& b) {
+    if (a.rooms.size() != b.rooms.size() || a.halls.size() != b.halls.size()) return false;
+    for (size_t i = 0; i < a.rooms.size(); ++i)
+        if (std::memcmp(&a.rooms[i], &b.rooms[i], sizeof(DungeonRoom)) != 0) return false;
+    for (size_t i = 0; i < a.halls.size(); ++i) {
+        const DungeonHall& x = a.halls[i];
+        const DungeonHall& y = b.halls[i];
+        if (std::memcmp(&x.position, &y.position, sizeof(Vector3)) != 0 || std::memcmp(&x.size, &y.size, sizeof(Vector3)) != 0 ||
+            x.from != y.from || x.to != y.to || x.side != y.side)
+            return false;
+    }
+    return true;
+}
+
+// interiors overlap (touching faces don't count)
+static bool Penetrates(const BoundingBox& a, const BoundingBox& b) {
+    return a.min.x < b.max.x && a.max.x > b.min.x && a.min.z < b.max.z && a.max.z > b.min.z;
+}
+
+TEST(DungeonTest, SameSeedSameLayoutOnAnyThreadCount) {
+    DungeonSettings settings;
+    settings.rooms = 2000;
+    settings.regionRooms = 150;
+    DungeonLayout serial = GenerateDungeonLayout(settings);
+    ThreadPool pool(4);
+    DungeonLayout parallel = GenerateDungeonLayout(settings, &pool);
+    EXPECT_TRUE(SameLayout(serial, parallel));
+    EXPECT_EQ(serial.regions, 14u);
+
+    settings.seed = 2;
+    EXPECT_FALSE(SameLayout(serial, GenerateDungeonLayout(settings, &pool)));
+}
+
+TEST(DungeonTest, RoomsDontOverlapAndAreAllConnected) {
+    DungeonSettings settings;
+    settings.rooms = 1500;
+    settings.regionRooms = 100;
+    settings.seed = 7;
+    DungeonLayout layout = GenerateDungeonLayout(settings);
+    ASSERT_EQ(layout.rooms.size(), 1500u); // every region had room for its share
+    ASSERT_EQ(layout.halls.size(), layout.rooms.size() - 1); // a tree: grown halls plus one link per extra region
+
+    std::vector<BoundingBox> rooms, halls;
+    for (const DungeonRoom& r : layout.rooms) rooms.push_back(BoundsFromCenterSize(r.position, r.size));
+    for (const DungeonHall& h : layout.halls) halls.push_back(BoundsFromCenterSize(h.position, h.size));
+
+    for (size_t i = 0; i < rooms.size(); ++i)
+        for (size_t j = i + 1; j < rooms.size(); ++j) ASSERT_FALSE(Penetrates(rooms[i], rooms[j])) << i << " " << j;
+    for (size_t h = 0; h < halls.size(); ++h) {
+        for (size_t r = 0; r < rooms.size(); ++r) {
+            bool end = r == layout.halls[h].from || r == layout.halls[h].to; // touches those, give rounding some room
+            ASSERT_FALSE(Penetrates(end ? dungeon::Inflate(halls[h], -0.01f) : halls[h], rooms[r])) << h << " " << r;
+        }
+        for (size_t k = h + 1; k < halls.size(); ++k) ASSERT_FALSE(Penetrates(halls[h], halls[k])) << h << " " << k;
+    }
+
+    // each hallway spans exactly the gap between its rooms' facing walls
+    for (const DungeonHall& h : layout.halls) {
+        Vector3 dir = AnchorDirVector(h.side);
+        Vector3 start = Vector3Add(layout.rooms[h.from].position, Vector3Scale(dir, dungeon::HalfAlong(layout.rooms[h.from].size, dir)));
+        Vector3 end = Vector3Subtract(layout.rooms[h.to].position, Vector3Scale(dir, dungeon::HalfAlong(layout.rooms[h.to].size, dir)));
+        EXPECT_NEAR(Vector3Distance(start, end), dungeon::HalfAlong(h.size, dir) * 2.0f, 1e-2f);
+        EXPECT_NEAR(Vector3Distance(Vector3Scale(Vector3Add(start, end), 0.5f), h.position), 0.0f, 1e-2f);
+    }
+
+    std::vector<std::vector<uint32_t>> adjacent(layout.rooms.size());
+    for (const DungeonHall& h : layout.halls) {
+        adjacent[h.from].push_back(h.to);
+        adjacent[h.to].push_back(h.from);
+    }
+    std::vector<bool> reached(layout.rooms.size(), false);
+    std::queue<uint32_t> open;
+    open.push(0);
+    reached[0] = true;
+    size_t count = 1;
+    while (!open.empty()) {
+        uint32_t r = open.front();
+        open.pop();
+        for (uint32_t n : adjacent[r])
+            if (!reached[n]) {
+                reached[n] = true;
+                count++;
+                open.push(n);
+            }
+    }
+    EXPECT_EQ(count, layout.rooms.size());
+}
+
+TEST(DungeonTest, BuildConnectsAnchorsAndCarvesDoorways) {
+    DungeonSettings settings;
+    settings.rooms = 40;
+    settings.regionRooms = 10;
+    DungeonLayout layout = GenerateDungeonLayout(settings);
+
+    Registry reg;
+    TransformSystem transforms;
+    DungeonEntities built = BuildDungeon(reg, transforms, layout);
+    ASSERT_EQ(built.rooms.size(), layout.rooms.size());
+    ASSERT_EQ(built.halls.size(), layout.halls.size());
+
+    for (size_t h = 0; h < layout.halls.size(); ++h) {
+        const DungeonHall& hall = layout.halls[h];
+        // snapped in place: the hallway didn't move
+        auto wt = reg.get<WorldTransform>(built.halls[h]);
+        ASSERT_NE(wt, nullptr);
+        EXPECT_NEAR(Vector3Distance(wt->position, hall.position), 0.0f, 1e-2f);
+
+        Entity fromAnchor = FindAnchor(reg, built.rooms[hall.from], hall.side);
+        Entity toAnchor = FindAnchor(reg, built.rooms[hall.to], OppositeDir(hall.side));
+        ASSERT_NE(fromAnchor, INVALID_ENTITY);
+        ASSERT_NE(toAnchor, INVALID_ENTITY);
+        EXPECT_EQ(reg.get<Parent>(reg.get<Anchor>(fromAnchor)->connectedTo)->parent, built.halls[h]);
+        EXPECT_EQ(reg.get<Parent>(reg.get<Anchor>(toAnchor)->connectedTo)->parent, built.halls[h]);
+
+        // the wall on that side was split around the anchor: no segment is left where the hallway comes in
+        Vector3 doorway = reg.get<Anchor>(fromAnchor)->localPos;
+        int segments = 0;
+        for (Entity child : reg.get<Children>(built.rooms[hall.from])->entities) {
+            auto wall = reg.get<Wall>(child);
+            if (!wall || wall->side != AnchorToWallSide(hall.side)) continue;
+            auto t = reg.get<TransformComp>(child);
+            EXPECT_FALSE(BoundsContainsPoint(BoundsFromCenterSize(t->position, t->size), doorway));
+            segments++;
+        }
+        EXPECT_GE(segments, 3);
+    }
+}
+
+TEST(DungeonTest, HallsAreWalledAcrossTheirTravelAxis) {
+    DungeonSettings settings;
+    settings.rooms = 200;
+    DungeonLayout layout = GenerateDungeonLayout(settings);
+    Registry reg;
+    TransformSystem transforms;
+    DungeonEntities built = BuildDungeon(reg, transforms, layout);
+
+    // halls shorter than hallWidth are wider than they are long: the walls still go along the travel axis
+    int stubby = 0;
+    for (size_t h = 0; h < layout.halls.size(); ++h) {
+        const DungeonHall& hall = layout.halls[h];
+        const bool alongX = HallRunsAlongX(hall.side);
+        stubby += alongX ? hall.size.x < hall.size.z : hall.size.z < hall.size.x;
+        int sides[6] = {};
+        for (Entity child : reg.get<Children>(built.halls[h])->entities)
+            if (auto wall = reg.get<Wall>(child)) sides[static_cast<int>(wall->side)]++;
+        EXPECT_EQ(sides[static_cast<int>(Wall::Side::Front)], alongX ? 1 : 0) << "hall " << h;
+        EXPECT_EQ(sides[static_cast<int>(Wall::Side::Back)], alongX ? 1 : 0) << "hall " << h;
+        EXPECT_EQ(sides[static_cast<int>(Wall::Side::Left)], alongX ? 0 : 1) << "hall " << h;
+        EXPECT_EQ(sides[static_cast<int>(Wall::Side::Right)], alongX ? 0 : 1) << "hall " << h;
+    }
+    EXPECT_GT(stubby, 0);
+}
+
+TEST(DungeonTest, FloorAndCeilingHaveTheirOwnSides) {
+    Registry reg;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+
+    int floors = 0, ceilings = 0, fronts = 0;
+    for (Entity child : reg.get<Children>(room)->entities) {
+        auto wall = reg.get<Wall>(child);
+        if (!wall) continue;
+        floors += wall->side == Wall::Side::Floor;
+        ceilings += wall->side == Wall::Side::Ceiling;
+        fronts += wall->side == Wall::Side::Front;
+    }
+    EXPECT_EQ(floors, 1);
+    EXPECT_EQ(ceilings, 1);
+    EXPECT_EQ(fronts, 1);
+
+    // carving the front wall leaves the floor alone
+    CarveDoorwayInWall(reg, room, Wall::Side::Front);
+    floors = 0;
+    for (Entity child : reg.get<Children>(room)->entities)
+        if (auto wall = reg.get<Wall>(child)) floors += wall->side == Wall::Side::Floor;
+    EXPECT_EQ(floors, 1);
+
+    // hallways walked along x are open at their x ends
+    Entity hall = CreateHallway(reg, { 0, 0, 50 }, { 60, 10, 8 }, AnchorDir::Right);
+    std::vector<Wall::Side> sides;
+    for (Entity child : reg.get<Children>(hall)->entities)
+        if (auto wall = reg.get<Wall>(child)) sides.push_back(wall->side);
+    std::sort(sides.begin(), sides.end());
+    EXPECT_EQ(sides, (std::vector<Wall::Side>{ Wall::Side::Front, Wall::Side::Back, Wall::Side::Floor, Wall::Side::Ceiling }));
+}
+
+TEST(DungeonTest, SideWallDoorwaysSplitAlongZ) {
+    Registry reg;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 30 });
+    CarveDoorwayInWall(reg, room, Wall::Side::Right);
+
+    // left + right + top segments, all 0.1 thick in x and inside the original wall
+    int segments = 0;
+    float covered = 0.0f;
+    for (Entity child : reg.get<Children>(room)->entities) {
+        auto wall = reg.get<Wall>(child);
+        if (!wall || wall->side != Wall::Side::Right) continue;
+        auto t = reg.get<TransformComp>(child);
+        segments++;
+        EXPECT_FLOAT_EQ(t->size.x, 0.1f);
+        EXPECT_FLOAT_EQ(t->position.x, 10.0f);
+        EXPECT_LE(fabsf(t->position.z) + t->size.z / 2, 15.0f + 1e-4f);
+        EXPECT_LE(fabsf(t->position.y) + t->size.y / 2, 5.0f + 1e-4f);
+        if (t->size.y == 10.0f) covered += t->size.z;
+    }
+    EXPECT_EQ(segments, 3);
+    EXPECT_FLOAT_EQ(covered, 30.0f - 2.0f); // full height on both sides of a 2-wide door
+}
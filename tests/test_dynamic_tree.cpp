@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/dynamic_broadphase.h"
+#include "../include/spatial/dynamic_tree.h"
+#include "../include/world/room.h"
+
+static std::vector<int32_t> QueryIds(const DynamicAabbTree& tree, const BoundingBox& box) {
+    std::vector<int32_t> ids;
+    tree.query(box, [&](int32_t id) { ids.push_back(id); });
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+TEST(DynamicTreeTest, QueriesMatchBruteForceThroughInsertsMovesAndRemoves) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 8.0f);
+    std::uniform_real_distribution<float> step(-3.0f, 3.0f);
+    auto randomBox = [&] { return BoundsFromCenterSize({ pos(rng), pos(rng), pos(rng) }, { size(rng), size(rng), size(rng) }); };
+
+    DynamicAabbTree tree(0.2f);
+    std::vector<int32_t> ids;
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 1000; ++i) {
+        boxes.push_back(randomBox());
+        ids.push_back(tree.insert(boxes.back(), static_cast<uint32_t>(i)));
+    }
+    ASSERT_TRUE(tree.validate());
+
+    for (int round = 0; round < 20; ++round) {
+        // move a third, remove and re-add a few
+        for (size_t i = 0; i < ids.size(); i += 3) {
+            Vector3 d{ step(rng), step(rng), step(rng) };
+            boxes[i] = BoundingBox{ Vector3Add(boxes[i].min, d), Vector3Add(boxes[i].max, d) };
+            tree.move(ids[i], boxes[i], d);
+        }
+        for (int k = 0; k < 20; ++k) {
+            size_t i = rng() % ids.size();
+            tree.remove(ids[i]);
+            EXPECT_FALSE(tree.contains(ids[i]));
+            boxes[i] = randomBox();
+            ids[i] = tree.insert(boxes[i], static_cast<uint32_t>(i));
+        }
+        ASSERT_TRUE(tree.validate()) << round;
+        ASSERT_EQ(tree.size(), ids.size());
+
+        for (int q = 0; q < 20; ++q) {
+            BoundingBox box = BoundsFromCenterSize({ pos(rng), pos(rng), pos(rng) }, { 20, 20, 20 });
+            std::vector<int32_t> expected;
+            for (size_t i = 0; i < ids.size(); ++i)
+                if (BoundsOverlap(boxes[i], box)) expected.push_back(ids[i]);
+            std::sort(expected.begin(), expected.end());
+
+            // the tree answers with fat boxes: a superset of the exact hits, and never a box farther than the fat margin
+            std::vector<int32_t> got = QueryIds(tree, box);
+            EXPECT_TRUE(std::includes(got.begin(), got.end(), expected.begin(), expected.end())) << round;
+            for (int32_t id : got) EXPECT_TRUE(BoundsOverlap(tree.fatBounds(id), box));
+        }
+    }
+
+    // user data survives all of it
+    for (size_t i = 0; i < ids.size(); ++i) EXPECT_EQ(tree.userData(ids[i]), i);
+}
+
+TEST(DynamicTreeTest, StaysBalancedForSortedInserts) {
+    // boxes inserted along a line are the worst case for an unbalanced tree (it degenerates into a list)
+    DynamicAabbTree tree;
+    for (int i = 0; i < 4096; ++i) tree.insert(BoundsFromCenterSize({ i * 2.0f, 0, 0 }, { 1, 1, 1 }));
+    EXPECT_TRUE(tree.validate());
+    EXPECT_LE(tree.height(), 2 * 12 + 2); // log2(4096) = 12
+    EXPECT_LE(tree.maxBalance(), 2) << tree.height();
+    EXPECT_EQ(tree.nodeCount(), 2 * 4096u - 1);
+}
+
+TEST(DynamicTreeTest, SmallMovesStayInTheFatBox) {
+    DynamicAabbTree tree(0.5f);
+    BoundingBox box = BoundsFromCenterSize({ 0, 0, 0 }, { 1, 1, 1 });
+    int32_t id = tree.insert(box);
+    tree.insert(BoundsFromCenterSize({ 10, 0, 0 }, { 1, 1, 1 }));
+
+    BoundingBox nudged = BoundsFromCenterSize({ 0.3f, 0, 0 }, { 1, 1, 1 });
+    EXPECT_FALSE(tree.move(id, nudged, { 0.3f, 0, 0 }));
+    EXPECT_TRUE(tree.move(id, BoundsFromCenterSize({ 2, 0, 0 }, { 1, 1, 1 }), { 1.7f, 0, 0 }));
+    // fattened ahead of the move
+    EXPECT_GT(tree.fatBounds(id).max.x, 2.5f + 0.5f);
+    EXPECT_FLOAT_EQ(tree.fatBounds(id).min.x, 1.5f - 0.5f);
+    EXPECT_TRUE(tree.validate());
+
+    // nodes are pooled: removing and re-inserting reuses them
+    size_t pool = tree.poolSize();
+    for (int i = 0; i < 100; ++i) {
+        tree.remove(id);
+        id = tree.insert(box);
+    }
+    EXPECT_EQ(tree.poolSize(), pool);
+}
+
+TEST(DynamicBroadphaseTest, FollowsTransformSystemChanges) {
+    Registry reg;
+    TransformSystem transformSystem;
+    for (int i = 0; i < 20; ++i) CreateRoom(reg, { i * 30.0f, 0, 0 }, { 20, 10, 20 });
+
+    Entity platform = reg.create();
+    reg.add<TransformComp>(platform, TransformComp{ { 0, -20, 0 }, { 4, 0.5f, 4 } });
+    reg.add<Collision>(platform, Collision{});
+    transformSystem.update(reg);
+
+    DynamicBroadphase broadphase(transformSystem);
+    broadphase.update(reg);
+    EXPECT_EQ(broadphase.colliderCount(), 20u * 6u + 1u);
+    EXPECT_TRUE(broadphase.getTree().validate());
+
+    // nothing moved: nothing reported, nothing touched
+    transformSystem.update(reg);
+    EXPECT_TRUE(transformSystem.getChangedColliders().empty());
+    broadphase.update(reg);
+    EXPECT_EQ(broadphase.moved, 0u);
+
+    // only the platform is reported and updated
+    auto findPlatform = [&](Vector3 at) {
+        bool found = false;
+        broadphase.query(BoundsFromCenterSize(at, { 0.1f, 0.1f, 0.1f }), [&](Entity e, const BoundingBox&) { found |= e == platform; });
+        return found;
+    };
+    for (int frame = 1; frame <= 100; ++frame) {
+        reg.get<TransformComp>(platform)->position.x = frame * 2.0f;
+        transformSystem.update(reg);
+        ASSERT_EQ(transformSystem.getChangedColliders().size(), 1u);
+        broadphase.update(reg);
+        EXPECT_EQ(broadphase.moved, 1u);
+        EXPECT_TRUE(findPlatform({ frame * 2.0f, -20, 0 })) << frame;
+        EXPECT_FALSE(findPlatform({ frame * 2.0f - 2.5f, -20, 0 })) << frame; // the real box moved on, not just the fat one
+    }
+    EXPECT_TRUE(broadphase.getTree().validate());
+
+    // collision toggles go through markChanged()
+    reg.get<Collision>(platform)->enabled = false;
+    broadphase.markChanged(platform);
+    broadphase.update(reg);
+    EXPECT_FALSE(findPlatform({ 200, -20, 0 }));
+    EXPECT_EQ(broadphase.colliderCount(), 20u * 6u);
+
+    // destroyed entities drop out with the re-sync
+    reg.get<Collision>(platform)->enabled = true;
+    broadphase.markChanged(platform);
+    broadphase.update(reg);
+    reg.destroy(platform);
+    transformSystem.update(reg);
+    broadphase.update(reg);
+    EXPECT_EQ(broadphase.colliderCount(), 20u * 6u);
+    EXPECT_TRUE(broadphase.getTree().validate());
+}
@@ -265,6 +265,49 @@ TEST(RegistryTest, ReuseEntityId_IncrementsVersion) {
     EXPECT_NE(e1, e2);
 }
 
+TEST(RegistryTest, CreateBatch_ReusesFreedIdsFirst) {
+    Registry reg;
+    Entity freed = reg.create();
+    reg.destroy(freed);
+
+    Entity batch[4];
+    reg.create(std::span<Entity>(batch));
+    EXPECT_EQ(reg.entityCount(), 4);
+    EXPECT_EQ(batch[0].id, freed.id);
+    EXPECT_NE(batch[0], freed);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(isValidEntity(batch[i]));
+        for (int j = i + 1; j < 4; ++j) EXPECT_NE(batch[i], batch[j]);
+    }
+    reg.add(batch[3], Position{1, 2});
+    EXPECT_TRUE(reg.has<Position>(batch[3]));
+}
+
+TEST(RegistryTest, AddBatch_AppendsOrOverwrites) {
+    Registry reg;
+    Entity batch[3];
+    reg.create(std::span<Entity>(batch));
+    const Position values[3] = { {1, 1}, {2, 2}, {3, 3} };
+    reg.add<Position>(std::span<const Entity>(batch), std::span<const Position>(values));
+    EXPECT_EQ(reg.count<Position>(), 3);
+    EXPECT_EQ(reg.get<Position>(batch[2])->x, 3);
+
+    // one of them already has one: overwritten in place, the rest appended
+    Entity more[2] = { batch[1], reg.create() };
+    const Position others[2] = { {7, 7}, {8, 8} };
+    reg.add<Position>(std::span<const Entity>(more), std::span<const Position>(others));
+    EXPECT_EQ(reg.count<Position>(), 4);
+    EXPECT_EQ(reg.get<Position>(batch[1])->x, 7);
+    EXPECT_EQ(reg.get<Position>(more[1])->y, 8);
+    EXPECT_EQ(reg.get<Position>(batch[0])->x, 1);
+
+    // dead entities are skipped
+    reg.destroy(batch[0]);
+    Entity stale[1] = { batch[0] };
+    reg.add<Position>(std::span<const Entity>(stale), std::span<const Position>(values, 1));
+    EXPECT_FALSE(reg.has<Position>(batch[0]));
+}
+
 TEST(RegistryTest, SingleComponentView) {
     Registry reg;
     Entity e1 = reg.create();
@@ -343,6 +386,30 @@ TEST(RegistryTest, EraseMaintainsViewCorrectness) {
     EXPECT_EQ(std::find(alive.begin(), alive.end(), e2), alive.end());
 }
 
+TEST(RegistryTest, RevisionMovesOnEveryAddAndRemove) {
+    Registry reg;
+    EXPECT_EQ(reg.revision<Position>(), 0u);
+    Entity a = reg.create();
+    reg.add(a, Position{1, 1});
+    const uint64_t before = reg.revision<Position>();
+
+    // overwriting isn't a membership change
+    reg.add(a, Position{2, 2});
+    EXPECT_EQ(reg.revision<Position>(), before);
+
+    // one out, one in: same count, different revision
+    reg.destroy(a);
+    reg.add(reg.create(), Position{3, 3});
+    EXPECT_EQ(reg.count<Position>(), 1);
+    EXPECT_EQ(reg.revision<Position>(), before + 2);
+
+    Entity batch[2];
+    reg.create(std::span<Entity>(batch));
+    const Position values[2] = { {4, 4}, {5, 5} };
+    reg.add<Position>(std::span<const Entity>(batch), std::span<const Position>(values));
+    EXPECT_EQ(reg.revision<Position>(), before + 4);
+}
+
 TEST(RegistryTest, StressCreateDestroyReuse) {
     Registry reg;
     constexpr int N = 200;
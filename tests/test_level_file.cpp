@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../include/core/mapped_file.h"
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/textures/asset_cache.h"
+#include "../include/world/anchor.h"
+#include "../include/world/dungeon.h"
+#include "../include/world/level_file.h"
+
+static_assert(std::is_trivially_copyable_v<TransformComp> && std::is_trivially_copyable_v<Anchor> && std::is_trivially_copyable_v<AnchorSlots>);
+
+static DungeonLayout SmallLayout() {
+    DungeonSettings settings;
+    settings.rooms = 40;
+    settings.regionRooms = 10;
+    settings.seed = 50;
+    return GenerateDungeonLayout(settings);
+}
+
+// the writer's numbering: every saved entity, by id
+static std::vector<Entity> SavedEntities(const Registry& reg) {
+    std::vector<Entity> all;
+    ForEachLevelComponent([&]<typename T>(uint32_t) {
+        for (const auto& [e, value] : reg.view<T>()) all.push_back(e);
+    });
+    std::sort(all.begin(), all.end(), [](Entity a, Entity b) { return a.id < b.id; });
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+    return all;
+}
+
+// component by component, references compared through the original -> loaded mapping
+static void ExpectSameWorld(const Registry& a, const AssetCache& assetsA, const Registry& b, const AssetCache& assetsB,
+                            const std::vector<Entity>& loaded) {
+    std::vector<Entity> original = SavedEntities(a);
+    ASSERT_EQ(original.size(), loaded.size());
+    std::unordered_map<Entity, Entity> map = { { INVALID_ENTITY, INVALID_ENTITY } };
+    for (size_t i = 0; i < original.size(); ++i) map[original[i]] = loaded[i];
+    auto same = [](Vector3 p, Vector3 q) { return p.x == q.x && p.y == q.y && p.z == q.z; };
+
+    for (size_t i = 0; i < original.size(); ++i) {
+        Entity x = original[i], y = loaded[i];
+        if (auto t = a.get<TransformComp>(x)) {
+            ASSERT_NE(b.get<TransformComp>(y), nullptr);
+            EXPECT_TRUE(same(t->position, b.get<TransformComp>(y)->position) && same(t->size, b.get<TransformComp>(y)->size));
+        }
+        if (auto w = a.get<WorldTransform>(x)) {
+            ASSERT_NE(b.get<WorldTransform>(y), nullptr);
+            EXPECT_TRUE(same(w->position, b.get<WorldTransform>(y)->position));
+        }
+        EXPECT_EQ(a.has<Parent>(x), b.has<Parent>(y));
+        if (auto p = a.get<Parent>(x)) {
+            EXPECT_EQ(map.at(p->parent), b.get<Parent>(y)->parent);
+        }
+        if (auto c = a.get<Children>(x)) {
+            const auto& theirs = b.get<Children>(y)->entities;
+            ASSERT_EQ(c->entities.size(), theirs.size());
+            for (size_t k = 0; k < theirs.size(); ++k) EXPECT_EQ(map.at(c->entities[k]), theirs[k]);
+        }
+        if (auto anchor = a.get<Anchor>(x)) {
+            EXPECT_EQ(b.get<Anchor>(y)->dir, anchor->dir);
+            EXPECT_EQ(b.get<Anchor>(y)->connectedTo, map.at(anchor->connectedTo));
+        }
+        if (auto slots = a.get<AnchorSlots>(x)) {
+            for (int d = 0; d < 4; ++d) EXPECT_EQ(b.get<AnchorSlots>(y)->anchors[d], map.at(slots->anchors[d]));
+        }
+        EXPECT_EQ(a.has<Collision>(x), b.has<Collision>(y));
+        EXPECT_EQ(a.has<StaticBatched>(x), b.has<StaticBatched>(y));
+        if (auto wall = a.get<Wall>(x)) {
+            EXPECT_EQ(b.get<Wall>(y)->side, wall->side);
+        }
+        if (auto color = a.get<ColoredRender>(x)) {
+            EXPECT_EQ(b.get<ColoredRender>(y)->color.r, color->color.r);
+        }
+        if (auto render = a.get<TexturedRender>(x)) {
+            ASSERT_NE(b.get<TexturedRender>(y), nullptr);
+            EXPECT_EQ(assetsB.keyOf(b.get<TexturedRender>(y)->texture), assetsA.keyOf(render->texture));
+            EXPECT_EQ(b.get<TexturedRender>(y)->uv.width, render->uv.width);
+        }
+    }
+}
+
+TEST(LevelFileTest, DungeonRoundTrips) {
+    AssetCache assets;
+    const TexturedRender brick{ assets.loadTexture("textures/brick.png"), Rectangle{ 0, 0.5f, 0.5f, -0.5f } };
+    Registry reg;
+    TransformSystem transforms;
+    BuildDungeon(reg, transforms, SmallLayout(), brick);
+    transforms.update(reg);
+
+    LevelFile level = WriteLevel(reg, &assets);
+    ASSERT_TRUE(SaveLevel(level, "level_test.level"));
+    MappedFile file("level_test.level");
+    ASSERT_TRUE(file.isOpen());
+    LevelFileView view;
+    ASSERT_TRUE(ParseLevelFile(file.data(), file.size(), view));
+    EXPECT_EQ(view.header->entityCount, reg.entityCount());
+    ASSERT_EQ(view.header->textureCount, 1u);
+    EXPECT_EQ(view.textureKey(0), "textures/brick.png");
+
+    // the atlas (or whatever owns the key) is already loaded: the level shares it
+    AssetCache other;
+    TextureHandle atlas = other.loadTexture("textures/brick.png");
+    Registry loaded;
+    LevelInstance instance = InstantiateLevel(loaded, view, &other);
+    EXPECT_EQ(loaded.entityCount(), reg.entityCount());
+    EXPECT_EQ(loaded.count<Anchor>(), reg.count<Anchor>());
+    EXPECT_EQ(loaded.count<TexturedRender>(), reg.count<TexturedRender>());
+    EXPECT_EQ(other.refCount(atlas), 2u);
+    ExpectSameWorld(reg, assets, loaded, other, instance.entities);
+
+    // the level's reference goes back, the atlas keeps its own
+    ASSERT_EQ(instance.textures.size(), 1u);
+    EXPECT_EQ(instance.textures[0], atlas);
+    ReleaseLevelTextures(instance, other);
+    EXPECT_EQ(other.refCount(atlas), 1u);
+    EXPECT_TRUE(instance.textures.empty());
+    file.close();
+    std::remove("level_test.level");
+}
+
+TEST(LevelFileTest, LoadsNextToAnExistingWorld) {
+    Registry reg;
+    TransformSystem transforms;
+    DungeonEntities dungeon = BuildDungeon(reg, transforms, SmallLayout());
+    transforms.update(reg);
+    LevelFile level = WriteLevel(reg);
+
+    // ids taken and one freed: nothing lines up, every reference goes through the remap
+    Registry busy;
+    Entity keep = busy.create();
+    busy.destroy(busy.create());
+    busy.add<TransformComp>(keep, TransformComp{ { 1, 2, 3 }, { 1, 1, 1 } });
+    AssetCache none;
+    std::vector<Entity> first = InstantiateLevel(busy, level.view()).entities;
+    std::vector<Entity> second = InstantiateLevel(busy, level.view()).entities;
+    EXPECT_EQ(busy.entityCount(), 1 + 2 * reg.entityCount());
+    EXPECT_EQ(busy.get<TransformComp>(keep)->position.y, 2.0f);
+    ExpectSameWorld(reg, none, busy, none, first);
+    ExpectSameWorld(reg, none, busy, none, second);
+
+    // the copies are linked among themselves only
+    const DungeonLayout layout = SmallLayout();
+    std::vector<Entity> original = SavedEntities(reg);
+    size_t room = std::find(original.begin(), original.end(), dungeon.rooms[layout.halls[0].from]) - original.begin();
+    Entity anchor = FindAnchor(busy, second[room], layout.halls[0].side);
+    Entity other = busy.get<Anchor>(anchor)->connectedTo;
+    ASSERT_NE(other, INVALID_ENTITY);
+    EXPECT_NE(std::find(second.begin(), second.end(), other), second.end());
+    EXPECT_EQ(std::find(first.begin(), first.end(), other), first.end());
+}
+
+TEST(LevelFileTest, BrokenFilesAreRejected) {
+    Registry reg;
+    TransformSystem transforms;
+    BuildDungeon(reg, transforms, SmallLayout());
+    LevelFile level = WriteLevel(reg);
+    LevelFileView view;
+    ASSERT_TRUE(ParseLevelFile(level.bytes.data(), level.bytes.size(), view));
+    EXPECT_FALSE(ParseLevelFile(level.bytes.data(), level.bytes.size() / 2, view));
+    EXPECT_FALSE(view.valid());
+
+    // a section's first entity pointing past the end, then the same entity twice
+    const auto* section = reinterpret_cast<const LevelSection*>(level.bytes.data() + sizeof(LevelFileHeader));
+    LevelFile bad = level;
+    const Entity far{ static_cast<uint32_t>(reg.entityCount() + 1), 1 };
+    std::memcpy(bad.bytes.data() + section->entitiesAt, &far, sizeof(Entity));
+    EXPECT_FALSE(ParseLevelFile(bad.bytes.data(), bad.bytes.size(), view));
+    bad = level;
+    std::memcpy(bad.bytes.data() + section->entitiesAt + sizeof(Entity), bad.bytes.data() + section->entitiesAt, sizeof(Entity));
+    EXPECT_FALSE(ParseLevelFile(bad.bytes.data(), bad.bytes.size(), view));
+    bad = level;
+    bad.bytes[4] = 99; // version
+    EXPECT_FALSE(ParseLevelFile(bad.bytes.data(), bad.bytes.size(), view));
+
+    // references inside values: past the end, a stale version, id 0 with a version
+    auto sectionOf = [&](uint32_t component) -> const LevelSection* {
+        const auto* header = reinterpret_cast<const LevelFileHeader*>(level.bytes.data());
+        for (uint32_t i = 0; i < header->sectionCount; ++i)
+            if (section[i].component == component) return &section[i];
+        return nullptr;
+    };
+    const LevelSection* parents = sectionOf(2);   // Parent
+    const LevelSection* children = sectionOf(3);  // Children
+    const LevelSection* anchors = sectionOf(8);   // Anchor
+    ASSERT_TRUE(parents && children && anchors && children->extraCount > 0);
+    const Entity stale{ 1, 2 };
+    const Entity nullish{ 0, 1 };
+    for (auto [at, ref] : { std::pair{ parents->valuesAt + offsetof(Parent, parent), far },
+                            std::pair{ anchors->valuesAt + offsetof(Anchor, connectedTo), stale },
+                            std::pair{ children->extraAt, far },
+                            std::pair{ children->extraAt + sizeof(Entity), nullish } }) {
+        bad = level;
+        std::memcpy(bad.bytes.data() + at, &ref, sizeof(Entity));
+        EXPECT_FALSE(ParseLevelFile(bad.bytes.data(), bad.bytes.size(), view)) << "at " << at;
+    }
+    // out of range enums: they index 4 and 6 entry tables
+    const LevelSection* walls = sectionOf(7); // Wall
+    ASSERT_TRUE(walls && walls->count > 0);
+    for (uint8_t dir : { 4, 255 }) {
+        bad = level;
+        std::memcpy(bad.bytes.data() + anchors->valuesAt + offsetof(Anchor, dir), &dir, sizeof(AnchorDir));
+        EXPECT_FALSE(ParseLevelFile(bad.bytes.data(), bad.bytes.size(), view)) << "dir " << int(dir);
+    }
+    for (int side : { 6, -1 }) {
+        bad = level;
+        std::memcpy(bad.bytes.data() + walls->valuesAt + (walls->count - 1) * sizeof(Wall) + offsetof(Wall, side), &side, sizeof(Wall::Side));
+        EXPECT_FALSE(ParseLevelFile(bad.bytes.data(), bad.bytes.size(), view)) << "side " << side;
+    }
+    // null links are fine
+    bad = level;
+    std::memcpy(bad.bytes.data() + anchors->valuesAt + offsetof(Anchor, connectedTo), &INVALID_ENTITY, sizeof(Entity));
+    EXPECT_TRUE(ParseLevelFile(bad.bytes.data(), bad.bytes.size(), view));
+
+    Registry empty;
+    EXPECT_FALSE(LoadLevel(empty, "missing.level"));
+    EXPECT_TRUE(InstantiateLevel(empty, LevelFileView{}).entities.empty());
+    EXPECT_EQ(empty.entityCount(), 0u);
+}
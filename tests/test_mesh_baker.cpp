@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/mesh_baker.h"
+#include "../include/world/room.h"
+#include "../include/world/anchor.h"
+
+static BakeBox MakeBox(Vector3 min, Vector3 max, Color color = GRAY) {
+    BakeBox box;
+    box.min = min;
+    box.max = max;
+    box.color = color;
+    return box;
+}
+
+TEST(MeshBakerTest, SingleBox_AllSixFaces) {
+    BakedMesh mesh = BakeBoxes({ MakeBox({0, 0, 0}, {1, 1, 1}) });
+    ASSERT_EQ(mesh.batches.size(), 1);
+    EXPECT_EQ(mesh.faceCount, 6);
+    EXPECT_EQ(mesh.culledFaces, 0);
+    EXPECT_EQ(mesh.vertexCount(), 24);
+    EXPECT_EQ(mesh.batches[0].indices.size(), 36);
+    EXPECT_FALSE(mesh.dirty);
+}
+
+TEST(MeshBakerTest, TouchingBoxes_DropSharedFaces) {
+    BakedMesh mesh = BakeBoxes({
+        MakeBox({0, 0, 0}, {1, 1, 1}),
+        MakeBox({1, 0, 0}, {2, 1, 1}),
+    });
+    EXPECT_EQ(mesh.culledFaces, 2);
+    EXPECT_EQ(mesh.faceCount, 10);
+}
+
+TEST(MeshBakerTest, BuriedEndFace_Dropped) {
+    // thin wall whose bottom end sits inside a thick floor slab
+    BakedMesh mesh = BakeBoxes({
+        MakeBox({-5, -1, -5}, {5, 0.5f, 5}),
+        MakeBox({0, 0, 0}, {0.1f, 3, 2}),
+    });
+    EXPECT_EQ(mesh.culledFaces, 1);
+}
+
+TEST(MeshBakerTest, PartialContact_KeepsFace) {
+    // the second box only covers half of the first box's +x face
+    BakedMesh mesh = BakeBoxes({
+        MakeBox({0, 0, 0}, {1, 1, 1}),
+        MakeBox({1, 0, 0}, {2, 0.5f, 1}),
+    });
+    EXPECT_EQ(mesh.culledFaces, 1); // only the smaller box's -x face is fully covered
+}
+
+TEST(MeshBakerTest, BatchesSplitByMaterial) {
+    BakedMesh mesh = BakeBoxes({
+        MakeBox({0, 0, 0}, {1, 1, 1}, GRAY),
+        MakeBox({5, 0, 0}, {6, 1, 1}, RED),
+        MakeBox({9, 0, 0}, {10, 1, 1}, GRAY),
+    });
+    EXPECT_EQ(mesh.batches.size(), 2);
+}
+
+TEST(MeshBakerTest, WorldSpaceTiledUVs) {
+    BakeSettings settings;
+    settings.uvTileSize = 10.0f;
+    BakedMesh mesh = BakeBoxes({ MakeBox({0, 0, 0}, {20, 10, 0.1f}) }, settings);
+    ASSERT_EQ(mesh.batches.size(), 1);
+
+    float maxU = 0.0f;
+    for (size_t i = 0; i < mesh.batches[0].texcoords.size(); i += 2)
+        maxU = std::max(maxU, mesh.batches[0].texcoords[i]);
+    EXPECT_FLOAT_EQ(maxU, 2.0f); // 20 units wide -> two repeats
+}
+
+TEST(MeshBakerTest, AtlasTilesRepeatLikeTiledTextures) {
+    BakeSettings settings;
+    settings.uvTileSize = 10.0f;
+    BakeBox box = MakeBox({0, 0, 0}, {25, 10, 0.1f});
+    box.texture = TextureHandle{ 1, 1 };
+    box.uv = Rectangle{ 0.5f, 0.5f, 0.25f, 0.25f }; // an atlas tile
+    box.tiled = false;
+    BakedMesh mesh = BakeBoxes({ box }, settings);
+    ASSERT_EQ(mesh.batches.size(), 1);
+    const BakedMeshBatch& batch = mesh.batches[0];
+
+    // the big faces are cut at x = 10 and 20: three quads each, the last one half a repeat wide
+    size_t bigFaceQuads = 0;
+    for (size_t q = 0; q < batch.vertices.size() / 12; ++q) {
+        const float* vs = &batch.vertices[q * 12];
+        const float* uvs = &batch.texcoords[q * 8];
+        float minX = INFINITY, maxX = -INFINITY, minU = INFINITY, maxU = -INFINITY;
+        bool bigFace = true;
+        for (int i = 0; i < 4; ++i) {
+            minX = std::min(minX, vs[i * 3]);
+            maxX = std::max(maxX, vs[i * 3]);
+            minU = std::min(minU, uvs[i * 2]);
+            maxU = std::max(maxU, uvs[i * 2]);
+            bigFace = bigFace && (vs[i * 3 + 2] == 0.0f || vs[i * 3 + 2] == 0.1f) && batch.normals[q * 12 + i * 3 + 2] != 0.0f;
+            // never outside the tile
+            EXPECT_GE(uvs[i * 2], 0.5f - 1e-5f);
+            EXPECT_LE(uvs[i * 2], 0.75f + 1e-5f);
+            EXPECT_GE(uvs[i * 2 + 1], 0.5f - 1e-5f);
+            EXPECT_LE(uvs[i * 2 + 1], 0.75f + 1e-5f);
+        }
+        if (!bigFace) continue;
+        bigFaceQuads++;
+        EXPECT_LE(maxX - minX, 10.0f + 1e-4f);
+        // a whole repeat maps the whole tile, the 5 wide end half of it
+        EXPECT_NEAR(maxU - minU, 0.25f * (maxX - minX) / 10.0f, 1e-5f);
+    }
+    EXPECT_EQ(bigFaceQuads, 6u);
+}
+
+TEST(MeshBakerTest, BoundsCoverAllBoxes) {
+    BakedMesh mesh = BakeBoxes({
+        MakeBox({-1, 0, 0}, {1, 1, 1}),
+        MakeBox({0, -2, 0}, {1, 1, 3}),
+    });
+    EXPECT_FLOAT_EQ(mesh.bounds.min.x, -1);
+    EXPECT_FLOAT_EQ(mesh.bounds.min.y, -2);
+    EXPECT_FLOAT_EQ(mesh.bounds.max.z, 3);
+}
+
+TEST(MeshBakerTest, RoomBake_TagsWallsAndSkipsAnchors) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity room = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    transforms.update(reg);
+
+    BakedMesh mesh = BakeRoomMesh(reg, room);
+    EXPECT_EQ(mesh.batches.size(), 1); // all walls are flat GRAY
+    EXPECT_GT(mesh.faceCount, 0);
+
+    size_t tagged = 0;
+    for (Entity child : reg.get<Children>(room)->entities) {
+        if (reg.has<StaticBatched>(child)) tagged++;
+        if (reg.has<Anchor>(child)) {
+            EXPECT_FALSE(reg.has<StaticBatched>(child));
+        }
+    }
+    EXPECT_EQ(tagged, 6);
+}
+
+TEST(MeshBakerTest, CarveDoorway_MarksDirtyAndRebakes) {
+    Registry reg;
+    TransformSystem transforms;
+    MeshBakeSystem baker;
+    Entity room = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    transforms.update(reg);
+
+    EnableMeshBaking(reg, room);
+    baker.update(reg);
+    ASSERT_FALSE(reg.get<BakedMesh>(room)->dirty);
+    size_t facesBefore = reg.get<BakedMesh>(room)->faceCount;
+
+    CarveDoorwayInWall(reg, room, Wall::Side::Right);
+    EXPECT_TRUE(reg.get<BakedMesh>(room)->dirty);
+
+    transforms.update(reg);
+    baker.update(reg);
+    EXPECT_FALSE(reg.get<BakedMesh>(room)->dirty);
+    EXPECT_NE(reg.get<BakedMesh>(room)->faceCount, facesBefore);
+
+    // the new segments are drawn through the baked mesh too
+    for (Entity child : reg.get<Children>(room)->entities) {
+        if (reg.has<ColoredRender>(child)) {
+            EXPECT_TRUE(reg.has<StaticBatched>(child));
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../include/core/json.h"
+#include "../include/core/mapped_file.h"
+#include "../include/render/cooked_mesh.h"
+#include "../include/render/gltf_reader.h"
+#include "../include/render/mesh_cooker.h"
+
+TEST(JsonTest, ParsesNestedValues) {
+    bool ok = false;
+    JsonValue doc = ParseJson(R"({ "a": [1, 2.5, -3e2], "b": { "c": "x\"y" }, "d": true, "e": null })", &ok);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(doc["a"].size(), 3u);
+    EXPECT_DOUBLE_EQ(doc["a"][1].asNumber(), 2.5);
+    EXPECT_DOUBLE_EQ(doc["a"][2].asNumber(), -300.0);
+    EXPECT_EQ(doc["b"]["c"].asString(), "x\"y");
+    EXPECT_TRUE(doc["d"].boolean);
+    EXPECT_FALSE(doc.has("e"));
+    EXPECT_TRUE(doc["missing"]["deeper"][4].isNull()); // chains never need checks
+
+    ParseJson("{ \"a\": [1, 2 }", &ok);
+    EXPECT_FALSE(ok);
+}
+
+// one quad (two triangles) under a node moved +10 on x, positions/normals/uvs/indices in one .bin
+static std::string WriteQuadGltf() {
+    const float positions[] = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+    const float normals[] = { 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1 };
+    const float uvs[] = { 0, 0, 1, 0, 1, 1, 0, 1 };
+    const uint16_t indices[] = { 0, 1, 2, 0, 2, 3 };
+    std::ofstream bin("mesh_test.bin", std::ios::binary);
+    bin.write(reinterpret_cast<const char*>(positions), sizeof(positions));
+    bin.write(reinterpret_cast<const char*>(normals), sizeof(normals));
+    bin.write(reinterpret_cast<const char*>(uvs), sizeof(uvs));
+    bin.write(reinterpret_cast<const char*>(indices), sizeof(indices));
+
+    std::ofstream gltf("mesh_test.gltf");
+    gltf << R"({
+      "scene": 0, "scenes": [ { "nodes": [0] } ],
+      "nodes": [ { "translation": [10, 0, 0], "children": [1] }, { "mesh": 0 } ],
+      "meshes": [ { "primitives": [ { "attributes": { "POSITION": 0, "NORMAL": 1, "TEXCOORD_0": 2 }, "indices": 3, "material": 2 } ] } ],
+      "buffers": [ { "uri": "mesh_test.bin", "byteLength": 140 } ],
+      "bufferViews": [ { "buffer": 0, "byteOffset": 0, "byteLength": 48 }, { "buffer": 0, "byteOffset": 48, "byteLength": 48 },
+                       { "buffer": 0, "byteOffset": 96, "byteLength": 32 }, { "buffer": 0, "byteOffset": 128, "byteLength": 12 } ],
+      "accessors": [ { "bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3" },
+                     { "bufferView": 1, "componentType": 5126, "count": 4, "type": "VEC3" },
+                     { "bufferView": 2, "componentType": 5126, "count": 4, "type": "VEC2" },
+                     { "bufferView": 3, "componentType": 5123, "count": 6, "type": "SCALAR" } ]
+    })";
+    return "mesh_test.gltf";
+}
+
+TEST(MeshCookerTest, GltfNodesAreFlattened) {
+    MeshData mesh = LoadGltfMesh(WriteQuadGltf());
+    ASSERT_FALSE(mesh.empty());
+    EXPECT_EQ(mesh.positions.size(), 4u);
+    EXPECT_EQ(mesh.indices.size(), 6u);
+    ASSERT_EQ(mesh.primitives.size(), 1u);
+    EXPECT_EQ(mesh.primitives[0].material, 2);
+    EXPECT_FLOAT_EQ(mesh.positions[1].x, 11.0f); // node translation applied
+    EXPECT_FLOAT_EQ(mesh.bounds.min.x, 10.0f);
+    EXPECT_FLOAT_EQ(mesh.bounds.max.y, 1.0f);
+    EXPECT_FLOAT_EQ(mesh.normals[0].z, 1.0f);
+
+    EXPECT_TRUE(LoadGltfMesh("does_not_exist.gltf").empty());
+    std::remove("mesh_test.gltf");
+    std::remove("mesh_test.bin");
+}
+
+TEST(MeshCookerTest, CookedFileRoundTrips) {
+    MeshData mesh = LoadGltfMesh(WriteQuadGltf());
+    CookedMeshFile cooked = CookMesh(mesh);
+    ASSERT_TRUE(SaveCookedMesh(cooked, "mesh_test.cmesh"));
+
+    MappedFile file("mesh_test.cmesh");
+    ASSERT_TRUE(file.isOpen());
+    EXPECT_EQ(file.size(), cooked.bytes.size());
+    CookedMeshView view;
+    ASSERT_TRUE(ParseCookedMesh(file.data(), file.size(), view));
+    EXPECT_EQ(view.header->vertexCount, 4u);
+    EXPECT_EQ(view.header->indexCount, 6u);
+    EXPECT_EQ(view.header->partCount, 1u);
+    EXPECT_EQ(view.parts[0].material, 2);
+    EXPECT_FLOAT_EQ(view.bounds().min.x, 10.0f);
+
+    // quantized positions come back within 1/65535 of the bounds
+    for (uint32_t i = 0; i < 6; ++i) {
+        Vector3 original = mesh.positions[mesh.indices[i]];
+        Vector3 restored = view.position(view.indices[i]);
+        EXPECT_NEAR(original.x, restored.x, 1e-4f);
+        EXPECT_NEAR(original.y, restored.y, 1e-4f);
+    }
+    EXPECT_EQ(view.vertices[view.indices[2]].texcoord[0], 1.0f);
+    EXPECT_EQ(view.vertices[0].normal[2], 127);
+
+    // the GPU side takes the mapped bytes as they are
+    CookedMesh gpu;
+    EXPECT_TRUE(gpu.upload(view));
+    EXPECT_EQ(gpu.partCount(), 1u);
+
+    // truncated files are rejected, not read past the end
+    EXPECT_FALSE(ParseCookedMesh(file.data(), file.size() - 2, view));
+    file.close();
+    std::remove("mesh_test.cmesh");
+    std::remove("mesh_test.gltf");
+    std::remove("mesh_test.bin");
+}
+
+TEST(MeshCookerTest, OutOfRangeIndicesAreRejected) {
+    MeshData mesh = LoadGltfMesh(WriteQuadGltf());
+    CookedMeshFile cooked = CookMesh(mesh);
+    std::remove("mesh_test.gltf");
+    std::remove("mesh_test.bin");
+    CookedMeshView view;
+    ASSERT_TRUE(ParseCookedMesh(cooked.bytes.data(), cooked.bytes.size(), view));
+    const size_t lastIndexAt = reinterpret_cast<const uint8_t*>(view.indices + view.header->indexCount - 1) - cooked.bytes.data();
+
+    // past the vertex buffer
+    std::vector<uint8_t> bytes = cooked.bytes;
+    const uint16_t pastEnd = 4;
+    std::memcpy(bytes.data() + lastIndexAt, &pastEnd, sizeof(pastEnd));
+    EXPECT_FALSE(ParseCookedMesh(bytes.data(), bytes.size(), view));
+    EXPECT_FALSE(view.valid());
+
+    // inside the buffer but past its part's vertices
+    bytes = cooked.bytes;
+    CookedMeshPart part;
+    std::memcpy(&part, bytes.data() + sizeof(CookedMeshHeader), sizeof(part));
+    part.vertexCount = 2;
+    std::memcpy(bytes.data() + sizeof(CookedMeshHeader), &part, sizeof(part));
+    EXPECT_FALSE(ParseCookedMesh(bytes.data(), bytes.size(), view));
+}
+
+TEST(MeshCookerTest, BigPrimitivesSplitInto16BitParts) {
+    // 30000 separate triangles = 90000 vertices, more than one 16-bit part can address
+    MeshData mesh;
+    for (uint32_t t = 0; t < 30000; ++t) {
+        float x = static_cast<float>(t);
+        mesh.positions.push_back({ x, 0, 0 });
+        mesh.positions.push_back({ x + 1, 0, 0 });
+        mesh.positions.push_back({ x, 1, 0 });
+        for (uint32_t k = 0; k < 3; ++k) mesh.indices.push_back(t * 3 + k);
+    }
+    mesh.primitives.push_back({ 0, static_cast<uint32_t>(mesh.indices.size()), -1 });
+    mesh.bounds = BoundingBox{ { 0, 0, 0 }, { 30001, 1, 0 } };
+
+    CookedMeshFile cooked = CookMesh(mesh);
+    CookedMeshView view = cooked.view();
+    ASSERT_TRUE(view.valid());
+    ASSERT_EQ(view.header->partCount, 2u);
+    EXPECT_EQ(view.parts[0].vertexCount, 65535u); // whole triangles only
+    EXPECT_EQ(view.parts[0].indexCount + view.parts[1].indexCount, 90000u);
+    EXPECT_EQ(view.parts[1].firstVertex, view.parts[0].vertexCount);
+
+    // the last triangle still ends up where it was
+    const CookedMeshPart& last = view.parts[1];
+    Vector3 p = view.position(last.firstVertex + view.indices[last.firstIndex + last.indexCount - 2]);
+    EXPECT_NEAR(p.x, 30000.0f, 0.5f);
+}
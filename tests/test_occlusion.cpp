@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/entity_utils.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/occlusion.h"
+#include "../include/world/room.h"
+
+static Camera MakeCamera(Vector3 position, Vector3 target) {
+    Camera camera{};
+    camera.position = position;
+    camera.target = target;
+    camera.up = Vector3{0, 1, 0};
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    return camera;
+}
+
+// camera at the origin looking down -z at a 10 x 4 wall 10 units away
+static OcclusionBuffer WallScene(ThreadPool* pool = nullptr) {
+    Camera camera = MakeCamera({0, 0, 0}, {0, 0, -1});
+    OcclusionBuffer buffer(128, 64);
+    buffer.begin(Frustum::ViewProjection(camera, 2.0f));
+    buffer.addOccluder(BoundsFromCenterSize({0, 0, -10}, {10, 4, 0.2f}), camera.position);
+    buffer.rasterize(pool);
+    return buffer;
+}
+
+TEST(OcclusionBufferTest, BoxBehindWallHidden) {
+    OcclusionBuffer buffer = WallScene();
+    EXPECT_GT(buffer.triangleCount(), 0);
+    EXPECT_FALSE(buffer.isVisible(BoundsFromCenterSize({0, 0, -20}, {2, 2, 2})));
+    EXPECT_FALSE(buffer.isVisible(BoundsFromCenterSize({3, -2, -40}, {4, 4, 4})));
+}
+
+TEST(OcclusionBufferTest, BoxInFrontOrBesideVisible) {
+    OcclusionBuffer buffer = WallScene();
+    EXPECT_TRUE(buffer.isVisible(BoundsFromCenterSize({0, 0, -5}, {1, 1, 1})));
+    EXPECT_TRUE(buffer.isVisible(BoundsFromCenterSize({20, 0, -20}, {2, 2, 2})));  // off to the side of the wall
+    EXPECT_TRUE(buffer.isVisible(BoundsFromCenterSize({0, 0, -10}, {2, 2, 2})));   // straddles the wall
+}
+
+TEST(OcclusionBufferTest, BoxPeekingOverWallVisible) {
+    OcclusionBuffer buffer = WallScene();
+    // top of the wall is at y = 2 (10 units away), this box rises well above it further back
+    EXPECT_TRUE(buffer.isVisible(BoundsFromCenterSize({0, 15, -20}, {2, 12, 2})));
+}
+
+TEST(OcclusionBufferTest, OccluderCrossingNearPlaneIsClipped) {
+    // standing on a huge floor slab looking down and forward, things under the floor are hidden
+    Camera camera = MakeCamera({0, 0, 0}, {0, -1, -3});
+    OcclusionBuffer buffer(128, 64);
+    buffer.begin(Frustum::ViewProjection(camera, 2.0f));
+    buffer.addOccluder(BoundingBox{ {-100, -1.1f, -100}, {100, -1, 100} }, camera.position);
+    buffer.rasterize();
+
+    EXPECT_GT(buffer.triangleCount(), 0);
+    EXPECT_FALSE(buffer.isVisible(BoundsFromCenterSize({0, -5, -10}, {2, 2, 2})));
+    EXPECT_TRUE(buffer.isVisible(BoundsFromCenterSize({0, 0, -10}, {2, 2, 2})));
+}
+
+TEST(OcclusionBufferTest, ThreadedMatchesSingleThreaded) {
+    ThreadPool pool(4);
+    OcclusionBuffer a = WallScene();
+    OcclusionBuffer b = WallScene(&pool);
+    for (int y = 0; y < a.getHeight(); ++y)
+        for (int x = 0; x < a.getWidth(); ++x) ASSERT_EQ(a.depthAt(x, y), b.depthAt(x, y));
+}
+
+TEST(OcclusionCullingSystemTest, RoomBehindClosedWallCulled) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity a = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    Entity b = CreateRoom(reg, {0, 0, -20}, {10, 5, 10});
+    Entity side = CreateRoom(reg, {40, 0, -20}, {10, 5, 10}); // nothing between it and the camera
+    transforms.update(reg);
+
+    Camera camera = MakeCamera({0, 0, 3}, {0, 0, -20});
+    VisibleSet visible;
+    CullingSystem frustum(camera, visible);
+    frustum.aspect = 1.0f;
+    frustum.update(reg);
+
+    auto contains = [&](Entity e) { return std::find(visible.entities.begin(), visible.entities.end(), e) != visible.entities.end(); };
+    size_t before = visible.entities.size();
+    Entity bWall = reg.get<Children>(b)->entities[0];
+    ASSERT_TRUE(contains(bWall));
+
+    OcclusionSettings settings;
+    settings.threads = 2;
+    OcclusionCullingSystem occlusion(camera, visible, settings);
+    occlusion.aspect = 1.0f;
+    occlusion.update(reg);
+
+    EXPECT_GT(occlusion.occludersUsed, 0);
+    EXPECT_EQ(occlusion.tested, before);
+    EXPECT_GT(occlusion.culled, 0);
+    EXPECT_FALSE(contains(bWall));
+    for (Entity child : reg.get<Children>(a)->entities) {
+        if (reg.has<Wall>(child) && reg.get<Wall>(child)->side == Wall::Side::Front && reg.get<TransformComp>(child)->size.y > 1) {
+            EXPECT_TRUE(contains(child)); // the wall doing the occluding stays
+        }
+    }
+    (void)side;
+}
+
+TEST(OcclusionCullingSystemTest, OccluderSwappedInOneFrameStopsHiding) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity near = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    Entity far = CreateRoom(reg, {0, 0, -20}, {10, 5, 10});
+    transforms.update(reg);
+
+    Camera camera = MakeCamera({0, 0, 3}, {0, 0, -20});
+    VisibleSet visible;
+    CullingSystem frustum(camera, visible);
+    frustum.aspect = 1.0f;
+    OcclusionCullingSystem occlusion(camera, visible);
+    occlusion.aspect = 1.0f;
+    frustum.update(reg);
+    occlusion.update(reg);
+    auto contains = [&](Entity e) { return std::find(visible.entities.begin(), visible.entities.end(), e) != visible.entities.end(); };
+    Entity farWall = reg.get<Children>(far)->entities[0];
+    ASSERT_FALSE(contains(farWall));
+
+    // the room around the camera is swapped for one without a front wall, every count stays the same
+    const size_t transformCount = reg.count<WorldTransform>(), collisionCount = reg.count<Collision>();
+    DestroyEntityWithChildren(reg, near);
+    Entity open = CreateRoom(reg, {0, 0, 0}, {10, 5, 10}, {}, { Wall::Side::Front });
+    Entity filler = reg.create(); // stands in for the skipped wall in every pool
+    reg.add<TransformComp>(filler, TransformComp{ {0, 100, 0}, {0.1f, 0.1f, 0.1f} });
+    reg.add<ColoredRender>(filler, ColoredRender{ RED });
+    reg.add<Collision>(filler, Collision{});
+    reg.add<Parent>(filler, Parent{ open });
+    reg.add<Wall>(filler, Wall{ Wall::Side::Ceiling });
+    reg.get<Children>(open)->entities.push_back(filler);
+    transforms.update(reg);
+    ASSERT_EQ(reg.count<WorldTransform>(), transformCount);
+    ASSERT_EQ(reg.count<Collision>(), collisionCount);
+    frustum.update(reg);
+    occlusion.update(reg);
+    EXPECT_EQ(occlusion.rebuilds, 2u);
+    EXPECT_TRUE(contains(farWall));
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/entity_utils.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/portal_visibility.h"
+#include "../include/world/room.h"
+#include "../include/world/anchor.h"
+
+static Camera MakeCamera(Vector3 position, Vector3 target) {
+    Camera camera{};
+    camera.position = position;
+    camera.target = target;
+    camera.up = Vector3{0, 1, 0};
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    return camera;
+}
+
+static Entity AnchorFacing(Registry& reg, Entity room, Vector3 dir) {
+    for (Entity child : reg.get<Children>(room)->entities) {
+        if (auto a = reg.get<Anchor>(child)) {
+            if (Vector3DotProduct(Vector3Normalize(a->direction), dir) > 0.99f) return child;
+        }
+    }
+    return INVALID_ENTITY;
+}
+
+static bool Contains(const VisibleSet& set, Entity e) {
+    return std::find(set.entities.begin(), set.entities.end(), e) != set.entities.end();
+}
+
+// three rooms in a row along +x joined by doorways, plus one unconnected room further down the line
+struct PortalLevel {
+    Registry reg;
+    TransformSystem transforms;
+    Entity a, b, c, island;
+
+    PortalLevel() {
+        a = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+        b = CreateRoom(reg, {10, 0, 0}, {10, 5, 10});
+        c = CreateRoom(reg, {20, 0, 0}, {10, 5, 10});
+        island = CreateRoom(reg, {60, 0, 0}, {10, 5, 10});
+        transforms.update(reg);
+
+        ConnectAnchors(reg, AnchorFacing(reg, a, {1, 0, 0}), AnchorFacing(reg, b, {-1, 0, 0}));
+        transforms.update(reg);
+        ConnectAnchors(reg, AnchorFacing(reg, b, {1, 0, 0}), AnchorFacing(reg, c, {-1, 0, 0}));
+        transforms.update(reg);
+        for (Entity room : { a, b, c, island }) EnableMeshBaking(reg, room);
+
+        MeshBakeSystem baker;
+        baker.update(reg);
+    }
+};
+
+TEST(CellGraphTest, ConnectedAnchorsBecomePortals) {
+    PortalLevel level;
+    CellGraph graph;
+    graph.build(level.reg);
+
+    EXPECT_EQ(graph.getCells().size(), 4);
+    EXPECT_EQ(graph.getPortals().size(), 4); // a<->b and b<->c, one per direction
+
+    int a = graph.cellOf(level.a);
+    int island = graph.cellOf(level.island);
+    EXPECT_TRUE(graph.getCells()[island].portals.empty());
+    ASSERT_EQ(graph.getCells()[a].portals.size(), 1);
+
+    const Portal& portal = graph.getPortals()[graph.getCells()[a].portals[0]];
+    EXPECT_EQ(portal.toCell, static_cast<uint32_t>(graph.cellOf(level.b)));
+    EXPECT_FLOAT_EQ(portal.normal.x, 1.0f);
+    EXPECT_FLOAT_EQ(portal.opening.min.x, 5.0f);
+    EXPECT_FLOAT_EQ(portal.opening.max.x, 5.0f);
+}
+
+TEST(CellGraphTest, PortalOpeningIsTheCarvedDoorway) {
+    PortalLevel level;
+    CellGraph graph;
+    graph.build(level.reg);
+
+    int a = graph.cellOf(level.a);
+    ASSERT_EQ(graph.getCells()[a].portals.size(), 1);
+    // 2 wide around the anchor, from the floor up to 1.5 above the middle of the 5 high wall (see CarveDoorway)
+    const BoundingBox& opening = graph.getPortals()[graph.getCells()[a].portals[0]].opening;
+    EXPECT_NEAR(opening.min.z, -1.0f, 1e-4f);
+    EXPECT_NEAR(opening.max.z, 1.0f, 1e-4f);
+    EXPECT_NEAR(opening.min.y, -2.5f, 1e-4f);
+    EXPECT_NEAR(opening.max.y, 1.5f, 1e-4f);
+
+    // anchors linked without a doorway between them aren't a portal
+    Registry reg;
+    TransformSystem transforms;
+    Entity x = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    Entity y = CreateRoom(reg, {10, 0, 0}, {10, 5, 10});
+    transforms.update(reg);
+    Entity xa = AnchorFacing(reg, x, {1, 0, 0});
+    Entity ya = AnchorFacing(reg, y, {-1, 0, 0});
+    reg.get<Anchor>(xa)->connectedTo = ya;
+    reg.get<Anchor>(ya)->connectedTo = xa;
+    graph.build(reg);
+    EXPECT_TRUE(graph.getPortals().empty());
+}
+
+TEST(CellGraphTest, FindCell) {
+    PortalLevel level;
+    CellGraph graph;
+    graph.build(level.reg);
+
+    EXPECT_EQ(graph.findCell({-3, 0, 0}), graph.cellOf(level.a));
+    EXPECT_EQ(graph.findCell({22, 0, 0}, graph.cellOf(level.b)), graph.cellOf(level.c));
+    EXPECT_EQ(graph.findCell({40, 0, 0}), -1);
+}
+
+TEST(PortalVisibilityTest, SeesThroughDoorways_NotIntoUnconnectedRooms) {
+    PortalLevel level;
+    Camera camera = MakeCamera({-4, 0, 0}, {100, 0, 0});
+    VisibleSet visible;
+    PortalVisibilitySystem portals(camera, visible);
+    portals.update(level.reg);
+
+    ASSERT_TRUE(portals.usedPortals);
+    EXPECT_TRUE(Contains(visible, level.a));
+    EXPECT_TRUE(Contains(visible, level.b));
+    EXPECT_TRUE(Contains(visible, level.c));
+    EXPECT_FALSE(Contains(visible, level.island)); // inside the frustum, but no portal leads there
+}
+
+TEST(PortalVisibilityTest, PortalsBehindCameraAreSkipped) {
+    PortalLevel level;
+    Camera camera = MakeCamera({-4, 0, 0}, {-100, 0, 0});
+    VisibleSet visible;
+    PortalVisibilitySystem portals(camera, visible);
+    portals.update(level.reg);
+
+    EXPECT_EQ(portals.getVisibleCells().size(), 1);
+    EXPECT_TRUE(Contains(visible, level.a));
+    EXPECT_FALSE(Contains(visible, level.b));
+}
+
+TEST(PortalVisibilityTest, OutsideAllCells_FallsBackToFrustum) {
+    PortalLevel level;
+    Camera camera = MakeCamera({40, 0, 0}, {100, 0, 0});
+    VisibleSet visible;
+    PortalVisibilitySystem portals(camera, visible);
+    portals.update(level.reg);
+
+    EXPECT_FALSE(portals.usedPortals);
+    EXPECT_TRUE(visible.valid);
+    EXPECT_TRUE(Contains(visible, level.island));
+    EXPECT_FALSE(Contains(visible, level.a));
+}
+
+TEST(PortalVisibilityTest, RoomSwappedInOneFrameIsPickedUp) {
+    PortalLevel level;
+    Camera camera = MakeCamera({58, 0, 0}, {100, 0, 0});
+    VisibleSet visible;
+    PortalVisibilitySystem portals(camera, visible);
+    portals.update(level.reg);
+    ASSERT_TRUE(portals.usedPortals);
+    EXPECT_TRUE(Contains(visible, level.island));
+
+    // same shape and place, every count stays the same
+    DestroyEntityWithChildren(level.reg, level.island);
+    Entity island = CreateRoom(level.reg, {60, 0, 0}, {10, 5, 10});
+    EnableMeshBaking(level.reg, island);
+    level.transforms.update(level.reg);
+    MeshBakeSystem baker;
+    baker.update(level.reg);
+    portals.update(level.reg);
+    EXPECT_EQ(portals.rebuilds, 2u);
+    ASSERT_TRUE(portals.usedPortals);
+    EXPECT_TRUE(Contains(visible, island));
+    EXPECT_FALSE(Contains(visible, level.island));
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/prefab.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/anchor.h"
+#include "../include/world/anchor_index.h"
+#include "../include/world/hallway.h"
+#include "../include/world/prefabs.h"
+#include "../include/world/room.h"
+
+// a stamped copy has to be indistinguishable from the Create* version, component by component
+static void ExpectSameLayout(Registry& a, Entity rootA, Registry& b, Entity rootB) {
+    const auto& childrenA = a.get<Children>(rootA)->entities;
+    const auto& childrenB = b.get<Children>(rootB)->entities;
+    ASSERT_EQ(childrenA.size(), childrenB.size());
+    auto expectSame = [](const TransformComp& x, const TransformComp& y) {
+        EXPECT_EQ(x.position.x, y.position.x);
+        EXPECT_EQ(x.position.y, y.position.y);
+        EXPECT_EQ(x.position.z, y.position.z);
+        EXPECT_EQ(x.size.x, y.size.x);
+        EXPECT_EQ(x.size.y, y.size.y);
+        EXPECT_EQ(x.size.z, y.size.z);
+    };
+    expectSame(*a.get<TransformComp>(rootA), *b.get<TransformComp>(rootB));
+    EXPECT_FALSE(b.has<Parent>(rootB));
+    for (size_t i = 0; i < childrenA.size(); ++i) {
+        Entity x = childrenA[i], y = childrenB[i];
+        expectSame(*a.get<TransformComp>(x), *b.get<TransformComp>(y));
+        EXPECT_EQ(b.get<Parent>(y)->parent, rootB);
+        EXPECT_EQ(a.has<Collision>(x), b.has<Collision>(y));
+        EXPECT_EQ(a.has<ColoredRender>(x), b.has<ColoredRender>(y));
+        EXPECT_EQ(a.has<TexturedRender>(x), b.has<TexturedRender>(y));
+        if (auto wall = a.get<Wall>(x)) {
+            EXPECT_EQ(b.get<Wall>(y)->side, wall->side);
+        }
+        if (auto anchor = a.get<Anchor>(x)) {
+            auto copy = b.get<Anchor>(y);
+            ASSERT_NE(copy, nullptr);
+            EXPECT_EQ(copy->dir, anchor->dir);
+            EXPECT_EQ(copy->localPos.x, anchor->localPos.x);
+            EXPECT_EQ(copy->localPos.z, anchor->localPos.z);
+            EXPECT_EQ(copy->connectedTo, INVALID_ENTITY);
+            EXPECT_EQ(FindAnchor(b, rootB, copy->dir), y);
+        }
+    }
+}
+
+TEST(PrefabTest, StampedRoomMatchesCreateRoom) {
+    Registry created, stamped;
+    Entity room = CreateRoom(created, { 5, 1, -7 }, { 37, 13, 23 });
+    Prefab prefab = MakeRoomPrefab();
+    EXPECT_EQ(prefab.nodeCount(), 11u); // room, 6 walls, 4 anchors
+    Entity copy = prefab.instantiate(stamped, PrefabInstance{ { 5, 1, -7 }, Vector3{ 37, 13, 23 } });
+    EXPECT_EQ(stamped.entityCount(), created.entityCount());
+    ExpectSameLayout(created, room, stamped, copy);
+
+    // rooms with skipped walls go through their own prefab
+    Registry openCreated, openStamped;
+    const std::vector<Wall::Side> skip = { Wall::Side::Back };
+    Entity open = CreateRoom(openCreated, { 0, 0, 0 }, { 20, 10, 30 }, {}, skip);
+    Entity openCopy = MakeRoomPrefab({}, skip).instantiate(openStamped, PrefabInstance{ { 0, 0, 0 }, Vector3{ 20, 10, 30 } });
+    ExpectSameLayout(openCreated, open, openStamped, openCopy);
+}
+
+TEST(PrefabTest, ManyCopiesAreIndependent) {
+    Registry reg;
+    TransformSystem transforms;
+    AnchorIndex index;
+    Prefab prefab = MakeRoomPrefab();
+    const TexturedRender brick{ TextureHandle{ 3, 1 } };
+
+    std::vector<PrefabInstance> instances;
+    for (int i = 0; i < 100; ++i) {
+        PrefabInstance inst{ { i * 50.0f, 0, 0 }, Vector3{ 40, 10, 40 } };
+        if (i % 2) inst.material = brick;
+        instances.push_back(inst);
+    }
+    std::vector<Entity> rooms = InstantiateRooms(reg, prefab, instances, &index);
+    ASSERT_EQ(rooms.size(), 100u);
+    EXPECT_EQ(reg.entityCount(), 100u * prefab.nodeCount());
+    EXPECT_EQ(index.size(), 400u);
+    EXPECT_EQ(reg.count<TexturedRender>(), 50u * 6);
+    EXPECT_EQ(reg.count<ColoredRender>(), 50u * 6);
+    Entity textured = reg.get<Children>(rooms[1])->entities.front();
+    EXPECT_EQ(reg.get<TexturedRender>(textured)->texture, brick.texture);
+    EXPECT_FALSE(reg.has<ColoredRender>(textured));
+
+    // connecting two copies only touches those two
+    transforms.update(reg);
+    Entity right = FindAnchor(reg, rooms[0], AnchorDir::Right);
+    Entity left = FindAnchor(reg, rooms[1], AnchorDir::Left);
+    EXPECT_NE(right, FindAnchor(reg, rooms[2], AnchorDir::Right));
+    ConnectAnchors(reg, right, left, &index);
+    EXPECT_EQ(reg.get<Anchor>(right)->connectedTo, left);
+    EXPECT_EQ(reg.get<Anchor>(FindAnchor(reg, rooms[2], AnchorDir::Right))->connectedTo, INVALID_ENTITY);
+    EXPECT_EQ(index.size(), 398u);
+
+    // world transforms come from the usual pass
+    Entity floor = reg.get<Children>(rooms[7])->entities.front();
+    EXPECT_FLOAT_EQ(reg.get<WorldTransform>(floor)->position.x, 350.0f);
+    EXPECT_FLOAT_EQ(reg.get<WorldTransform>(floor)->position.y, -5.0f);
+}
+
+TEST(PrefabTest, HallwaysPickTheirAxis) {
+    Registry created, stamped;
+    HallwayPrefabs prefabs = MakeHallwayPrefabs();
+    const std::vector<PrefabInstance> instances = {
+        { { 0, 0, 0 }, Vector3{ 8, 10, 30 } },
+        { { 50, 0, 0 }, Vector3{ 30, 10, 8 } },
+        { { 100, 0, 0 }, Vector3{ 6, 12, 9 } },
+        { { 150, 0, 0 }, Vector3{ 4, 10, 40 } }, // shorter than it is wide
+    };
+    const std::vector<AnchorDir> travel = { AnchorDir::Back, AnchorDir::Right, AnchorDir::Front, AnchorDir::Left };
+    std::vector<Entity> halls = InstantiateHallways(stamped, prefabs, instances, travel);
+    ASSERT_EQ(halls.size(), 4u);
+    for (size_t i = 0; i < instances.size(); ++i) {
+        Entity hall = CreateHallway(created, instances[i].position, *instances[i].size, travel[i]);
+        ExpectSameLayout(created, hall, stamped, halls[i]);
+    }
+}
+
+TEST(PrefabTest, CaptureKeepsReferencesInsideTheSubtree) {
+    Registry reg;
+    Entity outside = reg.create();
+    Entity root = reg.create();
+    Entity child = reg.create();
+    reg.add<TransformComp>(root, TransformComp{ { 1, 2, 3 }, { 2, 2, 2 } });
+    reg.add<Parent>(root, Parent{ outside });
+    reg.add<Children>(root, Children{ { child } });
+    reg.add<TransformComp>(child, TransformComp{ { 1, 0, 0 }, { 0.5f, 2, 0.5f } });
+    reg.add<Parent>(child, Parent{ root });
+    reg.add<Anchor>(child, Anchor{ { 1, 0, 0 }, AnchorDir::Right, outside });
+    reg.add<ColoredRender>(child, ColoredRender{ RED });
+
+    // only the listed types are copied
+    Prefab prefab = Prefab::CaptureWith<TransformComp, Parent, Children, Anchor>(reg, root);
+    Entity copy = prefab.instantiate(reg, PrefabInstance{ { 10, 0, 0 }, Vector3{ 4, 2, 2 } });
+    EXPECT_FALSE(reg.has<Parent>(copy));
+    Entity copiedChild = reg.get<Children>(copy)->entities.at(0);
+    EXPECT_NE(copiedChild, child);
+    EXPECT_EQ(reg.get<Parent>(copiedChild)->parent, copy);
+    EXPECT_EQ(reg.get<Anchor>(copiedChild)->connectedTo, INVALID_ENTITY);
+    EXPECT_FALSE(reg.has<ColoredRender>(copiedChild));
+
+    // stretched: x doubled, the child's 0.5 thickness kept, its full-height y follows the root
+    auto t = reg.get<TransformComp>(copiedChild);
+    EXPECT_FLOAT_EQ(t->position.x, 2.0f);
+    EXPECT_FLOAT_EQ(t->size.x, 0.5f);
+    EXPECT_FLOAT_EQ(t->size.y, 2.0f);
+    EXPECT_FLOAT_EQ(reg.get<Anchor>(copiedChild)->localPos.x, 2.0f);
+    // the original is untouched
+    EXPECT_EQ(reg.get<Parent>(root)->parent, outside);
+    EXPECT_EQ(reg.get<Children>(root)->entities.at(0), child);
+}
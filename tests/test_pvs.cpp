@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <sstream>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/anchor.h"
+#include "../include/world/cell_graph.h"
+#include "../include/world/pvs.h"
+#include "../include/render/portal_visibility.h"
+#include "../include/world/room.h"
+
+static Entity AnchorFacing(Registry& reg, Entity room, Vector3 dir) {
+    for (Entity child : reg.get<Children>(room)->entities) {
+        if (auto a = reg.get<Anchor>(child)) {
+            if (Vector3DotProduct(Vector3Normalize(a->direction), dir) > 0.99f) return child;
+        }
+    }
+    return INVALID_ENTITY;
+}
+
+// U-shaped run of rooms: a -> b along +x, b -> c along +z, c -> d along -x
+// d sits right next to a, but every sight line from a would have to turn around
+struct UShapeLevel {
+    Registry reg;
+    TransformSystem transforms;
+    Entity a, b, c, d;
+
+    UShapeLevel() {
+        a = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+        b = CreateRoom(reg, {10, 0, 0}, {10, 5, 10});
+        c = CreateRoom(reg, {10, 0, 10}, {10, 5, 10});
+        d = CreateRoom(reg, {0, 0, 10}, {10, 5, 10});
+        transforms.update(reg);
+
+        ConnectAnchors(reg, AnchorFacing(reg, a, {1, 0, 0}), AnchorFacing(reg, b, {-1, 0, 0}));
+        ConnectAnchors(reg, AnchorFacing(reg, b, {0, 0, 1}), AnchorFacing(reg, c, {0, 0, -1}));
+        ConnectAnchors(reg, AnchorFacing(reg, c, {-1, 0, 0}), AnchorFacing(reg, d, {1, 0, 0}));
+        transforms.update(reg);
+    }
+};
+
+TEST(PvsTest, PortalFlow_DropsCellsBehindATurnAround) {
+    UShapeLevel level;
+    CellGraph graph;
+    graph.build(level.reg);
+    ASSERT_EQ(graph.getCells().size(), 4);
+
+    Pvs pvs = BuildPvs(graph);
+    uint32_t a = graph.cellOf(level.a), b = graph.cellOf(level.b), c = graph.cellOf(level.c), d = graph.cellOf(level.d);
+
+    EXPECT_TRUE(pvs.isVisible(a, a));
+    EXPECT_TRUE(pvs.isVisible(a, b));
+    EXPECT_TRUE(pvs.isVisible(a, c));
+    EXPECT_FALSE(pvs.isVisible(a, d));
+    EXPECT_TRUE(pvs.isVisible(b, d));
+    EXPECT_EQ(pvs.visibleCount(a), 3);
+}
+
+TEST(PvsTest, StraightRow_AllVisible) {
+    Registry reg;
+    TransformSystem transforms;
+    std::vector<Entity> rooms;
+    for (int i = 0; i < 5; ++i) rooms.push_back(CreateRoom(reg, {i * 10.0f, 0, 0}, {10, 5, 10}));
+    transforms.update(reg);
+    for (int i = 0; i + 1 < 5; ++i)
+        ConnectAnchors(reg, AnchorFacing(reg, rooms[i], {1, 0, 0}), AnchorFacing(reg, rooms[i + 1], {-1, 0, 0}));
+    transforms.update(reg);
+
+    CellGraph graph;
+    graph.build(reg);
+    Pvs pvs = BuildPvs(graph);
+    for (uint32_t i = 0; i < pvs.size(); ++i) EXPECT_EQ(pvs.visibleCount(i), 5);
+}
+
+TEST(PvsTest, SameResultForAnyThreadCount) {
+    UShapeLevel level;
+    CellGraph graph;
+    graph.build(level.reg);
+
+    PvsBuildSettings one, many;
+    one.threads = 1;
+    many.threads = 8;
+    Pvs a = BuildPvs(graph, one);
+    Pvs b = BuildPvs(graph, many);
+    for (uint32_t i = 0; i < a.size(); ++i)
+        for (uint32_t j = 0; j < a.size(); ++j) EXPECT_EQ(a.isVisible(i, j), b.isVisible(i, j));
+}
+
+TEST(PvsTest, SaveLoadRoundTrip_AndStaleCheck) {
+    UShapeLevel level;
+    CellGraph graph;
+    graph.build(level.reg);
+    Pvs pvs = BuildPvs(graph);
+
+    const char* path = "test_roundtrip.pvs";
+    ASSERT_TRUE(pvs.save(path));
+    Pvs loaded;
+    ASSERT_TRUE(loaded.load(path));
+    std::remove(path);
+
+    ASSERT_EQ(loaded.size(), pvs.size());
+    EXPECT_TRUE(loaded.matches(graph));
+    for (uint32_t i = 0; i < pvs.size(); ++i)
+        for (uint32_t j = 0; j < pvs.size(); ++j) EXPECT_EQ(loaded.isVisible(i, j), pvs.isVisible(i, j));
+
+    // moving a room makes the file stale
+    level.reg.get<TransformComp>(level.d)->position.y += 50.0f;
+    level.transforms.update(level.reg);
+    graph.build(level.reg);
+    EXPECT_FALSE(loaded.matches(graph));
+}
+
+TEST(PvsTest, LoadRejectsGarbage) {
+    const char* path = "test_garbage.pvs";
+    FILE* f = std::fopen(path, "wb");
+    std::fputs("not a pvs file", f);
+    std::fclose(f);
+
+    Pvs pvs;
+    EXPECT_FALSE(pvs.load(path));
+    EXPECT_TRUE(pvs.empty());
+    std::remove(path);
+}
+
+TEST(PvsTest, PortalSystemUsesMatchingPvsOnly) {
+    UShapeLevel level;
+    CellGraph graph;
+    graph.build(level.reg);
+    Pvs pvs = BuildPvs(graph);
+
+    Camera camera{};
+    camera.position = Vector3{-4, 0, 0};
+    camera.target = Vector3{100, 0, 100};
+    camera.up = Vector3{0, 1, 0};
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    VisibleSet visible;
+    PortalVisibilitySystem portals(camera, visible);
+    portals.setPvs(&pvs);
+    portals.update(level.reg);
+    EXPECT_TRUE(portals.usingPvs());
+    for (uint32_t cell : portals.getVisibleCells()) EXPECT_TRUE(pvs.isVisible(graph.cellOf(level.a), cell));
+
+    Pvs stale;
+    portals.setPvs(&stale);
+    portals.update(level.reg);
+    EXPECT_FALSE(portals.usingPvs());
+}
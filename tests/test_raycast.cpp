@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/entity_utils.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/raycast.h"
+#include "../include/world/room.h"
+
+// random boxes as collidable entities, plus their bounds for brute-force checks
+struct RandomBoxes {
+    Registry reg;
+    std::vector<Entity> entities;
+    std::vector<BoundingBox> bounds;
+
+    explicit RandomBoxes(int count, unsigned seed = 3) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> pos(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> size(0.1f, 10.0f);
+        for (int i = 0; i < count; ++i) {
+            Entity e = reg.create();
+            WorldTransform wt{ { pos(rng), pos(rng), pos(rng) }, { size(rng), size(rng), size(rng) } };
+            reg.add<WorldTransform>(e, wt);
+            reg.add<Collision>(e, Collision{});
+            entities.push_back(e);
+            bounds.push_back(BoundsFromTransform(wt));
+        }
+    }
+};
+
+// plain per-axis slab test, 0 when the ray starts inside
+static float SlabDistance(const Ray& ray, const BoundingBox& b) {
+    float tNear = 0.0f, tFar = INFINITY;
+    const float o[3] = { ray.position.x, ray.position.y, ray.position.z };
+    const float d[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+    const float lo[3] = { b.min.x, b.min.y, b.min.z }, hi[3] = { b.max.x, b.max.y, b.max.z };
+    for (int a = 0; a < 3; ++a) {
+        if (d[a] == 0.0f) {
+            if (o[a] < lo[a] || o[a] > hi[a]) return INFINITY;
+            continue;
+        }
+        float t1 = (lo[a] - o[a]) / d[a], t2 = (hi[a] - o[a]) / d[a];
+        tNear = std::max(tNear, std::min(t1, t2));
+        tFar = std::min(tFar, std::max(t1, t2));
+    }
+    return tNear <= tFar ? tNear : INFINITY;
+}
+
+static Ray RandomRay(std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+    return Ray{ { pos(rng), pos(rng), pos(rng) }, Vector3Normalize({ dir(rng), dir(rng), dir(rng) }) };
+}
+
+TEST(RaycastTest, ClosestHitMatchesBruteForce) {
+    RandomBoxes scene(2000);
+    RaycastQuery query;
+    query.update(scene.reg);
+    ASSERT_EQ(query.boxCount(), 2000u);
+
+    std::mt19937 rng(11);
+    int hits = 0;
+    for (int r = 0; r < 2000; ++r) {
+        Ray ray = RandomRay(rng);
+        float best = INFINITY;
+        for (const BoundingBox& b : scene.bounds) best = std::min(best, SlabDistance(ray, b));
+        RayHit hit = query.closest(ray);
+        ASSERT_EQ(hit.hit(), best != INFINITY) << r;
+        if (!hit.hit()) continue;
+        hits++;
+        EXPECT_NEAR(hit.distance, best, 1e-3f) << r;
+        EXPECT_TRUE(query.any(ray));
+        if (hit.distance > 0.0f) {
+            EXPECT_FALSE(query.any(ray, hit.distance * 0.5f)); // nothing closer than the closest
+        }
+    }
+    EXPECT_GT(hits, 200);
+}
+
+TEST(RaycastTest, ReportsEntityWallSideAndFace) {
+    Registry reg;
+    TransformSystem transformSystem;
+    CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    transformSystem.update(reg);
+    RaycastQuery query;
+    query.update(reg);
+
+    RayHit right = query.closest(Ray{ { 0, 0, 0 }, { 1, 0, 0 } });
+    ASSERT_TRUE(right.hit());
+    EXPECT_TRUE(right.isWall);
+    EXPECT_EQ(right.side, Wall::Side::Right);
+    EXPECT_NEAR(right.distance, 10.0f - 0.05f, 1e-4f);
+    EXPECT_FLOAT_EQ(right.normal.x, -1.0f); // the face looking into the room
+    EXPECT_NEAR(right.point.x, 9.95f, 1e-4f);
+    ASSERT_NE(reg.get<Wall>(right.entity), nullptr);
+
+    RayHit left = query.closest(Ray{ { 0, 0, 0 }, { -3, 0, 0 } }); // direction needn't be normalized
+    EXPECT_EQ(left.side, Wall::Side::Left);
+    EXPECT_NEAR(left.distance, 9.95f, 1e-4f);
+
+    EXPECT_FALSE(query.closest(Ray{ { 0, 0, 0 }, { 1, 0, 0 } }, 5.0f).hit()); // out of range
+    EXPECT_TRUE(query.lineOfSight({ -5, 0, 0 }, { 5, 0, 3 }));
+    EXPECT_FALSE(query.lineOfSight({ 0, 0, 0 }, { 30, 0, 0 })); // through the right wall
+
+    // disabled collision drops out after the next update
+    reg.get<Collision>(right.entity)->enabled = false;
+    query.invalidate();
+    query.update(reg);
+    EXPECT_TRUE(query.lineOfSight({ 0, 0, 0 }, { 30, 0, 0 }));
+}
+
+TEST(RaycastTest, RoomSwappedInOneFrameIsPickedUp) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity room = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    RaycastQuery query;
+    query.update(reg);
+    ASSERT_TRUE(query.closest(Ray{ { 0, 0, 0 }, { 1, 0, 0 } }).hit());
+
+    // one room out, an identical one in: the collider counts don't change
+    DestroyEntityWithChildren(reg, room);
+    Entity moved = CreateRoom(reg, { 100, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    query.update(reg);
+    EXPECT_FALSE(query.closest(Ray{ { 0, 0, 0 }, { 1, 0, 0 } }, 50.0f).hit());
+    RayHit hit = query.closest(Ray{ { 100, 0, 0 }, { 1, 0, 0 } });
+    ASSERT_TRUE(hit.hit());
+    EXPECT_EQ(reg.get<Parent>(hit.entity)->parent, moved);
+}
+
+template <int N>
+static void CheckPackets(const RaycastQuery& query, std::mt19937& rng) {
+    std::uniform_real_distribution<float> len(1.0f, 120.0f);
+    for (int round = 0; round < 300; ++round) {
+        RayPacket<N> packet;
+        Vector3 eye = RandomRay(rng).position; // shared origin like an AI eye
+        for (int i = 0; i < N; ++i) {
+            if (i == N - 1 && round % 3 == 0) continue; // leave a lane unused now and then
+            Ray r = RandomRay(rng);
+            packet.set(i, eye, Vector3Add(eye, Vector3Scale(r.direction, len(rng))));
+        }
+
+        RayHit hits[N];
+        query.closest(packet, hits);
+        uint32_t blocked = query.any(packet);
+        for (int i = 0; i < N; ++i) {
+            if (packet.maxDistance[i] <= 0.0f) {
+                EXPECT_FALSE(hits[i].hit());
+                EXPECT_FALSE(blocked & (1u << i));
+                continue;
+            }
+            Ray ray{ packet.origin[i], packet.direction[i] };
+            RayHit single = query.closest(ray, packet.maxDistance[i]);
+            ASSERT_EQ(hits[i].hit(), single.hit()) << round << " lane " << i;
+            if (single.hit()) {
+                EXPECT_NEAR(hits[i].distance, single.distance, 1e-4f);
+                if (single.distance > 0.0f) { // starting inside several: any of them
+                    EXPECT_EQ(hits[i].entity, single.entity);
+                }
+            }
+            EXPECT_EQ((blocked >> i) & 1u, single.hit() ? 1u : 0u) << round << " lane " << i;
+        }
+    }
+}
+
+TEST(RaycastTest, PacketsMatchSingleRays) {
+    RandomBoxes scene(1500, 5);
+    RaycastQuery query;
+    query.update(scene.reg);
+    std::mt19937 rng(21);
+    CheckPackets<4>(query, rng);
+    CheckPackets<8>(query, rng);
+}
+
+TEST(RaycastTest, SahTreeIsTighterThanMedian) {
+    RandomBoxes scene(3000, 9);
+    Bvh median, sah;
+    median.build(scene.bounds);
+    sah.build(scene.bounds, 4, BvhSplit::Sah);
+
+    // expected ray cost ~ sum of node surface areas (relative to the root)
+    auto cost = [](const Bvh& bvh) {
+        const auto& nodes = bvh.getNodes();
+        float root = BoundsSurfaceArea(nodes[0].bounds()), sum = 0.0f;
+        for (const BvhNode& n : nodes) sum += BoundsSurfaceArea(n.bounds()) * (n.isLeaf() ? n.count : 1);
+        return sum / root;
+    };
+    EXPECT_LT(cost(sah), cost(median));
+
+    // and still answers the same box queries
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> pos(-50.0f, 50.0f);
+    for (int q = 0; q < 100; ++q) {
+        BoundingBox box = BoundsFromCenterSize({ pos(rng), pos(rng), pos(rng) }, { 10, 10, 10 });
+        size_t a = 0, b = 0;
+        median.queryBox(box, [&](uint32_t) { a++; });
+        sah.queryBox(box, [&](uint32_t) { b++; });
+        EXPECT_EQ(a, b);
+    }
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/render_commands.h"
+#include "../include/world/room.h"
+
+static Texture2D FakeTexture(unsigned int id) {
+    Texture2D t{};
+    t.id = id;
+    return t;
+}
+
+TEST(RenderCommandsTest, SortGroupsByMaterial) {
+    RenderCommandBuffer commands;
+    commands.pushTexturedCube({0, 0, 0}, {1, 1, 1}, FakeTexture(2));
+    commands.pushColoredCube({1, 0, 0}, {1, 1, 1}, RED);
+    commands.pushTexturedCube({2, 0, 0}, {1, 1, 1}, FakeTexture(1));
+    commands.pushTexturedCube({3, 0, 0}, {1, 1, 1}, FakeTexture(2));
+    commands.pushColoredCube({4, 0, 0}, {1, 1, 1}, GRAY);
+
+    RecordingBackend unsorted;
+    unsorted.submit(commands);
+    EXPECT_EQ(unsorted.getStats().draws, 5);
+    EXPECT_EQ(unsorted.getStats().stateChanges, 5);
+
+    commands.sort();
+    RecordingBackend sorted;
+    sorted.submit(commands);
+    EXPECT_EQ(sorted.getStats().stateChanges, 3); // colored, texture 1, texture 2
+    EXPECT_EQ(sorted.getStats().vertices, 2 * 36 + 3 * 24);
+
+    // equal keys keep submission order
+    const auto& packets = commands.getPackets();
+    EXPECT_FLOAT_EQ(packets[0].position.x, 1);
+    EXPECT_FLOAT_EQ(packets[1].position.x, 4);
+}
+
+TEST(RenderCommandsTest, RadixSortMatchesStableSort) {
+    std::mt19937_64 rng(99);
+    std::vector<DrawPacket> packets(5000);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].sortKey = rng() & 0xF0FF'FFFF'0000'FF00ull; // a few constant bytes to hit the skip path
+        packets[i].vertexCount = static_cast<uint32_t>(i);  // identifies the original order
+    }
+    // plenty of duplicates to check stability
+    for (size_t i = 0; i < packets.size(); i += 3) packets[i].sortKey = packets[0].sortKey;
+
+    std::vector<DrawPacket> expected = packets;
+    std::stable_sort(expected.begin(), expected.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.sortKey < b.sortKey; });
+
+    PacketSortScratch scratch;
+    RadixSortPackets(packets, scratch);
+    ASSERT_EQ(packets.size(), expected.size());
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ASSERT_EQ(packets[i].sortKey, expected[i].sortKey);
+        ASSERT_EQ(packets[i].vertexCount, expected[i].vertexCount);
+    }
+}
+
+TEST(RenderCommandsTest, OpaqueFrontToBack_TransparentBackToFrontAndLast) {
+    RenderCommandBuffer commands;
+    commands.setView({0, 0, 0}, 100.0f);
+    commands.pushColoredCube({0, 0, -50}, {1, 1, 1}, Color{255, 0, 0, 128});
+    commands.pushColoredCube({0, 0, -30}, {1, 1, 1}, GRAY);
+    commands.pushColoredCube({0, 0, -10}, {1, 1, 1}, Color{255, 0, 0, 128});
+    commands.pushColoredCube({0, 0, -5}, {1, 1, 1}, GRAY);
+    commands.sort();
+
+    const auto& p = commands.getPackets();
+    EXPECT_FLOAT_EQ(p[0].position.z, -5);  // opaque, near first
+    EXPECT_FLOAT_EQ(p[1].position.z, -30);
+    EXPECT_FLOAT_EQ(p[2].position.z, -50); // transparent, far first
+    EXPECT_FLOAT_EQ(p[3].position.z, -10);
+}
+
+TEST(RenderCommandsTest, SortingCutsTextureBinds) {
+    RenderCommandBuffer commands;
+    commands.setView({0, 0, 0});
+    for (int i = 0; i < 30; ++i)
+        commands.pushTexturedCube({static_cast<float>(i), 0, 0}, {1, 1, 1}, FakeTexture(1 + i % 3));
+
+    RecordingBackend backend;
+    backend.submit(commands);
+    EXPECT_EQ(backend.getStats().textureBinds, 30);
+
+    commands.sort();
+    backend.submit(commands);
+    EXPECT_EQ(backend.getStats().textureBinds, 3);
+    EXPECT_EQ(backend.getTotals().textureBinds, 33);
+
+    // still front-to-back within one texture
+    const auto& p = commands.getPackets();
+    for (size_t i = 1; i < p.size(); ++i) {
+        if (p[i].texture.id == p[i - 1].texture.id) {
+            EXPECT_GT(p[i].position.x, p[i - 1].position.x);
+        }
+    }
+}
+
+TEST(RenderCommandsTest, DrawSystemEmitsOnePacketPerWall) {
+    Registry reg;
+    TransformSystem transforms;
+    CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    transforms.update(reg);
+
+    RecordingBackend backend;
+    backend.keepPackets = true;
+    DrawSystem draw(nullptr, &backend);
+    draw.update(reg);
+
+    EXPECT_EQ(backend.getStats().draws, 6); // anchors are not drawn
+    EXPECT_EQ(backend.getStats().stateChanges, 1);
+    EXPECT_EQ(backend.getRecorded().size(), 6);
+    for (const auto& p : backend.getRecorded()) EXPECT_EQ(p.kind, MeshKind::ColoredCube);
+}
+
+TEST(RenderCommandsTest, BakedRoomIsOneDrawPerBatch) {
+    Registry reg;
+    TransformSystem transforms;
+    MeshBakeSystem baker;
+    Entity room = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    transforms.update(reg);
+    EnableMeshBaking(reg, room);
+    baker.update(reg);
+
+    RecordingBackend backend;
+    DrawSystem draw(nullptr, &backend);
+    draw.update(reg);
+
+    EXPECT_EQ(backend.getStats().draws, reg.get<BakedMesh>(room)->batches.size());
+    EXPECT_EQ(backend.getStats().vertices, reg.get<BakedMesh>(room)->vertexCount());
+}
+
+TEST(RenderCommandsTest, DrawSystemRespectsVisibleSet) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity room = CreateRoom(reg, {0, 0, 0}, {10, 5, 10});
+    transforms.update(reg);
+
+    VisibleSet visible;
+    visible.valid = true;
+    visible.entities = { reg.get<Children>(room)->entities[0], reg.get<Children>(room)->entities[1] };
+
+    RecordingBackend backend;
+    DrawSystem draw(&visible, &backend);
+    draw.update(reg);
+    EXPECT_EQ(backend.getStats().draws, 2);
+    EXPECT_EQ(backend.frameCount(), 1);
+}
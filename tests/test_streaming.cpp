@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/culling.h"
+#include "../include/render/occlusion.h"
+#include "../include/render/portal_visibility.h"
+#include "../include/spatial/bounds.h"
+#include "../include/spatial/collision.h"
+#include "../include/spatial/raycast.h"
+#include "../include/world/anchor.h"
+#include "../include/world/dungeon.h"
+#include "../include/world/streaming.h"
+
+static DungeonLayout StreamingLayout() {
+    DungeonSettings settings;
+    settings.rooms = 300;
+    settings.regionRooms = 50;
+    settings.seed = 49;
+    return GenerateDungeonLayout(settings);
+}
+
+static StreamingSettings SmallCells() {
+    StreamingSettings settings;
+    settings.cellSize = 600.0f;
+    settings.loadRadius = 800.0f;
+    settings.unloadMargin = 200.0f;
+    settings.threads = 0;
+    settings.chunkRoots = 16;
+    return settings;
+}
+
+static float DistanceToRoom(Vector3 p, const DungeonRoom& room) {
+    BoundingBox b = BoundsFromCenterSize(room.position, room.size);
+    Vector3 d{ std::max({ b.min.x - p.x, 0.0f, p.x - b.max.x }), std::max({ b.min.y - p.y, 0.0f, p.y - b.max.y }),
+               std::max({ b.min.z - p.z, 0.0f, p.z - b.max.z }) };
+    return Vector3Length(d);
+}
+
+// side + local box of every wall piece, sorted
+static std::vector<std::tuple<int, float, float, float, float, float, float>> WallPieces(Registry& reg, Entity owner) {
+    std::vector<std::tuple<int, float, float, float, float, float, float>> pieces;
+    for (Entity child : reg.get<Children>(owner)->entities) {
+        auto wall = reg.get<Wall>(child);
+        if (!wall) continue;
+        auto t = reg.get<TransformComp>(child);
+        pieces.emplace_back(static_cast<int>(wall->side), t->position.x, t->position.y, t->position.z, t->size.x, t->size.y, t->size.z);
+    }
+    std::sort(pieces.begin(), pieces.end());
+    return pieces;
+}
+
+// nothing points at a destroyed anchor
+static void ExpectLinksAlive(Registry& reg) {
+    for (const auto& [e, anchor] : reg.view<Anchor>())
+        if (anchor->connectedTo != INVALID_ENTITY) {
+            auto other = reg.get<Anchor>(anchor->connectedTo);
+            ASSERT_NE(other, nullptr);
+            EXPECT_EQ(other->connectedTo, e);
+        }
+}
+
+TEST(StreamingTest, LoadsTheSameRoomsBuildDungeonWould) {
+    DungeonLayout layout = StreamingLayout();
+    Registry full;
+    TransformSystem transforms;
+    DungeonEntities built = BuildDungeon(full, transforms, layout);
+
+    Registry reg;
+    StreamingWorld world(layout, SmallCells());
+    const Vector3 camera = layout.rooms[0].position;
+    world.finish(reg, camera);
+    EXPECT_GT(world.cellCount(), 4u);
+    EXPECT_GT(world.getStats().residentCells, 0u);
+    EXPECT_EQ(world.getStats().pendingCells, 0u);
+
+    size_t resident = 0;
+    for (size_t r = 0; r < layout.rooms.size(); ++r) {
+        Entity room = world.room(r);
+        if (DistanceToRoom(camera, layout.rooms[r]) <= 800.0f) {
+            EXPECT_NE(room, INVALID_ENTITY) << "room " << r;
+        }
+        if (room == INVALID_ENTITY) continue;
+        resident++;
+        // same position, same doorways
+        auto t = reg.get<TransformComp>(room);
+        EXPECT_EQ(t->position.x, layout.rooms[r].position.x);
+        EXPECT_EQ(t->position.z, layout.rooms[r].position.z);
+        auto mine = WallPieces(reg, room), theirs = WallPieces(full, built.rooms[r]);
+        ASSERT_EQ(mine.size(), theirs.size()) << "room " << r;
+        for (size_t i = 0; i < mine.size(); ++i) {
+            EXPECT_EQ(std::get<0>(mine[i]), std::get<0>(theirs[i]));
+            EXPECT_NEAR(std::get<1>(mine[i]), std::get<1>(theirs[i]), 1e-3f);
+            EXPECT_NEAR(std::get<2>(mine[i]), std::get<2>(theirs[i]), 1e-3f);
+            EXPECT_NEAR(std::get<3>(mine[i]), std::get<3>(theirs[i]), 1e-3f);
+            EXPECT_NEAR(std::get<4>(mine[i]), std::get<4>(theirs[i]), 1e-3f);
+            EXPECT_NEAR(std::get<5>(mine[i]), std::get<5>(theirs[i]), 1e-3f);
+            EXPECT_NEAR(std::get<6>(mine[i]), std::get<6>(theirs[i]), 1e-3f);
+        }
+    }
+    EXPECT_GT(resident, 0u);
+    EXPECT_LT(resident, layout.rooms.size());
+    EXPECT_EQ(world.loaded().size(), reg.count<AnchorSlots>()); // every room and hallway came in this call
+
+    // hallways whose rooms are both here are linked on both ends
+    size_t linked = 0;
+    for (size_t h = 0; h < layout.halls.size(); ++h) {
+        const DungeonHall& hall = layout.halls[h];
+        if (world.hall(h) == INVALID_ENTITY || world.room(hall.from) == INVALID_ENTITY) continue;
+        Entity roomAnchor = FindAnchor(reg, world.room(hall.from), hall.side);
+        Entity hallAnchor = FindAnchor(reg, world.hall(h), OppositeDir(hall.side));
+        EXPECT_EQ(reg.get<Anchor>(roomAnchor)->connectedTo, hallAnchor);
+        linked++;
+    }
+    EXPECT_GT(linked, 0u);
+    ExpectLinksAlive(reg);
+}
+
+TEST(StreamingTest, WalkingAcrossTheWorldKeepsTheRegistrySmall) {
+    DungeonLayout layout = StreamingLayout();
+    Registry reg;
+    StreamingWorld world(layout, SmallCells());
+
+    size_t everything = 0;
+    {
+        Registry full;
+        TransformSystem transforms;
+        BuildDungeon(full, transforms, layout);
+        everything = full.entityCount();
+    }
+
+    // room to room along the layout, then back to the start
+    world.finish(reg, layout.rooms[0].position);
+    std::vector<size_t> atStart;
+    for (size_t r = 0; r < layout.rooms.size(); ++r)
+        if (world.room(r) != INVALID_ENTITY) atStart.push_back(r);
+    size_t most = 0;
+    for (size_t r = 0; r < layout.rooms.size(); r += 7) {
+        world.finish(reg, layout.rooms[r].position);
+        most = std::max(most, reg.entityCount());
+        ExpectLinksAlive(reg);
+        if (HasFatalFailure()) return;
+    }
+    // back at the start: the same rooms again (plus whatever is still inside the unload margin)
+    world.finish(reg, layout.rooms[0].position);
+    for (size_t r : atStart) {
+        EXPECT_NE(world.room(r), INVALID_ENTITY) << "room " << r;
+    }
+    for (size_t r = 0; r < layout.rooms.size(); ++r)
+        if (world.room(r) != INVALID_ENTITY) {
+            EXPECT_TRUE(reg.has<AnchorSlots>(world.room(r)));
+        }
+    EXPECT_LE(reg.entityCount(), most);
+    EXPECT_LT(most, everything / 2);
+}
+
+TEST(StreamingTest, ColliderCachesFollowTheLoadedCells) {
+    DungeonLayout layout = StreamingLayout();
+    StreamingSettings settings = SmallCells();
+    settings.chunkRoots = 4;
+    Registry reg;
+    TransformSystem transforms;
+    CollisionSystem collision;
+    RaycastQuery raycast;
+    StreamingWorld world(layout, settings);
+
+    // the game loop's order: stream, place, publish, then the caches
+    size_t changed = 0;
+    for (size_t r = 0; r < layout.rooms.size(); r += 5) {
+        world.update(reg, layout.rooms[r].position);
+        transforms.update(reg);
+        world.invalidate(collision, raycast);
+        collision.update(reg);
+        raycast.update(reg);
+        changed += world.changedRegistry();
+
+        ASSERT_EQ(collision.colliderCount(), reg.count<Collision>()) << "room " << r;
+        ASSERT_EQ(raycast.boxCount(), reg.count<Collision>()) << "room " << r;
+        // a resident room's floor is where the caches say it is
+        for (size_t q = 0; q < layout.rooms.size(); ++q) {
+            if (world.room(q) == INVALID_ENTITY) continue;
+            Vector3 above = Vector3Add(layout.rooms[q].position, { 0.5f, 0, 0.5f });
+            RayHit hit = raycast.closest(Ray{ above, { 0, -1, 0 } });
+            ASSERT_TRUE(hit.hit()) << "room " << q;
+            EXPECT_EQ(reg.get<Parent>(hit.entity)->parent, world.room(q));
+            break;
+        }
+    }
+    EXPECT_GT(changed, 1u);
+}
+
+TEST(StreamingTest, RenderCachesFollowUnloadsAndMergesInOneStep) {
+    DungeonLayout layout = StreamingLayout();
+    StreamingSettings settings = SmallCells();
+    settings.frameBudgetMs = 1000.0; // every unload and merge of a move in the same update()
+    Registry reg;
+    TransformSystem transforms;
+    StreamingWorld world(layout, settings);
+
+    Camera camera{};
+    camera.up = { 0, 1, 0 };
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    VisibleSet culled, portalVisible;
+    CullingSystem culling(camera, culled);
+    PortalVisibilitySystem portals(camera, portalVisible);
+    OcclusionCullingSystem occlusion(camera, portalVisible);
+
+    // nothing told about the streaming: registry revisions are enough
+    size_t sameStep = 0;
+    for (size_t r = 0; r < layout.rooms.size(); r += 7) {
+        camera.position = layout.rooms[r].position;
+        camera.target = Vector3Add(camera.position, { 1, 0, 0 });
+        world.update(reg, camera.position);
+        transforms.update(reg);
+        culling.update(reg);
+        portals.update(reg);
+        occlusion.update(reg);
+        const StreamingStats& stats = world.getStats();
+        sameStep += stats.unloadedCells > 0 && stats.mergedChunks > 0;
+
+        size_t drawables = 0;
+        for (const auto& [e, wt] : reg.view<WorldTransform>()) drawables += IsDrawable(reg, e);
+        ASSERT_EQ(culling.drawableCount(), drawables) << "room " << r;
+        ASSERT_EQ(portals.getGraph().getCells().size(), reg.count<AnchorSlots>()) << "room " << r;
+        for (const VisibleSet* set : { &culled, &portalVisible })
+            for (Entity e : set->entities) ASSERT_TRUE(reg.has<WorldTransform>(e)) << "room " << r;
+        // the camera's room is the cell the walk starts from
+        ASSERT_GE(portals.currentCell(), 0) << "room " << r;
+        EXPECT_EQ(portals.getGraph().getCells()[portals.currentCell()].entity, world.room(r)) << "room " << r;
+    }
+    EXPECT_GT(sameStep, 0u);
+}
+
+TEST(StreamingTest, MergesWithinTheFrameBudget) {
+    DungeonLayout layout = StreamingLayout();
+    StreamingSettings settings = SmallCells();
+    settings.frameBudgetMs = 0.0; // one merge or unload per update
+    settings.chunkRoots = 4;
+    Registry reg;
+    StreamingWorld world(layout, settings);
+
+    int updates = 0;
+    do {
+        world.update(reg, layout.rooms[0].position);
+        EXPECT_LE(world.getStats().mergedChunks + world.getStats().unloadedCells, 1u);
+        updates++;
+    } while (world.getStats().pendingCells > 0 && updates < 10000);
+    EXPECT_GT(updates, 2);
+    EXPECT_EQ(world.getStats().pendingCells, 0u);
+
+    // the same set as loading it in one go
+    Registry other;
+    StreamingWorld oneGo(layout, SmallCells());
+    oneGo.finish(other, layout.rooms[0].position);
+    EXPECT_EQ(reg.entityCount(), other.entityCount());
+}
+
+TEST(StreamingTest, BackgroundBuildsAndCancels) {
+    DungeonLayout layout = StreamingLayout();
+    StreamingSettings settings = SmallCells();
+    settings.threads = 1;
+    Registry reg;
+    StreamingWorld world(layout, settings);
+
+    // ask for the far end, then turn around before it's merged
+    world.update(reg, layout.rooms.back().position);
+    world.finish(reg, layout.rooms[0].position);
+    EXPECT_EQ(world.getStats().pendingCells, 0u);
+    for (size_t r = 0; r < layout.rooms.size(); ++r)
+        if (world.room(r) != INVALID_ENTITY) {
+            // within the keep radius, give or take a cell
+            EXPECT_LE(DistanceToRoom(layout.rooms[0].position, layout.rooms[r]), 800.0f + 200.0f + 2 * 600.0f);
+        }
+
+    Registry inline_;
+    StreamingWorld same(layout, SmallCells());
+    same.finish(inline_, layout.rooms[0].position);
+    EXPECT_EQ(reg.entityCount(), inline_.entityCount());
+    ExpectLinksAlive(reg);
+}
+
+TEST(StreamingTest, GraphRadiusFollowsHallways) {
+    DungeonLayout layout = StreamingLayout();
+    StreamingSettings settings = SmallCells();
+    settings.loadRadius = -1.0f; // graph only
+    settings.unloadMargin = 0.0f;
+    settings.graphRadius = 0;
+    Registry reg;
+    StreamingWorld world(layout, settings);
+    world.finish(reg, layout.rooms[0].position);
+    EXPECT_EQ(world.getStats().residentCells, 1u);
+    EXPECT_NE(world.room(0), INVALID_ENTITY);
+
+    settings.graphRadius = 1;
+    Registry wider;
+    StreamingWorld hops(layout, settings);
+    hops.finish(wider, layout.rooms[0].position);
+    EXPECT_GT(hops.getStats().residentCells, 1u);
+    // every hallway out of room 0 leads somewhere resident
+    for (size_t h = 0; h < layout.halls.size(); ++h)
+        if (layout.halls[h].from == 0 || layout.halls[h].to == 0) {
+            EXPECT_NE(hops.room(layout.halls[h].from), INVALID_ENTITY);
+            EXPECT_NE(hops.room(layout.halls[h].to), INVALID_ENTITY);
+        }
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/render/mesh_baker.h"
+#include "../include/render/render_commands.h"
+#include "../include/textures/texture_atlas.h"
+#include "../include/world/room.h"
+
+TEST(TextureAtlasTest, LayoutIsNearSquare) {
+    AtlasLayout one(1, 64, 4);
+    EXPECT_EQ(one.columns, 1);
+    EXPECT_EQ(one.width(), 72);
+
+    AtlasLayout five(5, 64, 4);
+    EXPECT_EQ(five.columns, 3);
+    EXPECT_EQ(five.rows, 2);
+    EXPECT_EQ(five.width(), 3 * 72);
+    EXPECT_EQ(five.height(), 2 * 72);
+
+    Rectangle s = five.source(4); // second row, second column
+    EXPECT_FLOAT_EQ(s.x, 72 + 4);
+    EXPECT_FLOAT_EQ(s.y, 72 + 4);
+    EXPECT_FLOAT_EQ(s.width, 64);
+
+    // flipped like the default TexturedRender::uv
+    Rectangle uv = five.uv(4);
+    EXPECT_FLOAT_EQ(uv.x, 76.0f / 216);
+    EXPECT_FLOAT_EQ(uv.y, 140.0f / 144);
+    EXPECT_FLOAT_EQ(uv.height, -64.0f / 144);
+}
+
+TEST(TextureAtlasTest, BlitClampsPaddingToTileEdges) {
+    AtlasLayout layout(2, 2, 1); // 2 tiles of 2x2, cells of 4x4, atlas 8x4
+    const uint8_t tile[16] = { 1, 1, 1, 1,  2, 2, 2, 2,
+                               3, 3, 3, 3,  4, 4, 4, 4 };
+    std::vector<uint8_t> atlas(static_cast<size_t>(layout.width()) * layout.height() * 4, 0);
+    BlitAtlasTile(layout, 1, tile, atlas.data());
+
+    auto at = [&](int x, int y) { return atlas[(static_cast<size_t>(y) * layout.width() + x) * 4]; };
+    EXPECT_EQ(at(0, 0), 0); // first cell untouched
+    EXPECT_EQ(at(5, 1), 1); // tile pixels
+    EXPECT_EQ(at(6, 1), 2);
+    EXPECT_EQ(at(5, 2), 3);
+    EXPECT_EQ(at(6, 2), 4);
+    EXPECT_EQ(at(4, 0), 1); // corner padding repeats the corner pixel
+    EXPECT_EQ(at(7, 3), 4);
+    EXPECT_EQ(at(7, 1), 2); // side padding repeats the edge
+}
+
+TEST(TextureAtlasTest, MaterialsShareOneTexture) {
+    AssetCache assets;
+    TextureAtlas atlas(32, 2);
+    int stone = atlas.add(GenImageColor(32, 32, GRAY));
+    int brick = atlas.add(GenImageColor(16, 16, RED)); // resized to the tile size
+    ASSERT_EQ(stone, 0);
+    ASSERT_EQ(brick, 1);
+    ASSERT_TRUE(atlas.build(assets));
+    EXPECT_EQ(atlas.add(GenImageColor(32, 32, RED)), -1); // too late
+
+    TexturedRender a = atlas.material(stone);
+    TexturedRender b = atlas.material(brick);
+    EXPECT_EQ(a.texture, b.texture);
+    EXPECT_TRUE(a.isSubRegion());
+    EXPECT_NE(a.uv.x, b.uv.x);
+    EXPECT_FALSE(TexturedRender{}.isSubRegion());
+
+    // rooms of both materials: one texture bind for every wall, one baked batch per room
+    Registry reg;
+    TransformSystem transforms;
+    Entity r1 = CreateRoom(reg, {0, 0, 0}, {10, 5, 10}, a);
+    CreateRoom(reg, {20, 0, 0}, {10, 5, 10}, b);
+    transforms.update(reg);
+
+    RecordingBackend backend;
+    DrawSystem draw(nullptr, &backend);
+    draw.setAssets(&assets);
+    draw.update(reg);
+    EXPECT_EQ(backend.getStats().draws, 12);
+    EXPECT_EQ(backend.getStats().textureBinds, 1);
+
+    BakedMesh mesh = BakeRoomMesh(reg, r1);
+    ASSERT_EQ(mesh.batches.size(), 1);
+    // atlas tiles are not repeated, every texcoord stays inside the tile
+    const Rectangle& uv = a.uv;
+    for (size_t i = 0; i < mesh.batches[0].texcoords.size(); i += 2) {
+        EXPECT_GE(mesh.batches[0].texcoords[i], uv.x - 1e-5f);
+        EXPECT_LE(mesh.batches[0].texcoords[i], uv.x + uv.width + 1e-5f);
+        EXPECT_LE(mesh.batches[0].texcoords[i + 1], uv.y + 1e-5f);
+        EXPECT_GE(mesh.batches[0].texcoords[i + 1], uv.y + uv.height - 1e-5f);
+    }
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+#include "../include/core/thread_pool.h"
+#include "../include/textures/cooked_texture.h"
+#include "../include/textures/managed_texture.h"
+#include "../include/textures/texture_cooker.h"
+
+using namespace texture_cooker;
+
+static std::vector<uint8_t> SolidBlock(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    std::vector<uint8_t> px(64);
+    for (int i = 0; i < 16; ++i) {
+        px[i * 4] = r; px[i * 4 + 1] = g; px[i * 4 + 2] = b; px[i * 4 + 3] = a;
+    }
+    return px;
+}
+
+static int MaxChannelError(const std::vector<uint8_t>& a, const uint8_t* b, int channels) {
+    int worst = 0;
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < channels; ++c) worst = std::max(worst, std::abs(a[i * 4 + c] - b[i * 4 + c]));
+    return worst;
+}
+
+// pseudo-random but fixed RGBA8 pixels
+static Image NoiseImage(int w, int h, bool alpha) {
+    Image image = GenImageColor(w, h, WHITE);
+    auto* px = static_cast<uint8_t*>(image.data);
+    uint32_t seed = 12345;
+    for (int i = 0; i < w * h * 4; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        px[i] = (!alpha && (i & 3) == 3) ? 255 : static_cast<uint8_t>(seed >> 24);
+    }
+    return image;
+}
+
+TEST(TextureCookerTest, Bc1SolidBlockIsExact) {
+    // 565-representable color (every channel survives the 5/6 bit round trip)
+    auto px = SolidBlock(255, 0, 132, 255);
+    uint8_t block[8], out[64];
+    EncodeBc1Block(px.data(), block);
+    DecodeBc1Block(block, out);
+    EXPECT_EQ(MaxChannelError(px, out, 4), 0);
+}
+
+TEST(TextureCookerTest, Bc1GradientStaysClose) {
+    std::vector<uint8_t> px(64);
+    for (int i = 0; i < 16; ++i) {
+        px[i * 4] = static_cast<uint8_t>(40 + i * 10);
+        px[i * 4 + 1] = static_cast<uint8_t>(200 - i * 8);
+        px[i * 4 + 2] = 90;
+        px[i * 4 + 3] = 255;
+    }
+    uint8_t block[8], out[64];
+    EncodeBc1Block(px.data(), block);
+    DecodeBc1Block(block, out);
+    EXPECT_LE(MaxChannelError(px, out, 3), 24); // 16 values on a line, 4 palette steps
+    // 4-color mode (c0 > c1), no accidental punch-through alpha
+    EXPECT_GT(block[0] | (block[1] << 8), block[2] | (block[3] << 8));
+}
+
+TEST(TextureCookerTest, Bc3KeepsAlpha) {
+    std::vector<uint8_t> px = SolidBlock(10, 20, 30, 255);
+    for (int i = 0; i < 16; ++i) px[i * 4 + 3] = static_cast<uint8_t>(i * 17); // 0..255
+    uint8_t block[16], out[64];
+    EncodeBc3Block(px.data(), block);
+    DecodeBc3Block(block, out);
+    for (int i = 0; i < 16; ++i) EXPECT_LE(std::abs(out[i * 4 + 3] - px[i * 4 + 3]), 19) << i;
+}
+
+TEST(TextureCookerTest, MipChainStopsAtWholeBlocks) {
+    Image image = NoiseImage(64, 32, false);
+    CookedTexture cooked = CookTexture(image);
+    EXPECT_EQ(cooked.format, PIXELFORMAT_COMPRESSED_DXT1_RGB);
+    EXPECT_EQ(cooked.mipmaps, 4); // 64x32, 32x16, 16x8, 8x4
+
+    size_t expected = 0;
+    for (int l = 0; l < cooked.mipmaps; ++l) expected += GetPixelDataSize(64 >> l, 32 >> l, cooked.format);
+    EXPECT_EQ(cooked.data.size(), expected); // the layout raylib expects
+    UnloadImage(image);
+
+    Image translucent = NoiseImage(16, 16, true);
+    EXPECT_EQ(CookTexture(translucent).format, PIXELFORMAT_COMPRESSED_DXT5_RGBA);
+    UnloadImage(translucent);
+}
+
+TEST(TextureCookerTest, MipsFilterInLinearLight) {
+    // black/white checker: the average is half the light, which is ~188 in sRGB (not 128)
+    Image image = GenImageColor(16, 16, BLACK);
+    auto* px = static_cast<uint8_t*>(image.data);
+    for (int y = 0; y < 16; ++y)
+        for (int x = 0; x < 16; ++x)
+            if ((x + y) & 1) std::memset(px + (y * 16 + x) * 4, 255, 3);
+
+    FloatImage level = ToFloat(px, 16, 16, true);
+    level = Downsample(level);
+    std::vector<uint8_t> bytes = ToBytes(level, true);
+    EXPECT_NEAR(bytes[(4 * 8 + 4) * 4], 188, 2);
+    UnloadImage(image);
+}
+
+TEST(TextureCookerTest, OutputDoesNotDependOnThreads) {
+    Image image = NoiseImage(128, 64, true);
+    CookedTexture single = CookTexture(image);
+    ThreadPool pool(4);
+    CookedTexture threaded = CookTexture(image, {}, &pool);
+    EXPECT_EQ(single.data, threaded.data);
+    UnloadImage(image);
+}
+
+TEST(TextureCookerTest, CtexRoundTrip) {
+    Image image = NoiseImage(32, 32, false);
+    CookedTexture cooked = CookTexture(image);
+    UnloadImage(image);
+
+    const char* path = "cooker_test.ctex";
+    ASSERT_TRUE(SaveCookedTexture(cooked, path));
+
+    Image loaded = LoadCookedImage(path);
+    ASSERT_NE(loaded.data, nullptr);
+    EXPECT_EQ(loaded.width, 32);
+    EXPECT_EQ(loaded.mipmaps, cooked.mipmaps);
+    EXPECT_EQ(loaded.format, cooked.format);
+    EXPECT_EQ(std::memcmp(loaded.data, cooked.data.data(), cooked.data.size()), 0);
+    UnloadImage(loaded);
+
+    // ManagedTexture takes .ctex paths directly
+    ManagedTexture texture(path);
+    EXPECT_TRUE(texture.isReady());
+    EXPECT_EQ(texture.get().width, 32);
+    std::remove(path);
+
+    EXPECT_EQ(LoadCookedImage("does_not_exist.ctex").data, nullptr);
+}
+
+TEST(TextureCookerTest, BrokenCtexIsRejected) {
+    Image image = NoiseImage(32, 32, false);
+    CookedTexture cooked = CookTexture(image);
+    UnloadImage(image);
+    EXPECT_EQ(CookedMipChainSize(cooked.width, cooked.height, cooked.mipmaps, cooked.format), cooked.data.size());
+
+    // the file cut short, then a header that agrees with the cut (too little for its mips), then a format the
+    // cooker never writes
+    const char* path = "cooker_broken.ctex";
+    ASSERT_TRUE(SaveCookedTexture(cooked, path));
+    std::filesystem::resize_file(path, sizeof(CookedTextureHeader) + cooked.data.size() / 2);
+    EXPECT_EQ(LoadCookedImage(path).data, nullptr);
+
+    FILE* f = std::fopen(path, "wb");
+    ASSERT_NE(f, nullptr);
+    CookedTextureHeader header;
+    header.width = cooked.width;
+    header.height = cooked.height;
+    header.mipmaps = cooked.mipmaps;
+    header.format = cooked.format;
+    header.dataSize = cooked.data.size() - 8;
+    std::fwrite(&header, sizeof(header), 1, f);
+    std::fwrite(cooked.data.data(), 1, header.dataSize, f);
+    std::fclose(f);
+    EXPECT_EQ(LoadCookedImage(path).data, nullptr);
+
+    CookedTexture broken = cooked;
+    broken.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    ASSERT_TRUE(SaveCookedTexture(broken, path));
+    EXPECT_EQ(LoadCookedImage(path).data, nullptr);
+    std::remove(path);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/world/doorway.h"
+#include "../include/world/wall_builder.h"
+
+static bool Inside(const Rectangle& r, float x, float y) {
+    return x > r.x && x < r.x + r.width && y > r.y && y < r.y + r.height;
+}
+
+// exact cover, checked on the grid made by every edge involved: each cell is covered by exactly one rectangle if it's
+// solid (in the wall, outside every opening) and by none otherwise... rectangles only use input coordinates, so
+// checking cell centres is enough
+static void ExpectExactCover(Rectangle wall, const std::vector<Rectangle>& openings, const std::vector<Rectangle>& rects) {
+    std::vector<float> xs = { wall.x, wall.x + wall.width }, ys = { wall.y, wall.y + wall.height };
+    for (const auto* list : { &openings, &rects })
+        for (const Rectangle& r : *list) {
+            xs.insert(xs.end(), { r.x, r.x + r.width });
+            ys.insert(ys.end(), { r.y, r.y + r.height });
+        }
+    std::sort(xs.begin(), xs.end());
+    std::sort(ys.begin(), ys.end());
+    for (const Rectangle& r : rects) {
+        EXPECT_GT(r.width, 0.0f);
+        EXPECT_GT(r.height, 0.0f);
+        EXPECT_GE(r.x, wall.x);
+        EXPECT_GE(r.y, wall.y);
+        EXPECT_LE(r.x + r.width, wall.x + wall.width);
+        EXPECT_LE(r.y + r.height, wall.y + wall.height);
+    }
+    for (size_t j = 0; j + 1 < ys.size(); ++j) {
+        if (ys[j] == ys[j + 1]) continue;
+        for (size_t i = 0; i + 1 < xs.size(); ++i) {
+            if (xs[i] == xs[i + 1]) continue;
+            float cx = (xs[i] + xs[i + 1]) * 0.5f, cy = (ys[j] + ys[j + 1]) * 0.5f;
+            bool solid = Inside(wall, cx, cy) &&
+                         std::none_of(openings.begin(), openings.end(), [&](const Rectangle& o) { return Inside(o, cx, cy); });
+            int covered = static_cast<int>(std::count_if(rects.begin(), rects.end(), [&](const Rectangle& r) { return Inside(r, cx, cy); }));
+            ASSERT_EQ(covered, solid ? 1 : 0) << "cell centre " << cx << ", " << cy;
+        }
+    }
+}
+
+// exhaustive minimum partition of a w x h cell grid (bit j * w + i set = solid)
+// the lowest uncovered cell in row-major order has to be the bottom-left corner of its rectangle
+static int BruteForceMinimum(uint32_t cells, int w, int h, std::unordered_map<uint32_t, int>& memo) {
+    if (cells == 0) return 0;
+    if (auto it = memo.find(cells); it != memo.end()) return it->second;
+    int first = __builtin_ctz(cells);
+    int i0 = first % w, j0 = first / w;
+    int best = 1 << 20;
+    for (int i1 = i0; i1 < w && (cells >> (j0 * w + i1) & 1); ++i1) {
+        uint32_t rect = 0;
+        for (int j1 = j0; j1 < h; ++j1) {
+            uint32_t row = 0;
+            for (int i = i0; i <= i1; ++i) row |= 1u << (j1 * w + i);
+            if ((cells & row) != row) break;
+            rect |= row;
+            best = std::min(best, 1 + BruteForceMinimum(cells & ~rect, w, h, memo));
+        }
+    }
+    memo[cells] = best;
+    return best;
+}
+
+TEST(WallBuilderTest, SimpleShapes) {
+    const Rectangle wall{ 0, 0, 20, 10 };
+    std::vector<Rectangle> openings;
+    EXPECT_EQ(DecomposeWall(wall, openings).size(), 1u);
+
+    // door from the floor: left, right, lintel
+    openings = { { 9, 0, 2, 6 } };
+    std::vector<Rectangle> rects = DecomposeWall(wall, openings);
+    ASSERT_EQ(rects.size(), 3u);
+    EXPECT_FLOAT_EQ(rects[0].width, 9.0f);
+    EXPECT_FLOAT_EQ(rects[0].height, 10.0f);
+    EXPECT_FLOAT_EQ(rects[2].y, 6.0f);
+    ExpectExactCover(wall, openings, rects);
+
+    // a window is a hole: 4 pieces
+    openings = { { 4, 4, 2, 2 } };
+    EXPECT_EQ(DecomposeWall(wall, openings).size(), 4u);
+
+    // two windows in a row share the strips above and below them: 5, not 8
+    openings = { { 4, 4, 2, 2 }, { 12, 4, 2, 2 } };
+    rects = DecomposeWall(wall, openings);
+    EXPECT_EQ(rects.size(), 5u);
+    ExpectExactCover(wall, openings, rects);
+
+    // overlapping openings and ones sticking out of the wall
+    openings = { { 4, 4, 4, 2 }, { 6, 5, 4, 3 }, { -5, -5, 7, 7 }, { 18, 8, 10, 10 }, { 3, 3, 0, 5 } };
+    rects = DecomposeWall(wall, openings);
+    ExpectExactCover(wall, openings, rects);
+
+    // nothing left
+    openings = { { -1, -1, 30, 30 } };
+    EXPECT_TRUE(DecomposeWall(wall, openings).empty());
+}
+
+TEST(WallBuilderTest, RandomOpeningsAreCoveredExactly) {
+    std::mt19937 rng(46);
+    for (int trial = 0; trial < 400; ++trial) {
+        // half/quarter-unit coordinates, exact in float (so is x + width)... edges line up with each other and with the
+        // wall's edges all the time
+        std::uniform_int_distribution<int> coord(-2, 22), size(0, 12), count(0, 8);
+        const Rectangle wall{ 0, 0, 10, 6 };
+        std::vector<Rectangle> openings;
+        for (int k = count(rng); k > 0; --k)
+            openings.push_back(Rectangle{ coord(rng) * 0.5f, coord(rng) * 0.25f, size(rng) * 0.5f, size(rng) * 0.25f });
+        std::vector<Rectangle> rects = DecomposeWall(wall, openings);
+        ExpectExactCover(wall, openings, rects);
+        if (HasFatalFailure()) return;
+    }
+}
+
+TEST(WallBuilderTest, MatchesBruteForceMinimum) {
+    std::mt19937 rng(7);
+    for (int trial = 0; trial < 300; ++trial) {
+        int w = 2 + trial % 4, h = 2 + (trial / 4) % 4; // up to 5 x 5 cells
+        std::bernoulli_distribution open(0.3);
+        uint32_t cells = 0;
+        std::vector<Rectangle> openings;
+        for (int j = 0; j < h; ++j)
+            for (int i = 0; i < w; ++i) {
+                if (open(rng)) openings.push_back(Rectangle{ float(i), float(j), 1, 1 });
+                else cells |= 1u << (j * w + i);
+            }
+        const Rectangle wall{ 0, 0, float(w), float(h) };
+        std::vector<Rectangle> rects = DecomposeWall(wall, openings);
+        ExpectExactCover(wall, openings, rects);
+        std::unordered_map<uint32_t, int> memo;
+        ASSERT_EQ(static_cast<int>(rects.size()), BruteForceMinimum(cells, w, h, memo)) << "trial " << trial;
+    }
+}
+
+TEST(WallBuilderTest, MakeWallWithOpeningsBuildsOnePieceEach) {
+    Registry reg;
+    Entity room = reg.create();
+    reg.add<Children>(room, Children{});
+
+    // front wall 20 wide (x), 10 high, centred at z = -5; a door at the left and a window at the right
+    const std::vector<Rectangle> openings = { { 2, 0, 2, 6 }, { 14, 4, 3, 3 } };
+    std::vector<Entity> pieces = MakeWallWithOpenings(reg, room, { 0, 5, -5 }, { 20, 10, 0.1f }, openings, {}, Wall::Side::Front);
+    EXPECT_EQ(pieces.size(), DecomposeWall({ 0, 0, 20, 10 }, openings).size());
+    EXPECT_EQ(reg.get<Children>(room)->entities, pieces);
+
+    float area = 0.0f;
+    for (Entity e : pieces) {
+        auto t = reg.get<TransformComp>(e);
+        ASSERT_NE(t, nullptr);
+        EXPECT_EQ(reg.get<Wall>(e)->side, Wall::Side::Front);
+        EXPECT_TRUE(reg.has<Collision>(e));
+        EXPECT_FLOAT_EQ(t->position.z, -5.0f);
+        EXPECT_FLOAT_EQ(t->size.z, 0.1f);
+        EXPECT_GE(t->position.x - t->size.x / 2, -10.0f - 1e-4f);
+        EXPECT_LE(t->position.y + t->size.y / 2, 10.0f + 1e-4f);
+        area += t->size.x * t->size.y;
+    }
+    EXPECT_NEAR(area, 200.0f - 12.0f - 9.0f, 1e-3f);
+
+    // the old single-door helper goes through the same builder: left, right, lintel
+    Entity hall = reg.create();
+    reg.add<Children>(hall, Children{});
+    MakeWallWithDoor(reg, hall, { 3, 0, 0 }, { 0.1f, 10, 30 }, {}, true);
+    const auto& segments = reg.get<Children>(hall)->entities;
+    ASSERT_EQ(segments.size(), 3u);
+    EXPECT_FLOAT_EQ(reg.get<TransformComp>(segments[0])->position.z, -(15.0f + 1.0f) / 2);
+    EXPECT_FLOAT_EQ(reg.get<TransformComp>(segments[0])->size.z, 14.0f);
+    EXPECT_FLOAT_EQ(reg.get<TransformComp>(segments[2])->position.y, (5.0f + 1.5f) / 2);
+    EXPECT_FLOAT_EQ(reg.get<TransformComp>(segments[2])->size.x, 0.1f);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/components.h"
+#include "../include/ecs/systems.h"
+#include "../include/spatial/collision.h"
+#include "../include/world/anchor.h"
+#include "../include/world/hallway.h"
+#include "../include/world/room.h"
+#include "../include/world/wall_merge.h"
+
+static Entity WallOf(Registry& reg, Entity owner, Wall::Side side) {
+    for (Entity child : reg.get<Children>(owner)->entities)
+        if (auto wall = reg.get<Wall>(child); wall && wall->side == side) return child;
+    return INVALID_ENTITY;
+}
+
+static BoundingBox WorldBox(Registry& reg, Entity e) {
+    return BoundsFromTransform(*reg.get<WorldTransform>(e));
+}
+
+TEST(WallMergeTest, CorridorOfHallwaysBecomesOneBoxPerSide) {
+    Registry reg;
+    TransformSystem transforms;
+    std::vector<Entity> halls;
+    for (int i = 0; i < 3; ++i) halls.push_back(CreateHallway(reg, { 0, 0, 20.0f * i }, { 8, 10, 20 }, AnchorDir::Back));
+    transforms.update(reg);
+    size_t before = reg.entityCount();
+
+    std::vector<WallChange> changes;
+    WallMergeStats stats = MergeCoplanarWalls(reg, {}, {}, &changes);
+    EXPECT_EQ(stats.merged, 8u); // floor, ceiling, left, right: three boxes each down to one
+    EXPECT_EQ(stats.duplicates, 0u);
+    EXPECT_EQ(reg.entityCount(), before - 8);
+    EXPECT_EQ(changes.size(), 12u);
+
+    // everything ended up on the first hallway, its left wall runs the whole corridor
+    Entity left = WallOf(reg, halls[0], Wall::Side::Left);
+    ASSERT_NE(left, INVALID_ENTITY);
+    BoundingBox box = WorldBox(reg, left);
+    EXPECT_NEAR(box.min.z, -10.0f, 1e-4f);
+    EXPECT_NEAR(box.max.z, 50.0f, 1e-4f);
+    EXPECT_EQ(WallOf(reg, halls[1], Wall::Side::Left), INVALID_ENTITY);
+
+    // the TransformComp was rewritten to match: another TransformSystem pass doesn't move anything
+    transforms.update(reg);
+    EXPECT_EQ(transforms.getChangedColliders().size(), 0u);
+    BoundingBox again = WorldBox(reg, left);
+    EXPECT_FLOAT_EQ(again.min.z, box.min.z);
+    EXPECT_FLOAT_EQ(again.max.z, box.max.z);
+
+    // anchors aren't walls
+    for (Entity hall : halls) EXPECT_NE(FindAnchor(reg, hall, AnchorDir::Back), INVALID_ENTITY);
+}
+
+TEST(WallMergeTest, RoomsSideBySideDropTheSharedWall) {
+    Registry reg;
+    TransformSystem transforms;
+    CollisionSystem collision;
+    Entity a = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    Entity b = CreateRoom(reg, { 20, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    collision.update(reg);
+    size_t colliders = reg.count<Collision>();
+
+    std::vector<WallChange> changes;
+    WallMergeStats stats = MergeCoplanarWalls(reg, {}, {}, &changes);
+    // a's right wall and b's left wall are the same box, the floors, ceilings, fronts and backs continue each other
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(stats.merged, 5u);
+    EXPECT_EQ(reg.count<Collision>(), colliders - 5);
+    EXPECT_NE(WallOf(reg, a, Wall::Side::Right), INVALID_ENTITY);
+    EXPECT_EQ(WallOf(reg, b, Wall::Side::Left), INVALID_ENTITY);
+    BoundingBox floor = WorldBox(reg, WallOf(reg, a, Wall::Side::Floor));
+    EXPECT_NEAR(floor.min.x, -10.0f, 1e-4f);
+    EXPECT_NEAR(floor.max.x, 30.0f, 1e-4f);
+
+    // the broadphase follows through the events
+    collision.applyWallChanges(reg, changes);
+    transforms.update(reg);
+    collision.update(reg);
+    Vector3 p = collision.moveAndSlide({ 25, 0, 0 }, { 25, 0, 20 }, { 0.4f, 0.8f, 0.4f });
+    EXPECT_LT(p.z, 10.0f); // the merged back wall still stops the player on b's side
+}
+
+TEST(WallMergeTest, OnlyMatchingMaterialsAndOwnersMerge) {
+    {
+        Registry reg;
+        TransformSystem transforms;
+        CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+        Entity b = CreateRoom(reg, { 20, 0, 0 }, { 20, 10, 20 });
+        reg.get<ColoredRender>(WallOf(reg, b, Wall::Side::Floor))->color = RED;
+        reg.get<Collision>(WallOf(reg, b, Wall::Side::Front))->enabled = false;
+        transforms.update(reg);
+        WallMergeStats stats = MergeCoplanarWalls(reg);
+        EXPECT_EQ(stats.merged, 3u); // shared wall, ceilings, backs
+    }
+    {
+        Registry reg;
+        TransformSystem transforms;
+        Entity a = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+        CreateRoom(reg, { 20, 0, 0 }, { 20, 10, 20 });
+        transforms.update(reg);
+        WallMergeSettings settings;
+        settings.acrossOwners = false;
+        EXPECT_EQ(MergeCoplanarWalls(reg, {}, settings).merged, 0u);
+        // only the listed owners are looked at
+        std::vector<Entity> justA = { a };
+        EXPECT_EQ(MergeCoplanarWalls(reg, justA).merged, 0u);
+    }
+}
+
+TEST(WallMergeTest, CarvedDoorwaysStayOpen) {
+    Registry reg;
+    TransformSystem transforms;
+    Entity a = CreateRoom(reg, { 0, 0, 0 }, { 20, 10, 20 });
+    Entity b = CreateRoom(reg, { 20, 0, 0 }, { 20, 10, 20 });
+    transforms.update(reg);
+    // rooms joined directly, both walls carved at the same spot
+    CarveDoorwayInWall(reg, a, Wall::Side::Right);
+    CarveDoorwayInWall(reg, b, Wall::Side::Left);
+    transforms.update(reg);
+
+    WallMergeStats stats = MergeCoplanarWalls(reg);
+    EXPECT_EQ(stats.duplicates, 3u); // the two sets of door pieces
+    // nothing covers the doorway
+    for (const auto& [e, wt] : reg.view<WorldTransform>()) {
+        if (!reg.has<Collision>(e)) continue;
+        EXPECT_FALSE(BoundsContainsPoint(BoundsFromTransform(*wt), { 10, -3, 0 }));
+    }
+}
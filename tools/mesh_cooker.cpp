@@ -0,0 +1,96 @@
+// offline mesh cooking: glTF -> .cmesh (quantized interleaved vertices, 16-bit indices, precomputed bounds)
+//
+// usage: mesh_cooker [file.gltf ...] [--out DIR]
+//   default input is assets/models/*/scene.gltf, each .cmesh is written next to its source (or into --out)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "../include/render/cooked_mesh.h"
+#include "../include/render/gltf_reader.h"
+#include "../include/render/mesh_cooker.h"
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static uintmax_t GltfBytes(const fs::path& gltf) {
+    // the .gltf plus its buffers (every .bin next to it is close enough for a report)
+    std::error_code ec;
+    uintmax_t total = fs::file_size(gltf, ec);
+    for (const auto& entry : fs::directory_iterator(gltf.parent_path(), ec))
+        if (entry.path().extension() == ".bin") total += entry.file_size(ec);
+    return total;
+}
+
+int main(int argc, char** argv) {
+    std::vector<fs::path> inputs;
+    fs::path outDir;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--out") && i + 1 < argc) outDir = argv[++i];
+        else inputs.emplace_back(argv[i]);
+    }
+    if (inputs.empty()) {
+        std::error_code ec;
+        for (const auto& model : fs::directory_iterator("assets/models", ec))
+            if (fs::exists(model.path() / "scene.gltf")) inputs.push_back(model.path() / "scene.gltf");
+    }
+    if (inputs.empty()) {
+        std::fprintf(stderr, "no meshes to cook\n");
+        return 1;
+    }
+    if (!outDir.empty()) fs::create_directories(outDir);
+
+    int failed = 0;
+    for (const fs::path& input : inputs) {
+        auto t0 = Clock::now();
+        MeshData mesh = LoadGltfMesh(input.string());
+        double parseMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (mesh.empty()) {
+            std::fprintf(stderr, "%s: failed to load\n", input.string().c_str());
+            failed++;
+            continue;
+        }
+
+        CookedMeshFile cooked = CookMesh(mesh);
+        fs::path output = (outDir.empty() ? input.parent_path() : outDir) / input.filename().replace_extension(".cmesh");
+        if (!SaveCookedMesh(cooked, output.string().c_str())) {
+            std::fprintf(stderr, "%s: failed to write\n", output.string().c_str());
+            failed++;
+            continue;
+        }
+
+        // worst position error after quantization, relative to the largest side of the bounds
+        CookedMeshView view = cooked.view();
+        float worst = 0.0f;
+        const Vector3 extent = BoundsExtent(mesh.bounds);
+        const float largest = std::max({ extent.x, extent.y, extent.z, 1e-6f });
+        for (size_t prim = 0, p = 0; prim < mesh.primitives.size(); ++prim) {
+            // parts follow the primitives in order, with the primitive's triangles in order
+            const MeshData::Primitive& src = mesh.primitives[prim];
+            for (uint32_t i = 0; i + 2 < src.indexCount && p < view.header->partCount;) {
+                const CookedMeshPart& part = view.parts[p];
+                for (uint32_t k = 0; k < part.indexCount; ++k, ++i) {
+                    Vector3 a = mesh.positions[mesh.indices[src.firstIndex + i]];
+                    Vector3 b = view.position(part.firstVertex + view.indices[part.firstIndex + k]);
+                    worst = std::max(worst, Vector3Distance(a, b));
+                }
+                p++;
+            }
+        }
+
+        std::printf("%s -> %s\n", input.string().c_str(), output.string().c_str());
+        std::printf("  %u vertices, %u indices, %u parts, parsed in %.2f ms\n", view.header->vertexCount, view.header->indexCount,
+                    view.header->partCount, parseMs);
+        std::printf("  bounds: (%.3f %.3f %.3f) - (%.3f %.3f %.3f)\n", mesh.bounds.min.x, mesh.bounds.min.y, mesh.bounds.min.z,
+                    mesh.bounds.max.x, mesh.bounds.max.y, mesh.bounds.max.z);
+        std::printf("  disk:   %ju -> %zu bytes\n", GltfBytes(input), cooked.bytes.size());
+        std::printf("  max position error: %.6f (%.4f%% of the largest side)\n", worst, 100.0f * worst / largest);
+    }
+    return failed == 0 ? 0 : 1;
+}
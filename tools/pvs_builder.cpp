@@ -0,0 +1,78 @@
+// offline PVS build: walks the cell/portal graph of a level and writes one visibility bit row per cell
+//
+// usage: pvs_builder [out.pvs] [--threads N] [--grid N]
+//   default level is the game's demo level (BuildDemoLevel), --grid N builds an N x N grid of joined rooms instead
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "../include/ecs/registry.h"
+#include "../include/ecs/systems.h"
+#include "../include/world/anchor.h"
+#include "../include/world/cell_graph.h"
+#include "../include/world/demo_level.h"
+#include "../include/world/pvs.h"
+#include "../include/world/room.h"
+
+using Clock = std::chrono::steady_clock;
+
+// rooms placed edge to edge, each joined to its +x and +z neighbour
+static void BuildGrid(Registry& reg, TransformSystem& transforms, int side) {
+    const Vector3 roomSize = { 200, 50, 200 };
+    std::vector<Entity> rooms;
+    for (int z = 0; z < side; ++z)
+        for (int x = 0; x < side; ++x)
+            rooms.push_back(CreateRoom(reg, { x * roomSize.x, 0, z * roomSize.z }, roomSize));
+    transforms.update(reg);
+
+    for (int z = 0; z < side; ++z) {
+        for (int x = 0; x < side; ++x) {
+            Entity room = rooms[z * side + x];
+            if (x + 1 < side) ConnectAnchors(reg, FindAnchor(reg, room, AnchorDir::Right), FindAnchor(reg, rooms[z * side + x + 1], AnchorDir::Left));
+            if (z + 1 < side) ConnectAnchors(reg, FindAnchor(reg, room, AnchorDir::Back), FindAnchor(reg, rooms[(z + 1) * side + x], AnchorDir::Front));
+        }
+    }
+    transforms.update(reg);
+}
+
+int main(int argc, char** argv) {
+    std::string outPath = "level.pvs";
+    PvsBuildSettings settings;
+    int grid = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) settings.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--grid") && i + 1 < argc) grid = std::atoi(argv[++i]);
+        else outPath = argv[i];
+    }
+
+    Registry registry;
+    TransformSystem transformSystem;
+
+    if (grid > 0) BuildGrid(registry, transformSystem, grid);
+    else BuildDemoLevel(registry, transformSystem);
+
+    CellGraph graph;
+    graph.build(registry);
+
+    auto t0 = Clock::now();
+    Pvs pvs = BuildPvs(graph, settings);
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    size_t total = 0;
+    for (uint32_t c = 0; c < pvs.size(); ++c) total += pvs.visibleCount(c);
+
+    std::printf("cells:            %u\n", pvs.size());
+    std::printf("portals:          %zu\n", graph.getPortals().size());
+    std::printf("build:            %.2f ms\n", ms);
+    std::printf("avg visible/cell: %.1f\n", pvs.size() ? static_cast<double>(total) / pvs.size() : 0.0);
+
+    if (!pvs.save(outPath)) {
+        std::fprintf(stderr, "failed to write %s\n", outPath.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", outPath.c_str());
+    return 0;
+}
@@ -0,0 +1,151 @@
+// offline texture cooking: mip chain + BC1/BC3 compression into .ctex files the game uploads as is
+//
+// usage: texture_cooker [file or dir ...] [--out DIR] [--threads N] [--bc1 | --bc3] [--linear] [--max N] [--no-mips]
+//   default input is every image under assets/models/*/textures, each .ctex is written next to its source
+//   (or into --out), then the cooked file is compared with the source: size on disk, bytes sent to the GPU,
+//   load time (PNG decode vs .ctex read) and the level 0 error
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "../include/core/thread_pool.h"
+#include "../include/textures/cooked_texture.h"
+#include "../include/textures/texture_cooker.h"
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static bool IsImageFile(const fs::path& p) {
+    std::string ext = p.extension().string();
+    for (char& c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+static void CollectImages(const fs::path& p, std::vector<fs::path>& out) {
+    std::error_code ec;
+    if (fs::is_directory(p, ec)) {
+        for (const auto& entry : fs::directory_iterator(p, ec))
+            if (entry.is_regular_file() && IsImageFile(entry.path())) out.push_back(entry.path());
+    } else if (fs::is_regular_file(p, ec)) {
+        out.push_back(p);
+    }
+}
+
+static double Ms(Clock::time_point t0) { return std::chrono::duration<double, std::milli>(Clock::now() - t0).count(); }
+
+// root mean square error of the cooked level 0 against the (resized) source, per 8-bit channel
+static double Level0Rmse(const CookedTexture& cooked, const Image& source) {
+    Image reference = ImageCopy(source);
+    ImageFormat(&reference, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if (reference.width != cooked.width || reference.height != cooked.height) ImageResize(&reference, cooked.width, cooked.height);
+
+    const auto* ref = static_cast<const uint8_t*>(reference.data);
+    const int blockBytes = texture_cooker::BlockBytes(cooked.format);
+    const int blocksX = cooked.width / 4;
+    double sum = 0;
+    uint8_t px[64];
+    for (int by = 0; by < cooked.height / 4; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            const uint8_t* block = cooked.data.data() + static_cast<size_t>(by * blocksX + bx) * blockBytes;
+            if (cooked.format == PIXELFORMAT_COMPRESSED_DXT5_RGBA) texture_cooker::DecodeBc3Block(block, px);
+            else texture_cooker::DecodeBc1Block(block, px);
+            for (int i = 0; i < 16; ++i) {
+                const uint8_t* r = ref + ((static_cast<size_t>(by) * 4 + i / 4) * cooked.width + bx * 4 + i % 4) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    double d = static_cast<double>(px[i * 4 + c]) - r[c];
+                    sum += d * d;
+                }
+            }
+        }
+    }
+    UnloadImage(reference);
+    return std::sqrt(sum / (static_cast<double>(cooked.width) * cooked.height * 4));
+}
+
+int main(int argc, char** argv) {
+    CookSettings settings;
+    std::vector<fs::path> inputs;
+    fs::path outDir;
+    unsigned threads = 0;
+    bool explicitInputs = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--out") && i + 1 < argc) outDir = argv[++i];
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--max") && i + 1 < argc) settings.maxSize = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--bc1")) settings.format = CookSettings::Format::BC1;
+        else if (!std::strcmp(argv[i], "--bc3")) settings.format = CookSettings::Format::BC3;
+        else if (!std::strcmp(argv[i], "--linear")) settings.srgb = false;
+        else if (!std::strcmp(argv[i], "--no-mips")) settings.mipmaps = false;
+        else {
+            CollectImages(argv[i], inputs);
+            explicitInputs = true;
+        }
+    }
+    if (!explicitInputs) {
+        std::error_code ec;
+        for (const auto& model : fs::directory_iterator("assets/models", ec))
+            CollectImages(model.path() / "textures", inputs);
+    }
+    if (inputs.empty()) {
+        std::fprintf(stderr, "no textures to cook\n");
+        return 1;
+    }
+    if (!outDir.empty()) fs::create_directories(outDir);
+
+    SetTraceLogLevel(LOG_WARNING);
+    ThreadPool pool(threads);
+    int failed = 0;
+
+    for (const fs::path& input : inputs) {
+        auto t0 = Clock::now();
+        Image source = LoadImage(input.string().c_str());
+        double pngMs = Ms(t0);
+        if (source.data == nullptr) {
+            std::fprintf(stderr, "%s: failed to load\n", input.string().c_str());
+            failed++;
+            continue;
+        }
+
+        t0 = Clock::now();
+        CookedTexture cooked = CookTexture(source, settings, &pool);
+        double cookMs = Ms(t0);
+
+        fs::path output = (outDir.empty() ? input.parent_path() : outDir) / input.filename().replace_extension(".ctex");
+        if (!SaveCookedTexture(cooked, output.string().c_str())) {
+            std::fprintf(stderr, "%s: failed to write\n", output.string().c_str());
+            UnloadImage(source);
+            failed++;
+            continue;
+        }
+
+        t0 = Clock::now();
+        Image reloaded = LoadCookedImage(output.string().c_str());
+        double ctexMs = Ms(t0);
+        UnloadImage(reloaded);
+
+        // what the PNG path uploads: RGBA8 at source size, plus a third more once mips are generated
+        size_t rawBytes = static_cast<size_t>(source.width) * source.height * 4;
+        if (settings.mipmaps) rawBytes += rawBytes / 3;
+        std::error_code ec;
+        auto srcFile = fs::file_size(input, ec);
+        auto ctexFile = fs::file_size(output, ec);
+
+        std::printf("%s -> %s\n", input.string().c_str(), output.string().c_str());
+        std::printf("  %dx%d -> %dx%d %s, %d mips, cooked in %.1f ms\n", source.width, source.height, cooked.width, cooked.height,
+                    cooked.format == PIXELFORMAT_COMPRESSED_DXT5_RGBA ? "BC3" : "BC1", cooked.mipmaps, cookMs);
+        std::printf("  disk:   %10ju -> %10ju bytes\n", static_cast<uintmax_t>(srcFile), static_cast<uintmax_t>(ctexFile));
+        std::printf("  upload: %10zu -> %10zu bytes (%.1fx smaller)\n", rawBytes, cooked.data.size(),
+                    static_cast<double>(rawBytes) / static_cast<double>(std::max<size_t>(1, cooked.data.size())));
+        std::printf("  load:   %10.2f -> %10.2f ms\n", pngMs, ctexMs);
+        std::printf("  rmse:   %.2f\n", Level0Rmse(cooked, source));
+        UnloadImage(source);
+    }
+    return failed == 0 ? 0 : 1;
+}